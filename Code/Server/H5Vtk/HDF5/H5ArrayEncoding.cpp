@@ -0,0 +1,190 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+#include "H5ArrayEncoding.h"
+#include <cmath>
+
+using namespace H5Vtk;
+
+namespace
+{
+  // Position of the components XX, XY, XZ, YY, YZ, ZZ in a row major 3x3
+  // tensor, and of the transposes of XY, XZ and YZ
+  const int H5EncodingSymmetric[6] = { 0, 1, 2, 4, 5, 8 };
+  const int H5EncodingTransposed[3] = { 3, 6, 7 };
+  const int H5EncodingTransposedFrom[3] = { 1, 2, 4 };
+
+  const double H5EncodingOctScale = 65535.0;
+
+  template<typename T>
+  bool H5EncodingIsSymmetric(const T* t, vtkIdType numTuples)
+  {
+    for (vtkIdType i = 0; i < numTuples; ++i, t += 9)
+    {
+      if (t[1] != t[3] || t[5] != t[7] || t[2] != t[6])
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  template<typename T>
+  void H5EncodingPackSymmetric(const T* t, vtkIdType numTuples, T* packed)
+  {
+    for (vtkIdType i = 0; i < numTuples; ++i, t += 9, packed += 6)
+    {
+      for (int c = 0; c < 6; ++c)
+      {
+        packed[c] = t[H5EncodingSymmetric[c]];
+      }
+    }
+  }
+
+  template<typename T>
+  void H5EncodingUnpackSymmetric(const T* packed, vtkIdType numTuples, T* t)
+  {
+    for (vtkIdType i = 0; i < numTuples; ++i, t += 9, packed += 6)
+    {
+      for (int c = 0; c < 6; ++c)
+      {
+        t[H5EncodingSymmetric[c]] = packed[c];
+      }
+      for (int c = 0; c < 3; ++c)
+      {
+        t[H5EncodingTransposed[c]] = packed[H5EncodingTransposedFrom[c]];
+      }
+    }
+  }
+
+  inline uint16_t H5EncodingQuantize(double v)
+  {
+    double q = std::floor((v * 0.5 + 0.5) * H5EncodingOctScale + 0.5);
+    return static_cast<uint16_t>(q < 0.0 ? 0.0 : (q > H5EncodingOctScale ? H5EncodingOctScale : q));
+  }
+
+  template<typename T>
+  void H5EncodingEncodeOctahedral(const T* n, vtkIdType numTuples, uint16_t* encoded)
+  {
+    for (vtkIdType i = 0; i < numTuples; ++i, n += 3, encoded += 2)
+    {
+      double x = n[0];
+      double y = n[1];
+      double z = n[2];
+      double l1 = std::fabs(x) + std::fabs(y) + std::fabs(z);
+      double u = 0.0;
+      double v = 0.0;
+      if (l1 > 0.0)
+      {
+        u = x / l1;
+        v = y / l1;
+        if (z < 0.0)
+        {
+          // Fold the lower half of the octahedron over the upper one
+          double fu = (1.0 - std::fabs(v)) * (u >= 0.0 ? 1.0 : -1.0);
+          double fv = (1.0 - std::fabs(u)) * (v >= 0.0 ? 1.0 : -1.0);
+          u = fu;
+          v = fv;
+        }
+      }
+      encoded[0] = H5EncodingQuantize(u);
+      encoded[1] = H5EncodingQuantize(v);
+    }
+  }
+
+  // Branch free so the loop vectorizes
+  template<typename T>
+  void H5EncodingDecodeOctahedral(const uint16_t* encoded, vtkIdType numTuples, T* n)
+  {
+    const T scale = static_cast<T>(2.0 / H5EncodingOctScale);
+    for (vtkIdType i = 0; i < numTuples; ++i)
+    {
+      T x = static_cast<T>(encoded[2 * i]) * scale - 1;
+      T y = static_cast<T>(encoded[2 * i + 1]) * scale - 1;
+      T z = 1 - std::fabs(x) - std::fabs(y);
+      T t = (z < 0) ? -z : 0;
+      x += (x >= 0) ? -t : t;
+      y += (y >= 0) ? -t : t;
+      T inv = 1 / std::sqrt(x * x + y * y + z * z);
+      n[3 * i] = x * inv;
+      n[3 * i + 1] = y * inv;
+      n[3 * i + 2] = z * inv;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+H5ArrayEncoding::~H5ArrayEncoding()
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool H5ArrayEncoding::isSymmetric(const float* tensors, vtkIdType numTuples)
+{
+  return H5EncodingIsSymmetric(tensors, numTuples);
+}
+
+bool H5ArrayEncoding::isSymmetric(const double* tensors, vtkIdType numTuples)
+{
+  return H5EncodingIsSymmetric(tensors, numTuples);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void H5ArrayEncoding::packSymmetric(const float* tensors, vtkIdType numTuples, float* packed)
+{
+  H5EncodingPackSymmetric(tensors, numTuples, packed);
+}
+
+void H5ArrayEncoding::packSymmetric(const double* tensors, vtkIdType numTuples, double* packed)
+{
+  H5EncodingPackSymmetric(tensors, numTuples, packed);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void H5ArrayEncoding::unpackSymmetric(const float* packed, vtkIdType numTuples, float* tensors)
+{
+  H5EncodingUnpackSymmetric(packed, numTuples, tensors);
+}
+
+void H5ArrayEncoding::unpackSymmetric(const double* packed, vtkIdType numTuples, double* tensors)
+{
+  H5EncodingUnpackSymmetric(packed, numTuples, tensors);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void H5ArrayEncoding::encodeOctahedral(const float* normals, vtkIdType numTuples, uint16_t* encoded)
+{
+  H5EncodingEncodeOctahedral(normals, numTuples, encoded);
+}
+
+void H5ArrayEncoding::encodeOctahedral(const double* normals, vtkIdType numTuples, uint16_t* encoded)
+{
+  H5EncodingEncodeOctahedral(normals, numTuples, encoded);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void H5ArrayEncoding::decodeOctahedral(const uint16_t* encoded, vtkIdType numTuples, float* normals)
+{
+  H5EncodingDecodeOctahedral(encoded, numTuples, normals);
+}
+
+void H5ArrayEncoding::decodeOctahedral(const uint16_t* encoded, vtkIdType numTuples, double* normals)
+{
+  H5EncodingDecodeOctahedral(encoded, numTuples, normals);
+}
@@ -0,0 +1,82 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+#ifndef _H5ARRAYENCODING_H_
+#define _H5ARRAYENCODING_H_
+
+#include <stdint.h>
+
+#include "vtkType.h"
+
+#define H5Support_EXPORT
+
+namespace H5Vtk {
+
+/**
+ * @brief Compact encodings of tensor and normal arrays. A symmetric 3x3
+ * tensor is kept as its 6 components in the order of the XDMF Tensor6
+ * attribute (XX, XY, XZ, YY, YZ, ZZ), which is lossless. A unit normal is
+ * projected onto the octahedron |x|+|y|+|z| = 1, the lower half folded over
+ * the upper one, and the two remaining coordinates quantized to 16 bits
+ * each, for an angular error below 0.01 degree. The
+ * dataset of an encoded array carries the Encoding attribute and, for
+ * normals, the vtk type of the decoded values as EncodedDataType.
+ * @author Mike Jackson for BlueQuartz Software
+ * @date Nov 2010
+ * @version $Revision: 1.1 $
+ */
+class H5ArrayEncoding
+{
+  public:
+    virtual ~H5ArrayEncoding();
+
+    /**
+     * @brief Returns true if every one of the numTuples 9 component tensors
+     * equals its transpose exactly
+     */
+    static H5Support_EXPORT bool isSymmetric(const float* tensors, vtkIdType numTuples);
+    static H5Support_EXPORT bool isSymmetric(const double* tensors, vtkIdType numTuples);
+
+    /**
+     * @brief Copies the 6 independent components of symmetric tensors into
+     * packed, which must hold 6 * numTuples values
+     */
+    static H5Support_EXPORT void packSymmetric(const float* tensors, vtkIdType numTuples, float* packed);
+    static H5Support_EXPORT void packSymmetric(const double* tensors, vtkIdType numTuples, double* packed);
+
+    /**
+     * @brief Expands packed symmetric tensors into tensors, which must hold
+     * 9 * numTuples values
+     */
+    static H5Support_EXPORT void unpackSymmetric(const float* packed, vtkIdType numTuples, float* tensors);
+    static H5Support_EXPORT void unpackSymmetric(const double* packed, vtkIdType numTuples, double* tensors);
+
+    /**
+     * @brief Encodes numTuples normals into 2 * numTuples values. Normals do
+     * not need to be of unit length, a zero normal decodes to (0, 0, 1)
+     */
+    static H5Support_EXPORT void encodeOctahedral(const float* normals, vtkIdType numTuples, uint16_t* encoded);
+    static H5Support_EXPORT void encodeOctahedral(const double* normals, vtkIdType numTuples, uint16_t* encoded);
+
+    /**
+     * @brief Decodes numTuples unit normals into normals, which must hold
+     * 3 * numTuples values
+     */
+    static H5Support_EXPORT void decodeOctahedral(const uint16_t* encoded, vtkIdType numTuples, float* normals);
+    static H5Support_EXPORT void decodeOctahedral(const uint16_t* encoded, vtkIdType numTuples, double* normals);
+
+  protected:
+    H5ArrayEncoding() {}; //This is just a bunch of Static methods
+
+  private:
+    H5ArrayEncoding(const H5ArrayEncoding&);   //Copy Constructor Not Implemented
+    void operator=(const H5ArrayEncoding&); //Copy Assignment Not Implemented
+};
+
+}
+
+#endif /* _H5ARRAYENCODING_H_ */
@@ -0,0 +1,430 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+#include "H5Compression.h"
+
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <stdint.h>
+
+#include "vtk_zlib.h"
+
+using namespace H5Vtk;
+
+namespace
+{
+  // Values per chunk of a compressed dataset
+  const hsize_t H5CompressionChunkValues = 65536;
+
+  // Mode of the H5Z-ZFP cd_values for a fixed accuracy
+  const unsigned int H5CompressionZfpModeAccuracy = 3;
+
+  // Shuffle and compressor codes of the Blosc cd_values
+  const unsigned int H5CompressionBloscBitshuffle = 2;
+  const unsigned int H5CompressionBloscLZ4 = 1;
+
+  // U is the unsigned integer of the size of the float type. Mantissa is the
+  // number of stored mantissa bits and ExpMask the bits of the exponent
+  template<typename F, typename U, int Mantissa>
+  void H5CompressionRoundMantissa(F* values, size_t numValues, int keptBits, U expMask)
+  {
+    int dropped = Mantissa - keptBits;
+    if (dropped <= 0)
+    {
+      return;
+    }
+    const U one = 1;
+    const U mask = ~((one << dropped) - 1);
+    const U halfMinusOne = (one << (dropped - 1)) - 1;
+    for (size_t i = 0; i < numValues; ++i)
+    {
+      U bits;
+      std::memcpy(&bits, values + i, sizeof(U));
+      if ((bits & expMask) == expMask)
+      {
+        continue; // Inf or NaN
+      }
+      // A carry out of the mantissa correctly increments the exponent
+      U rounded = (bits + halfMinusOne + ((bits >> dropped) & one)) & mask;
+      if ((rounded & expMask) == expMask)
+      {
+        continue; // Values this close to the largest finite one would become Inf
+      }
+      std::memcpy(values + i, &rounded, sizeof(U));
+    }
+  }
+
+  template<typename T>
+  double H5CompressionMaximumMagnitude(const T* values, size_t numValues)
+  {
+    double result = 0.0;
+    for (size_t i = 0; i < numValues; ++i)
+    {
+      double v = std::fabs(static_cast<double>(values[i]));
+      if (v > result && v != HUGE_VAL) // NaN never compares larger
+      {
+        result = v;
+      }
+    }
+    return result;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+H5Compression::~H5Compression()
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+H5Z_filter_t H5Compression::getCodecFilter(int codec)
+{
+  switch (codec)
+  {
+    case H5Codec_Deflate: return H5Z_FILTER_DEFLATE;
+    case H5Codec_LZ4: return H5Z_FILTER_LZ4;
+    case H5Codec_Zstd: return H5Z_FILTER_ZSTD;
+    case H5Codec_Blosc: return H5Z_FILTER_BLOSC;
+    default: break;
+  }
+  return H5Z_FILTER_NONE;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const char* H5Compression::getCodecName(int codec)
+{
+  switch (codec)
+  {
+    case H5Codec_Deflate: return "Deflate";
+    case H5Codec_LZ4: return "LZ4";
+    case H5Codec_Zstd: return "Zstd";
+    case H5Codec_Blosc: return "Blosc";
+    case H5Codec_Auto: return "Auto";
+    default: break;
+  }
+  return "None";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t H5Compression::setCodec(hid_t dcpl, int codec, int level)
+{
+  H5Z_filter_t filter = getCodecFilter(codec);
+  if (filter == H5Z_FILTER_NONE)
+  {
+    return (codec == H5Codec_None) ? 0 : -1;
+  }
+  if (!isFilterAvailable(filter))
+  {
+    return -1;
+  }
+  herr_t err = 0;
+  if (codec != H5Codec_Blosc)
+  {
+    err = H5Pset_shuffle(dcpl);
+  }
+  if (err < 0)
+  {
+    return err;
+  }
+  switch (codec)
+  {
+    case H5Codec_Deflate:
+      return H5Pset_deflate(dcpl, level);
+    case H5Codec_LZ4:
+      // The default block size of the plugin
+      return H5Pset_filter(dcpl, H5Z_FILTER_LZ4, H5Z_FLAG_MANDATORY, 0, NULL);
+    case H5Codec_Zstd:
+    {
+      unsigned int cdValues[1] = { static_cast<unsigned int>(level) };
+      return H5Pset_filter(dcpl, H5Z_FILTER_ZSTD, H5Z_FLAG_MANDATORY, 1, cdValues);
+    }
+    default:
+    {
+      // The first 4 values are filled in by the plugin from the chunk
+      unsigned int cdValues[7] = { 0, 0, 0, 0, static_cast<unsigned int>(level),
+                                   H5CompressionBloscBitshuffle, H5CompressionBloscLZ4 };
+      return H5Pset_filter(dcpl, H5Z_FILTER_BLOSC, H5Z_FLAG_MANDATORY, 7, cdValues);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t H5Compression::appendPluginPath(const std::string &path)
+{
+#if H5_VERSION_GE(1,10,1)
+  return H5PLappend(path.c_str());
+#else
+  (void)path;
+  return -1; // Only HDF5_PLUGIN_PATH is searched
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool H5Compression::findMissingFilter(hid_t loc_id, const std::string &dsetName, std::string &missing)
+{
+  hid_t did = H5Dopen(loc_id, dsetName.c_str(), H5P_DEFAULT);
+  if (did < 0)
+  {
+    return false;
+  }
+  hid_t dcpl = H5Dget_create_plist(did);
+  bool isMissing = false;
+  int numFilters = (dcpl < 0) ? 0 : H5Pget_nfilters(dcpl);
+  for (int i = 0; i < numFilters && !isMissing; ++i)
+  {
+    unsigned int flags = 0;
+    size_t numValues = 0;
+    unsigned int config = 0;
+    char name[256] = { 0 };
+    H5Z_filter_t filter = H5Pget_filter2(dcpl, static_cast<unsigned>(i), &flags, &numValues, NULL,
+                                         sizeof(name), name, &config);
+    if (filter < 0 || (flags & H5Z_FLAG_OPTIONAL) != 0)
+    {
+      continue;
+    }
+    // Reading only needs the decoder
+    if (H5Zfilter_avail(filter) <= 0 || H5Zget_filter_info(filter, &config) < 0
+        || (config & H5Z_FILTER_CONFIG_DECODE_ENABLED) == 0)
+    {
+      std::stringstream ss;
+      ss << filter << " (" << (name[0] ? name : "unnamed") << ")";
+      missing = ss.str();
+      isMissing = true;
+    }
+  }
+  if (dcpl >= 0)
+  {
+    H5Pclose(dcpl);
+  }
+  H5Dclose(did);
+  return isMissing;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+hid_t H5Compression::createChunkedProperties(hsize_t numValues, int numComp, hsize_t chunkValues)
+{
+  if (numValues == 0)
+  {
+    return -1; // Chunks can not be empty
+  }
+  hsize_t tupleSize = (numComp > 0) ? static_cast<hsize_t>(numComp) : 1;
+  if (chunkValues == 0) { chunkValues = H5CompressionChunkValues; }
+  hsize_t chunk = (chunkValues / tupleSize) * tupleSize;
+  if (chunk == 0) { chunk = tupleSize; }
+  if (chunk > numValues) { chunk = numValues; }
+  hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+  if (dcpl < 0)
+  {
+    return dcpl;
+  }
+  if (H5Pset_chunk(dcpl, 1, &chunk) < 0)
+  {
+    H5Pclose(dcpl);
+    return -1;
+  }
+  return dcpl;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+long H5Compression::shuffleDeflateChunk(const unsigned char* chunk, size_t chunkBytes, size_t typeSize,
+                                        int level, std::vector<unsigned char> &shuffled,
+                                        std::vector<unsigned char> &compressed)
+{
+  // The shuffle filter groups byte j of every value, bytes left over at the
+  // end stay where they are
+  const unsigned char* source = chunk;
+  if (typeSize > 1 && chunkBytes >= typeSize)
+  {
+    shuffled.resize(chunkBytes);
+    size_t numValues = chunkBytes / typeSize;
+    for (size_t j = 0; j < typeSize; ++j)
+    {
+      unsigned char* dest = &shuffled[j * numValues];
+      for (size_t i = 0; i < numValues; ++i)
+      {
+        dest[i] = chunk[i * typeSize + j];
+      }
+    }
+    size_t leftover = chunkBytes - numValues * typeSize;
+    if (leftover > 0)
+    {
+      std::memcpy(&shuffled[numValues * typeSize], chunk + numValues * typeSize, leftover);
+    }
+    source = &shuffled[0];
+  }
+  uLongf compressedBytes = compressBound(static_cast<uLong>(chunkBytes));
+  compressed.resize(compressedBytes);
+  if (compress2(&compressed[0], &compressedBytes, source, static_cast<uLong>(chunkBytes), level) != Z_OK)
+  {
+    return -1;
+  }
+  return static_cast<long>(compressedBytes);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool H5Compression::isRawChunkWriteAvailable()
+{
+#if H5_VERSION_GE(1,10,3)
+  return true;
+#else
+  return false;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t H5Compression::writeRawChunk(hid_t did, hsize_t offset, const void* data, size_t size)
+{
+#if H5_VERSION_GE(1,10,3)
+  // A filter mask of 0 tells that every filter of the pipeline was applied
+  return H5Dwrite_chunk(did, H5P_DEFAULT, 0, &offset, size, data);
+#else
+  (void)did; (void)offset; (void)data; (void)size;
+  return -1;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool H5Compression::isFilterAvailable(H5Z_filter_t filter)
+{
+  if (H5Zfilter_avail(filter) <= 0)
+  {
+    return false;
+  }
+  unsigned int config = 0;
+  if (H5Zget_filter_info(filter, &config) < 0)
+  {
+    return false;
+  }
+  return (config & H5Z_FILTER_CONFIG_ENCODE_ENABLED) && (config & H5Z_FILTER_CONFIG_DECODE_ENABLED);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t H5Compression::setScaleOffset(hid_t dcpl, double errorBound)
+{
+  if (!(errorBound > 0.0) || !isFilterAvailable(H5Z_FILTER_SCALEOFFSET))
+  {
+    return -1;
+  }
+  // The values are stored as integers in units of 10^-digits. Asking for an
+  // error of a whole unit keeps the bound whether they are rounded or
+  // truncated
+  int digits = static_cast<int>(std::ceil(-std::log10(errorBound)));
+  if (digits < 0) { digits = 0; }
+  return H5Pset_scaleoffset(dcpl, H5Z_SO_FLOAT_DSCALE, digits);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t H5Compression::setZfpAccuracy(hid_t dcpl, double errorBound)
+{
+  if (!(errorBound > 0.0) || !isFilterAvailable(H5Z_FILTER_ZFP))
+  {
+    return -1;
+  }
+  // The tolerance is passed as a double over cd_values[2] and cd_values[3]
+  unsigned int cdValues[4] = { H5CompressionZfpModeAccuracy, 0, 0, 0 };
+  std::memcpy(cdValues + 2, &errorBound, sizeof(double));
+  return H5Pset_filter(dcpl, H5Z_FILTER_ZFP, H5Z_FLAG_MANDATORY, 4, cdValues);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t H5Compression::setShuffleDeflate(hid_t dcpl, int level)
+{
+  if (!isFilterAvailable(H5Z_FILTER_DEFLATE))
+  {
+    return -1;
+  }
+  herr_t err = H5Pset_shuffle(dcpl);
+  if (err >= 0)
+  {
+    err = H5Pset_deflate(dcpl, level);
+  }
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int H5Compression::getKeptMantissaBits(double relativeBound, bool isDouble)
+{
+  int mantissa = isDouble ? 52 : 23;
+  if (!(relativeBound > 0.0))
+  {
+    return mantissa;
+  }
+  if (!(relativeBound < 1.0))
+  {
+    return 0; // Also keeps an infinite bound out of the integer conversion
+  }
+  // Rounding to k bits is off by at most half a unit in the last kept place,
+  // which is 2^-(k+1) of the value
+  int kept = static_cast<int>(std::ceil(-std::log(relativeBound) / std::log(2.0))) - 1;
+  if (kept < 0) { kept = 0; }
+  if (kept > mantissa) { kept = mantissa; }
+  return kept;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+double H5Compression::getBitRoundError(int keptBits)
+{
+  return std::ldexp(1.0, -(keptBits + 1));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void H5Compression::roundMantissa(float* values, size_t numValues, int keptBits)
+{
+  H5CompressionRoundMantissa<float, uint32_t, 23>(values, numValues, keptBits, 0x7F800000u);
+}
+
+void H5Compression::roundMantissa(double* values, size_t numValues, int keptBits)
+{
+  H5CompressionRoundMantissa<double, uint64_t, 52>(values, numValues, keptBits, 0x7FF0000000000000ull);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+double H5Compression::getMaximumMagnitude(const float* values, size_t numValues)
+{
+  return H5CompressionMaximumMagnitude(values, numValues);
+}
+
+double H5Compression::getMaximumMagnitude(const double* values, size_t numValues)
+{
+  return H5CompressionMaximumMagnitude(values, numValues);
+}
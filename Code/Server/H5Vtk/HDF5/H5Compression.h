@@ -0,0 +1,191 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+#ifndef _H5COMPRESSION_H_
+#define _H5COMPRESSION_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include <hdf5.h>
+
+#include "vtkType.h"
+
+#define H5Support_EXPORT
+
+// Registered ids of the filter plugins
+#define H5Z_FILTER_BLOSC 32001
+#define H5Z_FILTER_LZ4   32004
+#define H5Z_FILTER_ZFP   32013
+#define H5Z_FILTER_ZSTD  32015
+
+namespace H5Vtk {
+
+/**
+ * @brief Builds the dataset creation properties of compressed datasets. All
+ * of them only use filters that are either built into HDF5 (scale-offset,
+ * shuffle, deflate) or registered plugins (ZFP, LZ4, Zstd, Blosc), so any
+ * HDF5 reader that can load the filter decodes the data without knowing how
+ * it was written. HDF5 loads the plugins from HDF5_PLUGIN_PATH and the paths
+ * added with appendPluginPath(). Bit rounding is applied to the values before
+ * they are written and needs no filter to be read back.
+ * @author Mike Jackson for BlueQuartz Software
+ * @date Nov 2010
+ * @version $Revision: 1.1 $
+ */
+class H5Compression
+{
+  public:
+    virtual ~H5Compression();
+
+    enum Codecs {
+      H5Codec_None = 0,
+      H5Codec_Deflate = 1,
+      H5Codec_LZ4 = 2,
+      H5Codec_Zstd = 3,
+      H5Codec_Blosc = 4, // Blosc with bitshuffle and LZ4
+      H5Codec_Auto = 5 // Chosen for each dataset by H5StorageTuner
+    };
+
+    /**
+     * @brief Returns the filter implementing codec, or H5Z_FILTER_NONE
+     */
+    static H5Support_EXPORT H5Z_filter_t getCodecFilter(int codec);
+
+    /**
+     * @brief Returns the name of codec for messages and attributes
+     */
+    static H5Support_EXPORT const char* getCodecName(int codec);
+
+    /**
+     * @brief Adds the filters of codec to dcpl. Deflate, LZ4 and Zstd are
+     * preceded by the byte shuffle filter, Blosc does its own bitshuffle.
+     * @param level The compression level of deflate, Zstd and Blosc, LZ4 has
+     * none
+     * @return Standard HDF5 error condition, negative if the filter is not
+     * available
+     */
+    static H5Support_EXPORT herr_t setCodec(hid_t dcpl, int codec, int level);
+
+    /**
+     * @brief Adds path to the directories HDF5 searches for filter plugins
+     * @return Standard HDF5 error condition
+     */
+    static H5Support_EXPORT herr_t appendPluginPath(const std::string &path);
+
+    /**
+     * @brief Checks that every filter of the dataset dsetName can be applied
+     * @param missing Receives the id and name of the first filter that can
+     * not be loaded
+     * @return true if a filter is missing
+     */
+    static H5Support_EXPORT bool findMissingFilter(hid_t loc_id, const std::string &dsetName,
+                                                   std::string &missing);
+
+    /**
+     * @brief Creates a dataset creation property list for a one dimensional
+     * dataset of numValues values chunked in rows of about chunkValues
+     * values, 64K if 0, each chunk holding whole tuples of numComp values.
+     * @return The property list, negative value on error
+     */
+    static H5Support_EXPORT hid_t createChunkedProperties(hsize_t numValues, int numComp,
+                                                          hsize_t chunkValues = 0);
+
+    /**
+     * @brief Runs one chunk of chunkBytes bytes of values of typeSize bytes
+     * through the shuffle and deflate filters of setCodec(H5Codec_Deflate)
+     * the way the HDF5 filter pipeline does, so it can be stored with
+     * writeRawChunk(). Uses no HDF5 call and may run on several threads.
+     * @param shuffled Scratch space, resized as needed
+     * @param compressed Receives the compressed chunk, resized as needed
+     * @return The size of the compressed chunk, negative value on error
+     */
+    static H5Support_EXPORT long shuffleDeflateChunk(const unsigned char* chunk, size_t chunkBytes,
+                                                     size_t typeSize, int level,
+                                                     std::vector<unsigned char> &shuffled,
+                                                     std::vector<unsigned char> &compressed);
+
+    /**
+     * @brief Returns true if this HDF5 library can store chunks that were
+     * filtered by the caller (H5Dwrite_chunk, HDF5 1.10.3 and later)
+     */
+    static H5Support_EXPORT bool isRawChunkWriteAvailable();
+
+    /**
+     * @brief Stores size bytes of an already filtered chunk of the one
+     * dimensional dataset did starting at the value offset
+     * @return Standard HDF5 error condition
+     */
+    static H5Support_EXPORT herr_t writeRawChunk(hid_t did, hsize_t offset, const void* data, size_t size);
+
+    /**
+     * @brief Returns true if the filter is available to this HDF5 library for
+     * encoding and decoding
+     */
+    static H5Support_EXPORT bool isFilterAvailable(H5Z_filter_t filter);
+
+    /**
+     * @brief Adds the scale-offset filter with the smallest decimal scale
+     * that keeps every value within errorBound.
+     * @return Standard HDF5 error condition
+     */
+    static H5Support_EXPORT herr_t setScaleOffset(hid_t dcpl, double errorBound);
+
+    /**
+     * @brief Adds the ZFP filter in fixed accuracy mode with errorBound as
+     * the absolute error tolerance.
+     * @return Standard HDF5 error condition, negative if ZFP is not available
+     */
+    static H5Support_EXPORT herr_t setZfpAccuracy(hid_t dcpl, double errorBound);
+
+    /**
+     * @brief Adds the shuffle and deflate filters. Shuffling the bytes first
+     * turns the zeroed low mantissa bits of rounded values into long runs.
+     * @return Standard HDF5 error condition
+     */
+    static H5Support_EXPORT herr_t setShuffleDeflate(hid_t dcpl, int level);
+
+    /**
+     * @brief Returns the number of mantissa bits bit rounding has to keep so
+     * that the relative error of every value is at most relativeBound. A
+     * bound of 1 or more, including infinity, keeps no bits.
+     */
+    static H5Support_EXPORT int getKeptMantissaBits(double relativeBound, bool isDouble);
+
+    /**
+     * @brief Returns the relative error of values rounded to keptBits
+     * mantissa bits
+     */
+    static H5Support_EXPORT double getBitRoundError(int keptBits);
+
+    /**
+     * @brief Rounds numValues values in place to nearest, ties to even, so
+     * that only keptBits bits of their mantissa are left. Infinities, NaN
+     * and values that would round up to infinity are kept as they are.
+     */
+    static H5Support_EXPORT void roundMantissa(float* values, size_t numValues, int keptBits);
+    static H5Support_EXPORT void roundMantissa(double* values, size_t numValues, int keptBits);
+
+    /**
+     * @brief Returns the largest finite magnitude of numValues values
+     */
+    static H5Support_EXPORT double getMaximumMagnitude(const float* values, size_t numValues);
+    static H5Support_EXPORT double getMaximumMagnitude(const double* values, size_t numValues);
+
+  protected:
+    H5Compression() {}; //This is just a bunch of Static methods
+
+  private:
+    H5Compression(const H5Compression&);   //Copy Constructor Not Implemented
+    void operator=(const H5Compression&); //Copy Assignment Not Implemented
+};
+
+}
+
+#endif /* _H5COMPRESSION_H_ */
@@ -0,0 +1,406 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+#include "H5ConnectivityCodec.h"
+#include <algorithm>
+#include "H5Lite.h"
+#include "VTKH5Constants.h"
+
+using namespace H5Vtk;
+
+namespace
+{
+  // Number of values packed with one width
+  const size_t H5CodecBlockSize = 128;
+
+  inline vtkTypeUInt64 H5CodecZigzag(vtkTypeInt64 v)
+  {
+    return (static_cast<vtkTypeUInt64>(v) << 1) ^ static_cast<vtkTypeUInt64>(v >> 63);
+  }
+
+  inline vtkTypeInt64 H5CodecUnzigzag(vtkTypeUInt64 u)
+  {
+    return static_cast<vtkTypeInt64>(u >> 1) ^ -static_cast<vtkTypeInt64>(u & 1);
+  }
+
+  // Appends the width and the packed bits of count values, least significant
+  // bit first
+  void H5CodecPackBlock(const vtkTypeUInt64* values, size_t count, std::vector<unsigned char> &out)
+  {
+    vtkTypeUInt64 all = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+      all |= values[i];
+    }
+    int width = 0;
+    while (width < 64 && (all >> width) != 0)
+    {
+      ++width;
+    }
+    out.push_back(static_cast<unsigned char>(width));
+    size_t base = out.size();
+    out.resize(base + (count * width + 7) / 8, 0);
+    vtkTypeUInt64 bitPos = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+      vtkTypeUInt64 v = values[i];
+      for (int b = 0; b < width; )
+      {
+        int shift = static_cast<int>(bitPos & 7);
+        int take = std::min(8 - shift, width - b);
+        out[base + (bitPos >> 3)] |= static_cast<unsigned char>(((v >> b) & ((1u << take) - 1)) << shift);
+        b += take;
+        bitPos += take;
+      }
+    }
+  }
+
+  // Unpacks the block at pos into values and moves pos past it
+  bool H5CodecUnpackBlock(const unsigned char* in, size_t numBytes, size_t &pos, size_t count, vtkTypeUInt64* values)
+  {
+    if (pos >= numBytes)
+    {
+      return false;
+    }
+    int width = in[pos++];
+    size_t bytes = (count * width + 7) / 8;
+    if (width > 64 || pos + bytes > numBytes)
+    {
+      return false;
+    }
+    if (width == 0)
+    {
+      std::fill(values, values + count, 0);
+      return true;
+    }
+    // Copy the block with 8 bytes of padding so every value is extracted with
+    // one unaligned 64 bit load, the loop has no dependency between values
+    unsigned char block[H5CodecBlockSize * 8 + 8] = { 0 };
+    std::copy(in + pos, in + pos + bytes, block);
+    pos += bytes;
+    if (width <= 56)
+    {
+      vtkTypeUInt64 mask = (static_cast<vtkTypeUInt64>(1) << width) - 1;
+      for (size_t i = 0; i < count; ++i)
+      {
+        vtkTypeUInt64 bit = i * width;
+        const unsigned char* p = block + (bit >> 3);
+        vtkTypeUInt64 word = static_cast<vtkTypeUInt64>(p[0])
+                           | (static_cast<vtkTypeUInt64>(p[1]) << 8)
+                           | (static_cast<vtkTypeUInt64>(p[2]) << 16)
+                           | (static_cast<vtkTypeUInt64>(p[3]) << 24)
+                           | (static_cast<vtkTypeUInt64>(p[4]) << 32)
+                           | (static_cast<vtkTypeUInt64>(p[5]) << 40)
+                           | (static_cast<vtkTypeUInt64>(p[6]) << 48)
+                           | (static_cast<vtkTypeUInt64>(p[7]) << 56);
+        values[i] = (word >> (bit & 7)) & mask;
+      }
+      return true;
+    }
+    vtkTypeUInt64 bitPos = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+      vtkTypeUInt64 v = 0;
+      for (int b = 0; b < width; )
+      {
+        int shift = static_cast<int>(bitPos & 7);
+        int take = std::min(8 - shift, width - b);
+        v |= static_cast<vtkTypeUInt64>((block[bitPos >> 3] >> shift) & ((1u << take) - 1)) << b;
+        b += take;
+        bitPos += take;
+      }
+      values[i] = v;
+    }
+    return true;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+H5ConnectivityCodec::~H5ConnectivityCodec()
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t H5ConnectivityCodec::encode(const vtkIdType* cells, vtkIdType numCells, vtkIdType numIds,
+                                   std::vector<unsigned char> &out, vtkTypeInt32 &cellSize)
+{
+  out.clear();
+  cellSize = 0;
+  vtkIdType pos = 0;
+  for (vtkIdType c = 0; c < numCells; ++c)
+  {
+    if (pos >= numIds || cells[pos] < 0 || pos + cells[pos] + 1 > numIds)
+    {
+      return -1;
+    }
+    if (c == 0)
+    {
+      cellSize = static_cast<vtkTypeInt32>(cells[pos]);
+    }
+    else if (cells[pos] != cellSize)
+    {
+      cellSize = 0;
+    }
+    pos += cells[pos] + 1;
+  }
+  if (pos != numIds)
+  {
+    return -1;
+  }
+
+  vtkTypeUInt64 values[H5CodecBlockSize];
+  size_t n = 0;
+  if (cellSize == 0)
+  {
+    pos = 0;
+    for (vtkIdType c = 0; c < numCells; ++c)
+    {
+      values[n++] = static_cast<vtkTypeUInt64>(cells[pos]);
+      if (n == H5CodecBlockSize)
+      {
+        H5CodecPackBlock(values, n, out);
+        n = 0;
+      }
+      pos += cells[pos] + 1;
+    }
+    if (n > 0)
+    {
+      H5CodecPackBlock(values, n, out);
+      n = 0;
+    }
+  }
+
+  vtkTypeInt64 prevFirst = 0;
+  pos = 0;
+  for (vtkIdType c = 0; c < numCells; ++c)
+  {
+    vtkIdType npts = cells[pos++];
+    vtkTypeInt64 prev = prevFirst;
+    for (vtkIdType k = 0; k < npts; ++k)
+    {
+      vtkTypeInt64 id = cells[pos++];
+      if (cellSize > 0)
+      {
+        // Same corner of the previous cell
+        prev = (c > 0) ? cells[pos - 1 - npts - 1] : 0;
+      }
+      values[n++] = H5CodecZigzag(id - prev);
+      prev = id;
+      if (k == 0)
+      {
+        prevFirst = id;
+      }
+      if (n == H5CodecBlockSize)
+      {
+        H5CodecPackBlock(values, n, out);
+        n = 0;
+      }
+    }
+  }
+  if (n > 0)
+  {
+    H5CodecPackBlock(values, n, out);
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t H5ConnectivityCodec::decode(const unsigned char* in, size_t numBytes, vtkIdType numCells,
+                                   vtkIdType numIds, vtkTypeInt32 cellSize, vtkIdType* cells)
+{
+  if (numIds < numCells || cellSize < 0)
+  {
+    return -1;
+  }
+  size_t pos = 0;
+  vtkTypeUInt64 values[H5CodecBlockSize];
+  std::vector<vtkIdType> sizes;
+  if (cellSize == 0)
+  {
+    sizes.resize(static_cast<size_t>(numCells));
+    for (size_t start = 0; start < sizes.size(); start += H5CodecBlockSize)
+    {
+      size_t count = std::min(H5CodecBlockSize, sizes.size() - start);
+      if (!H5CodecUnpackBlock(in, numBytes, pos, count, values))
+      {
+        return -1;
+      }
+      for (size_t i = 0; i < count; ++i)
+      {
+        sizes[start + i] = static_cast<vtkIdType>(values[i]);
+      }
+    }
+  }
+
+  vtkIdType out = 0;
+  vtkIdType c = 0;
+  vtkIdType k = 0;
+  vtkIdType npts = 0;
+  vtkTypeInt64 prev = 0;
+  vtkTypeInt64 prevFirst = 0;
+  size_t numDeltas = static_cast<size_t>(numIds - numCells);
+  for (size_t start = 0; start < numDeltas; start += H5CodecBlockSize)
+  {
+    size_t count = std::min(H5CodecBlockSize, numDeltas - start);
+    if (!H5CodecUnpackBlock(in, numBytes, pos, count, values))
+    {
+      return -1;
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+      // Start the next cell, and any empty cells before it
+      while (k == npts)
+      {
+        if (c >= numCells)
+        {
+          return -1;
+        }
+        npts = (cellSize == 0) ? sizes[c] : cellSize;
+        ++c;
+        if (npts < 0 || out + npts + 1 > numIds)
+        {
+          return -1;
+        }
+        cells[out++] = npts;
+        k = 0;
+      }
+      vtkTypeInt64 base = (k == 0) ? prevFirst : prev;
+      if (cellSize > 0)
+      {
+        base = (out > npts) ? cells[out - npts - 1] : 0;
+      }
+      vtkTypeInt64 id = base + H5CodecUnzigzag(values[i]);
+      if (k == 0)
+      {
+        prevFirst = id;
+      }
+      prev = id;
+      cells[out++] = static_cast<vtkIdType>(id);
+      ++k;
+    }
+  }
+  // Trailing empty cells
+  for (; c < numCells; ++c)
+  {
+    if (k != npts || ((cellSize == 0) ? sizes[c] : cellSize) != 0 || out >= numIds)
+    {
+      return -1;
+    }
+    cells[out++] = 0;
+  }
+  return (out == numIds && k == npts && pos == numBytes) ? 0 : -1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t H5ConnectivityCodec::writeCells(hid_t loc_id, const std::string &dsetName,
+                                       const vtkIdType* cells, vtkIdType numCells, vtkIdType numIds)
+{
+  std::vector<unsigned char> bytes;
+  vtkTypeInt32 cellSize = 0;
+  herr_t err = encode(cells, numCells, numIds, bytes, cellSize);
+  if (err < 0)
+  {
+    std::cout << "Error encoding the cells of " << dsetName << std::endl;
+    return err;
+  }
+  // Only a stream without cells encodes to nothing, keep the dataset non empty
+  if (bytes.empty())
+  {
+    bytes.push_back(0);
+  }
+  int32_t rank = 1;
+  hsize_t dims[1] = { bytes.size() };
+  err = H5Lite::writePointerDataset(loc_id, dsetName, rank, dims, &(bytes.front()));
+  if (err >= 0)
+  {
+    err = H5Lite::writeStringAttribute(loc_id, dsetName, H5_CODEC, H5_CODEC_DELTA_BITPACK);
+  }
+  if (err >= 0)
+  {
+    err = H5Lite::writeScalarAttribute(loc_id, dsetName, H5_CODEC_NUMBER_OF_IDS, static_cast<int64_t>(numIds));
+  }
+  if (err >= 0)
+  {
+    err = H5Lite::writeScalarAttribute(loc_id, dsetName, H5_CODEC_CELL_SIZE, static_cast<int32_t>(cellSize));
+  }
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool H5ConnectivityCodec::isEncoded(hid_t loc_id, const std::string &dsetName)
+{
+  return H5Lexists(loc_id, dsetName.c_str(), H5P_DEFAULT) > 0
+      && H5Aexists_by_name(loc_id, dsetName.c_str(), H5_CODEC, H5P_DEFAULT) > 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkTypeInt64 H5ConnectivityCodec::getNumberOfIds(hid_t loc_id, const std::string &dsetName)
+{
+  int64_t numIds = 0;
+  if (H5Lite::readScalarAttribute(loc_id, dsetName, H5_CODEC_NUMBER_OF_IDS, numIds) < 0 || numIds < 0)
+  {
+    return -1;
+  }
+  return numIds;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t H5ConnectivityCodec::readCells(hid_t loc_id, const std::string &dsetName,
+                                      vtkIdType numCells, vtkIdType* cells)
+{
+  if (numCells == 0)
+  {
+    return 0;
+  }
+  std::string codec;
+  herr_t err = H5Lite::readStringAttribute(loc_id, dsetName, H5_CODEC, codec);
+  if (err < 0 || codec != H5_CODEC_DELTA_BITPACK)
+  {
+    std::cout << "Unknown connectivity codec '" << codec << "' for " << dsetName << std::endl;
+    return -1;
+  }
+  vtkTypeInt64 numIds = getNumberOfIds(loc_id, dsetName);
+  int32_t cellSize = 0;
+  if (numIds < 0 || H5Lite::readScalarAttribute(loc_id, dsetName, H5_CODEC_CELL_SIZE, cellSize) < 0)
+  {
+    return -1;
+  }
+  std::vector<hsize_t> dims;
+  H5T_class_t classType;
+  size_t typeSize = 0;
+  err = H5Lite::getDatasetInfo(loc_id, dsetName, dims, classType, typeSize);
+  if (err < 0 || dims.size() != 1 || typeSize != 1)
+  {
+    return -1;
+  }
+  std::vector<unsigned char> bytes(static_cast<size_t>(dims[0]));
+  err = H5Lite::readPointerDataset(loc_id, dsetName, &(bytes.front()));
+  if (err < 0)
+  {
+    return err;
+  }
+  err = decode(&(bytes.front()), bytes.size(), numCells, static_cast<vtkIdType>(numIds), cellSize, cells);
+  if (err < 0)
+  {
+    std::cout << "The encoded cells of " << dsetName << " are corrupt" << std::endl;
+  }
+  return err;
+}
@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+#ifndef _H5CONNECTIVITYCODEC_H_
+#define _H5CONNECTIVITYCODEC_H_
+
+#include <string>
+#include <vector>
+
+#include <hdf5.h>
+
+#include "vtkType.h"
+
+#define H5Support_EXPORT
+
+namespace H5Vtk {
+
+/**
+ * @brief Compact encoding of a vtk cell stream (npts, id, id, ..., npts, ...).
+ * When all cells have the same number of points every id is stored as the
+ * difference to the id at the same corner of the previous cell and the cell
+ * size once as the CellSize attribute. Otherwise the first id of a cell is
+ * stored as the difference to the first id of the previous cell, every other
+ * id as the difference to the id before it, and the cell sizes are packed in
+ * front of the differences. The differences are zigzag mapped to unsigned
+ * values and bit packed in blocks of 128 values, each block with the width of
+ * its largest value. The encoded bytes are kept in a 1D dataset of
+ * unsigned char with the Codec, NumberOfIds and CellSize attributes.
+ * @author Mike Jackson for BlueQuartz Software
+ * @date Nov 2010
+ * @version $Revision: 1.1 $
+ */
+class H5ConnectivityCodec
+{
+  public:
+    virtual ~H5ConnectivityCodec();
+
+    /**
+     * @brief Encodes a cell stream
+     * @param cells The cell stream
+     * @param numCells The number of cells in the stream
+     * @param numIds The length of the stream, cell sizes included
+     * @param out Receives the encoded bytes
+     * @param cellSize Receives the number of points of every cell, or 0 if
+     * the cells have different sizes
+     * @return Negative value if the stream does not match numCells and numIds
+     */
+    static H5Support_EXPORT herr_t encode(const vtkIdType* cells, vtkIdType numCells, vtkIdType numIds,
+                                          std::vector<unsigned char> &out, vtkTypeInt32 &cellSize);
+
+    /**
+     * @brief Decodes the bytes made by encode() into cells, which must hold
+     * numIds values
+     * @return Negative value if the bytes are corrupt
+     */
+    static H5Support_EXPORT herr_t decode(const unsigned char* in, size_t numBytes, vtkIdType numCells,
+                                          vtkIdType numIds, vtkTypeInt32 cellSize, vtkIdType* cells);
+
+    /**
+     * @brief Encodes a cell stream and writes it as the dataset dsetName
+     * @return Standard HDF5 error condition
+     */
+    static H5Support_EXPORT herr_t writeCells(hid_t loc_id, const std::string &dsetName,
+                                              const vtkIdType* cells, vtkIdType numCells, vtkIdType numIds);
+
+    /**
+     * @brief Returns true if dsetName was written by writeCells()
+     */
+    static H5Support_EXPORT bool isEncoded(hid_t loc_id, const std::string &dsetName);
+
+    /**
+     * @brief Returns the length of the decoded cell stream of dsetName, or a
+     * negative value on error
+     */
+    static H5Support_EXPORT vtkTypeInt64 getNumberOfIds(hid_t loc_id, const std::string &dsetName);
+
+    /**
+     * @brief Reads and decodes dsetName into cells, which must hold
+     * getNumberOfIds() values
+     * @param numCells The number of cells, from the "Number Of Cells" attribute
+     * @return Standard HDF5 error condition
+     */
+    static H5Support_EXPORT herr_t readCells(hid_t loc_id, const std::string &dsetName,
+                                             vtkIdType numCells, vtkIdType* cells);
+
+  protected:
+    H5ConnectivityCodec() {}; //This is just a bunch of Static methods
+
+  private:
+    H5ConnectivityCodec(const H5ConnectivityCodec&);   //Copy Constructor Not Implemented
+    void operator=(const H5ConnectivityCodec&); //Copy Assignment Not Implemented
+};
+
+}
+
+#endif /* _H5CONNECTIVITYCODEC_H_ */
@@ -0,0 +1,39 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+#include "H5IOStatistics.h"
+
+using namespace H5Vtk;
+
+vtkTypeUInt64 H5IOStatistics::m_ObjectOpens = 0;
+vtkTypeUInt64 H5IOStatistics::m_ReadOperations = 0;
+vtkTypeUInt64 H5IOStatistics::m_BytesRead = 0;
+vtkTypeUInt64 H5IOStatistics::m_WriteOperations = 0;
+vtkTypeUInt64 H5IOStatistics::m_BytesWritten = 0;
+vtkTypeUInt64 H5IOStatistics::m_Allocations = 0;
+vtkTypeUInt64 H5IOStatistics::m_BytesAllocated = 0;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+H5IOStatistics::~H5IOStatistics()
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void H5IOStatistics::reset()
+{
+  m_ObjectOpens = 0;
+  m_ReadOperations = 0;
+  m_BytesRead = 0;
+  m_WriteOperations = 0;
+  m_BytesWritten = 0;
+  m_Allocations = 0;
+  m_BytesAllocated = 0;
+}
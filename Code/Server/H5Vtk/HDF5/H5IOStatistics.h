@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+#ifndef _H5IOSTATISTICS_H_
+#define _H5IOSTATISTICS_H_
+
+#include "vtkType.h"
+
+#define H5Support_EXPORT
+
+namespace H5Vtk {
+
+/**
+ * @brief Process wide counters for the HDF5 traffic generated by H5Lite and the
+ * H5Vtk readers/writers. The counters only depend on the file layout and the
+ * code path taken, never on timing, so they can be compared exactly between two
+ * runs on the same input. H5VtkBenchmark uses them to detect I/O regressions.
+ * The counters are not thread safe, which matches the HDF5 library itself.
+ * @author Mike Jackson for BlueQuartz Software
+ * @date Nov 2010
+ * @version $Revision: 1.1 $
+ */
+class H5IOStatistics
+{
+  public:
+    virtual ~H5IOStatistics();
+
+    /**
+     * @brief Sets all the counters back to zero
+     */
+    static H5Support_EXPORT void reset();
+
+    /**
+     * @brief Records that an HDF5 object (group or dataset) was opened or created
+     */
+    static H5Support_EXPORT void objectOpened() { ++m_ObjectOpens; }
+
+    /**
+     * @brief Records the number of bytes moved by an H5Dread call
+     */
+    static H5Support_EXPORT void bytesRead(vtkTypeUInt64 bytes) { m_BytesRead += bytes; ++m_ReadOperations; }
+
+    /**
+     * @brief Records the number of bytes moved by an H5Dwrite call
+     */
+    static H5Support_EXPORT void bytesWritten(vtkTypeUInt64 bytes) { m_BytesWritten += bytes; ++m_WriteOperations; }
+
+    /**
+     * @brief Records an allocation of a buffer that will hold data read from the file
+     */
+    static H5Support_EXPORT void allocated(vtkTypeUInt64 bytes) { m_BytesAllocated += bytes; ++m_Allocations; }
+
+    static H5Support_EXPORT vtkTypeUInt64 getObjectOpens() { return m_ObjectOpens; }
+    static H5Support_EXPORT vtkTypeUInt64 getReadOperations() { return m_ReadOperations; }
+    static H5Support_EXPORT vtkTypeUInt64 getBytesRead() { return m_BytesRead; }
+    static H5Support_EXPORT vtkTypeUInt64 getWriteOperations() { return m_WriteOperations; }
+    static H5Support_EXPORT vtkTypeUInt64 getBytesWritten() { return m_BytesWritten; }
+    static H5Support_EXPORT vtkTypeUInt64 getAllocations() { return m_Allocations; }
+    static H5Support_EXPORT vtkTypeUInt64 getBytesAllocated() { return m_BytesAllocated; }
+
+  protected:
+    H5IOStatistics() {}; //This is just a bunch of Static methods
+
+  private:
+    static vtkTypeUInt64 m_ObjectOpens;
+    static vtkTypeUInt64 m_ReadOperations;
+    static vtkTypeUInt64 m_BytesRead;
+    static vtkTypeUInt64 m_WriteOperations;
+    static vtkTypeUInt64 m_BytesWritten;
+    static vtkTypeUInt64 m_Allocations;
+    static vtkTypeUInt64 m_BytesAllocated;
+
+    H5IOStatistics(const H5IOStatistics&);   //Copy Constructor Not Implemented
+    void operator=(const H5IOStatistics&); //Copy Assignment Not Implemented
+};
+
+}
+
+#endif /* _H5IOSTATISTICS_H_ */
@@ -119,6 +119,7 @@ herr_t H5Lite::openId( hid_t loc_id, const std::string& obj_name, H5O_type_t obj
     /* Open the dataset. */
     if ( (obj_id = H5Dopen( loc_id, obj_name.c_str(), H5P_DEFAULT )) < 0 )
      return -1;
+    H5IOStatistics::objectOpened();
     break;
 
    case H5O_TYPE_GROUP:
@@ -126,6 +127,7 @@ herr_t H5Lite::openId( hid_t loc_id, const std::string& obj_name, H5O_type_t obj
     /* Open the group. */
     if ( (obj_id = H5Gopen( loc_id, obj_name.c_str(), H5P_DEFAULT )) < 0 )
      return -1;
+    H5IOStatistics::objectOpened();
     break;
 
 
@@ -713,6 +715,7 @@ hid_t H5Lite::getDatasetType(hid_t loc_id, const std::string &dsetName)
   {
      return -1;
   }
+  H5IOStatistics::objectOpened();
   /* Get an identifier for the datatype. */
   hid_t tid =  H5Dget_type( did );
   CloseH5D(did, err, retErr);
@@ -743,6 +746,7 @@ herr_t H5Lite::getDatasetInfo( hid_t loc_id,
   /* Open the dataset. */
   if ( (did = H5Dopen( loc_id, dsetName.c_str(), H5P_DEFAULT )) < 0 )
   return -1;
+  H5IOStatistics::objectOpened();
 
   /* Get an identifier for the datatype. */
   tid = H5Dget_type( did );
@@ -28,6 +28,8 @@
 
 #include "vtkType.h"
 
+#include "H5IOStatistics.h"
+
 #define uint8_t vtkTypeUInt8
 #define int8_t  vtkTypeInt8
 #define uint16_t vtkTypeUInt16
@@ -424,11 +426,16 @@ class H5Lite
     did = H5Dcreate (loc_id, dsetName.c_str(), dataType, sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
     if ( did >= 0 )
     {
+      H5IOStatistics::objectOpened();
       err = H5Dwrite( did, dataType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data );
       if (err < 0 ) {
         std::cout << "Error Writing Data" << std::endl;
         retErr = err;
       }
+      else
+      {
+        H5IOStatistics::bytesWritten(static_cast<vtkTypeUInt64>(H5Sget_simple_extent_npoints(sid)) * sizeof(T));
+      }
       err = H5Dclose( did );
       if (err < 0) {
         std::cout << "Error Closing Dataset." << std::endl;
@@ -446,6 +453,273 @@ class H5Lite
     return retErr;
   }
 
+  /**
+   * @brief Appends rows to a dataset along its first dimension. The dataset is
+   * created chunked with an unlimited first dimension if it does not exist yet,
+   * otherwise it is extended and the new rows are written at its end. All the
+   * other dimensions must match the existing dataset.
+   * @param loc_id The hdf5 object id of the parent
+   * @param dsetName The name of the dataset to append to
+   * @param rank The number of dimensions
+   * @param dims The sizes of each dimension of the data to append
+   * @param data The data to be written. May be NULL if dims[0] is 0
+   * @param chunkValues The number of values a chunk of a new dataset aims
+   * for, whole rows of at least one. It does not depend on the first append
+   * so later appends do not inherit a tiny chunk.
+   * @return Standard hdf5 error condition.
+   */
+  template <typename T>
+  static herr_t appendPointerDataset (hid_t loc_id,
+                              const std::string& dsetName,
+                              int32_t   rank,
+                              hsize_t* dims,
+                              T* data,
+                              hsize_t chunkValues = 65536)
+  {
+    herr_t err    = -1;
+    hid_t did     = -1;
+    hid_t sid     = -1;
+    herr_t retErr = 0;
+    T test = 0x00;
+    hid_t dataType = H5Lite::HDFTypeForPrimitive(test);
+    if(dataType == -1 || rank < 1)
+    {
+      return -1;
+    }
+    std::vector<hsize_t> offset(rank, 0);
+    std::vector<hsize_t> total(dims, dims + rank);
+
+    HDF_ERROR_HANDLER_OFF
+    did = H5Dopen(loc_id, dsetName.c_str(), H5P_DEFAULT );
+    HDF_ERROR_HANDLER_ON
+    if ( did < 0 ) // dataset does not exist so create it
+    {
+      std::vector<hsize_t> maxDims(dims, dims + rank);
+      maxDims[0] = H5S_UNLIMITED;
+      std::vector<hsize_t> chunk(dims, dims + rank);
+      hsize_t rowSize = 1;
+      for (int32_t i = 1; i < rank; ++i)
+      {
+        if (chunk[i] == 0) { chunk[i] = 1; }
+        rowSize *= chunk[i];
+      }
+      chunk[0] = chunkValues / rowSize;
+      if (chunk[0] == 0) { chunk[0] = 1; }
+      sid = H5Screate_simple( rank, dims, &(maxDims.front()) );
+      if (sid < 0)
+      {
+        return sid;
+      }
+      hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+      H5Pset_chunk(dcpl, rank, &(chunk.front()));
+      did = H5Dcreate (loc_id, dsetName.c_str(), dataType, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+      H5Pclose(dcpl);
+      H5Sclose(sid);
+      if (did < 0)
+      {
+        return did;
+      }
+    }
+    else
+    {
+      sid = H5Dget_space(did);
+      std::vector<hsize_t> fileDims(rank, 0);
+      if (H5Sget_simple_extent_ndims(sid) != rank)
+      {
+        std::cout << "Error appending to " << dsetName << ": the rank does not match the existing dataset" << std::endl;
+        H5Sclose(sid);
+        H5Dclose(did);
+        return -1;
+      }
+      H5Sget_simple_extent_dims(sid, &(fileDims.front()), NULL);
+      H5Sclose(sid);
+      for (int32_t i = 1; i < rank; ++i)
+      {
+        if (fileDims[i] != dims[i])
+        {
+          std::cout << "Error appending to " << dsetName << ": dimension " << i << " does not match the existing dataset" << std::endl;
+          H5Dclose(did);
+          return -1;
+        }
+      }
+      offset[0] = fileDims[0];
+      total[0] = fileDims[0] + dims[0];
+      err = H5Dset_extent(did, &(total.front()));
+      if (err < 0)
+      {
+        std::cout << "Error extending dataset " << dsetName << std::endl;
+        H5Dclose(did);
+        return err;
+      }
+    }
+    H5IOStatistics::objectOpened();
+
+    if (dims[0] > 0)
+    {
+      hid_t fileSpace = H5Dget_space(did);
+      hid_t memSpace = H5Screate_simple(rank, dims, NULL);
+      err = H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, &(offset.front()), NULL, dims, NULL);
+      if (err >= 0)
+      {
+        err = H5Dwrite( did, dataType, memSpace, fileSpace, H5P_DEFAULT, data );
+      }
+      if (err < 0 ) {
+        std::cout << "Error Writing Data" << std::endl;
+        retErr = err;
+      }
+      else
+      {
+        H5IOStatistics::bytesWritten(static_cast<vtkTypeUInt64>(H5Sget_simple_extent_npoints(memSpace)) * sizeof(T));
+      }
+      H5Sclose(memSpace);
+      H5Sclose(fileSpace);
+    }
+    err = H5Dclose( did );
+    if (err < 0) {
+      std::cout << "Error Closing Dataset." << std::endl;
+      retErr = err;
+    }
+    return retErr;
+  }
+
+  /**
+   * @brief Creates a chunked dataset and writes the data into it. Chunked
+   * storage lets a reader fetch a sub block of the dataset without touching the
+   * chunks outside of it. An existing dataset with the same name is replaced.
+   * @param loc_id The hdf5 object id of the parent
+   * @param dsetName The name of the dataset
+   * @param rank The number of dimensions
+   * @param dims The sizes of each dimension
+   * @param chunkDims The chunk size of each dimension. Values are clamped to dims
+   * @param data The data to be written.
+   * @return Standard hdf5 error condition.
+   */
+  template <typename T>
+  static herr_t writeChunkedPointerDataset (hid_t loc_id,
+                              const std::string& dsetName,
+                              int32_t   rank,
+                              hsize_t* dims,
+                              hsize_t* chunkDims,
+                              T* data)
+  {
+    herr_t err    = -1;
+    herr_t retErr = 0;
+    T test = 0x00;
+    hid_t dataType = H5Lite::HDFTypeForPrimitive(test);
+    if(dataType == -1 || rank < 1)
+    {
+      return -1;
+    }
+    std::vector<hsize_t> chunk(chunkDims, chunkDims + rank);
+    hsize_t numElements = 1;
+    for (int32_t i = 0; i < rank; ++i)
+    {
+      if (chunk[i] > dims[i]) { chunk[i] = dims[i]; }
+      if (chunk[i] == 0) { chunk[i] = 1; }
+      numElements *= dims[i];
+    }
+    HDF_ERROR_HANDLER_OFF
+    if (H5Lexists(loc_id, dsetName.c_str(), H5P_DEFAULT) > 0)
+    {
+      H5Ldelete(loc_id, dsetName.c_str(), H5P_DEFAULT);
+    }
+    HDF_ERROR_HANDLER_ON
+    hid_t sid = H5Screate_simple( rank, dims, NULL );
+    if (sid < 0)
+    {
+      return sid;
+    }
+    hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    if (numElements > 0)
+    {
+      H5Pset_chunk(dcpl, rank, &(chunk.front()));
+    }
+    hid_t did = H5Dcreate (loc_id, dsetName.c_str(), dataType, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    H5Pclose(dcpl);
+    if (did < 0)
+    {
+      H5Sclose(sid);
+      return did;
+    }
+    H5IOStatistics::objectOpened();
+    if (numElements > 0)
+    {
+      err = H5Dwrite( did, dataType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data );
+      if (err < 0 ) {
+        std::cout << "Error Writing Data" << std::endl;
+        retErr = err;
+      }
+      else
+      {
+        H5IOStatistics::bytesWritten(static_cast<vtkTypeUInt64>(numElements) * sizeof(T));
+      }
+    }
+    H5Sclose(sid);
+    err = H5Dclose( did );
+    if (err < 0) {
+      std::cout << "Error Closing Dataset." << std::endl;
+      retErr = err;
+    }
+    return retErr;
+  }
+
+  /**
+   * @brief Creates a dataset with the dataset creation properties dcpl, which
+   * hold its chunking and filters, and writes the data into it.
+   * @param loc_id The hdf5 object id of the parent
+   * @param dsetName The name of the dataset
+   * @param rank The number of dimensions
+   * @param dims The sizes of each dimension
+   * @param dcpl The dataset creation property list
+   * @param data The data to be written.
+   * @return Standard hdf5 error condition.
+   */
+  template <typename T>
+  static herr_t writeFilteredPointerDataset (hid_t loc_id,
+                              const std::string& dsetName,
+                              int32_t   rank,
+                              hsize_t* dims,
+                              hid_t dcpl,
+                              T* data)
+  {
+    herr_t err    = -1;
+    herr_t retErr = 0;
+    T test = 0x00;
+    hid_t dataType = H5Lite::HDFTypeForPrimitive(test);
+    if(dataType == -1 || rank < 1)
+    {
+      return -1;
+    }
+    hid_t sid = H5Screate_simple( rank, dims, NULL );
+    if (sid < 0)
+    {
+      return sid;
+    }
+    hid_t did = H5Dcreate (loc_id, dsetName.c_str(), dataType, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    if (did < 0)
+    {
+      H5Sclose(sid);
+      return did;
+    }
+    H5IOStatistics::objectOpened();
+    err = H5Dwrite( did, dataType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data );
+    if (err < 0 ) {
+      std::cout << "Error Writing Data" << std::endl;
+      retErr = err;
+    }
+    else
+    {
+      H5IOStatistics::bytesWritten(static_cast<vtkTypeUInt64>(H5Sget_simple_extent_npoints(sid)) * sizeof(T));
+    }
+    H5Sclose(sid);
+    err = H5Dclose( did );
+    if (err < 0) {
+      std::cout << "Error Closing Dataset." << std::endl;
+      retErr = err;
+    }
+    return retErr;
+  }
+
   template <typename T>
   static herr_t replacePointerDataset (hid_t loc_id,
                               const std::string& dsetName,
@@ -560,11 +834,16 @@ class H5Lite
     did = H5Dcreate (loc_id, dsetName.c_str(), dataType, sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
     if ( did >= 0 )
     {
+      H5IOStatistics::objectOpened();
       err = H5Dwrite( did, dataType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data );
       if (err < 0 ) {
         std::cout << "Error Writing Data" << std::endl;
         retErr = err;
       }
+      else
+      {
+        H5IOStatistics::bytesWritten(static_cast<vtkTypeUInt64>(H5Sget_simple_extent_npoints(sid)) * sizeof(T));
+      }
       err = H5Dclose( did );
       if (err < 0) {
         std::cout << "Error Closing Dataset." << std::endl;
@@ -1052,12 +1331,19 @@ class H5Lite
     }
     if ( did >= 0 )
     {
+      H5IOStatistics::objectOpened();
       err = H5Dread(did, dataType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data );
       if (err < 0)
       {
         std::cout  << "Error Reading Data." << std::endl;
         retErr = err;
       }
+      else
+      {
+        hid_t sid = H5Dget_space(did);
+        H5IOStatistics::bytesRead(static_cast<vtkTypeUInt64>(H5Sget_simple_extent_npoints(sid)) * sizeof(T));
+        H5Sclose(sid);
+      }
       err = H5Dclose( did );
       if (err < 0 )
       {
@@ -1069,6 +1355,211 @@ class H5Lite
   }
 
 
+  /**
+   * @brief Reads a range of rows, along the first dimension, of a dataset into
+   * a preallocated array. All of the other dimensions are read completely.
+   * @param loc_id The parent location that contains the dataset to read
+   * @param dsetName The name of the dataset to read
+   * @param rowStart The first row to read
+   * @param rowCount The number of rows to read
+   * @param data A Pointer to the PreAllocated Array of Data
+   * @return Standard HDF error condition
+   */
+  template <typename T>
+  static herr_t readPointerDatasetRows(hid_t loc_id,
+                                  const std::string& dsetName,
+                                  hsize_t rowStart,
+                                  hsize_t rowCount,
+                                  T* data)
+  {
+    herr_t err = 0;
+    herr_t retErr = 0;
+    T test = 0x00;
+    hid_t dataType = H5Lite::HDFTypeForPrimitive(test);
+    if (dataType == -1)
+    {
+      std::cout  << "dataType was not supported." << std::endl;
+      return -10;
+    }
+    if (rowCount == 0)
+    {
+      return 0;
+    }
+    if (NULL == data)
+    {
+      std::cout  << "The Pointer to hold the data is NULL. This is NOT allowed." << std::endl;
+      return -3;
+    }
+    hid_t did = H5Dopen( loc_id, dsetName.c_str(), H5P_DEFAULT );
+    if ( did < 0 )
+    {
+      std::cout  << " Error opening Dataset: " << did << std::endl;
+      return -1;
+    }
+    H5IOStatistics::objectOpened();
+    hid_t fileSpace = H5Dget_space(did);
+    int rank = H5Sget_simple_extent_ndims(fileSpace);
+    std::vector<hsize_t> dims(rank > 0 ? rank : 1, 0);
+    H5Sget_simple_extent_dims(fileSpace, &(dims.front()), NULL);
+    if (rank < 1 || rowStart + rowCount > dims[0])
+    {
+      std::cout << "Rows " << rowStart << " to " << rowStart + rowCount << " are outside of " << dsetName << std::endl;
+      H5Sclose(fileSpace);
+      H5Dclose(did);
+      return -1;
+    }
+    std::vector<hsize_t> offset(rank, 0);
+    std::vector<hsize_t> count(dims);
+    offset[0] = rowStart;
+    count[0] = rowCount;
+    hid_t memSpace = H5Screate_simple(rank, &(count.front()), NULL);
+    err = H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, &(offset.front()), NULL, &(count.front()), NULL);
+    if (err >= 0)
+    {
+      err = H5Dread(did, dataType, memSpace, fileSpace, H5P_DEFAULT, data);
+    }
+    if (err < 0)
+    {
+      std::cout  << "Error Reading Data." << std::endl;
+      retErr = err;
+    }
+    else
+    {
+      H5IOStatistics::bytesRead(static_cast<vtkTypeUInt64>(H5Sget_simple_extent_npoints(memSpace)) * sizeof(T));
+    }
+    H5Sclose(memSpace);
+    H5Sclose(fileSpace);
+    err = H5Dclose( did );
+    if (err < 0 )
+    {
+      std::cout  << "Error Closing Dataset id" << std::endl;
+      retErr = err;
+    }
+    return retErr;
+  }
+
+  /**
+   * @brief Reads a block of an N dimensional dataset into a preallocated array.
+   * offset and count describe the block for the leading dimensions of the
+   * dataset; any remaining trailing dimensions are read completely. Only the
+   * chunks that intersect the block are read from the file.
+   * @param loc_id The parent location that contains the dataset to read
+   * @param dsetName The name of the dataset to read
+   * @param numSelected The number of leading dimensions in offset and count
+   * @param offset The first index along each selected dimension
+   * @param count The number of indices along each selected dimension
+   * @param data A Pointer to the PreAllocated Array of Data. May be NULL if
+   * the block is empty
+   * @return Standard HDF error condition
+   */
+  template <typename T>
+  static herr_t readPointerDatasetHyperslab(hid_t loc_id,
+                                  const std::string& dsetName,
+                                  int32_t numSelected,
+                                  const hsize_t* offset,
+                                  const hsize_t* count,
+                                  T* data)
+  {
+    for (int32_t i = 0; i < numSelected; ++i)
+    {
+      if (count[i] == 0)
+      {
+        return 0;
+      }
+    }
+    hid_t did = H5Dopen( loc_id, dsetName.c_str(), H5P_DEFAULT );
+    if ( did < 0 )
+    {
+      std::cout  << " Error opening Dataset: " << did << std::endl;
+      return -1;
+    }
+    H5IOStatistics::objectOpened();
+    herr_t retErr = readOpenDatasetHyperslab(did, numSelected, offset, count, data);
+    herr_t err = H5Dclose( did );
+    if (err < 0 )
+    {
+      std::cout  << "Error Closing Dataset id" << std::endl;
+      retErr = err;
+    }
+    return retErr;
+  }
+
+  /**
+   * @brief Reads a block of the open dataset did like
+   * readPointerDatasetHyperslab(). Reading several blocks through one open
+   * dataset keeps the chunks in its chunk cache between the reads.
+   * @return Standard HDF error condition
+   */
+  template <typename T>
+  static herr_t readOpenDatasetHyperslab(hid_t did,
+                                  int32_t numSelected,
+                                  const hsize_t* offset,
+                                  const hsize_t* count,
+                                  T* data)
+  {
+    herr_t err = 0;
+    herr_t retErr = 0;
+    T test = 0x00;
+    hid_t dataType = H5Lite::HDFTypeForPrimitive(test);
+    if (dataType == -1)
+    {
+      std::cout  << "dataType was not supported." << std::endl;
+      return -10;
+    }
+    for (int32_t i = 0; i < numSelected; ++i)
+    {
+      if (count[i] == 0)
+      {
+        return 0;
+      }
+    }
+    if (NULL == data)
+    {
+      std::cout  << "The Pointer to hold the data is NULL. This is NOT allowed." << std::endl;
+      return -3;
+    }
+    hid_t fileSpace = H5Dget_space(did);
+    int rank = H5Sget_simple_extent_ndims(fileSpace);
+    std::vector<hsize_t> dims(rank > 0 ? rank : 1, 0);
+    H5Sget_simple_extent_dims(fileSpace, &(dims.front()), NULL);
+    bool inside = (rank >= numSelected && numSelected > 0);
+    for (int32_t i = 0; inside && i < numSelected; ++i)
+    {
+      inside = (offset[i] + count[i] <= dims[i]);
+    }
+    if (!inside)
+    {
+      std::cout << "The requested block is outside of the dataset" << std::endl;
+      H5Sclose(fileSpace);
+      return -1;
+    }
+    std::vector<hsize_t> start(rank, 0);
+    std::vector<hsize_t> block(dims);
+    for (int32_t i = 0; i < numSelected; ++i)
+    {
+      start[i] = offset[i];
+      block[i] = count[i];
+    }
+    hid_t memSpace = H5Screate_simple(rank, &(block.front()), NULL);
+    err = H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, &(start.front()), NULL, &(block.front()), NULL);
+    if (err >= 0)
+    {
+      err = H5Dread(did, dataType, memSpace, fileSpace, H5P_DEFAULT, data);
+      if (err >= 0)
+      {
+        H5IOStatistics::bytesRead(static_cast<vtkTypeUInt64>(H5Sget_simple_extent_npoints(memSpace)) * sizeof(T));
+      }
+    }
+    if (err < 0)
+    {
+      std::cout  << "Error Reading Data." << std::endl;
+      retErr = err;
+    }
+    H5Sclose(memSpace);
+    H5Sclose(fileSpace);
+    return retErr;
+  }
+
   /**
    * @brief Reads data from the HDF5 File into an std::vector<T> object. If the dataset
    * is very large this can be an expensive method to use. It is here for convenience
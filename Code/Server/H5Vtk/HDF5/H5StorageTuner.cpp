@@ -0,0 +1,288 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+#include "H5StorageTuner.h"
+#include "H5Compression.h"
+
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace H5Vtk;
+
+namespace
+{
+  // Values of each of the three slabs of the sample
+  const hsize_t H5StorageTunerSlabValues = 65536;
+
+  // Arrays smaller than this are stored contiguous, the chunk index and the
+  // filter headers would take most of what compression saves
+  const size_t H5StorageTunerMinimumBytes = 16384;
+
+  // Samples with more bits per byte are taken as incompressible
+  const double H5StorageTunerMaximumEntropy = 7.9;
+
+  // Chunk sizes the best codec is tried with, the last one spans the sample
+  const hsize_t H5StorageTunerChunkValues[3] = { 16384, 65536, 196608 };
+
+  // Every trial is written this often and the fastest time is kept
+  const int H5StorageTunerRepeats = 2;
+
+  // The in memory files need names unique within the process
+  int H5StorageTunerFileCount = 0;
+
+  struct H5StorageTunerTrial
+  {
+    int codec;
+    hsize_t chunkValues;
+    double ratio;
+    double throughput;
+  };
+
+  bool H5StorageTunerMeets(const H5StorageTunerTrial &trial, double targetRatio, double targetThroughput)
+  {
+    return (targetRatio <= 0.0 || trial.ratio >= targetRatio)
+        && (targetThroughput <= 0.0 || trial.throughput >= targetThroughput);
+  }
+
+  // Returns the index of the trial that meets the targets best
+  size_t H5StorageTunerPick(const std::vector<H5StorageTunerTrial> &trials, double targetRatio,
+                            double targetThroughput)
+  {
+    bool anyMeets = false;
+    for (size_t i = 0; i < trials.size(); ++i)
+    {
+      anyMeets = anyMeets || H5StorageTunerMeets(trials[i], targetRatio, targetThroughput);
+    }
+    // Once the throughput is met the ratio decides, otherwise the speed. If
+    // nothing meets the targets the ratio decides when a ratio was asked for
+    bool byRatio = anyMeets ? (targetThroughput > 0.0) : (targetRatio > 0.0);
+    size_t best = trials.size();
+    for (size_t i = 0; i < trials.size(); ++i)
+    {
+      if (anyMeets && !H5StorageTunerMeets(trials[i], targetRatio, targetThroughput))
+      {
+        continue;
+      }
+      if (best == trials.size()
+          || (byRatio ? trials[i].ratio > trials[best].ratio : trials[i].throughput > trials[best].throughput))
+      {
+        best = i;
+      }
+    }
+    return best;
+  }
+
+  // Writes the sample to a dataset of fileId with codec and chunkValues and
+  // measures the ratio and throughput
+  herr_t H5StorageTunerRunTrial(hid_t fileId, const void* sample, hid_t memType, hsize_t sampleValues,
+                                int numComp, int level, H5StorageTunerTrial &trial)
+  {
+    hid_t dcpl = H5Compression::createChunkedProperties(sampleValues, numComp, trial.chunkValues);
+    if (dcpl < 0)
+    {
+      return -1;
+    }
+    herr_t err = H5Compression::setCodec(dcpl, trial.codec, level);
+    // Without a chunk cache H5Dwrite compresses and stores every chunk itself
+    hid_t dapl = H5Pcreate(H5P_DATASET_ACCESS);
+    if (err >= 0 && dapl >= 0)
+    {
+      err = H5Pset_chunk_cache(dapl, 0, 0, 1.0);
+    }
+    hid_t sid = H5Screate_simple(1, &sampleValues, NULL);
+    if (dapl < 0 || sid < 0)
+    {
+      err = -1;
+    }
+    double seconds = 0.0;
+    hsize_t storageSize = 0;
+    for (int r = 0; r < H5StorageTunerRepeats && err >= 0; ++r)
+    {
+      const char* name = "Trial";
+      hid_t did = H5Dcreate2(fileId, name, memType, sid, H5P_DEFAULT, dcpl, dapl);
+      if (did < 0)
+      {
+        err = -1;
+        break;
+      }
+      std::clock_t start = std::clock();
+      err = H5Dwrite(did, memType, H5S_ALL, H5S_ALL, H5P_DEFAULT, sample);
+      double elapsed = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+      if (r == 0 || elapsed < seconds)
+      {
+        seconds = elapsed;
+      }
+      storageSize = H5Dget_storage_size(did);
+      H5Dclose(did);
+      H5Ldelete(fileId, name, H5P_DEFAULT);
+    }
+    if (sid >= 0) { H5Sclose(sid); }
+    if (dapl >= 0) { H5Pclose(dapl); }
+    H5Pclose(dcpl);
+    if (err < 0 || storageSize == 0)
+    {
+      return -1;
+    }
+    double bytes = static_cast<double>(sampleValues) * static_cast<double>(H5Tget_size(memType));
+    trial.ratio = bytes / static_cast<double>(storageSize);
+    // The clock may not resolve the fastest writes
+    trial.throughput = bytes / (1024.0 * 1024.0) / (seconds > 1.0e-6 ? seconds : 1.0e-6);
+    return 0;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+H5StorageTuner::~H5StorageTuner()
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+double H5StorageTuner::getByteEntropy(const unsigned char* bytes, size_t numBytes)
+{
+  if (numBytes == 0)
+  {
+    return 0.0;
+  }
+  size_t counts[256];
+  std::memset(counts, 0, sizeof(counts));
+  for (size_t i = 0; i < numBytes; ++i)
+  {
+    ++counts[bytes[i]];
+  }
+  double entropy = 0.0;
+  for (int b = 0; b < 256; ++b)
+  {
+    if (counts[b] > 0)
+    {
+      double p = static_cast<double>(counts[b]) / static_cast<double>(numBytes);
+      entropy -= p * std::log(p);
+    }
+  }
+  return entropy / std::log(2.0);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t H5StorageTuner::tune(const void* data, hid_t memType, hsize_t numValues, int numComp,
+                            double targetRatio, double targetThroughput, int level, Decision &decision)
+{
+  decision.codec = H5Compression::H5Codec_None;
+  decision.chunkValues = 0;
+  decision.entropy = 0.0;
+  decision.ratio = 1.0;
+  decision.throughput = 0.0;
+  size_t typeSize = H5Tget_size(memType);
+  if (data == NULL || typeSize == 0)
+  {
+    return -1;
+  }
+
+  // Up to three slabs of whole tuples from the start, middle and end
+  hsize_t tupleSize = (numComp > 0) ? static_cast<hsize_t>(numComp) : 1;
+  hsize_t slab = (H5StorageTunerSlabValues / tupleSize) * tupleSize;
+  if (slab == 0) { slab = tupleSize; }
+  const unsigned char* sample = static_cast<const unsigned char*>(data);
+  hsize_t sampleValues = numValues;
+  std::vector<unsigned char> gathered;
+  if (numValues > 3 * slab)
+  {
+    hsize_t starts[3] = { 0, ((numValues / 2 - slab / 2) / tupleSize) * tupleSize,
+                          ((numValues - slab) / tupleSize) * tupleSize };
+    size_t slabBytes = static_cast<size_t>(slab) * typeSize;
+    gathered.resize(3 * slabBytes);
+    for (int s = 0; s < 3; ++s)
+    {
+      std::memcpy(&gathered[s * slabBytes], sample + static_cast<size_t>(starts[s]) * typeSize, slabBytes);
+    }
+    sample = &gathered[0];
+    sampleValues = 3 * slab;
+  }
+  size_t sampleBytes = static_cast<size_t>(sampleValues) * typeSize;
+  decision.entropy = getByteEntropy(sample, sampleBytes);
+  if (sampleBytes < H5StorageTunerMinimumBytes || decision.entropy > H5StorageTunerMaximumEntropy)
+  {
+    return 0;
+  }
+
+  hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+  if (fapl < 0 || H5Pset_fapl_core(fapl, 1024 * 1024, 0) < 0)
+  {
+    if (fapl >= 0) { H5Pclose(fapl); }
+    return -1;
+  }
+  std::stringstream ss;
+  ss << "H5StorageTuner" << ++H5StorageTunerFileCount << ".h5";
+  hid_t fileId = H5Fcreate(ss.str().c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+  H5Pclose(fapl);
+  if (fileId < 0)
+  {
+    return -1;
+  }
+
+  // Every available codec with the default chunk size
+  hsize_t defaultChunk = (H5StorageTunerChunkValues[1] < sampleValues) ? H5StorageTunerChunkValues[1] : sampleValues;
+  std::vector<H5StorageTunerTrial> trials;
+  for (int codec = H5Compression::H5Codec_None; codec <= H5Compression::H5Codec_Blosc; ++codec)
+  {
+    if (codec != H5Compression::H5Codec_None
+        && !H5Compression::isFilterAvailable(H5Compression::getCodecFilter(codec)))
+    {
+      continue;
+    }
+    H5StorageTunerTrial trial = { codec, defaultChunk, 0.0, 0.0 };
+    if (H5StorageTunerRunTrial(fileId, sample, memType, sampleValues, numComp, level, trial) >= 0)
+    {
+      trials.push_back(trial);
+    }
+  }
+  size_t best = H5StorageTunerPick(trials, targetRatio, targetThroughput);
+
+  // Then the best codec with the other chunk sizes
+  if (best < trials.size() && trials[best].codec != H5Compression::H5Codec_None)
+  {
+    std::vector<H5StorageTunerTrial> sizes(1, trials[best]);
+    for (int c = 0; c < 3; ++c)
+    {
+      hsize_t chunk = (H5StorageTunerChunkValues[c] < sampleValues) ? H5StorageTunerChunkValues[c] : sampleValues;
+      bool tried = false;
+      for (size_t i = 0; i < sizes.size(); ++i)
+      {
+        tried = tried || (sizes[i].chunkValues == chunk);
+      }
+      if (tried)
+      {
+        continue; // The sample is too small to tell the sizes apart
+      }
+      H5StorageTunerTrial trial = { trials[best].codec, chunk, 0.0, 0.0 };
+      if (H5StorageTunerRunTrial(fileId, sample, memType, sampleValues, numComp, level, trial) >= 0)
+      {
+        sizes.push_back(trial);
+      }
+    }
+    trials.swap(sizes);
+    best = H5StorageTunerPick(trials, targetRatio, targetThroughput);
+  }
+  H5Fclose(fileId);
+
+  if (best < trials.size())
+  {
+    decision.codec = trials[best].codec;
+    decision.chunkValues = (decision.codec == H5Compression::H5Codec_None) ? 0 : trials[best].chunkValues;
+    decision.ratio = trials[best].ratio;
+    decision.throughput = trials[best].throughput;
+  }
+  return 0;
+}
@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+#ifndef _H5STORAGETUNER_H_
+#define _H5STORAGETUNER_H_
+
+#include <stddef.h>
+
+#include <hdf5.h>
+
+#define H5Support_EXPORT
+
+namespace H5Vtk {
+
+/**
+ * @brief Chooses the codec and chunk size of a one dimensional dataset from
+ * its values. A sample of up to three slabs of 64K values, taken from the
+ * start, the middle and the end of the array, is written to an in memory
+ * HDF5 file with every lossless codec of H5Compression whose filter is
+ * available, so the trials run the same filter pipeline as the real write.
+ * The codec that meets the targets best is then tried with smaller and larger
+ * chunks. Arrays too small to gain from compression and arrays whose bytes
+ * look random are stored contiguous without trials.
+ * @author Mike Jackson for BlueQuartz Software
+ * @date Nov 2010
+ * @version $Revision: 1.1 $
+ */
+class H5StorageTuner
+{
+  public:
+    virtual ~H5StorageTuner();
+
+    /**
+     * @brief The storage chosen for a dataset and what its trial measured
+     */
+    struct Decision
+    {
+      int codec;             // One of H5Compression::Codecs
+      hsize_t chunkValues;   // 0 for contiguous storage
+      double entropy;        // Shannon entropy of the sample in bits per byte
+      double ratio;          // Uncompressed over compressed size of the sample
+      double throughput;     // MB of the sample written per second
+    };
+
+    /**
+     * @brief Chooses the storage of numValues values of the HDF5 memory type
+     * memType. When targetThroughput is set the codec with the best ratio
+     * that writes at least that many MB/s is taken, otherwise the fastest
+     * codec with at least a ratio of targetRatio. If no codec meets the
+     * targets the one coming closest is taken.
+     * @param level The compression level the codecs are tried with
+     * @return Standard HDF5 error condition. decision always holds a usable
+     * storage, contiguous without a codec if the trials failed
+     */
+    static H5Support_EXPORT herr_t tune(const void* data, hid_t memType, hsize_t numValues, int numComp,
+                                        double targetRatio, double targetThroughput, int level,
+                                        Decision &decision);
+
+    /**
+     * @brief Returns the Shannon entropy of numBytes bytes in bits per byte,
+     * 8 for uniformly random bytes
+     */
+    static H5Support_EXPORT double getByteEntropy(const unsigned char* bytes, size_t numBytes);
+
+  protected:
+    H5StorageTuner() {}; //This is just a bunch of Static methods
+
+  private:
+    H5StorageTuner(const H5StorageTuner&);   //Copy Constructor Not Implemented
+    void operator=(const H5StorageTuner&); //Copy Assignment Not Implemented
+};
+
+}
+
+#endif /* _H5STORAGETUNER_H_ */
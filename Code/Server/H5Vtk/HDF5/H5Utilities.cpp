@@ -2,6 +2,7 @@
 
 // C++ Includes
 #include <iostream>
+#include <algorithm>
 
 
 #define CheckValidLocId(locId)\
@@ -40,6 +41,223 @@ hid_t H5Utilities::openFile(const std::string &filename, bool readOnly)
   return fileId;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+hid_t H5Utilities::openSWMRWriteFile(const std::string &filename, bool create)
+{
+  hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+  if (fapl < 0)
+  {
+    return fapl;
+  }
+  H5Pset_libver_bounds(fapl, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST);
+  hid_t fileId = -1;
+  if (create)
+  {
+    fileId = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+  }
+  else
+  {
+    HDF_ERROR_HANDLER_OFF
+    fileId = H5Fopen(filename.c_str(), H5F_ACC_RDWR, fapl);
+    HDF_ERROR_HANDLER_ON
+  }
+  H5Pclose(fapl);
+  return fileId;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+hid_t H5Utilities::openSWMRReadFile(const std::string &filename)
+{
+  HDF_ERROR_HANDLER_OFF
+  hid_t fileId = H5Fopen(filename.c_str(), H5F_ACC_RDONLY | H5F_ACC_SWMR_READ, H5P_DEFAULT);
+  HDF_ERROR_HANDLER_ON
+  return fileId;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t H5Utilities::refreshDatasets(hid_t loc_id, const std::list<std::string> &first)
+{
+  herr_t err = 0;
+  std::list<std::string> groups;
+  for (std::list<std::string>::const_iterator iter = first.begin(); iter != first.end(); ++iter)
+  {
+    if (H5Lexists(loc_id, iter->c_str(), H5P_DEFAULT) > 0)
+    {
+      groups.push_back(*iter);
+    }
+  }
+  std::list<std::string> names;
+  err = H5Utilities::getGroupObjects(loc_id, H5Support_GROUP, names);
+  for (std::list<std::string>::iterator iter = names.begin(); iter != names.end(); ++iter)
+  {
+    if (std::find(groups.begin(), groups.end(), *iter) == groups.end())
+    {
+      groups.push_back(*iter);
+    }
+  }
+  for (std::list<std::string>::iterator iter = groups.begin(); iter != groups.end() && err >= 0; ++iter)
+  {
+    hid_t gid = H5Gopen(loc_id, iter->c_str(), H5P_DEFAULT);
+    if (gid < 0)
+    {
+      return gid;
+    }
+    err = H5Utilities::refreshDatasets(gid, std::list<std::string>());
+    H5Gclose(gid);
+  }
+
+  names.clear();
+  if (err >= 0)
+  {
+    err = H5Utilities::getGroupObjects(loc_id, H5Support_DATASET, names);
+  }
+  for (std::list<std::string>::iterator iter = names.begin(); iter != names.end() && err >= 0; ++iter)
+  {
+    hid_t did = H5Dopen(loc_id, iter->c_str(), H5P_DEFAULT);
+    if (did < 0)
+    {
+      return did;
+    }
+    err = H5Drefresh(did);
+    H5Dclose(did);
+  }
+  return err;
+}
+
+namespace
+{
+  // The smallest cache and hash table HDF5 uses by default
+  const size_t H5UtilitiesDefaultCacheBytes = 1024 * 1024;
+  const size_t H5UtilitiesDefaultCacheSlots = 521;
+  const size_t H5UtilitiesMaximumCacheSlots = 1048576;
+
+  // HDF5 spreads the chunks best over a prime number of slots
+  size_t H5UtilitiesNextPrime(size_t n)
+  {
+    for (;; ++n)
+    {
+      bool prime = (n > 1);
+      for (size_t d = 2; prime && d * d <= n; ++d)
+      {
+        prime = (n % d != 0);
+      }
+      if (prime)
+      {
+        return n;
+      }
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+hid_t H5Utilities::createChunkCacheAccess(hid_t loc_id, const std::string &dsetName,
+                                          const std::vector<std::pair<hsize_t, hsize_t> > &runs,
+                                          size_t maxBytes)
+{
+  if (maxBytes == 0)
+  {
+    return H5P_DEFAULT;
+  }
+  hid_t did = H5Dopen(loc_id, dsetName.c_str(), H5P_DEFAULT);
+  if (did < 0)
+  {
+    return did;
+  }
+  hid_t dcpl = H5Dget_create_plist(did);
+  hid_t spaceId = H5Dget_space(did);
+  hid_t typeId = H5Dget_type(did);
+  int rank = (spaceId < 0) ? -1 : H5Sget_simple_extent_ndims(spaceId);
+  bool chunked = (dcpl >= 0 && rank > 0 && typeId >= 0 && H5Pget_layout(dcpl) == H5D_CHUNKED);
+  std::vector<hsize_t> dims(rank > 0 ? rank : 1, 0);
+  std::vector<hsize_t> chunkDims(rank > 0 ? rank : 1, 0);
+  if (chunked)
+  {
+    chunked = (H5Sget_simple_extent_dims(spaceId, &(dims.front()), NULL) == rank
+               && H5Pget_chunk(dcpl, rank, &(chunkDims.front())) == rank);
+  }
+  size_t typeSize = chunked ? H5Tget_size(typeId) : 0;
+  if (typeId >= 0) { H5Tclose(typeId); }
+  if (spaceId >= 0) { H5Sclose(spaceId); }
+  if (dcpl >= 0) { H5Pclose(dcpl); }
+  H5Dclose(did);
+  if (!chunked || typeSize == 0 || chunkDims[0] == 0)
+  {
+    return H5P_DEFAULT;
+  }
+
+  // A row of chunks spans the first dimension chunkDims[0] rows at a time
+  size_t chunkBytes = typeSize;
+  hsize_t chunksPerRow = 1;
+  for (int i = 0; i < rank; ++i)
+  {
+    chunkBytes *= static_cast<size_t>(chunkDims[i]);
+    if (i > 0 && chunkDims[i] > 0)
+    {
+      chunksPerRow *= (dims[i] + chunkDims[i] - 1) / chunkDims[i];
+    }
+  }
+
+  // The rows of chunks of every run, and whether the runs move forward
+  std::vector<std::pair<hsize_t, hsize_t> > rows;
+  bool ascending = true;
+  hsize_t previousEnd = 0;
+  for (size_t r = 0; r < runs.size(); ++r)
+  {
+    if (runs[r].second == 0)
+    {
+      continue;
+    }
+    ascending = ascending && (runs[r].first >= previousEnd);
+    previousEnd = runs[r].first + runs[r].second;
+    rows.push_back(std::make_pair(runs[r].first / chunkDims[0], (previousEnd - 1) / chunkDims[0]));
+  }
+  hsize_t numRows = ascending ? 1 : 0;
+  if (!ascending)
+  {
+    std::sort(rows.begin(), rows.end());
+    hsize_t covered = 0;
+    for (size_t r = 0; r < rows.size(); ++r)
+    {
+      hsize_t first = std::max(rows[r].first, covered);
+      if (rows[r].second + 1 > first)
+      {
+        numRows += rows[r].second + 1 - first;
+        covered = rows[r].second + 1;
+      }
+    }
+  }
+
+  double needed = static_cast<double>(numRows) * static_cast<double>(chunksPerRow) * static_cast<double>(chunkBytes);
+  size_t nbytes = (needed < static_cast<double>(maxBytes)) ? static_cast<size_t>(needed) : maxBytes;
+  if (nbytes < H5UtilitiesDefaultCacheBytes)
+  {
+    nbytes = (maxBytes < H5UtilitiesDefaultCacheBytes) ? maxBytes : H5UtilitiesDefaultCacheBytes;
+  }
+  size_t nslots = 100 * (nbytes / chunkBytes);
+  if (nslots < H5UtilitiesDefaultCacheSlots) { nslots = H5UtilitiesDefaultCacheSlots; }
+  if (nslots > H5UtilitiesMaximumCacheSlots) { nslots = H5UtilitiesMaximumCacheSlots; }
+
+  hid_t dapl = H5Pcreate(H5P_DATASET_ACCESS);
+  if (dapl < 0)
+  {
+    return dapl;
+  }
+  if (H5Pset_chunk_cache(dapl, H5UtilitiesNextPrime(nslots), nbytes, ascending ? 1.0 : 0.75) < 0)
+  {
+    H5Pclose(dapl);
+    return -1;
+  }
+  return dapl;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -260,7 +478,7 @@ herr_t H5Utilities::getGroupObjects(hid_t loc_id, int32_t typeFilter, std::list<
     else
     {
       H5O_info_t object_info;
-      err = H5Oget_info( loc_id, &object_info);
+      err = H5Oget_info_by_name( loc_id, &(name.front()), &object_info, H5P_DEFAULT);
       if (err >= 0)
       {
         type = object_info.type;
@@ -17,6 +17,8 @@
 #include <map>
 #include <list>
 #include <string>
+#include <utility>
+#include <vector>
 
 //-- HDF Headers
 #include <hdf5.h>
@@ -60,6 +62,46 @@ class H5Utilities
 
     static H5Support_EXPORT herr_t closeFile(hid_t &fileId);
 
+    /**
+     * @brief Opens or creates a file with the latest file format, which single
+     * writer/multiple reader (SWMR) access needs. A writer opened this way
+     * calls H5Fstart_swmr_write() once all its objects exist.
+     * @param filename The file
+     * @param create Truncate or create the file instead of opening it
+     * @return The file id or a negative value on error
+     */
+    static H5Support_EXPORT hid_t openSWMRWriteFile(const std::string &filename, bool create);
+
+    /**
+     * @brief Opens a file for reading while a SWMR writer appends to it
+     * @return The file id or a negative value on error
+     */
+    static H5Support_EXPORT hid_t openSWMRReadFile(const std::string &filename);
+
+    /**
+     * @brief Refreshes every dataset below loc_id with H5Drefresh() so a SWMR
+     * reader sees the extents and data the writer flushed since the datasets
+     * were last read. The group names in first are refreshed before the rest.
+     * @return Standard HDF5 error condition
+     */
+    static H5Support_EXPORT herr_t refreshDatasets(hid_t loc_id, const std::list<std::string> &first);
+
+    /**
+     * @brief Creates dataset access properties whose raw data chunk cache fits
+     * reading the runs (first row, number of rows) of the chunked dataset
+     * dsetName through one open dataset. Runs in ascending order only come
+     * back to the row of chunks the previous run ended in, so the cache holds
+     * one row of chunks and evicts fully read chunks first. Runs in any other
+     * order get a cache for every chunk they touch. The cache has at least
+     * the HDF5 default size, at most maxBytes, and about 100 hash slots per
+     * chunk it holds.
+     * @return The property list, H5P_DEFAULT if the dataset is not chunked or
+     * maxBytes is 0, negative value on error
+     */
+    static H5Support_EXPORT hid_t createChunkCacheAccess(hid_t loc_id, const std::string &dsetName,
+                                                         const std::vector<std::pair<hsize_t, hsize_t> > &runs,
+                                                         size_t maxBytes);
+
     // -------------- HDF Indentifier Methods ----------------------------
     /**
     * @brief Retuirns the path to an object
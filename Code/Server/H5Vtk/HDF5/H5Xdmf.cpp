@@ -0,0 +1,639 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+#include "H5Xdmf.h"
+
+#include <algorithm>
+#include <fstream>
+#include <list>
+#include <sstream>
+#include <stdlib.h>
+
+#include "H5Lite.h"
+#include "H5Utilities.h"
+#include "VTKH5Constants.h"
+
+using namespace H5Vtk;
+
+namespace
+{
+  // Number of CELLS entries scanned at a time when checking the layout
+  const hsize_t H5XdmfScanBlock = 1 << 20;
+
+  std::string H5XdmfDirectory(const std::string &path)
+  {
+    std::string::size_type slash = path.find_last_of("/\\");
+    return (slash == std::string::npos) ? std::string() : path.substr(0, slash);
+  }
+
+  std::string H5XdmfBaseName(const std::string &path)
+  {
+    std::string::size_type slash = path.find_last_of("/\\");
+    return (slash == std::string::npos) ? path : path.substr(slash + 1);
+  }
+
+  bool H5XdmfIndexLess(const std::string &a, const std::string &b)
+  {
+    return atol(a.c_str()) < atol(b.c_str());
+  }
+
+  void H5XdmfCollectObjects(hid_t fileId, const std::string &path, std::vector<std::string> &objects)
+  {
+    hid_t gid = H5Gopen(fileId, path.c_str(), H5P_DEFAULT);
+    if (gid < 0)
+    {
+      return;
+    }
+    std::list<std::string> names;
+    H5Utilities::getGroupObjects(gid, H5Utilities::H5Support_GROUP, names);
+    H5Gclose(gid);
+    for (std::list<std::string>::iterator iter = names.begin(); iter != names.end(); ++iter)
+    {
+      std::string child = (path == "/") ? "/" + *iter : path + "/" + *iter;
+      if (child == H5_VTK_OBJECT_INDEX_PATH || child == H5_VTKHDF_GROUP)
+      {
+        continue;
+      }
+      if (H5Aexists_by_name(fileId, child.c_str(), H5_VTK_DATA_OBJECT, H5P_DEFAULT) > 0)
+      {
+        objects.push_back(child);
+      }
+      else
+      {
+        H5XdmfCollectObjects(fileId, child, objects);
+      }
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+H5Xdmf::~H5Xdmf()
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t H5Xdmf::writeDescriptor(const std::string &h5File,
+                               const std::string &xmfFile,
+                               const std::vector<std::string> &hdfPaths)
+{
+  hid_t fileId = H5Utilities::openFile(h5File, true);
+  if (fileId < 0)
+  {
+    std::cout << "Error opening HDF5 file " << h5File << std::endl;
+    return -1;
+  }
+
+  std::vector<std::string> objects = hdfPaths;
+  if (objects.empty())
+  {
+    objects = H5Xdmf::findObjects(fileId);
+  }
+
+  // The descriptor references the HDF5 file relative to its own location
+  // whenever both live in the same directory so the pair can be moved together
+  std::string h5Name = h5File;
+  if (H5XdmfDirectory(h5File) == H5XdmfDirectory(xmfFile))
+  {
+    h5Name = H5XdmfBaseName(h5File);
+  }
+
+  std::stringstream grids;
+  int numGrids = 0;
+  for (std::vector<std::string>::size_type i = 0; i < objects.size(); ++i)
+  {
+    if (H5Xdmf::writeGrid(grids, fileId, h5Name, objects[i]) >= 0)
+    {
+      ++numGrids;
+    }
+  }
+  H5Utilities::closeFile(fileId);
+
+  if (numGrids == 0)
+  {
+    std::cout << "No object of " << h5File << " can be described with XDMF" << std::endl;
+    return -1;
+  }
+
+  std::ofstream out(xmfFile.c_str(), std::ios::out | std::ios::trunc);
+  if (!out.is_open())
+  {
+    std::cout << "Error opening " << xmfFile << " for writing" << std::endl;
+    return -1;
+  }
+  out << "<?xml version=\"1.0\" ?>\n";
+  out << "<!DOCTYPE Xdmf SYSTEM \"Xdmf.dtd\" []>\n";
+  out << "<Xdmf Version=\"2.0\">\n";
+  out << " <Domain>\n";
+  if (numGrids > 1)
+  {
+    out << "  <Grid Name=\"" << H5Xdmf::escape(H5XdmfBaseName(h5File))
+        << "\" GridType=\"Collection\" CollectionType=\"Spatial\">\n";
+  }
+  out << grids.str();
+  if (numGrids > 1)
+  {
+    out << "  </Grid>\n";
+  }
+  out << " </Domain>\n";
+  out << "</Xdmf>\n";
+  out.close();
+  return out.fail() ? -1 : 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::string H5Xdmf::descriptorFileName(const std::string &h5File)
+{
+  std::string::size_type dot = h5File.find_last_of('.');
+  std::string::size_type slash = h5File.find_last_of("/\\");
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+  {
+    return h5File + ".xmf";
+  }
+  return h5File.substr(0, dot) + ".xmf";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::vector<std::string> H5Xdmf::findObjects(hid_t fileId)
+{
+  std::vector<std::string> objects;
+  if (H5Lexists(fileId, H5_VTK_OBJECT_INDEX_PATH, H5P_DEFAULT) > 0)
+  {
+    hid_t gid = H5Gopen(fileId, H5_VTK_OBJECT_INDEX_PATH, H5P_DEFAULT);
+    std::list<std::string> names;
+    H5Utilities::getGroupObjects(gid, H5Utilities::H5Support_DATASET, names);
+    // The index datasets are named after the position of the object
+    std::vector<std::string> keys(names.begin(), names.end());
+    std::sort(keys.begin(), keys.end(), H5XdmfIndexLess);
+    for (std::vector<std::string>::iterator iter = keys.begin(); iter != keys.end(); ++iter)
+    {
+      std::string path;
+      if (H5Lite::readStringDataset(gid, *iter, path) >= 0 && !path.empty())
+      {
+        objects.push_back(path);
+      }
+    }
+    H5Gclose(gid);
+  }
+  if (objects.empty())
+  {
+    H5XdmfCollectObjects(fileId, "/", objects);
+  }
+  return objects;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::string H5Xdmf::topologyType(int vtkCellType, int numPoints, bool &needsNodesPerElement)
+{
+  needsNodesPerElement = false;
+  switch(vtkCellType)
+  {
+    case VTK_CELLTYPE_VERTEX:
+    case VTK_CELLTYPE_POLY_VERTEX:
+      needsNodesPerElement = true;
+      return "Polyvertex";
+    case VTK_CELLTYPE_LINE:
+    case VTK_CELLTYPE_POLY_LINE:
+      needsNodesPerElement = true;
+      return "Polyline";
+    case VTK_CELLTYPE_TRIANGLE:
+      return "Triangle";
+    case VTK_CELLTYPE_POLYGON:
+      if (numPoints == 3) { return "Triangle"; }
+      if (numPoints == 4) { return "Quadrilateral"; }
+      needsNodesPerElement = true;
+      return "Polygon";
+    case VTK_CELLTYPE_QUAD:
+      return "Quadrilateral";
+    case VTK_CELLTYPE_TETRA:
+      return "Tetrahedron";
+    case VTK_CELLTYPE_HEXAHEDRON:
+      return "Hexahedron";
+    case VTK_CELLTYPE_WEDGE:
+      return "Wedge";
+    case VTK_CELLTYPE_PYRAMID:
+      return "Pyramid";
+    case VTK_CELLTYPE_QUADRATIC_EDGE:
+      return "Edge_3";
+    case VTK_CELLTYPE_QUADRATIC_TRIANGLE:
+      return "Triangle_6";
+    case VTK_CELLTYPE_QUADRATIC_QUAD:
+      return "Quadrilateral_8";
+    case VTK_CELLTYPE_QUADRATIC_TETRA:
+      return "Tetrahedron_10";
+    case VTK_CELLTYPE_QUADRATIC_HEXAHEDRON:
+      return "Hexahedron_20";
+    case VTK_CELLTYPE_QUADRATIC_WEDGE:
+      return "Wedge_15";
+    case VTK_CELLTYPE_QUADRATIC_PYRAMID:
+      return "Pyramid_13";
+    case VTK_CELLTYPE_BIQUADRATIC_QUAD:
+      return "Quadrilateral_9";
+    case VTK_CELLTYPE_TRIQUADRATIC_HEXAHEDRON:
+      return "Hexahedron_27";
+    default:
+      break;
+  }
+  // Pixels and voxels use a point order XDMF does not have
+  return std::string();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t H5Xdmf::writeGrid(std::ostream &out, hid_t fileId, const std::string &h5Name,
+                         const std::string &hdfPath)
+{
+  std::string objectType;
+  herr_t err = H5Lite::readStringAttribute(fileId, hdfPath, H5_VTK_DATA_OBJECT, objectType);
+  if (err < 0)
+  {
+    std::cout << hdfPath << " is not a vtk data object" << std::endl;
+    return -1;
+  }
+  hid_t rootId = H5Gopen(fileId, hdfPath.c_str(), H5P_DEFAULT);
+  if (rootId < 0)
+  {
+    std::cout << "Error opening HDF Group " << hdfPath << std::endl;
+    return -1;
+  }
+
+  std::vector<hsize_t> dims;
+  H5T_class_t classType;
+  size_t typeSize = 0;
+  vtkTypeUInt64 numPoints = 0;
+  if (H5Lexists(rootId, H5_POINTS, H5P_DEFAULT) > 0
+      && H5Lite::getDatasetInfo(rootId, H5_POINTS, dims, classType, typeSize) >= 0)
+  {
+    numPoints = 1;
+    for (std::vector<hsize_t>::size_type i = 0; i < dims.size(); ++i)
+    {
+      numPoints = numPoints * dims[i];
+    }
+    numPoints = numPoints / 3;
+  }
+  if (numPoints == 0)
+  {
+    std::cout << hdfPath << " has no points, it is left out of the XDMF descriptor" << std::endl;
+    H5Gclose(rootId);
+    return -1;
+  }
+
+  std::stringstream topology;
+  vtkTypeUInt64 numCells = 0;
+  err = H5Xdmf::writeTopology(topology, rootId, h5Name, hdfPath, objectType, numCells);
+  if (err < 0)
+  {
+    std::cout << hdfPath << " is left out of the XDMF descriptor" << std::endl;
+    H5Gclose(rootId);
+    return -1;
+  }
+
+  std::string name = H5XdmfBaseName(hdfPath);
+  out << "   <Grid Name=\"" << H5Xdmf::escape(name.empty() ? hdfPath : name) << "\" GridType=\"Uniform\">\n";
+  out << topology.str();
+  std::stringstream pointDims;
+  pointDims << numPoints << " 3";
+  out << "    <Geometry GeometryType=\"XYZ\">\n";
+  out << "     " << H5Xdmf::dataItem(rootId, H5_POINTS, h5Name + ":" + hdfPath + "/" + H5_POINTS, pointDims.str()) << "\n";
+  out << "    </Geometry>\n";
+  H5Xdmf::writeAttributes(out, rootId, h5Name, hdfPath, H5_POINT_DATA_GROUP_NAME, "Node", numPoints);
+  H5Xdmf::writeAttributes(out, rootId, h5Name, hdfPath, H5_CELL_DATA_GROUP_NAME, "Cell", numCells);
+  out << "   </Grid>\n";
+
+  H5Gclose(rootId);
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t H5Xdmf::writeTopology(std::ostream &out, hid_t rootId, const std::string &h5Name,
+                             const std::string &hdfPath, const std::string &objectType,
+                             vtkTypeUInt64 &numCells)
+{
+  numCells = 0;
+  std::string cellsName;
+  int vtkCellType = VTK_CELLTYPE_EMPTY_CELL;
+  if (objectType == H5_VTK_UNSTRUCTURED_GRID)
+  {
+    cellsName = H5_CELLS;
+  }
+  else if (objectType == H5_VTK_POLYDATA)
+  {
+    // XDMF grids have a single topology, so only one kind of cell is allowed
+    const char* sets[3] = { H5_VERTICES, H5_LINES, H5_POLYGONS };
+    const int setTypes[3] = { VTK_CELLTYPE_POLY_VERTEX, VTK_CELLTYPE_POLY_LINE, VTK_CELLTYPE_POLYGON };
+    if (H5Lexists(rootId, H5_TRIANGLE_STRIPS, H5P_DEFAULT) > 0)
+    {
+      std::cout << hdfPath << ": triangle strips can not be described with XDMF" << std::endl;
+      return -1;
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+      if (H5Lexists(rootId, sets[i], H5P_DEFAULT) <= 0)
+      {
+        continue;
+      }
+      if (!cellsName.empty())
+      {
+        std::cout << hdfPath << ": both " << cellsName << " and " << sets[i]
+                  << " are present but an XDMF grid can only hold one kind of cell" << std::endl;
+        return -1;
+      }
+      cellsName = sets[i];
+      vtkCellType = setTypes[i];
+    }
+  }
+  else
+  {
+    std::cout << hdfPath << ": " << objectType << " objects are not supported" << std::endl;
+    return -1;
+  }
+  if (cellsName.empty() && H5Lexists(rootId, H5_POINTS, H5P_DEFAULT) > 0
+      && H5Aexists_by_name(rootId, H5_POINTS, H5_IMPLICIT_VERTICES, H5P_DEFAULT) > 0)
+  {
+    std::cout << hdfPath << ": the vertices of the point cloud are implicit and can not be described with XDMF" << std::endl;
+    return -1;
+  }
+  if (cellsName.empty() || H5Lexists(rootId, cellsName.c_str(), H5P_DEFAULT) <= 0)
+  {
+    std::cout << hdfPath << " has no cells" << std::endl;
+    return -1;
+  }
+  if (H5Aexists_by_name(rootId, cellsName.c_str(), H5_CODEC, H5P_DEFAULT) > 0)
+  {
+    std::cout << hdfPath << ": " << cellsName << " is encoded and can not be described with XDMF" << std::endl;
+    return -1;
+  }
+
+  vtkTypeInt32 ncells = 0;
+  std::vector<hsize_t> dims;
+  H5T_class_t classType;
+  size_t typeSize = 0;
+  if (H5Lite::readScalarAttribute(rootId, cellsName, "Number Of Cells", ncells) < 0
+      || H5Lite::getDatasetInfo(rootId, cellsName, dims, classType, typeSize) < 0
+      || dims.size() != 1 || ncells < 1)
+  {
+    std::cout << hdfPath << ": can not read the size of " << cellsName << std::endl;
+    return -1;
+  }
+  hsize_t size = dims[0];
+
+  // A grid with a single cell type stores only the point ids, which XDMF
+  // reads as a (cells x npts) table as they are
+  vtkTypeInt32 cellType = 0;
+  if (objectType == H5_VTK_UNSTRUCTURED_GRID
+      && H5Aexists_by_name(rootId, cellsName.c_str(), H5_CELL_TYPE, H5P_DEFAULT) > 0)
+  {
+    if (H5Lite::readScalarAttribute(rootId, cellsName, H5_CELL_TYPE, cellType) < 0
+        || size % static_cast<hsize_t>(ncells) != 0)
+    {
+      std::cout << hdfPath << ": can not read the cell type of " << cellsName << std::endl;
+      return -1;
+    }
+    hsize_t npts = size / static_cast<hsize_t>(ncells);
+    bool needsNodesPerElement = false;
+    std::string xdmfType = H5Xdmf::topologyType(cellType, static_cast<int>(npts), needsNodesPerElement);
+    if (xdmfType.empty())
+    {
+      std::cout << hdfPath << ": vtk cell type " << cellType << " has no XDMF equivalent" << std::endl;
+      return -1;
+    }
+    numCells = static_cast<vtkTypeUInt64>(ncells);
+    std::stringstream tableDims;
+    tableDims << ncells << " " << npts;
+    out << "    <Topology TopologyType=\"" << xdmfType << "\" NumberOfElements=\"" << ncells << "\"";
+    if (needsNodesPerElement)
+    {
+      out << " NodesPerElement=\"" << npts << "\"";
+    }
+    out << ">\n";
+    out << "     " << H5Xdmf::dataItem(rootId, cellsName, h5Name + ":" + hdfPath + "/" + cellsName, tableDims.str()) << "\n";
+    out << "    </Topology>\n";
+    return 0;
+  }
+
+  // The cells are stored as (npts, id, id, ...) runs. Presenting them to XDMF
+  // without a copy requires every run to have the same length, so the dataset
+  // can be viewed as a (cells x (npts + 1)) table and the first column skipped
+  std::vector<int64_t> block(1);
+  if (H5Lite::readPointerDatasetRows(rootId, cellsName, 0, 1, &(block.front())) < 0)
+  {
+    return -1;
+  }
+  hsize_t npts = static_cast<hsize_t>(block[0]);
+  if (npts < 1 || size != static_cast<hsize_t>(ncells) * (npts + 1))
+  {
+    std::cout << hdfPath << ": the cells of " << cellsName << " do not all have the same number of points" << std::endl;
+    return -1;
+  }
+  hsize_t rowsPerBlock = std::max<hsize_t>(1, H5XdmfScanBlock / (npts + 1));
+  for (hsize_t row = 0; row < static_cast<hsize_t>(ncells); row += rowsPerBlock)
+  {
+    hsize_t rows = std::min<hsize_t>(rowsPerBlock, static_cast<hsize_t>(ncells) - row);
+    block.resize(rows * (npts + 1));
+    if (H5Lite::readPointerDatasetRows(rootId, cellsName, row * (npts + 1), rows * (npts + 1), &(block.front())) < 0)
+    {
+      return -1;
+    }
+    for (hsize_t c = 0; c < rows; ++c)
+    {
+      if (static_cast<hsize_t>(block[c * (npts + 1)]) != npts)
+      {
+        std::cout << hdfPath << ": the cells of " << cellsName << " do not all have the same number of points" << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  if (objectType == H5_VTK_UNSTRUCTURED_GRID)
+  {
+    std::vector<hsize_t> typeDims;
+    if (H5Lite::getDatasetInfo(rootId, H5_CELL_TYPES, typeDims, classType, typeSize) < 0
+        || typeDims.size() != 1 || typeDims[0] != static_cast<hsize_t>(ncells))
+    {
+      std::cout << hdfPath << ": can not read " << H5_CELL_TYPES << std::endl;
+      return -1;
+    }
+    std::vector<uint8_t> types(static_cast<size_t>(ncells));
+    if (H5Lite::readPointerDataset(rootId, H5_CELL_TYPES, &(types.front())) < 0)
+    {
+      return -1;
+    }
+    vtkCellType = types[0];
+    for (vtkTypeInt32 c = 1; c < ncells; ++c)
+    {
+      if (types[c] != vtkCellType)
+      {
+        std::cout << hdfPath << ": mixed cell types can not be described with XDMF" << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  bool needsNodesPerElement = false;
+  std::string xdmfType = H5Xdmf::topologyType(vtkCellType, static_cast<int>(npts), needsNodesPerElement);
+  if (xdmfType.empty())
+  {
+    std::cout << hdfPath << ": vtk cell type " << vtkCellType << " has no XDMF equivalent" << std::endl;
+    return -1;
+  }
+
+  numCells = static_cast<vtkTypeUInt64>(ncells);
+  std::stringstream slabDims;
+  slabDims << ncells << " " << npts;
+  std::stringstream fileDims;
+  fileDims << ncells << " " << (npts + 1);
+
+  out << "    <Topology TopologyType=\"" << xdmfType << "\" NumberOfElements=\"" << ncells << "\"";
+  if (needsNodesPerElement)
+  {
+    out << " NodesPerElement=\"" << npts << "\"";
+  }
+  out << ">\n";
+  out << "     <DataItem ItemType=\"HyperSlab\" Dimensions=\"" << slabDims.str() << "\" Type=\"HyperSlab\">\n";
+  out << "      <DataItem Dimensions=\"3 2\" Format=\"XML\">0 1 1 1 " << slabDims.str() << "</DataItem>\n";
+  out << "      " << H5Xdmf::dataItem(rootId, cellsName, h5Name + ":" + hdfPath + "/" + cellsName, fileDims.str()) << "\n";
+  out << "     </DataItem>\n";
+  out << "    </Topology>\n";
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void H5Xdmf::writeAttributes(std::ostream &out, hid_t rootId, const std::string &h5Name,
+                             const std::string &hdfPath, const char* groupName,
+                             const char* center, vtkTypeUInt64 numTuples)
+{
+  if (numTuples == 0 || H5Lexists(rootId, groupName, H5P_DEFAULT) <= 0)
+  {
+    return;
+  }
+  hid_t gid = H5Gopen(rootId, groupName, H5P_DEFAULT);
+  if (gid < 0)
+  {
+    return;
+  }
+  std::list<std::string> names;
+  H5Utilities::getGroupObjects(gid, H5Utilities::H5Support_DATASET, names);
+  for (std::list<std::string>::iterator iter = names.begin(); iter != names.end(); ++iter)
+  {
+    std::vector<hsize_t> dims;
+    H5T_class_t classType;
+    size_t typeSize = 0;
+    if (H5Lite::getDatasetInfo(gid, *iter, dims, classType, typeSize) < 0
+        || (classType != H5T_INTEGER && classType != H5T_FLOAT))
+    {
+      continue;
+    }
+    vtkTypeUInt64 numElements = 1;
+    for (std::vector<hsize_t>::size_type i = 0; i < dims.size(); ++i)
+    {
+      numElements = numElements * dims[i];
+    }
+    vtkTypeInt32 numComp = 1;
+    H5Lite::readScalarAttribute(gid, *iter, H5_NUMCOMPONENTS, numComp);
+    // Symmetric tensors are stored in the Tensor6 order, other encodings
+    // have no XDMF equivalent
+    std::string encoding;
+    if (H5Aexists_by_name(gid, iter->c_str(), H5_ENCODING, H5P_DEFAULT) > 0
+        && (H5Lite::readStringAttribute(gid, *iter, H5_ENCODING, encoding) < 0
+            || encoding != H5_ENCODING_SYMMETRIC_TENSOR))
+    {
+      continue;
+    }
+    // Bit arrays and arrays written for another number of tuples can not be mapped
+    if (numComp < 1 || numElements != numTuples * static_cast<vtkTypeUInt64>(numComp))
+    {
+      continue;
+    }
+    const char* attributeType = "Matrix";
+    switch(numComp)
+    {
+      case 1: attributeType = "Scalar"; break;
+      case 3: attributeType = "Vector"; break;
+      case 6: attributeType = "Tensor6"; break;
+      case 9: attributeType = "Tensor"; break;
+      default: break;
+    }
+    std::stringstream attrDims;
+    attrDims << numTuples;
+    if (numComp > 1)
+    {
+      attrDims << " " << numComp;
+    }
+    out << "    <Attribute Name=\"" << H5Xdmf::escape(*iter) << "\" AttributeType=\"" << attributeType
+        << "\" Center=\"" << center << "\">\n";
+    out << "     " << H5Xdmf::dataItem(gid, *iter, h5Name + ":" + hdfPath + "/" + groupName + "/" + *iter, attrDims.str()) << "\n";
+    out << "    </Attribute>\n";
+  }
+  H5Gclose(gid);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::string H5Xdmf::dataItem(hid_t parentId, const std::string &dsetName,
+                             const std::string &reference, const std::string &dimensions)
+{
+  std::string numberType = "Float";
+  size_t precision = 4;
+  hid_t typeId = H5Lite::getDatasetType(parentId, dsetName);
+  if (typeId >= 0)
+  {
+    precision = H5Tget_size(typeId);
+    if (H5Tget_class(typeId) == H5T_INTEGER)
+    {
+      bool isSigned = (H5Tget_sign(typeId) != H5T_SGN_NONE);
+      if (precision == 1)
+      {
+        numberType = isSigned ? "Char" : "UChar";
+      }
+      else
+      {
+        numberType = isSigned ? "Int" : "UInt";
+      }
+    }
+    H5Tclose(typeId);
+  }
+  std::stringstream ss;
+  ss << "<DataItem Dimensions=\"" << dimensions << "\" NumberType=\"" << numberType
+     << "\" Precision=\"" << precision << "\" Format=\"HDF\">" << H5Xdmf::escape(reference) << "</DataItem>";
+  return ss.str();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::string H5Xdmf::escape(const std::string &value)
+{
+  std::string escaped;
+  for (std::string::size_type i = 0; i < value.size(); ++i)
+  {
+    switch(value[i])
+    {
+      case '&': escaped += "&amp;"; break;
+      case '<': escaped += "&lt;"; break;
+      case '>': escaped += "&gt;"; break;
+      case '"': escaped += "&quot;"; break;
+      case '\'': escaped += "&apos;"; break;
+      default: escaped += value[i]; break;
+    }
+  }
+  return escaped;
+}
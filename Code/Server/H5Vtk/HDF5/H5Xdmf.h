@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+#ifndef _H5XDMF_H_
+#define _H5XDMF_H_
+
+//-- STL Headers
+#include <iostream>
+#include <string>
+#include <vector>
+
+//-- HDF Headers
+#include <hdf5.h>
+
+#include "vtkType.h"
+
+#define H5Support_EXPORT
+
+namespace H5Vtk {
+
+/**
+ * @brief Writes XDMF (version 2) descriptors for the objects of an h5p/h5u file.
+ * The descriptor only references the POINTS, CELLS and attribute datasets that
+ * are already in the file so XDMF aware tools read the same bytes without a
+ * conversion pass.
+ *
+ * XDMF can only express a single cell type per grid and has no notion of the
+ * per cell point count VTK stores in front of every cell. When all cells of a
+ * grid have the same number of points the CELLS dataset is described as a
+ * (cells x (points + 1)) table and a HyperSlab selects the point columns.
+ * Grids with mixed cell types, cells of different sizes or triangle strips
+ * are reported and left out of the descriptor.
+ * @author Mike Jackson for BlueQuartz Software
+ * @date Nov 2010
+ * @version $Revision: 1.1 $
+ */
+class H5Xdmf
+{
+  public:
+    virtual ~H5Xdmf();
+
+    /**
+     * @brief Writes an XDMF descriptor for vtk objects stored in an HDF5 file
+     * @param h5File The path to the h5p/h5u file
+     * @param xmfFile The path of the XDMF file to write
+     * @param hdfPaths The objects to describe. Empty means every object in the file
+     * @return Standard HDF5 error condition. Negative if no object could be described
+     */
+    static H5Support_EXPORT herr_t writeDescriptor(const std::string &h5File,
+                                                   const std::string &xmfFile,
+                                                   const std::vector<std::string> &hdfPaths);
+
+    /**
+     * @brief Returns the default descriptor name for an HDF5 file, which is the
+     * file name with its extension replaced by ".xmf"
+     * @param h5File The path to the h5p/h5u file
+     */
+    static H5Support_EXPORT std::string descriptorFileName(const std::string &h5File);
+
+    /**
+     * @brief Returns the paths of the vtk objects in a file, either from the
+     * VTK_OBJECT_INDEX or, without an index, from the groups with a VTK_DATA_OBJECT attribute.
+     * @param fileId The HDF5 file id
+     */
+    static H5Support_EXPORT std::vector<std::string> findObjects(hid_t fileId);
+
+    /**
+     * @brief Returns the XDMF topology type for a vtk cell type with the given
+     * number of points or an empty string if XDMF has no equivalent.
+     * @param vtkCellType One of the VTK_CELLTYPE_* values
+     * @param numPoints The number of points of each cell
+     * @param needsNodesPerElement Set to true if the XDMF type needs the
+     * NodesPerElement attribute
+     */
+    static H5Support_EXPORT std::string topologyType(int vtkCellType, int numPoints, bool &needsNodesPerElement);
+
+  protected:
+    H5Xdmf() {}; //This is just a bunch of Static methods
+
+    static herr_t writeGrid(std::ostream &out, hid_t fileId, const std::string &h5Name,
+                            const std::string &hdfPath);
+
+    static herr_t writeTopology(std::ostream &out, hid_t rootId, const std::string &h5Name,
+                                const std::string &hdfPath, const std::string &objectType,
+                                vtkTypeUInt64 &numCells);
+
+    static void writeAttributes(std::ostream &out, hid_t rootId, const std::string &h5Name,
+                                const std::string &hdfPath, const char* groupName,
+                                const char* center, vtkTypeUInt64 numTuples);
+
+    static std::string dataItem(hid_t parentId, const std::string &dsetName,
+                                const std::string &reference, const std::string &dimensions);
+
+    static std::string escape(const std::string &value);
+
+  private:
+    H5Xdmf(const H5Xdmf&);   //Copy Constructor Not Implemented
+    void operator=(const H5Xdmf&); //Copy Assignment Not Implemented
+};
+
+}
+
+#endif /* _H5XDMF_H_ */
@@ -9,13 +9,19 @@
 #ifndef VTKH5CONSTANTS_H_
 #define VTKH5CONSTANTS_H_
 
+#include "vtkConfigure.h"
+
 
 #define H5_VTK_OBJECT_INDEX_PATH "/VTK_OBJECT_INDEX"
 #define H5_VTK_DATA_OBJECT  "VTK_DATA_OBJECT"
 #define H5_VTK_POLYDATA     "VTK_POLYDATA"
 #define H5_VTK_UNSTRUCTURED_GRID "VTK_UNSTRUCTURED_GRID"
+#define H5_VTK_IMAGE_DATA   "VTK_IMAGE_DATA"
+#define H5_VTK_STRUCTURED_GRID "VTK_STRUCTURED_GRID"
+#define H5_VTK_RECTILINEAR_GRID "VTK_RECTILINEAR_GRID"
 #define H5_NAME             "NAME"
 #define H5_VTK_DATASET_ATTRIBUTE "VTK_DATASET_ATTRIBUTE"
+#define H5_SOURCE_FILE      "SOURCE_FILE"
 
 #define H5_FIELD_DATA_GROUP_NAME "FIELD_DATA"
 #define H5_FIELD_DATA_DEFAULT    "FieldData"
@@ -31,8 +37,148 @@
 #define H5_CELLS                  "CELLS"
 #define H5_CELL_TYPES             "CELL_TYPES"
 
+// Attribute of POINTS set on poly data whose only vertices are one vertex per
+// point in point order. Such a point cloud is written without VERTICES
+#define H5_IMPLICIT_VERTICES      "ImplicitVertices"
+// Offset of every cell into the decoded CELLS stream of an unstructured grid,
+// as kept by vtkUnstructuredGrid
+#define H5_CELL_LOCATIONS         "CELL_LOCATIONS"
+
+// Unstructured grids whose cells all have the same type and number of points
+// keep that type as the CellType attribute of CELLS and write no CELL_TYPES.
+// Unless encoded, CELLS then holds only the point ids of every cell and its
+// size divided by "Number Of Cells" gives the number of points per cell
+#define H5_CELL_TYPE              "CellType"
+
+// Polyhedron faces of an unstructured grid. FACES is the vtk face stream
+// (nFaces, nPts, ids..., nPts, ids...) of every polyhedron, FACE_LOCATIONS
+// the offset of each cell into FACES or -1 for cells that are no polyhedron
+#define H5_FACES                  "FACES"
+#define H5_FACE_LOCATIONS         "FACE_LOCATIONS"
+
+// Spatial index of an unstructured grid whose cells were binned into chunks.
+// BOUNDS holds (xmin, xmax, ymin, ymax, zmin, zmax) of every chunk and RANGES
+// (cellStart, cellCount, connStart, connCount, pointStart, pointCount) into
+// CELL_TYPES, CELLS and POINTS. connStart and connCount count the values
+// actually stored in CELLS, so they skip the cell sizes of a grid with a
+// single cell type. pointStart and pointCount are the points chunk c uses
+// first, the points it shares with earlier chunks are
+// SHARED_POINTS[SHARED_POINT_OFFSETS[c]] up to
+// SHARED_POINTS[SHARED_POINT_OFFSETS[c + 1]]. Files without SHARED_POINTS
+// store the range of all points a chunk uses instead. The (min, max) of
+// every chunk of the single component arrays are stored under CELL_DATA and
+// POINT_DATA of the index. The chunks sharing a point with chunk c are
+// NEIGHBORS[NEIGHBOR_OFFSETS[c]] up to NEIGHBORS[NEIGHBOR_OFFSETS[c + 1]]
+#define H5_SPATIAL_INDEX          "SPATIAL_INDEX"
+#define H5_SPATIAL_INDEX_BOUNDS   "BOUNDS"
+#define H5_SPATIAL_INDEX_RANGES   "RANGES"
+#define H5_SPATIAL_INDEX_COLUMNS  6
+#define H5_SPATIAL_INDEX_NEIGHBORS        "NEIGHBORS"
+#define H5_SPATIAL_INDEX_NEIGHBOR_OFFSETS "NEIGHBOR_OFFSETS"
+#define H5_SPATIAL_INDEX_SHARED_POINTS        "SHARED_POINTS"
+#define H5_SPATIAL_INDEX_SHARED_POINT_OFFSETS "SHARED_POINT_OFFSETS"
+
+// Levels of detail of a poly data, stored as the groups LOD/1 ... LOD/n of
+// the object. The object keeps the number of levels and every level, the
+// full resolution object included, its number of cells
+#define H5_LOD_GROUP              "LOD"
+#define H5_LOD_NUMBER_OF_LEVELS   "NumberOfLevels"
+#define H5_LOD_NUMBER_OF_CELLS    "NumberOfCells"
+
+// Connectivity written by H5ConnectivityCodec: the encoded bytes with the
+// name of the codec, the length of the decoded cell stream and the number of
+// points of every cell (0 when the cells have different sizes)
+#define H5_CODEC                  "Codec"
+#define H5_CODEC_DELTA_BITPACK    "DeltaZigzagBitPack"
+#define H5_CODEC_NUMBER_OF_IDS    "NumberOfIds"
+#define H5_CODEC_CELL_SIZE        "CellSize"
+
+// Tensors and normals written by H5ArrayEncoding carry the name of their
+// encoding. Normals also keep the vtk type they are decoded to
+#define H5_ENCODING                 "Encoding"
+#define H5_ENCODING_SYMMETRIC_TENSOR "SymmetricTensor"
+#define H5_ENCODING_OCTAHEDRAL      "Octahedral16"
+#define H5_ENCODED_DATA_TYPE        "EncodedDataType"
+
+// Arrays written with a lossy mode of vtkH5DataWriter name the mode and the
+// largest absolute error of any of their values. RelativeErrorBound is the
+// bound that was asked for when it was relative to the largest magnitude
+#define H5_LOSSY_COMPRESSION        "LossyCompression"
+#define H5_LOSSY_SCALE_OFFSET       "ScaleOffset"
+#define H5_LOSSY_BIT_ROUND          "BitRound"
+#define H5_LOSSY_ZFP                "ZFP"
+#define H5_ERROR_BOUND              "ErrorBound"
+#define H5_RELATIVE_ERROR_BOUND     "RelativeErrorBound"
+
+// Datasets whose storage vtkH5DataWriter chose with H5StorageTuner record the
+// codec, level and chunk size (0 for contiguous), the byte entropy and the
+// ratio and throughput the trials measured, and the targets they were held to
+#define H5_STORAGE_CODEC            "StorageCodec"
+#define H5_STORAGE_LEVEL            "StorageLevel"
+#define H5_STORAGE_CHUNK_VALUES     "StorageChunkValues"
+#define H5_STORAGE_ENTROPY          "StorageEntropy"
+#define H5_STORAGE_RATIO            "StorageTrialRatio"
+#define H5_STORAGE_THROUGHPUT       "StorageTrialThroughput"
+#define H5_STORAGE_TARGET_RATIO     "StorageTargetRatio"
+#define H5_STORAGE_TARGET_THROUGHPUT "StorageTargetThroughput"
+
 #define H5_NUMCOMPONENTS          "NumComponents"
 
+// Arrays holding the input ids of points and cells a writer reordered
+#define H5_ORIGINAL_POINT_IDS     "vtkOriginalPointIds"
+#define H5_ORIGINAL_CELL_IDS      "vtkOriginalCellIds"
+
+// Ghost level of the cells and points a reader adds around its piece
+#define H5_GHOST_LEVELS           "vtkGhostLevels"
+
+// vtkStringArray, stored as a group with the packed characters of all strings
+// and numValues + 1 offsets into them
+#define H5_STRING_CHARACTERS      "CHARACTERS"
+#define H5_STRING_OFFSETS         "OFFSETS"
+
+// vtkImageData geometry, stored as attributes of the data object group
+#define H5_ORIGIN                 "Origin"
+#define H5_SPACING                "Spacing"
+#define H5_WHOLE_EXTENT           "WholeExtent"
+
+// vtkRectilinearGrid axes
+#define H5_X_COORDINATES          "X_COORDINATES"
+#define H5_Y_COORDINATES          "Y_COORDINATES"
+#define H5_Z_COORDINATES          "Z_COORDINATES"
+
+// VTKHDF layout, see the VTK file formats documentation
+#define H5_VTKHDF_GROUP                      "/VTKHDF"
+#define H5_VTKHDF_VERSION                    "Version"
+#define H5_VTKHDF_TYPE                       "Type"
+#define H5_VTKHDF_UNSTRUCTURED_GRID          "UnstructuredGrid"
+#define H5_VTKHDF_POLYDATA                   "PolyData"
+#define H5_VTKHDF_NUMBER_OF_POINTS           "NumberOfPoints"
+#define H5_VTKHDF_NUMBER_OF_CELLS            "NumberOfCells"
+#define H5_VTKHDF_NUMBER_OF_CONNECTIVITY_IDS "NumberOfConnectivityIds"
+#define H5_VTKHDF_POINTS                     "Points"
+#define H5_VTKHDF_CONNECTIVITY               "Connectivity"
+#define H5_VTKHDF_OFFSETS                    "Offsets"
+#define H5_VTKHDF_TYPES                      "Types"
+#define H5_VTKHDF_POINT_DATA                 "PointData"
+#define H5_VTKHDF_CELL_DATA                  "CellData"
+#define H5_VTKHDF_FIELD_DATA                 "FieldData"
+#define H5_VTKHDF_VERTICES                   "Vertices"
+#define H5_VTKHDF_LINES                      "Lines"
+#define H5_VTKHDF_POLYGONS                   "Polygons"
+#define H5_VTKHDF_STRIPS                     "Strips"
+
+// Time steps of the VTKHDF layout. Every row of the Steps datasets is one
+// step: its time value, first partition and number of partitions and the
+// number of points, cells and connectivity ids stored before it
+#define H5_VTKHDF_STEPS                      "Steps"
+#define H5_VTKHDF_NSTEPS                     "NSteps"
+#define H5_VTKHDF_VALUES                     "Values"
+#define H5_VTKHDF_PART_OFFSETS               "PartOffsets"
+#define H5_VTKHDF_NUMBER_OF_PARTS            "NumberOfParts"
+#define H5_VTKHDF_POINT_OFFSETS              "PointOffsets"
+#define H5_VTKHDF_CELL_OFFSETS               "CellOffsets"
+#define H5_VTKHDF_CONNECTIVITY_ID_OFFSETS    "ConnectivityIdOffsets"
+
 #define H5_DEFAULT       "default"
 
 #define H5_ACTIVE_SCALARS      "ActiveScalars"
@@ -113,6 +259,11 @@
 // Polyhedron cell (consisting of polygonal faces)
 #define VTK_CELLTYPE_POLYHEDRON  42
 
+// vtkUnstructuredGrid keeps the faces of polyhedra since VTK 5.8
+#if VTK_MAJOR_VERSION > 5 || (VTK_MAJOR_VERSION == 5 && VTK_MINOR_VERSION >= 8)
+#define H5VTK_HAVE_POLYHEDRON_FACES 1
+#endif
+
 // Higher order cells in parametric form
 #define VTK_CELLTYPE_PARAMETRIC_CURVE         51
 #define VTK_CELLTYPE_PARAMETRIC_SURFACE       52
@@ -11,21 +11,31 @@
 
 #include <vector>
 #include <list>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
 
 #include "HDF5/H5Lite.h"
 #include "HDF5/H5Utilities.h"
+#include "HDF5/H5IOStatistics.h"
+#include "HDF5/H5ConnectivityCodec.h"
+#include "HDF5/H5ArrayEncoding.h"
+#include "HDF5/H5Compression.h"
 
 
 #include "vtkAbstractArray.h"
 #include "vtkBitArray.h"
 #include "vtkByteSwap.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCharArray.h"
+#include "vtkDataObject.h"
 #include "vtkDoubleArray.h"
 #include "vtkErrorCode.h"
 #include "vtkFieldData.h"
 #include "vtkFloatArray.h"
 #include "vtkGraph.h"
+#include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -34,6 +44,7 @@
 #include "vtkLookupTable.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
 #include "vtkPointSet.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkShortArray.h"
@@ -61,6 +72,7 @@ array = VTK_TYPE##Array::New();\
 array->SetNumberOfComponents(numComp);\
 dType* dest = static_cast<dType*>( ((VTK_TYPE##Array*)array)->WritePointer(0,numTuples));\
 if (NULL != dest) {\
+  H5Vtk::H5IOStatistics::allocated(static_cast<vtkTypeUInt64>(numTuples) * sizeof(dType));\
   err = H5Vtk::H5Lite::readPointerDataset(parentId, dsetName, dest);\
 }\
 
@@ -88,7 +100,15 @@ vtkH5DataReader::vtkH5DataReader()
   InputString = NULL;
   Header = NULL;
   InputArray = NULL;
-
+  this->MemoryBudget = 0;
+  this->ChunkCacheLimit = 64;
+  this->DowncastDoubles = 0;
+  this->SkipLinks = 0;
+  this->OverMemoryBudget = 0;
+  this->SWMRMode = 0;
+  this->FilterPluginPath = NULL;
+  this->SWMRFileId = -1;
+  this->TimeStep = -1;
 }
 
 
@@ -98,6 +118,8 @@ vtkH5DataReader::vtkH5DataReader()
 vtkH5DataReader::~vtkH5DataReader()
 {
   //std::cout << "vtkH5DataReader Destructor" << std::endl;
+  H5Vtk::H5Utilities::closeFile(this->SWMRFileId);
+  this->SetFilterPluginPath(NULL);
 }
 
 // -----------------------------------------------------------------------------
@@ -106,6 +128,58 @@ vtkH5DataReader::~vtkH5DataReader()
 void vtkH5DataReader::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "MemoryBudget: " << this->MemoryBudget << " MB" << std::endl;
+  os << indent << "ChunkCacheLimit: " << this->ChunkCacheLimit << " MB" << std::endl;
+  os << indent << "SWMRMode: " << this->SWMRMode << std::endl;
+  os << indent << "FilterPluginPath: " << (this->FilterPluginPath ? this->FilterPluginPath : "(none)") << std::endl;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5DataReader::Refresh()
+{
+  this->Modified();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5DataReader::SetFilterPluginPath(const char* path)
+{
+  if (this->FilterPluginPath == path
+      || (this->FilterPluginPath && path && strcmp(this->FilterPluginPath, path) == 0))
+  {
+    return;
+  }
+  delete [] this->FilterPluginPath;
+  this->FilterPluginPath = NULL;
+  if (path)
+  {
+    this->FilterPluginPath = strcpy(new char[strlen(path) + 1], path);
+    if (H5Vtk::H5Compression::appendPluginPath(path) < 0)
+    {
+      vtkWarningMacro(<< "Could not add " << path << " to the HDF5 plugin search path");
+    }
+  }
+  this->Modified();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataReader::CheckFilters(hid_t parentId, const std::string &dsetName)
+{
+  std::string missing;
+  if (H5Vtk::H5Compression::findMissingFilter(parentId, dsetName, missing))
+  {
+    vtkErrorMacro(<< "Can not read " << dsetName << " from " << (this->FileName ? this->FileName : "")
+                  << ": it is compressed with the HDF5 filter " << missing
+                  << ", which is not available. Add the directory of its plugin to HDF5_PLUGIN_PATH"
+                  << " or FilterPluginPath.");
+    return 0;
+  }
+  return 1;
 }
 
 // -----------------------------------------------------------------------------
@@ -179,9 +253,15 @@ vtkAbstractArray* vtkH5DataReader::ReadArray(hid_t parentId, const std::string&
   hid_t typeId = -1;
   H5T_class_t attr_type;
   size_t attr_size;
-  std::string res;
   hid_t did = -1;
 
+  // String arrays are stored as a group of packed characters and offsets
+  if (H5Lexists(parentId, dsetName.c_str(), H5P_DEFAULT) > 0
+      && H5Vtk::H5Utilities::isGroup(parentId, dsetName))
+  {
+    return this->ReadStringArray(parentId, dsetName);
+  }
+
   did = H5Dopen( parentId, dsetName.c_str() , H5P_DEFAULT);
   if ( did  < 0 ) {
    return array;
@@ -190,6 +270,10 @@ vtkAbstractArray* vtkH5DataReader::ReadArray(hid_t parentId, const std::string&
   {
     H5Dclose(did);
   }
+  if (this->CheckFilters(parentId, dsetName) == 0)
+  {
+    return array;
+  }
 
   vtkTypeInt32 numComp = 1;
   err = H5Vtk::H5Lite::readScalarAttribute(parentId, dsetName, H5_NUMCOMPONENTS, numComp);
@@ -219,17 +303,13 @@ vtkAbstractArray* vtkH5DataReader::ReadArray(hid_t parentId, const std::string&
   {
     return array;
   }
-  vtkTypeUInt8* dest = NULL;
   switch(attr_type)
   {
   case H5T_STRING:
-    res.clear(); //Clear the string out first
-    array = vtkStringArray::New();
-    array->SetNumberOfComponents(numComp);
-    array->Allocate(numElements, 100);
-    dest = static_cast<vtkTypeUInt8*>(array->GetVoidPointer(0) );
-    if (NULL != dest) {
-      err = H5Vtk::H5Lite::readPointerDataset(parentId, dsetName, dest);
+    array = this->ReadStringDataset(parentId, dsetName, numComp, numElements);
+    if (NULL == array) {
+      err = -1;
+      retErr = -1;
     }
     break;
   case H5T_INTEGER:
@@ -258,6 +338,9 @@ vtkAbstractArray* vtkH5DataReader::ReadArray(hid_t parentId, const std::string&
   case H5T_FLOAT:
     if (attr_size == 4) {
       ALLOCATE_AND_READ_ARRAY(array, vtkFloat, numComp, numElements, parentId, dsetName, float );
+    } else if (attr_size == 8 && this->DowncastDoubles) {
+      // HDF5 converts the values while reading so no double copy is ever made
+      ALLOCATE_AND_READ_ARRAY(array, vtkFloat, numComp, numElements, parentId, dsetName, float );
     } else if (attr_size == 8 ) {
       ALLOCATE_AND_READ_ARRAY(array, vtkDouble, numComp, numElements, parentId, dsetName, double );
     } else {
@@ -272,85 +355,285 @@ vtkAbstractArray* vtkH5DataReader::ReadArray(hid_t parentId, const std::string&
   }
   CloseH5T(typeId, err, retErr); //Close the H5A type Id that was retrieved during the loop
 
+  vtkDataArray* data = vtkDataArray::SafeDownCast(array);
+  if (NULL != data)
+  {
+    array = this->DecodeArray(parentId, dsetName, data);
+  }
   return array;
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-int vtkH5DataReader::ReadDataSetArrays(vtkDataSet *ds, vtkDataSetAttributes *a, int num,
-                                      hid_t parentId, hid_t gid, const char* groupName )
+vtkDataArray* vtkH5DataReader::DecodeArray(hid_t parentId, const std::string &dsetName, vtkDataArray* stored)
 {
-  hsize_t nObjs = 0;
-  herr_t err = H5Gget_num_objs(gid, &nObjs);
-  char name[1024];
-
-
-  // Loop on all the arrays for this data set
-  for (hsize_t i = 0; i < nObjs; ++i)
+  std::string encoding;
+  if (H5Aexists_by_name(parentId, dsetName.c_str(), H5_ENCODING, H5P_DEFAULT) <= 0)
   {
-    ::memset(name, 0, 1024);
-    err = H5Gget_objname_by_idx(gid, i, name, 1024);
-    //TODO: Error trap here.
-
-    err = ReadDataHelper(a, num, gid, name);
-    if (err == 0)
+    return stored;
+  }
+  H5Vtk::H5Lite::readStringAttribute(parentId, dsetName, H5_ENCODING, encoding);
+  vtkIdType numTuples = stored->GetNumberOfTuples();
+  int storedType = stored->GetDataType();
+  vtkDataArray* decoded = NULL;
+  if (encoding == H5_ENCODING_SYMMETRIC_TENSOR && stored->GetNumberOfComponents() == 6
+      && (storedType == VTK_FLOAT || storedType == VTK_DOUBLE))
+  {
+    decoded = vtkDataArray::CreateDataArray(storedType);
+    decoded->SetNumberOfComponents(9);
+    decoded->SetNumberOfTuples(numTuples);
+    if (numTuples > 0 && storedType == VTK_FLOAT)
     {
-      vtkErrorMacro(<< "Could not successfully read data set attribute array with name '" << name << "'");
-      return 0;
+      H5Vtk::H5ArrayEncoding::unpackSymmetric(static_cast<float*>(stored->GetVoidPointer(0)), numTuples,
+                                              static_cast<float*>(decoded->GetVoidPointer(0)));
+    }
+    else if (numTuples > 0)
+    {
+      H5Vtk::H5ArrayEncoding::unpackSymmetric(static_cast<double*>(stored->GetVoidPointer(0)), numTuples,
+                                              static_cast<double*>(decoded->GetVoidPointer(0)));
+    }
+  }
+  else if (encoding == H5_ENCODING_OCTAHEDRAL && stored->GetNumberOfComponents() == 2
+           && storedType == VTK_UNSIGNED_SHORT)
+  {
+    vtkTypeInt32 dataType = VTK_FLOAT;
+    H5Vtk::H5Lite::readScalarAttribute(parentId, dsetName, H5_ENCODED_DATA_TYPE, dataType);
+    dataType = (dataType == VTK_DOUBLE && !this->DowncastDoubles) ? VTK_DOUBLE : VTK_FLOAT;
+    decoded = vtkDataArray::CreateDataArray(dataType);
+    decoded->SetNumberOfComponents(3);
+    decoded->SetNumberOfTuples(numTuples);
+    const uint16_t* encoded = (numTuples > 0) ? static_cast<uint16_t*>(stored->GetVoidPointer(0)) : NULL;
+    if (numTuples > 0 && dataType == VTK_FLOAT)
+    {
+      H5Vtk::H5ArrayEncoding::decodeOctahedral(encoded, numTuples, static_cast<float*>(decoded->GetVoidPointer(0)));
+    }
+    else if (numTuples > 0)
+    {
+      H5Vtk::H5ArrayEncoding::decodeOctahedral(encoded, numTuples, static_cast<double*>(decoded->GetVoidPointer(0)));
     }
   }
+  else
+  {
+    vtkErrorMacro(<< "Unknown encoding '" << encoding << "' of " << dsetName);
+    stored->Delete();
+    return NULL;
+  }
+  H5Vtk::H5IOStatistics::allocated(static_cast<vtkTypeUInt64>(numTuples) * decoded->GetNumberOfComponents()
+                                   * decoded->GetDataTypeSize());
+  decoded->SetName(stored->GetName());
+  stored->Delete();
+  return decoded;
+}
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkStringArray* vtkH5DataReader::ReadStringArray(hid_t parentId, const std::string &name)
+{
+  hid_t gid = H5Gopen(parentId, name.c_str(), H5P_DEFAULT);
+  if (gid < 0)
+  {
+    return NULL;
+  }
+  vtkTypeInt32 numComp = 1;
+  if (H5Vtk::H5Lite::readScalarAttribute(parentId, name, H5_NUMCOMPONENTS, numComp) < 0 || numComp < 1)
+  {
+    numComp = 1;
+  }
 
-  std::string data;
-  err =  H5Vtk::H5Lite::readStringAttribute(parentId, groupName, H5_ACTIVE_SCALARS, data);
-  if (data.size() > 0)
+  std::vector<hsize_t> dims;
+  H5T_class_t classType;
+  size_t typeSize;
+  herr_t err = H5Vtk::H5Lite::getDatasetInfo(gid, H5_STRING_OFFSETS, dims, classType, typeSize);
+  if (err < 0 || dims.size() != 1 || dims[0] < 1)
   {
-    a->SetActiveScalars(data.c_str());
+    vtkErrorMacro(<< "The string array " << name << " has no valid " << H5_STRING_OFFSETS);
+    H5Gclose(gid);
+    return NULL;
   }
-  data.clear();
+  vtkIdType numValues = static_cast<vtkIdType>(dims[0]) - 1;
+  std::vector<int64_t> offsets(dims[0]);
+  err = H5Vtk::H5Lite::readPointerDataset(gid, H5_STRING_OFFSETS, &(offsets.front()));
 
-  err =  H5Vtk::H5Lite::readStringAttribute(parentId, groupName, H5_ACTIVE_VECTORS, data);
-  if (data.size() > 0)
+  // The offsets come from the file, so they are checked against CHARACTERS
+  // before they size any allocation
+  for (size_t i = 0; err >= 0 && i < offsets.size(); ++i)
   {
-    a->SetActiveVectors(data.c_str());
+    if (offsets[i] < 0 || (i > 0 && offsets[i] < offsets[i - 1]))
+    {
+      vtkErrorMacro(<< "The string array " << name << " has invalid offsets");
+      err = -1;
+    }
   }
-  data.clear();
+  if (err >= 0 && offsets.back() > 0)
+  {
+    err = H5Vtk::H5Lite::getDatasetInfo(gid, H5_STRING_CHARACTERS, dims, classType, typeSize);
+    if (err >= 0 && (dims.size() != 1 || static_cast<int64_t>(dims[0]) != offsets.back()))
+    {
+      vtkErrorMacro(<< "The offsets of the string array " << name << " do not match its " << H5_STRING_CHARACTERS);
+      err = -1;
+    }
+  }
+  std::vector<char> characters;
+  if (err >= 0)
+  {
+    characters.resize(static_cast<size_t>(offsets.back()) + 1, 0);
+  }
+  if (err >= 0 && offsets.back() > 0)
+  {
+    err = H5Vtk::H5Lite::readPointerDataset(gid, H5_STRING_CHARACTERS, &(characters.front()));
+  }
+  H5Gclose(gid);
+  if (err < 0)
+  {
+    vtkErrorMacro(<< "Error reading the string array " << name);
+    return NULL;
+  }
+  H5Vtk::H5IOStatistics::allocated(characters.size() + offsets.size() * sizeof(int64_t));
 
-  err =  H5Vtk::H5Lite::readStringAttribute(parentId, groupName, H5_ACTIVE_NORMALS, data);
-  if (data.size() > 0)
+  vtkStringArray* array = vtkStringArray::New();
+  array->SetNumberOfComponents(numComp);
+  array->SetNumberOfValues(numValues);
+  const char* chars = &(characters.front());
+  for (vtkIdType i = 0; i < numValues; ++i)
   {
-    a->SetActiveNormals(data.c_str());
+    int64_t start = offsets[i];
+    int64_t end = offsets[i + 1];
+    array->SetValue(i, vtkStdString(chars + start, static_cast<size_t>(end - start)));
   }
-  data.clear();
+  return array;
+}
 
-  err =  H5Vtk::H5Lite::readStringAttribute(parentId, groupName, H5_ACTIVE_TEXTURE_COORDINATES, data);
-  if (data.size() > 0)
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkStringArray* vtkH5DataReader::ReadStringDataset(hid_t parentId, const std::string &dsetName,
+                                                   int numComp, vtkIdType numValues)
+{
+  hid_t did = H5Dopen(parentId, dsetName.c_str(), H5P_DEFAULT);
+  if (did < 0)
   {
-    a->SetActiveTCoords(data.c_str());
+    return NULL;
   }
-  data.clear();
+  hid_t typeId = H5Dget_type(did);
+  vtkStringArray* array = vtkStringArray::New();
+  array->SetNumberOfComponents(numComp);
+  array->SetNumberOfValues(numValues);
+  herr_t err = 0;
+  if (numValues > 0 && H5Tis_variable_str(typeId) > 0)
+  {
+    // Variable length strings come back as one allocation per string
+    std::vector<char*> values(numValues, static_cast<char*>(NULL));
+    hid_t memType = H5Tcopy(H5T_C_S1);
+    H5Tset_size(memType, H5T_VARIABLE);
+    err = H5Dread(did, memType, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(values.front()));
+    if (err >= 0)
+    {
+      for (vtkIdType i = 0; i < numValues; ++i)
+      {
+        array->SetValue(i, (NULL != values[i]) ? values[i] : "");
+      }
+      hid_t spaceId = H5Dget_space(did);
+      H5Dvlen_reclaim(memType, spaceId, H5P_DEFAULT, &(values.front()));
+      H5Sclose(spaceId);
+    }
+    H5Tclose(memType);
+  }
+  else if (numValues > 0)
+  {
+    // Fixed length strings are read in one buffer, padding is dropped
+    size_t size = H5Tget_size(typeId);
+    bool spacePadded = (H5Tget_strpad(typeId) == H5T_STR_SPACEPAD);
+    std::vector<char> buffer(static_cast<size_t>(numValues) * size + 1, 0);
+    err = H5Dread(did, typeId, H5S_ALL, H5S_ALL, H5P_DEFAULT, &(buffer.front()));
+    for (vtkIdType i = 0; err >= 0 && i < numValues; ++i)
+    {
+      const char* value = &(buffer[static_cast<size_t>(i) * size]);
+      size_t length = 0;
+      while (length < size && value[length] != '\0')
+      {
+        ++length;
+      }
+      while (spacePadded && length > 0 && value[length - 1] == ' ')
+      {
+        --length;
+      }
+      array->SetValue(i, vtkStdString(value, length));
+    }
+  }
+  H5Tclose(typeId);
+  H5Dclose(did);
+  if (err < 0)
+  {
+    array->Delete();
+    return NULL;
+  }
+  return array;
+}
 
-  err =  H5Vtk::H5Lite::readStringAttribute(parentId, groupName, H5_ACTIVE_TENSORS, data);
-  if (data.size() > 0)
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataReader::ReadEncodedCells(hid_t parentId, const std::string &dsetName, vtkCellArray* cells)
+{
+  vtkTypeInt32 ncells = 0;
+  herr_t err = H5Vtk::H5Lite::readScalarAttribute(parentId, dsetName, "Number Of Cells", ncells);
+  vtkTypeInt64 size = H5Vtk::H5ConnectivityCodec::getNumberOfIds(parentId, dsetName);
+  if (err < 0 || size < 0)
   {
-    a->SetActiveTensors(data.c_str());
+    vtkErrorMacro(<< "Could not read the size of the encoded cells " << dsetName);
+    return 0;
   }
-  data.clear();
 
-  err =  H5Vtk::H5Lite::readStringAttribute(parentId, groupName, H5_ACTIVE_GLOBAL_IDS, data);
-  if (data.size() > 0)
+  vtkIdTypeArray* data = vtkIdTypeArray::New();
+  vtkIdType* dataPtr = data->WritePointer(0, static_cast<vtkIdType>(size));
+  H5Vtk::H5IOStatistics::allocated(static_cast<vtkTypeUInt64>(size) * sizeof(vtkIdType));
+  err = H5Vtk::H5ConnectivityCodec::readCells(parentId, dsetName, ncells, dataPtr);
+  if (err < 0)
   {
-    a->SetActiveGlobalIds(data.c_str());
+    vtkErrorMacro(<< "Error decoding the cells " << dsetName);
+    data->Delete();
+    return 0;
   }
-  data.clear();
+  cells->SetCells(ncells, data);
+  data->Delete();
+  return 1;
+}
 
-  err =  H5Vtk::H5Lite::readStringAttribute(parentId, groupName, H5_ACTIVE_PEDIGREE_IDS, data);
-  if (data.size() > 0)
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataReader::ReadDataSetArrays(vtkDataSet *ds, vtkDataSetAttributes *a, int num,
+                                      hid_t parentId, hid_t gid, const char* groupName )
+{
+  hsize_t nObjs = 0;
+  herr_t err = H5Gget_num_objs(gid, &nObjs);
+  char name[1024];
+
+
+  // Loop on all the arrays for this data set
+  for (hsize_t i = 0; i < nObjs; ++i)
   {
-    a->SetActivePedigreeIds(data.c_str());
+    ::memset(name, 0, 1024);
+    err = H5Gget_objname_by_idx(gid, i, name, 1024);
+    //TODO: Error trap here.
+    if (this->SkippedArrays.find(std::string(groupName) + "/" + name) != this->SkippedArrays.end())
+    {
+      vtkDebugMacro(<< "Skipping array '" << name << "' to stay within the memory budget");
+      continue;
+    }
+
+    err = ReadDataHelper(a, num, gid, name);
+    if (err == 0)
+    {
+      vtkErrorMacro(<< "Could not successfully read data set attribute array with name '" << name << "'");
+      return 0;
+    }
   }
-  data.clear();
+
+
+  this->ReadActiveAttributeNames(parentId, groupName, a);
 
   return 1;
 }
@@ -470,10 +753,10 @@ int vtkH5DataReader::ReadDataHelper(vtkDataSetAttributes *a, int num,
   int err = 0;
  // int skipNormal=0;
   std::string dsName;
-  vtkDataArray *data = NULL;
+  vtkAbstractArray *data = NULL;
 
   // try reading the data set
-  data = vtkDataArray::SafeDownCast( this->ReadArray(gid, name));
+  data = this->ReadArray(gid, name);
   dsName = name;
 
   if (data != NULL)
@@ -481,10 +764,11 @@ int vtkH5DataReader::ReadDataHelper(vtkDataSetAttributes *a, int num,
     if (num != data->GetNumberOfTuples()) // Number of cells or points must match
     {
       data->Delete();
-      err = 0;
+      return 0;
     }
     data->SetName(dsName.c_str());
     a->AddArray(data);
+    data->Delete();
     err = 1;
   }
   else
@@ -514,3 +798,1173 @@ std::vector<std::string> vtkH5DataReader::ReadObjectIndex(hid_t file_id)
   return objects;
 }
 
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkTypeUInt64 vtkH5DataReader::GetDatasetElementCount(hid_t parentId, const std::string &dsetName,
+                                                      H5T_class_t &classType, size_t &typeSize)
+{
+  std::vector<hsize_t> dims;
+  typeSize = 0;
+  herr_t err = H5Vtk::H5Lite::getDatasetInfo(parentId, dsetName, dims, classType, typeSize);
+  if (err < 0 || dims.size() == 0)
+  {
+    return 0;
+  }
+  vtkTypeUInt64 numElements = 1;
+  for (std::vector<hsize_t>::size_type i = 0; i < dims.size(); ++i)
+  {
+    numElements = numElements * dims[i];
+  }
+  return numElements;
+}
+
+namespace
+{
+  // Size of one point array or cell array as it would be materialized
+  struct H5VtkArrayEstimate
+  {
+    std::string key;
+    vtkTypeUInt64 bytes;
+    vtkTypeUInt64 doubleBytes;
+  };
+
+  bool H5VtkLargerArray(const H5VtkArrayEstimate &a, const H5VtkArrayEstimate &b)
+  {
+    return a.bytes > b.bytes;
+  }
+
+  // Mirrors vtkCellLinks::Link
+  struct H5VtkLinkRecord
+  {
+    unsigned short ncells;
+    vtkIdType* cells;
+  };
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5DataReader::ResetMemoryBudget()
+{
+  this->DowncastDoubles = 0;
+  this->SkipLinks = 0;
+  this->OverMemoryBudget = 0;
+  this->SkippedArrays.clear();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataReader::ApplyMemoryBudget(hid_t fileId, const std::string &hdfpath)
+{
+  this->ResetMemoryBudget();
+  if (this->MemoryBudget <= 0 || fileId < 0)
+  {
+    return 1;
+  }
+
+  HDF_ERROR_HANDLER_OFF;
+  hid_t rootId = H5Gopen(fileId, hdfpath.c_str(), H5P_DEFAULT);
+  if (rootId < 0)
+  {
+    // RequestData reports the missing group
+    HDF_ERROR_HANDLER_ON;
+    return 1;
+  }
+
+  H5T_class_t classType;
+  size_t typeSize = 0;
+  vtkTypeUInt64 fixedBytes = 0;
+  vtkTypeUInt64 doubleBytes = 0;
+  vtkTypeUInt64 linkBytes = 0;
+
+  vtkTypeUInt64 n = this->GetDatasetElementCount(rootId, H5_POINTS, classType, typeSize);
+  vtkTypeUInt64 numPoints = n / 3;
+  fixedBytes += n * typeSize;
+  if (classType == H5T_FLOAT && typeSize == 8)
+  {
+    doubleBytes += n * typeSize;
+  }
+
+  // Connectivity is read in its file type and then widened into a vtkIdType
+  // array. Both copies are alive at the same time.
+  const char* cellDatasets[] = { H5_VERTICES, H5_LINES, H5_POLYGONS, H5_TRIANGLE_STRIPS, H5_CELLS };
+  vtkTypeUInt64 numConnectivity = 0;
+  vtkTypeUInt64 numCells = 0;
+  bool homogeneous = false;
+  for (size_t i = 0; i < sizeof(cellDatasets) / sizeof(cellDatasets[0]); ++i)
+  {
+    n = this->GetDatasetElementCount(rootId, cellDatasets[i], classType, typeSize);
+    if (n == 0) { continue; }
+    vtkTypeInt32 ncells = 0;
+    H5Vtk::H5Lite::readScalarAttribute(rootId, cellDatasets[i], "Number Of Cells", ncells);
+    numCells += ncells;
+    bool singleType = H5Aexists_by_name(rootId, cellDatasets[i], H5_CELL_TYPE, H5P_DEFAULT) > 0;
+    homogeneous = homogeneous || singleType;
+    if (H5Vtk::H5ConnectivityCodec::isEncoded(rootId, cellDatasets[i]))
+    {
+      // n encoded bytes are decoded into the vtkIdType array
+      vtkTypeInt64 numIds = H5Vtk::H5ConnectivityCodec::getNumberOfIds(rootId, cellDatasets[i]);
+      fixedBytes += n;
+      n = (numIds > 0) ? static_cast<vtkTypeUInt64>(numIds) : 0;
+      fixedBytes += n * sizeof(vtkIdType);
+    }
+    else if (singleType)
+    {
+      // The ids are read in place into the cell stream, sizes added after
+      n += ncells;
+      fixedBytes += n * sizeof(vtkIdType);
+    }
+    else
+    {
+      fixedBytes += n * (typeSize + sizeof(vtkIdType));
+    }
+    numConnectivity += (n > static_cast<vtkTypeUInt64>(ncells)) ? n - ncells : 0;
+  }
+  // The vertices of a point cloud are made as a (1, id) stream
+  if (H5Aexists_by_name(rootId, H5_POINTS, H5_IMPLICIT_VERTICES, H5P_DEFAULT) > 0)
+  {
+    fixedBytes += 2 * numPoints * sizeof(vtkIdType);
+    numCells += numPoints;
+    numConnectivity += numPoints;
+  }
+
+  // Cell types are read as int and then stored as unsigned char types plus
+  // vtkIdType locations. Poly data builds the equivalent map in BuildLinks().
+  // A single cell type is filled in without reading anything.
+  n = this->GetDatasetElementCount(rootId, H5_CELL_TYPES, classType, typeSize);
+  if (n > 0)
+  {
+    fixedBytes += n * (sizeof(vtkTypeInt32) + sizeof(unsigned char) + sizeof(vtkIdType));
+  }
+  else if (homogeneous)
+  {
+    fixedBytes += numCells * (sizeof(unsigned char) + sizeof(vtkIdType));
+  }
+  else
+  {
+    linkBytes += numCells * (sizeof(unsigned char) + sizeof(vtkIdType));
+  }
+  linkBytes += numPoints * sizeof(H5VtkLinkRecord) + numConnectivity * sizeof(vtkIdType);
+
+  // Polyhedron faces are read straight into vtkIdType arrays
+  const char* faceDatasets[] = { H5_FACES, H5_FACE_LOCATIONS };
+  for (size_t i = 0; i < sizeof(faceDatasets) / sizeof(faceDatasets[0]); ++i)
+  {
+    fixedBytes += this->GetDatasetElementCount(rootId, faceDatasets[i], classType, typeSize) * sizeof(vtkIdType);
+  }
+
+  // Field data is always read. Point and cell data arrays can be skipped.
+  const char* groups[] = { H5_FIELD_DATA_GROUP_NAME, H5_CELL_DATA_GROUP_NAME, H5_POINT_DATA_GROUP_NAME };
+  std::vector<H5VtkArrayEstimate> arrays;
+  for (size_t g = 0; g < sizeof(groups) / sizeof(groups[0]); ++g)
+  {
+    hid_t gid = H5Gopen(rootId, groups[g], H5P_DEFAULT);
+    if (gid < 0) { continue; }
+    std::list<std::string> names;
+    H5Vtk::H5Utilities::getGroupObjects(gid, H5Vtk::H5Utilities::H5Support_DATASET, names);
+    for (std::list<std::string>::iterator iter = names.begin(); iter != names.end(); ++iter)
+    {
+      n = this->GetDatasetElementCount(gid, *iter, classType, typeSize);
+      H5VtkArrayEstimate estimate;
+      estimate.key = std::string(groups[g]) + "/" + *iter;
+      estimate.bytes = n * typeSize;
+      // Encoded arrays are decoded into a larger copy
+      std::string encoding;
+      if (H5Aexists_by_name(gid, iter->c_str(), H5_ENCODING, H5P_DEFAULT) > 0
+          && H5Vtk::H5Lite::readStringAttribute(gid, *iter, H5_ENCODING, encoding) >= 0)
+      {
+        if (encoding == H5_ENCODING_SYMMETRIC_TENSOR)
+        {
+          estimate.bytes += n / 6 * 9 * typeSize;
+        }
+        else if (encoding == H5_ENCODING_OCTAHEDRAL)
+        {
+          vtkTypeInt32 dataType = VTK_FLOAT;
+          H5Vtk::H5Lite::readScalarAttribute(gid, *iter, H5_ENCODED_DATA_TYPE, dataType);
+          estimate.bytes += n / 2 * 3 * ((dataType == VTK_DOUBLE) ? sizeof(double) : sizeof(float));
+        }
+      }
+      estimate.doubleBytes = (classType == H5T_FLOAT && typeSize == 8) ? estimate.bytes : 0;
+      doubleBytes += estimate.doubleBytes;
+      if (g == 0)
+      {
+        fixedBytes += estimate.bytes;
+      }
+      else
+      {
+        arrays.push_back(estimate);
+      }
+    }
+    H5Gclose(gid);
+  }
+  H5Gclose(rootId);
+  HDF_ERROR_HANDLER_ON;
+
+  vtkTypeUInt64 total = fixedBytes + linkBytes;
+  for (std::vector<H5VtkArrayEstimate>::size_type i = 0; i < arrays.size(); ++i)
+  {
+    total += arrays[i].bytes;
+  }
+  const vtkTypeUInt64 mb = 1024 * 1024;
+  const vtkTypeUInt64 budget = static_cast<vtkTypeUInt64>(this->MemoryBudget) * mb;
+  vtkDebugMacro(<< "Estimated " << total / mb << " MB for " << hdfpath << ", budget is " << this->MemoryBudget << " MB");
+  if (total <= budget)
+  {
+    return 1;
+  }
+
+  vtksys_ios::ostringstream actions;
+  if (total > budget && linkBytes > 0)
+  {
+    this->SkipLinks = 1;
+    total -= linkBytes;
+    actions << " cell links are not built;";
+  }
+  if (total > budget && doubleBytes > 0)
+  {
+    this->DowncastDoubles = 1;
+    total -= doubleBytes / 2;
+    for (std::vector<H5VtkArrayEstimate>::size_type i = 0; i < arrays.size(); ++i)
+    {
+      arrays[i].bytes -= arrays[i].doubleBytes / 2;
+    }
+    actions << " double arrays are read as float;";
+  }
+  std::sort(arrays.begin(), arrays.end(), H5VtkLargerArray);
+  for (std::vector<H5VtkArrayEstimate>::size_type i = 0; i < arrays.size() && total > budget; ++i)
+  {
+    this->SkippedArrays.insert(arrays[i].key);
+    total -= arrays[i].bytes;
+    actions << " skipping " << arrays[i].key << ";";
+  }
+
+  if (total > budget)
+  {
+    this->OverMemoryBudget = 1;
+    vtkWarningMacro(<< hdfpath << " needs at least " << total / mb << " MB which is over the memory budget of "
+                    << this->MemoryBudget << " MB even without point and cell data. Nothing will be read.");
+    return 0;
+  }
+  vtkWarningMacro(<< hdfpath << " does not fit the memory budget of " << this->MemoryBudget << " MB:" << actions.str());
+  return 1;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataReader::IsVTKHDF(hid_t fileId, const char* type)
+{
+  if (fileId < 0 || H5Lexists(fileId, H5_VTKHDF_GROUP, H5P_DEFAULT) <= 0)
+  {
+    return 0;
+  }
+  std::string fileType;
+  herr_t err = H5Vtk::H5Lite::readStringAttribute(fileId, H5_VTKHDF_GROUP, H5_VTKHDF_TYPE, fileType);
+  if (err < 0)
+  {
+    return 0;
+  }
+  // The attribute may be stored null padded
+  fileType = fileType.c_str();
+  return (fileType.compare(type) == 0) ? 1 : 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataReader::SelectVTKHDFPartitions(hid_t vtkhdfId, int piece, int numPieces,
+                                            VTKHDFSelection &selection)
+{
+  std::vector<int64_t> numPoints;
+  herr_t err = H5Vtk::H5Lite::readVectorDataset(vtkhdfId, H5_VTKHDF_NUMBER_OF_POINTS, numPoints);
+  if (err < 0)
+  {
+    vtkErrorMacro(<< "Could not read " << H5_VTKHDF_NUMBER_OF_POINTS << " from " << H5_VTKHDF_GROUP);
+    return 0;
+  }
+  if (numPieces < 1)
+  {
+    numPieces = 1;
+  }
+  if (piece < 0 || piece >= numPieces)
+  {
+    piece = 0;
+  }
+  vtkTypeUInt64 total = numPoints.size();
+  vtkTypeUInt64 rangeStart = 0;
+  vtkTypeUInt64 rangeCount = total;
+  if (this->TimeStep >= 0 && static_cast<size_t>(this->TimeStep) < this->StepPartOffsets.size())
+  {
+    rangeStart = std::min(static_cast<vtkTypeUInt64>(this->StepPartOffsets[this->TimeStep]), total);
+    rangeCount = std::min(static_cast<vtkTypeUInt64>(this->StepNumberOfParts[this->TimeStep]), total - rangeStart);
+  }
+  vtkTypeUInt64 first = rangeStart + (rangeCount * piece) / numPieces;
+  vtkTypeUInt64 last = rangeStart + (rangeCount * (piece + 1)) / numPieces;
+
+  selection.FirstPartition = first;
+  selection.NumberOfPartitions = last - first;
+  selection.TotalPartitions = total;
+  selection.PartitionPoints.clear();
+  selection.PointStart = 0;
+  selection.PointCount = 0;
+  for (vtkTypeUInt64 p = 0; p < last; ++p)
+  {
+    if (p < first)
+    {
+      selection.PointStart += numPoints[p];
+    }
+    else
+    {
+      selection.PointCount += numPoints[p];
+      selection.PartitionPoints.push_back(static_cast<vtkIdType>(numPoints[p]));
+    }
+  }
+  vtkDebugMacro(<< "Piece " << piece << " of " << numPieces << " reads partitions " << first << " to " << last - 1 << " of " << total);
+  return 1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+hid_t vtkH5DataReader::OpenFile(bool readOnly)
+{
+  if (NULL == this->FileName)
+  {
+    return -1;
+  }
+  if (this->SWMRFileId >= 0 && (!this->SWMRMode || this->SWMRFileName.compare(this->FileName) != 0))
+  {
+    H5Vtk::H5Utilities::closeFile(this->SWMRFileId);
+    this->SWMRFileId = -1;
+  }
+  if (!this->SWMRMode)
+  {
+    return H5Vtk::H5Utilities::openFile(this->FileName, readOnly);
+  }
+
+  if (this->SWMRFileId < 0)
+  {
+    // Only the VTKHDF layout can be appended to, other files are read as usual
+    this->SWMRFileId = H5Vtk::H5Utilities::openSWMRReadFile(this->FileName);
+    if (this->SWMRFileId >= 0 && H5Lexists(this->SWMRFileId, H5_VTKHDF_GROUP, H5P_DEFAULT) <= 0)
+    {
+      H5Vtk::H5Utilities::closeFile(this->SWMRFileId);
+      this->SWMRFileId = -1;
+    }
+    if (this->SWMRFileId < 0)
+    {
+      return H5Vtk::H5Utilities::openFile(this->FileName, true);
+    }
+    this->SWMRFileName = this->FileName;
+  }
+  else if (H5Lexists(this->SWMRFileId, H5_VTKHDF_GROUP, H5P_DEFAULT) > 0)
+  {
+    // The steps are refreshed first: the writer flushes the data of a step
+    // before the step itself, so every step seen here has its data
+    hid_t gid = H5Gopen(this->SWMRFileId, H5_VTKHDF_GROUP, H5P_DEFAULT);
+    std::list<std::string> first(1, H5_VTKHDF_STEPS);
+    if (gid < 0 || H5Vtk::H5Utilities::refreshDatasets(gid, first) < 0)
+    {
+      vtkWarningMacro(<< "Could not refresh the datasets of " << this->FileName);
+    }
+    if (gid >= 0)
+    {
+      H5Gclose(gid);
+    }
+  }
+  return this->SWMRFileId;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t vtkH5DataReader::CloseFile(hid_t &fileId)
+{
+  if (fileId >= 0 && fileId == this->SWMRFileId)
+  {
+    fileId = -1;
+    return 0;
+  }
+  return H5Vtk::H5Utilities::closeFile(fileId);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataReader::ReadVTKHDFTimeSteps(hid_t fileId, vtkInformation* outInfo)
+{
+  this->TimeStepValues.clear();
+  this->StepPartOffsets.clear();
+  this->StepNumberOfParts.clear();
+  std::string stepsPath = std::string(H5_VTKHDF_GROUP) + "/" + H5_VTKHDF_STEPS;
+  if (H5Lexists(fileId, H5_VTKHDF_GROUP, H5P_DEFAULT) > 0
+      && H5Lexists(fileId, stepsPath.c_str(), H5P_DEFAULT) > 0)
+  {
+    hid_t gid = H5Gopen(fileId, stepsPath.c_str(), H5P_DEFAULT);
+    herr_t err = H5Vtk::H5Lite::readVectorDataset(gid, H5_VTKHDF_VALUES, this->TimeStepValues);
+    if (err >= 0)
+    {
+      err = H5Vtk::H5Lite::readVectorDataset(gid, H5_VTKHDF_PART_OFFSETS, this->StepPartOffsets);
+    }
+    if (err >= 0)
+    {
+      err = H5Vtk::H5Lite::readVectorDataset(gid, H5_VTKHDF_NUMBER_OF_PARTS, this->StepNumberOfParts);
+    }
+    H5Gclose(gid);
+    // A step is complete once it has a row in all three datasets
+    size_t numSteps = std::min(this->TimeStepValues.size(),
+                               std::min(this->StepPartOffsets.size(), this->StepNumberOfParts.size()));
+    if (err < 0)
+    {
+      vtkErrorMacro(<< "Could not read the time steps of " << this->FileName);
+      numSteps = 0;
+    }
+    this->TimeStepValues.resize(numSteps);
+    this->StepPartOffsets.resize(numSteps);
+    this->StepNumberOfParts.resize(numSteps);
+  }
+
+  if (this->TimeStepValues.empty())
+  {
+    outInfo->Remove(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    outInfo->Remove(vtkStreamingDemandDrivenPipeline::TIME_RANGE());
+    return 1;
+  }
+  double range[2] = { this->TimeStepValues.front(), this->TimeStepValues.back() };
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), &(this->TimeStepValues.front()),
+               static_cast<int>(this->TimeStepValues.size()));
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), range, 2);
+  return 1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5DataReader::SelectVTKHDFTimeStep(vtkInformation* outInfo, vtkDataObject* output)
+{
+  this->TimeStep = -1;
+  if (this->TimeStepValues.empty())
+  {
+    return;
+  }
+  double time = this->TimeStepValues.front();
+  if (outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS()))
+  {
+    time = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS())[0];
+  }
+  this->TimeStep = 0;
+  for (size_t i = 1; i < this->TimeStepValues.size(); ++i)
+  {
+    if (fabs(this->TimeStepValues[i] - time) < fabs(this->TimeStepValues[this->TimeStep] - time))
+    {
+      this->TimeStep = static_cast<int>(i);
+    }
+  }
+  output->GetInformation()->Set(vtkDataObject::DATA_TIME_STEPS(), &(this->TimeStepValues[this->TimeStep]), 1);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkCellArray* vtkH5DataReader::ReadVTKHDFCells(hid_t parentId, const VTKHDFSelection &selection,
+                                               vtkTypeUInt64 &cellStart, vtkTypeUInt64 &cellCount,
+                                               std::vector<vtkIdType> &partitionCells,
+                                               vtkIdTypeArray* locations)
+{
+  std::vector<int64_t> numCells;
+  std::vector<int64_t> numConnectivity;
+  herr_t err = H5Vtk::H5Lite::readVectorDataset(parentId, H5_VTKHDF_NUMBER_OF_CELLS, numCells);
+  if (err >= 0)
+  {
+    err = H5Vtk::H5Lite::readVectorDataset(parentId, H5_VTKHDF_NUMBER_OF_CONNECTIVITY_IDS, numConnectivity);
+  }
+  if (err < 0 || numCells.size() != selection.TotalPartitions || numConnectivity.size() != selection.TotalPartitions)
+  {
+    vtkErrorMacro(<< "The cell counts do not match the number of partitions");
+    return NULL;
+  }
+
+  vtkTypeUInt64 first = selection.FirstPartition;
+  vtkTypeUInt64 last = first + selection.NumberOfPartitions;
+  vtkTypeUInt64 connStart = 0;
+  vtkTypeUInt64 connCount = 0;
+  cellStart = 0;
+  cellCount = 0;
+  partitionCells.clear();
+  for (vtkTypeUInt64 p = 0; p < last; ++p)
+  {
+    if (p < first)
+    {
+      cellStart += numCells[p];
+      connStart += numConnectivity[p];
+    }
+    else
+    {
+      cellCount += numCells[p];
+      connCount += numConnectivity[p];
+      partitionCells.push_back(static_cast<vtkIdType>(numCells[p]));
+    }
+  }
+
+  vtkCellArray* cells = vtkCellArray::New();
+  if (locations)
+  {
+    locations->SetNumberOfValues(cellCount);
+  }
+  if (selection.NumberOfPartitions == 0)
+  {
+    return cells;
+  }
+
+  // Every partition stores numCells + 1 offsets, relative to its own
+  // connectivity, so the offsets of partition p start at row cellStart + p.
+  std::vector<int64_t> offsets(static_cast<size_t>(cellCount + selection.NumberOfPartitions));
+  std::vector<int64_t> connectivity(static_cast<size_t>(connCount));
+  H5Vtk::H5IOStatistics::allocated((offsets.size() + connectivity.size()) * sizeof(int64_t));
+  err = H5Vtk::H5Lite::readPointerDatasetRows(parentId, H5_VTKHDF_OFFSETS, cellStart + first, offsets.size(),
+                                              offsets.empty() ? static_cast<int64_t*>(NULL) : &(offsets.front()));
+  if (err >= 0)
+  {
+    err = H5Vtk::H5Lite::readPointerDatasetRows(parentId, H5_VTKHDF_CONNECTIVITY, connStart, connectivity.size(),
+                                                connectivity.empty() ? static_cast<int64_t*>(NULL) : &(connectivity.front()));
+  }
+  if (err < 0)
+  {
+    cells->Delete();
+    return NULL;
+  }
+
+  vtkIdTypeArray* legacy = vtkIdTypeArray::New();
+  vtkIdType* dest = legacy->WritePointer(0, static_cast<vtkIdType>(cellCount + connCount));
+  H5Vtk::H5IOStatistics::allocated((cellCount + connCount) * sizeof(vtkIdType));
+  vtkIdType pos = 0;
+  vtkIdType cellIndex = 0;
+  vtkTypeUInt64 offsetRow = 0;
+  vtkTypeUInt64 connBase = 0;
+  vtkIdType pointShift = 0;
+  for (vtkTypeUInt64 p = 0; p < selection.NumberOfPartitions; ++p)
+  {
+    vtkIdType nc = partitionCells[p];
+    for (vtkIdType c = 0; c < nc; ++c)
+    {
+      int64_t begin = offsets[offsetRow + c];
+      int64_t end = offsets[offsetRow + c + 1];
+      if (locations)
+      {
+        locations->SetValue(cellIndex, pos);
+      }
+      ++cellIndex;
+      dest[pos++] = static_cast<vtkIdType>(end - begin);
+      for (int64_t k = begin; k < end; ++k)
+      {
+        dest[pos++] = static_cast<vtkIdType>(connectivity[connBase + k]) + pointShift;
+      }
+    }
+    offsetRow += nc + 1;
+    connBase += numConnectivity[first + p];
+    pointShift += selection.PartitionPoints[p];
+  }
+  cells->SetCells(static_cast<vtkIdType>(cellCount), legacy);
+  legacy->Delete();
+  return cells;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataReader::ReadVTKHDFArrays(hid_t parentId, const char* groupName, vtkDataSetAttributes* a,
+                                      vtkTypeUInt64 rowStart, vtkTypeUInt64 rowCount, vtkIdList* order)
+{
+  if (H5Lexists(parentId, groupName, H5P_DEFAULT) <= 0)
+  {
+    return 1;
+  }
+  hid_t gid = H5Gopen(parentId, groupName, H5P_DEFAULT);
+  if (gid < 0)
+  {
+    return 0;
+  }
+  std::list<std::string> names;
+  H5Vtk::H5Utilities::getGroupObjects(gid, H5Vtk::H5Utilities::H5Support_DATASET, names);
+  for (std::list<std::string>::iterator iter = names.begin(); iter != names.end(); ++iter)
+  {
+    if (this->SkippedArrays.find(std::string(groupName) + "/" + *iter) != this->SkippedArrays.end())
+    {
+      continue;
+    }
+    vtkDataArray* data = this->ReadArrayRows(gid, *iter, rowStart, rowCount);
+    if (NULL == data)
+    {
+      vtkErrorMacro(<< "Could not successfully read data set attribute array with name '" << *iter << "'");
+      H5Gclose(gid);
+      return 0;
+    }
+    if (NULL != order)
+    {
+      vtkDataArray* ordered = data->NewInstance();
+      ordered->SetNumberOfComponents(data->GetNumberOfComponents());
+      ordered->SetNumberOfTuples(order->GetNumberOfIds());
+      data->GetTuples(order, ordered);
+      data->Delete();
+      data = ordered;
+    }
+    data->SetName(iter->c_str());
+    a->AddArray(data);
+    data->Delete();
+  }
+  H5Gclose(gid);
+
+  for (int attr = 0; attr < vtkDataSetAttributes::NUM_ATTRIBUTES; ++attr)
+  {
+    const char* attrName = vtkDataSetAttributes::GetAttributeTypeAsString(attr);
+    if (H5Aexists_by_name(parentId, groupName, attrName, H5P_DEFAULT) > 0)
+    {
+      std::string arrayName;
+      H5Vtk::H5Lite::readStringAttribute(parentId, groupName, attrName, arrayName);
+      a->SetActiveAttribute(arrayName.c_str(), attr);
+    }
+  }
+  return 1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkFieldData* vtkH5DataReader::ReadVTKHDFFieldData(hid_t vtkhdfId)
+{
+  if (H5Lexists(vtkhdfId, H5_VTKHDF_FIELD_DATA, H5P_DEFAULT) <= 0)
+  {
+    return NULL;
+  }
+  hid_t gid = H5Gopen(vtkhdfId, H5_VTKHDF_FIELD_DATA, H5P_DEFAULT);
+  if (gid < 0)
+  {
+    return NULL;
+  }
+  vtkFieldData* fd = vtkFieldData::New();
+  std::list<std::string> names;
+  H5Vtk::H5Utilities::getGroupObjects(gid, H5Vtk::H5Utilities::H5Support_DATASET, names);
+  for (std::list<std::string>::iterator iter = names.begin(); iter != names.end(); ++iter)
+  {
+    std::vector<hsize_t> dims;
+    H5T_class_t classType;
+    size_t typeSize = 0;
+    if (H5Vtk::H5Lite::getDatasetInfo(gid, *iter, dims, classType, typeSize) < 0 || dims.empty())
+    {
+      continue;
+    }
+    vtkDataArray* data = this->ReadArrayRows(gid, *iter, 0, dims[0]);
+    if (NULL != data)
+    {
+      data->SetName(iter->c_str());
+      fd->AddArray(data);
+      data->Delete();
+    }
+  }
+  H5Gclose(gid);
+  return fd;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkDataArray* vtkH5DataReader::ReadArrayRows(hid_t parentId, const std::string &dsetName,
+                                             vtkTypeUInt64 rowStart, vtkTypeUInt64 rowCount, hid_t did)
+{
+  hsize_t offset[1] = { static_cast<hsize_t>(rowStart) };
+  hsize_t count[1] = { static_cast<hsize_t>(rowCount) };
+  return this->ReadArrayHyperslab(parentId, dsetName, 1, offset, count, did);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+  template<typename T>
+  herr_t H5VtkReadHyperslab(hid_t parentId, const std::string &dsetName, hid_t did, int numSelected,
+                            const hsize_t* offset, const hsize_t* count, T* data)
+  {
+    if (did >= 0)
+    {
+      return H5Vtk::H5Lite::readOpenDatasetHyperslab(did, numSelected, offset, count, data);
+    }
+    return H5Vtk::H5Lite::readPointerDatasetHyperslab(parentId, dsetName, numSelected, offset, count, data);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkDataArray* vtkH5DataReader::ReadArrayHyperslab(hid_t parentId, const std::string &dsetName,
+                                                  int numSelected, const hsize_t* offset, const hsize_t* count,
+                                                  hid_t did)
+{
+  std::vector<hsize_t> dims;
+  H5T_class_t classType;
+  size_t typeSize = 0;
+  herr_t err = H5Vtk::H5Lite::getDatasetInfo(parentId, dsetName, dims, classType, typeSize);
+  if (err < 0 || numSelected < 1
+      || (dims.size() != static_cast<size_t>(numSelected) && dims.size() != static_cast<size_t>(numSelected + 1)))
+  {
+    return NULL;
+  }
+  int numComp = (dims.size() > static_cast<size_t>(numSelected)) ? static_cast<int>(dims[numSelected]) : 1;
+  vtkTypeUInt64 numTuples = 1;
+  for (int i = 0; i < numSelected; ++i)
+  {
+    numTuples = numTuples * count[i];
+  }
+
+  int vtkType = -1;
+  if (classType == H5T_FLOAT)
+  {
+    vtkType = (typeSize == 8 && !this->DowncastDoubles) ? VTK_DOUBLE : VTK_FLOAT;
+  }
+  else if (classType == H5T_INTEGER)
+  {
+    hid_t typeId = H5Vtk::H5Lite::getDatasetType(parentId, dsetName);
+    bool isSigned = (H5Tget_sign(typeId) != H5T_SGN_NONE);
+    H5Tclose(typeId);
+    switch (typeSize)
+    {
+      case 1: vtkType = isSigned ? VTK_TYPE_INT8 : VTK_TYPE_UINT8; break;
+      case 2: vtkType = isSigned ? VTK_TYPE_INT16 : VTK_TYPE_UINT16; break;
+      case 4: vtkType = isSigned ? VTK_TYPE_INT32 : VTK_TYPE_UINT32; break;
+      case 8: vtkType = isSigned ? VTK_TYPE_INT64 : VTK_TYPE_UINT64; break;
+      default: break;
+    }
+  }
+  if (vtkType < 0)
+  {
+    std::cout << "Unsupported data type for dataset " << dsetName << std::endl;
+    return NULL;
+  }
+
+  vtkDataArray* array = vtkDataArray::CreateDataArray(vtkType);
+  array->SetNumberOfComponents(numComp);
+  array->SetNumberOfTuples(static_cast<vtkIdType>(numTuples));
+  void* ptr = (numTuples > 0) ? array->GetVoidPointer(0) : NULL;
+  H5Vtk::H5IOStatistics::allocated(numTuples * numComp * array->GetDataTypeSize());
+  switch (vtkType)
+  {
+    case VTK_FLOAT:
+      err = H5VtkReadHyperslab(parentId, dsetName, did, numSelected, offset, count, static_cast<float*>(ptr));
+      break;
+    case VTK_DOUBLE:
+      err = H5VtkReadHyperslab(parentId, dsetName, did, numSelected, offset, count, static_cast<double*>(ptr));
+      break;
+    case VTK_TYPE_INT8:
+      err = H5VtkReadHyperslab(parentId, dsetName, did, numSelected, offset, count, static_cast<int8_t*>(ptr));
+      break;
+    case VTK_TYPE_UINT8:
+      err = H5VtkReadHyperslab(parentId, dsetName, did, numSelected, offset, count, static_cast<uint8_t*>(ptr));
+      break;
+    case VTK_TYPE_INT16:
+      err = H5VtkReadHyperslab(parentId, dsetName, did, numSelected, offset, count, static_cast<int16_t*>(ptr));
+      break;
+    case VTK_TYPE_UINT16:
+      err = H5VtkReadHyperslab(parentId, dsetName, did, numSelected, offset, count, static_cast<uint16_t*>(ptr));
+      break;
+    case VTK_TYPE_INT32:
+      err = H5VtkReadHyperslab(parentId, dsetName, did, numSelected, offset, count, static_cast<int32_t*>(ptr));
+      break;
+    case VTK_TYPE_UINT32:
+      err = H5VtkReadHyperslab(parentId, dsetName, did, numSelected, offset, count, static_cast<uint32_t*>(ptr));
+      break;
+    case VTK_TYPE_INT64:
+      err = H5VtkReadHyperslab(parentId, dsetName, did, numSelected, offset, count, static_cast<int64_t*>(ptr));
+      break;
+    case VTK_TYPE_UINT64:
+      err = H5VtkReadHyperslab(parentId, dsetName, did, numSelected, offset, count, static_cast<uint64_t*>(ptr));
+      break;
+    default:
+      err = -1;
+      break;
+  }
+  if (err < 0)
+  {
+    this->CheckFilters(parentId, dsetName);
+    array->Delete();
+    return NULL;
+  }
+  return array;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkDataArray* vtkH5DataReader::ReadArrayRuns(hid_t parentId, const std::string &dsetName,
+                                             const std::vector<std::pair<vtkTypeUInt64, vtkTypeUInt64> > &runs)
+{
+  std::vector<hsize_t> dims;
+  H5T_class_t classType;
+  size_t typeSize = 0;
+  herr_t err = H5Vtk::H5Lite::getDatasetInfo(parentId, dsetName, dims, classType, typeSize);
+  if (err < 0 || dims.size() == 0 || dims.size() > 2)
+  {
+    return NULL;
+  }
+  // A 2D dataset has one row per tuple, WriteArray() stores the components of
+  // the tuples one after the other
+  vtkTypeInt32 numComp = 1;
+  vtkTypeUInt64 rowsPerTuple = 1;
+  if (dims.size() == 2)
+  {
+    numComp = static_cast<vtkTypeInt32>(dims[1]);
+  }
+  else
+  {
+    if (H5Vtk::H5Lite::readScalarAttribute(parentId, dsetName, H5_NUMCOMPONENTS, numComp) < 0 || numComp < 1)
+    {
+      numComp = 1;
+    }
+    rowsPerTuple = numComp;
+  }
+
+  vtkTypeUInt64 numTuples = 0;
+  std::vector<std::pair<hsize_t, hsize_t> > rows(runs.size());
+  for (size_t r = 0; r < runs.size(); ++r)
+  {
+    numTuples += runs[r].second;
+    rows[r] = std::make_pair(static_cast<hsize_t>(runs[r].first * rowsPerTuple),
+                             static_cast<hsize_t>(runs[r].second * rowsPerTuple));
+  }
+
+  // Consecutive runs often share a chunk, which stays in the cache of the
+  // open dataset instead of being read and decompressed again
+  hid_t dapl = H5Vtk::H5Utilities::createChunkCacheAccess(parentId, dsetName, rows,
+                                                          static_cast<size_t>(this->ChunkCacheLimit) * 1024 * 1024);
+  hid_t did = H5Dopen(parentId, dsetName.c_str(), (dapl < 0) ? H5P_DEFAULT : dapl);
+  if (dapl > 0)
+  {
+    H5Pclose(dapl);
+  }
+  if (did < 0)
+  {
+    return NULL;
+  }
+  H5Vtk::H5IOStatistics::objectOpened();
+  vtkDataArray* array = NULL;
+  vtkTypeUInt64 tuple = 0;
+  for (size_t r = 0; r < runs.size(); ++r)
+  {
+    if (runs[r].second == 0)
+    {
+      continue;
+    }
+    vtkDataArray* run = this->ReadArrayRows(parentId, dsetName, rows[r].first, rows[r].second, did);
+    if (NULL == run)
+    {
+      H5Dclose(did);
+      if (NULL != array)
+      {
+        array->Delete();
+      }
+      return NULL;
+    }
+    if (NULL == array)
+    {
+      array = run->NewInstance();
+      array->SetNumberOfComponents(numComp);
+      array->SetNumberOfTuples(static_cast<vtkIdType>(numTuples));
+      H5Vtk::H5IOStatistics::allocated(numTuples * numComp * array->GetDataTypeSize());
+    }
+    ::memcpy(array->GetVoidPointer(static_cast<vtkIdType>(tuple * numComp)), run->GetVoidPointer(0),
+             static_cast<size_t>(runs[r].second * numComp * run->GetDataTypeSize()));
+    tuple += runs[r].second;
+    run->Delete();
+  }
+  H5Dclose(did);
+  if (NULL != array)
+  {
+    array = this->DecodeArray(parentId, dsetName, array);
+  }
+  return array;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataReader::ReadArraysRuns(hid_t parentId, const char* groupName, vtkDataSetAttributes* a,
+                                    const std::vector<std::pair<vtkTypeUInt64, vtkTypeUInt64> > &runs)
+{
+  if (H5Lexists(parentId, groupName, H5P_DEFAULT) <= 0)
+  {
+    return 1;
+  }
+  hid_t gid = H5Gopen(parentId, groupName, H5P_DEFAULT);
+  if (gid < 0)
+  {
+    return 0;
+  }
+  std::list<std::string> names;
+  H5Vtk::H5Utilities::getGroupObjects(gid, H5Vtk::H5Utilities::H5Support_DATASET, names);
+  for (std::list<std::string>::iterator iter = names.begin(); iter != names.end(); ++iter)
+  {
+    if (this->SkippedArrays.find(std::string(groupName) + "/" + *iter) != this->SkippedArrays.end())
+    {
+      continue;
+    }
+    vtkDataArray* data = this->ReadArrayRuns(gid, *iter, runs);
+    if (NULL == data)
+    {
+      vtkErrorMacro(<< "Could not successfully read data set attribute array with name '" << *iter << "'");
+      H5Gclose(gid);
+      return 0;
+    }
+    data->SetName(iter->c_str());
+    a->AddArray(data);
+    data->Delete();
+  }
+  H5Gclose(gid);
+  this->ReadActiveAttributeNames(parentId, groupName, a);
+  return 1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5DataReader::ReadActiveAttributeNames(hid_t parentId, const char* groupName, vtkDataSetAttributes* a)
+{
+  std::string data;
+  H5Vtk::H5Lite::readStringAttribute(parentId, groupName, H5_ACTIVE_SCALARS, data);
+  if (data.size() > 0)
+  {
+    a->SetActiveScalars(data.c_str());
+  }
+  data.clear();
+
+  H5Vtk::H5Lite::readStringAttribute(parentId, groupName, H5_ACTIVE_VECTORS, data);
+  if (data.size() > 0)
+  {
+    a->SetActiveVectors(data.c_str());
+  }
+  data.clear();
+
+  H5Vtk::H5Lite::readStringAttribute(parentId, groupName, H5_ACTIVE_NORMALS, data);
+  if (data.size() > 0)
+  {
+    a->SetActiveNormals(data.c_str());
+  }
+  data.clear();
+
+  H5Vtk::H5Lite::readStringAttribute(parentId, groupName, H5_ACTIVE_TEXTURE_COORDINATES, data);
+  if (data.size() > 0)
+  {
+    a->SetActiveTCoords(data.c_str());
+  }
+  data.clear();
+
+  H5Vtk::H5Lite::readStringAttribute(parentId, groupName, H5_ACTIVE_TENSORS, data);
+  if (data.size() > 0)
+  {
+    a->SetActiveTensors(data.c_str());
+  }
+  data.clear();
+
+  H5Vtk::H5Lite::readStringAttribute(parentId, groupName, H5_ACTIVE_GLOBAL_IDS, data);
+  if (data.size() > 0)
+  {
+    a->SetActiveGlobalIds(data.c_str());
+  }
+  data.clear();
+
+  H5Vtk::H5Lite::readStringAttribute(parentId, groupName, H5_ACTIVE_PEDIGREE_IDS, data);
+  if (data.size() > 0)
+  {
+    a->SetActivePedigreeIds(data.c_str());
+  }
+  data.clear();
+
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataReader::ReadStructuredArrays(hid_t parentId, const char* groupName, vtkDataSetAttributes* a,
+                                          const int offset[3], const int count[3])
+{
+  if (H5Lexists(parentId, groupName, H5P_DEFAULT) <= 0)
+  {
+    return 1;
+  }
+  hid_t gid = H5Gopen(parentId, groupName, H5P_DEFAULT);
+  if (gid < 0)
+  {
+    return 0;
+  }
+  // The datasets are stored slowest axis first
+  hsize_t start[3] = { static_cast<hsize_t>(offset[2]), static_cast<hsize_t>(offset[1]), static_cast<hsize_t>(offset[0]) };
+  hsize_t block[3] = { static_cast<hsize_t>(count[2]), static_cast<hsize_t>(count[1]), static_cast<hsize_t>(count[0]) };
+  std::list<std::string> names;
+  H5Vtk::H5Utilities::getGroupObjects(gid, H5Vtk::H5Utilities::H5Support_DATASET, names);
+  for (std::list<std::string>::iterator iter = names.begin(); iter != names.end(); ++iter)
+  {
+    vtkDataArray* data = this->ReadArrayHyperslab(gid, *iter, 3, start, block);
+    if (NULL == data)
+    {
+      vtkErrorMacro(<< "Could not successfully read data set attribute array with name '" << *iter << "'");
+      H5Gclose(gid);
+      return 0;
+    }
+    data->SetName(iter->c_str());
+    a->AddArray(data);
+    data->Delete();
+  }
+  H5Gclose(gid);
+
+  this->ReadActiveAttributeNames(parentId, groupName, a);
+  return 1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataReader::ReadWholeExtent(hid_t fileId, const std::string &hdfpath, int wholeExtent[6])
+{
+  vtkTypeInt32 extent[6];
+  herr_t err = H5Vtk::H5Lite::readPointerAttribute(fileId, hdfpath, H5_WHOLE_EXTENT, extent);
+  if (err < 0)
+  {
+    return 0;
+  }
+  for (int i = 0; i < 6; ++i)
+  {
+    wholeExtent[i] = extent[i];
+  }
+  return 1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataReader::GetRequestedExtent(vtkInformation* outInfo, const int wholeExtent[6], int extent[6])
+{
+  for (int i = 0; i < 6; ++i)
+  {
+    extent[i] = wholeExtent[i];
+  }
+  if (outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT()))
+  {
+    int updateExtent[6];
+    outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), updateExtent);
+    for (int i = 0; i < 3; ++i)
+    {
+      extent[2*i] = (updateExtent[2*i] > wholeExtent[2*i]) ? updateExtent[2*i] : wholeExtent[2*i];
+      extent[2*i+1] = (updateExtent[2*i+1] < wholeExtent[2*i+1]) ? updateExtent[2*i+1] : wholeExtent[2*i+1];
+    }
+  }
+  if (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+  {
+    return 0;
+  }
+  return 1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataReader::ReadStructuredData(hid_t parentId, vtkDataSet* ds,
+                                        const int wholeExtent[6], const int extent[6])
+{
+  // Point data is indexed by point, cell data by cell. Axes without any extent
+  // in the file hold a single layer of cells
+  int pointOffset[3], pointCount[3], cellOffset[3], cellCount[3];
+  for (int i = 0; i < 3; ++i)
+  {
+    int wholeCells = wholeExtent[2*i+1] - wholeExtent[2*i];
+    if (wholeCells < 1) { wholeCells = 1; }
+    pointOffset[i] = extent[2*i] - wholeExtent[2*i];
+    pointCount[i] = extent[2*i+1] - extent[2*i] + 1;
+    cellOffset[i] = pointOffset[i];
+    cellCount[i] = extent[2*i+1] - extent[2*i];
+    if (cellCount[i] < 1) { cellCount[i] = 1; }
+    if (cellOffset[i] + cellCount[i] > wholeCells) { cellOffset[i] = wholeCells - cellCount[i]; }
+  }
+
+  // Read any FIELD_DATA
+  if (H5Lexists(parentId, H5_FIELD_DATA_GROUP_NAME, H5P_DEFAULT) > 0)
+  {
+    hid_t gid = H5Gopen(parentId, H5_FIELD_DATA_GROUP_NAME, H5P_DEFAULT);
+    if (gid > 0)
+    {
+      vtkFieldData* fd = this->ReadFieldData(parentId, gid);
+      if (NULL != fd)
+      {
+        ds->SetFieldData(fd);
+        fd->Delete();
+      }
+      H5Gclose(gid);
+    }
+  }
+
+  int ok = 1;
+  if (ds->GetNumberOfCells() > 0
+      && this->ReadStructuredArrays(parentId, H5_CELL_DATA_GROUP_NAME, ds->GetCellData(), cellOffset, cellCount) == 0)
+  {
+    ok = 0;
+  }
+  if (this->ReadStructuredArrays(parentId, H5_POINT_DATA_GROUP_NAME, ds->GetPointData(), pointOffset, pointCount) == 0)
+  {
+    ok = 0;
+  }
+  return ok;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkPoints* vtkH5DataReader::ReadStructuredPoints(hid_t parentId, const int wholeExtent[6], const int extent[6])
+{
+  // The points are stored slowest axis first
+  hsize_t offset[3];
+  hsize_t count[3];
+  for (int i = 0; i < 3; ++i)
+  {
+    offset[2-i] = static_cast<hsize_t>(extent[2*i] - wholeExtent[2*i]);
+    count[2-i] = static_cast<hsize_t>(extent[2*i+1] - extent[2*i] + 1);
+  }
+  vtkDataArray* data = this->ReadArrayHyperslab(parentId, H5_POINTS, 3, offset, count);
+  if (NULL == data)
+  {
+    return NULL;
+  }
+  if (data->GetNumberOfComponents() != 3)
+  {
+    vtkErrorMacro(<< "The points have " << data->GetNumberOfComponents() << " components instead of 3");
+    data->Delete();
+    return NULL;
+  }
+  vtkPoints* points = vtkPoints::New();
+  points->SetData(data);
+  data->Delete();
+  return points;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkDataArray* vtkH5DataReader::ReadCoordinates(hid_t parentId, int axis,
+                                               const int wholeExtent[6], const int extent[6])
+{
+  const char* names[3] = { H5_X_COORDINATES, H5_Y_COORDINATES, H5_Z_COORDINATES };
+  if (axis < 0 || axis > 2)
+  {
+    vtkErrorMacro(<< "Invalid coordinate axis " << axis);
+    return NULL;
+  }
+  hsize_t offset[1] = { static_cast<hsize_t>(extent[2*axis] - wholeExtent[2*axis]) };
+  hsize_t count[1] = { static_cast<hsize_t>(extent[2*axis+1] - extent[2*axis] + 1) };
+  vtkDataArray* data = this->ReadArrayHyperslab(parentId, names[axis], 1, offset, count);
+  if (NULL != data)
+  {
+    data->SetName(names[axis]);
+  }
+  return data;
+}
@@ -13,6 +13,7 @@
 #define __vtkH5DataReader_h
 
 //-- C++ includes
+#include <set>
 #include <string>
 #include <vector>
 
@@ -26,13 +27,19 @@
 #define VTK_BINARY 2
 
 class vtkAbstractArray;
+class vtkCellArray;
 class vtkCharArray;
+class vtkDataArray;
+class vtkIdList;
+class vtkIdTypeArray;
 class vtkDataSet;
 class vtkDataSetAttributes;
 class vtkFieldData;
 class vtkGraph;
+class vtkPoints;
 class vtkPointSet;
 class vtkRectilinearGrid;
+class vtkStringArray;
 
 class VTK_EXPORT vtkH5DataReader : public vtkAlgorithm
 {
@@ -87,6 +94,46 @@ public:
   vtkSetStringMacro(FieldDataName);
   vtkGetStringMacro(FieldDataName);
 
+  // Description:
+  // Upper bound, in megabytes, for the memory the reader may allocate while
+  // reading an object. 0 (the default) disables the check. When the estimate
+  // made in RequestInformation is over the budget the reader skips building the
+  // cell links, then reads double arrays as float and finally skips point and
+  // cell data arrays, largest first. If the object still does not fit nothing
+  // is read and a warning is issued.
+  vtkSetClampMacro(MemoryBudget, int, 0, VTK_INT_MAX);
+  vtkGetMacro(MemoryBudget, int);
+
+  // Description:
+  // Upper bound, in megabytes, for the chunk cache of a dataset read in
+  // pieces. The cache of each such dataset is sized from its chunk
+  // dimensions and the order of the pieces, so no chunk has to be
+  // decompressed twice when it fits. 0 leaves the HDF5 default of 1 MB. The
+  // default is 64.
+  vtkSetClampMacro(ChunkCacheLimit, int, 0, VTK_INT_MAX);
+  vtkGetMacro(ChunkCacheLimit, int);
+
+  // Description:
+  // When on, the file is opened for single writer/multiple reader (SWMR)
+  // access and stays open between updates, so a VTKHDF file a simulation is
+  // appending time steps to can be watched. Every update refreshes the
+  // extents of the /VTKHDF datasets instead of reopening the file. Call
+  // Refresh() to list the time steps written since the last update.
+  vtkSetMacro(SWMRMode, int);
+  vtkGetMacro(SWMRMode, int);
+  vtkBooleanMacro(SWMRMode, int);
+
+  // Description:
+  // Marks the reader modified so the next update reads the time steps again.
+  void Refresh();
+
+  // Description:
+  // A directory HDF5 searches for filter plugins, such as LZ4, Zstd or Blosc,
+  // in addition to HDF5_PLUGIN_PATH. The path is added to the search path of
+  // the process when it is set.
+  virtual void SetFilterPluginPath(const char* path);
+  vtkGetStringMacro(FilterPluginPath);
+
 
 //BTX
   // Description:
@@ -107,6 +154,11 @@ public:
   // Read point coordinates. Return 0 if error.
   int ReadPoints(hid_t parentId, const std::string &dsetName, vtkPointSet* ps);
 
+  // Description:
+  // Reads cells written with vtkH5DataWriter::ConnectivityCodec on, decoding
+  // straight into the vtkIdTypeArray of cells. Return 0 if error.
+  int ReadEncodedCells(hid_t parentId, const std::string &dsetName, vtkCellArray* cells);
+
 #if 0
   // Description:
   // Read the vertex data of a vtk data file. The number of vertices (from the
@@ -133,6 +185,27 @@ public:
   // Helper functions for reading data.
   vtkAbstractArray* ReadArray(hid_t parentId, const std::string &dsetName);
 
+  // Description:
+  // Decodes an array written with vtkH5DataWriter::SymmetricTensors or
+  // OctahedralNormals. Returns stored itself if dsetName has no encoding, the
+  // decoded array otherwise (stored is deleted) and NULL on error.
+  vtkDataArray* DecodeArray(hid_t parentId, const std::string &dsetName, vtkDataArray* stored);
+
+  // Description:
+  // Reports an error naming the filter if the dataset dsetName was written
+  // with a filter HDF5 can not load. Returns 0 in that case, 1 otherwise.
+  int CheckFilters(hid_t parentId, const std::string &dsetName);
+
+  // Description:
+  // Reads a string array written by vtkH5DataWriter::WriteStringArray() with
+  // one read of the packed characters and one of the offsets.
+  vtkStringArray* ReadStringArray(hid_t parentId, const std::string &name);
+
+  // Description:
+  // Reads a dataset of fixed or variable length HDF5 strings.
+  vtkStringArray* ReadStringDataset(hid_t parentId, const std::string &dsetName,
+                                    int numComp, vtkIdType numValues);
+
   /**
    * @brief
    * @param parentId The parent Id of gid
@@ -198,6 +271,178 @@ protected:
   int ReadDataSetArrays(vtkDataSet *ds, vtkDataSetAttributes *a, int num,
                                        hid_t parentId, hid_t gid, const char* groupName);
 
+  int MemoryBudget;
+  int ChunkCacheLimit;
+//BTX
+  // Decisions made by ApplyMemoryBudget() for the next RequestData
+  int DowncastDoubles;
+  int SkipLinks;
+  int OverMemoryBudget;
+  std::set<std::string> SkippedArrays;
+
+  // Description:
+  // Clears the decisions of the last ApplyMemoryBudget() so the next read is
+  // not degraded. Called at the start of every RequestInformation.
+  void ResetMemoryBudget();
+
+  // Description:
+  // Estimates the memory needed to materialize the object at hdfpath from the
+  // shapes of its datasets and degrades the read until it fits MemoryBudget.
+  // A budget of 0 or less only clears the last decisions.
+  // Returns 1 if the object can be read, 0 if it does not fit the budget.
+  int ApplyMemoryBudget(hid_t fileId, const std::string &hdfpath);
+
+  // Description:
+  // Returns the number of elements of a dataset together with its type class
+  // and type size. Returns 0 if the dataset does not exist.
+  vtkTypeUInt64 GetDatasetElementCount(hid_t parentId, const std::string &dsetName,
+                                       H5T_class_t &classType, size_t &typeSize);
+
+  // Description:
+  // The VTKHDF partitions read for one piece. Partitions are distributed over
+  // the pieces in contiguous runs so every dataset is read with one hyperslab.
+  struct VTKHDFSelection
+  {
+    vtkTypeUInt64 FirstPartition;
+    vtkTypeUInt64 NumberOfPartitions;
+    vtkTypeUInt64 TotalPartitions;
+    std::vector<vtkIdType> PartitionPoints;  // points of each selected partition
+    vtkTypeUInt64 PointStart;                // first row in Points and PointData
+    vtkTypeUInt64 PointCount;
+  };
+
+  // Description:
+  // Returns 1 if the file has a /VTKHDF group with the given Type attribute.
+  int IsVTKHDF(hid_t fileId, const char* type);
+
+  // Description:
+  // Works out which partitions of the /VTKHDF group belong to piece out of
+  // numPieces. With a TimeStep selected only the partitions of that step are
+  // distributed. Returns 0 on error.
+  int SelectVTKHDFPartitions(hid_t vtkhdfId, int piece, int numPieces, VTKHDFSelection &selection);
+
+  // Description:
+  // Opens FileName. In SWMRMode the file is opened once for SWMR reading and
+  // the same id is returned, with the /VTKHDF datasets refreshed, until
+  // FileName changes. Files that can not be opened that way are opened as
+  // usual. Returns a negative value on error.
+  hid_t OpenFile(bool readOnly);
+
+  // Description:
+  // Closes a file returned by OpenFile() unless it is kept open for SWMR.
+  herr_t CloseFile(hid_t &fileId);
+
+  // Description:
+  // Reads the Steps group of a VTKHDF file and publishes its time values as
+  // TIME_STEPS and TIME_RANGE of outInfo, or removes them if there is none.
+  int ReadVTKHDFTimeSteps(hid_t fileId, vtkInformation* outInfo);
+
+  // Description:
+  // Selects the time step closest to the UPDATE_TIME_STEPS of outInfo and
+  // stamps output with its time. Does nothing for files without steps.
+  void SelectVTKHDFTimeStep(vtkInformation* outInfo, vtkDataObject* output);
+
+  int SWMRMode;
+  char* FilterPluginPath;
+  hid_t SWMRFileId;
+  std::string SWMRFileName;
+  std::vector<double> TimeStepValues;
+  std::vector<int64_t> StepPartOffsets;
+  std::vector<int64_t> StepNumberOfParts;
+  int TimeStep; // -1 reads every partition
+
+  // Description:
+  // Reads NumberOfCells, NumberOfConnectivityIds, Offsets and Connectivity of
+  // the selected partitions below parentId and converts them to a vtkCellArray
+  // with point ids relative to the merged points. cellStart/cellCount receive
+  // the rows of the cells in the file, partitionCells the cells of each
+  // selected partition. locations, if given, receives the cell locations.
+  // Returns NULL on error.
+  vtkCellArray* ReadVTKHDFCells(hid_t parentId, const VTKHDFSelection &selection,
+                                vtkTypeUInt64 &cellStart, vtkTypeUInt64 &cellCount,
+                                std::vector<vtkIdType> &partitionCells,
+                                vtkIdTypeArray* locations);
+
+  // Description:
+  // Reads the arrays of the group groupName, rowCount tuples starting at
+  // rowStart, into a. If order is given the tuples are reordered so that
+  // tuple i of the output is tuple order->GetId(i) of the rows read.
+  int ReadVTKHDFArrays(hid_t parentId, const char* groupName, vtkDataSetAttributes* a,
+                       vtkTypeUInt64 rowStart, vtkTypeUInt64 rowCount, vtkIdList* order);
+
+  // Description:
+  // Reads the complete FieldData group of a VTKHDF file. Returns NULL if
+  // there is none.
+  vtkFieldData* ReadVTKHDFFieldData(hid_t vtkhdfId);
+
+  // Description:
+  // Reads rowCount rows starting at rowStart of a dataset. A 2D dataset is
+  // read as an array with one component per column. did, if not negative,
+  // is the dataset already opened. Returns NULL on error.
+  vtkDataArray* ReadArrayRows(hid_t parentId, const std::string &dsetName,
+                              vtkTypeUInt64 rowStart, vtkTypeUInt64 rowCount, hid_t did = -1);
+
+  // Description:
+  // Reads a block of a dataset. offset and count select the block along the
+  // first numSelected dimensions; a dataset with one more dimension is read
+  // as an array with one component per entry of its last dimension. did, if
+  // not negative, is the dataset already opened. Returns NULL on error.
+  vtkDataArray* ReadArrayHyperslab(hid_t parentId, const std::string &dsetName,
+                                   int numSelected, const hsize_t* offset, const hsize_t* count,
+                                   hid_t did = -1);
+
+  // Description:
+  // Reads the runs (first tuple, number of tuples) of a dataset written by
+  // vtkH5DataWriter::WriteArray() and concatenates them into one array. The
+  // tuples are counted with the NumComponents attribute of the dataset. The
+  // runs are read through one open dataset with a chunk cache sized for
+  // them, at most ChunkCacheLimit. Returns NULL on error.
+  vtkDataArray* ReadArrayRuns(hid_t parentId, const std::string &dsetName,
+                              const std::vector<std::pair<vtkTypeUInt64, vtkTypeUInt64> > &runs);
+
+  // Description:
+  // Reads the runs of every dataset of the group groupName with
+  // ReadArrayRuns() into a and sets the active attributes. Returns 0 on error.
+  int ReadArraysRuns(hid_t parentId, const char* groupName, vtkDataSetAttributes* a,
+                     const std::vector<std::pair<vtkTypeUInt64, vtkTypeUInt64> > &runs);
+
+  // Description:
+  // Sets the active attributes of a from the names stored on the group
+  // groupName by vtkH5DataWriter::WriteActiveAttributeNames().
+  void ReadActiveAttributeNames(hid_t parentId, const char* groupName, vtkDataSetAttributes* a);
+
+  // Description:
+  // Reads the block offset/count (x, y, z) of every array written by
+  // vtkH5DataWriter::WriteStructuredArrays() in the group groupName into a.
+  int ReadStructuredArrays(hid_t parentId, const char* groupName, vtkDataSetAttributes* a,
+                           const int offset[3], const int count[3]);
+
+  // Description:
+  // Reads the WholeExtent attribute of the structured data set at hdfpath.
+  // Returns 0 on error.
+  int ReadWholeExtent(hid_t fileId, const std::string &hdfpath, int wholeExtent[6]);
+
+  // Description:
+  // Clips the UPDATE_EXTENT of outInfo, if any, to wholeExtent. Returns 0 if
+  // the resulting extent is empty.
+  int GetRequestedExtent(vtkInformation* outInfo, const int wholeExtent[6], int extent[6]);
+
+  // Description:
+  // Reads the field data and the extent of the cell and point data written by
+  // vtkH5DataWriter::WriteStructuredData() into ds. Returns 0 on error.
+  int ReadStructuredData(hid_t parentId, vtkDataSet* ds, const int wholeExtent[6], const int extent[6]);
+
+  // Description:
+  // Reads the extent of the points written by
+  // vtkH5DataWriter::WriteStructuredPoints(). Returns NULL on error.
+  vtkPoints* ReadStructuredPoints(hid_t parentId, const int wholeExtent[6], const int extent[6]);
+
+  // Description:
+  // Reads the extent of one axis (0, 1 or 2 for x, y or z) of a rectilinear
+  // grid. Returns NULL on error.
+  vtkDataArray* ReadCoordinates(hid_t parentId, int axis, const int wholeExtent[6], const int extent[6]);
+//ETX
+
   // This supports getting additional information from vtk files
   int  NumberOfScalarsInFile;
   char **ScalarsNameInFile;
@@ -8,6 +8,7 @@
 
 #include "vtkH5DataWriter.h"
 
+#include <algorithm>
 #include <sstream>
 
 //VTK/ParaView includes
@@ -16,6 +17,7 @@
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
 #include <vtkPolyData.h>
+#include <vtkUnstructuredGrid.h>
 #include "vtkBitArray.h"
 #include "vtkByteSwap.h"
 #include "vtkCellArray.h"
@@ -26,6 +28,7 @@
 #include "vtkErrorCode.h"
 #include "vtkFieldData.h"
 #include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkGraph.h"
 #include "vtkIntArray.h"
 #include "vtkLongArray.h"
@@ -33,6 +36,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
+#include "vtkPointSet.h"
 #include "vtkShortArray.h"
 #include "vtkStringArray.h"
 #include "vtkTypeTraits.h"
@@ -43,11 +47,19 @@
 #include "vtkVariantArray.h"
 #include "vtkDataArray.h"
 #include "vtkDataSetAttributes.h"
+#include "vtkMultiThreader.h"
 
 #include "HDF5/H5Utilities.h"
-
+#include "HDF5/H5Xdmf.h"
+#include "HDF5/H5ConnectivityCodec.h"
+#include "HDF5/H5ArrayEncoding.h"
+#include "HDF5/H5Compression.h"
+#include "HDF5/H5IOStatistics.h"
+
+// The size estimate was the third argument of the 1.6 API. H5Gcreate2 takes a
+// link creation property list there, so it is not passed on.
 #define H5G_CREATE_GROUP(outId, parentid, name, estimate, errorReturnValue)\
-  hid_t outId = H5Gcreate(parentid, name, estimate, H5P_DEFAULT, H5P_DEFAULT);\
+  hid_t outId = H5Gcreate(parentid, name, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);\
   if (outId < 0) {\
     vtkErrorMacro(<< "Error creating group with name " << name);\
     return errorReturnValue;\
@@ -69,7 +81,26 @@ vtkStandardNewMacro( vtkH5DataWriter );
 // -----------------------------------------------------------------------------
 vtkH5DataWriter::vtkH5DataWriter()
 {
-
+  this->VTKHDFLayout = 0;
+  this->XdmfDescriptor = 0;
+  this->ConnectivityCodec = 0;
+  this->SymmetricTensors = 0;
+  this->OctahedralNormals = 0;
+  this->LossyCompression = VTK_H5_LOSSY_NONE;
+  this->ErrorBound = 0.0;
+  this->RelativeErrorBound = 0;
+  this->PointsCompression = VTK_H5_CODEC_NONE;
+  this->ConnectivityCompression = VTK_H5_CODEC_NONE;
+  this->PointDataCompression = VTK_H5_CODEC_NONE;
+  this->CellDataCompression = VTK_H5_CODEC_NONE;
+  this->CompressionLevel = 4;
+  this->TargetWriteThroughput = 200.0;
+  this->TargetCompressionRatio = 0.0;
+  this->CompressionThreads = 0;
+  this->SpaceFillingCurve = VTK_H5_CURVE_NONE;
+  this->FilterPluginPath = NULL;
+  this->SWMRMode = 0;
+  this->SWMRFileId = -1;
 }
 
 // -----------------------------------------------------------------------------
@@ -77,7 +108,8 @@ vtkH5DataWriter::vtkH5DataWriter()
 // -----------------------------------------------------------------------------
 vtkH5DataWriter::~vtkH5DataWriter()
 {
-
+  this->CloseSWMRFile();
+  this->SetFilterPluginPath(NULL);
 }
 
 // -----------------------------------------------------------------------------
@@ -86,6 +118,359 @@ vtkH5DataWriter::~vtkH5DataWriter()
 void vtkH5DataWriter::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "VTKHDFLayout: " << this->VTKHDFLayout << std::endl;
+  os << indent << "XdmfDescriptor: " << this->XdmfDescriptor << std::endl;
+  os << indent << "ConnectivityCodec: " << this->ConnectivityCodec << std::endl;
+  os << indent << "SymmetricTensors: " << this->SymmetricTensors << std::endl;
+  os << indent << "OctahedralNormals: " << this->OctahedralNormals << std::endl;
+  os << indent << "LossyCompression: " << this->LossyCompression << std::endl;
+  os << indent << "ErrorBound: " << this->ErrorBound << std::endl;
+  os << indent << "RelativeErrorBound: " << this->RelativeErrorBound << std::endl;
+  os << indent << "PointsCompression: " << this->PointsCompression << std::endl;
+  os << indent << "ConnectivityCompression: " << this->ConnectivityCompression << std::endl;
+  os << indent << "PointDataCompression: " << this->PointDataCompression << std::endl;
+  os << indent << "CellDataCompression: " << this->CellDataCompression << std::endl;
+  os << indent << "CompressionLevel: " << this->CompressionLevel << std::endl;
+  os << indent << "TargetWriteThroughput: " << this->TargetWriteThroughput << " MB/s" << std::endl;
+  os << indent << "TargetCompressionRatio: " << this->TargetCompressionRatio << std::endl;
+  os << indent << "CompressionThreads: " << this->CompressionThreads << std::endl;
+  os << indent << "SpaceFillingCurve: " << this->SpaceFillingCurve << std::endl;
+  os << indent << "FilterPluginPath: " << (this->FilterPluginPath ? this->FilterPluginPath : "(none)") << std::endl;
+  std::map<std::string, std::pair<int, double> >::const_iterator iter;
+  for (iter = this->ArrayLossyCompression.begin(); iter != this->ArrayLossyCompression.end(); ++iter)
+  {
+    os << indent << "ArrayLossyCompression " << iter->first << ": " << iter->second.first
+       << " " << iter->second.second << std::endl;
+  }
+  os << indent << "SWMRMode: " << this->SWMRMode << std::endl;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5DataWriter::SetFilterPluginPath(const char* path)
+{
+  if (this->FilterPluginPath == path
+      || (this->FilterPluginPath && path && strcmp(this->FilterPluginPath, path) == 0))
+  {
+    return;
+  }
+  delete [] this->FilterPluginPath;
+  this->FilterPluginPath = NULL;
+  if (path)
+  {
+    this->FilterPluginPath = strcpy(new char[strlen(path) + 1], path);
+    if (H5Vtk::H5Compression::appendPluginPath(path) < 0)
+    {
+      vtkWarningMacro(<< "Could not add " << path << " to the HDF5 plugin search path");
+    }
+  }
+  this->Modified();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+hid_t vtkH5DataWriter::CreateCompressedProperties(int codec, hsize_t numValues, int numComp)
+{
+  if (codec == VTK_H5_CODEC_NONE || numValues == 0)
+  {
+    return -1;
+  }
+  if (!H5Vtk::H5Compression::isFilterAvailable(H5Vtk::H5Compression::getCodecFilter(codec)))
+  {
+    vtkWarningMacro(<< "The " << H5Vtk::H5Compression::getCodecName(codec)
+                    << " filter is not available, writing without compression");
+    return -1;
+  }
+  hid_t dcpl = H5Vtk::H5Compression::createChunkedProperties(numValues, numComp);
+  if (dcpl >= 0 && H5Vtk::H5Compression::setCodec(dcpl, codec, this->CompressionLevel) < 0)
+  {
+    H5Pclose(dcpl);
+    dcpl = -1;
+  }
+  return dcpl;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+hid_t vtkH5DataWriter::CreateTunedProperties(const void* data, hid_t memType, hsize_t numValues, int numComp,
+                                             H5Vtk::H5StorageTuner::Decision &decision)
+{
+  if (H5Vtk::H5StorageTuner::tune(data, memType, numValues, numComp, this->TargetCompressionRatio,
+                                  this->TargetWriteThroughput, this->CompressionLevel, decision) < 0
+      && numValues > 0)
+  {
+    vtkWarningMacro(<< "Could not trial compress an array, writing it without compression");
+  }
+  if (decision.codec == VTK_H5_CODEC_NONE)
+  {
+    return -1;
+  }
+  hid_t dcpl = H5Vtk::H5Compression::createChunkedProperties(numValues, numComp, decision.chunkValues);
+  if (dcpl >= 0 && H5Vtk::H5Compression::setCodec(dcpl, decision.codec, this->CompressionLevel) < 0)
+  {
+    H5Pclose(dcpl);
+    dcpl = -1;
+  }
+  if (dcpl < 0)
+  {
+    decision.codec = VTK_H5_CODEC_NONE;
+    decision.chunkValues = 0;
+  }
+  return dcpl;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t vtkH5DataWriter::WriteStorageDecision(hid_t fp, const std::string &name,
+                                             const H5Vtk::H5StorageTuner::Decision &decision)
+{
+  herr_t err = H5Vtk::H5Lite::writeStringAttribute(fp, name, H5_STORAGE_CODEC,
+                                                   H5Vtk::H5Compression::getCodecName(decision.codec));
+  if (err >= 0)
+  {
+    vtkTypeInt32 level = this->CompressionLevel;
+    err = H5Vtk::H5Lite::writeScalarAttribute(fp, name, std::string(H5_STORAGE_LEVEL), level);
+  }
+  if (err >= 0)
+  {
+    vtkTypeUInt64 chunkValues = decision.chunkValues;
+    err = H5Vtk::H5Lite::writeScalarAttribute(fp, name, std::string(H5_STORAGE_CHUNK_VALUES), chunkValues);
+  }
+  if (err >= 0)
+  {
+    err = H5Vtk::H5Lite::writeScalarAttribute(fp, name, std::string(H5_STORAGE_ENTROPY), decision.entropy);
+  }
+  if (err >= 0)
+  {
+    err = H5Vtk::H5Lite::writeScalarAttribute(fp, name, std::string(H5_STORAGE_RATIO), decision.ratio);
+  }
+  if (err >= 0)
+  {
+    err = H5Vtk::H5Lite::writeScalarAttribute(fp, name, std::string(H5_STORAGE_THROUGHPUT), decision.throughput);
+  }
+  if (err >= 0)
+  {
+    err = H5Vtk::H5Lite::writeScalarAttribute(fp, name, std::string(H5_STORAGE_TARGET_RATIO),
+                                              this->TargetCompressionRatio);
+  }
+  if (err >= 0)
+  {
+    err = H5Vtk::H5Lite::writeScalarAttribute(fp, name, std::string(H5_STORAGE_TARGET_THROUGHPUT),
+                                              this->TargetWriteThroughput);
+  }
+  if (err < 0)
+  {
+    std::cout << "Error writing the storage attributes of " << name << std::endl;
+  }
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+  // Chunk of the VTKHDF datasets that get one row per partition or time
+  // step. The bulk arrays are appended in chunks of 64K values.
+  const hsize_t H5VtkCountChunkValues = 256;
+
+  // Chunks each compressing thread takes per round
+  const hsize_t H5VtkChunksPerThread = 2;
+
+  struct H5VtkChunkSlot
+  {
+    std::vector<unsigned char> padded;
+    std::vector<unsigned char> shuffled;
+    std::vector<unsigned char> compressed;
+    long size;
+  };
+
+  // One round of WriteParallelDataset: the threads compress compressCount
+  // chunks into the slots from compressSlot on while the calling thread
+  // stores the writeCount chunks compressed in the previous round
+  struct H5VtkChunkRound
+  {
+    hid_t datasetId;
+    const unsigned char* data;
+    size_t typeSize;
+    hsize_t numValues;
+    hsize_t chunkValues;
+    int level;
+    int numWorkers;
+    std::vector<H5VtkChunkSlot>* slots;
+    hsize_t compressFirst;
+    hsize_t compressCount;
+    size_t compressSlot;
+    hsize_t writeFirst;
+    hsize_t writeCount;
+    size_t writeSlot;
+    herr_t writeError;
+  };
+
+  VTK_THREAD_RETURN_TYPE H5VtkChunkRoundExecute(void* arg)
+  {
+    vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    H5VtkChunkRound* round = static_cast<H5VtkChunkRound*>(info->UserData);
+    if (info->ThreadID == 0)
+    {
+      // The only HDF5 calls, made from the thread that called the writer
+      for (hsize_t c = 0; c < round->writeCount && round->writeError >= 0; ++c)
+      {
+        H5VtkChunkSlot &slot = (*round->slots)[round->writeSlot + c];
+        round->writeError = H5Vtk::H5Compression::writeRawChunk(round->datasetId,
+                                                                (round->writeFirst + c) * round->chunkValues,
+                                                                &slot.compressed[0], static_cast<size_t>(slot.size));
+      }
+      return VTK_THREAD_RETURN_VALUE;
+    }
+    size_t chunkBytes = static_cast<size_t>(round->chunkValues) * round->typeSize;
+    for (hsize_t c = info->ThreadID - 1; c < round->compressCount; c += round->numWorkers)
+    {
+      H5VtkChunkSlot &slot = (*round->slots)[round->compressSlot + c];
+      hsize_t first = (round->compressFirst + c) * round->chunkValues;
+      const unsigned char* chunk = round->data + static_cast<size_t>(first) * round->typeSize;
+      if (first + round->chunkValues > round->numValues)
+      {
+        // HDF5 stores the last chunk at full size, padded with the fill value
+        size_t bytes = static_cast<size_t>(round->numValues - first) * round->typeSize;
+        slot.padded.assign(chunkBytes, 0);
+        memcpy(&slot.padded[0], chunk, bytes);
+        chunk = &slot.padded[0];
+      }
+      slot.size = H5Vtk::H5Compression::shuffleDeflateChunk(chunk, chunkBytes, round->typeSize, round->level,
+                                                            slot.shuffled, slot.compressed);
+    }
+    return VTK_THREAD_RETURN_VALUE;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataWriter::WriteParallelDataset(hid_t fp, const std::string &name, hsize_t numValues, hid_t dcpl,
+                                          hid_t memType, const void* data)
+{
+  int numThreads = (this->CompressionThreads > 0) ? this->CompressionThreads
+                                                  : vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  if (numThreads > VTK_MAX_THREADS - 1) { numThreads = VTK_MAX_THREADS - 1; }
+  hsize_t chunkValues = 0;
+  if (numThreads < 2 || memType < 0 || !H5Vtk::H5Compression::isRawChunkWriteAvailable()
+      || H5Pget_layout(dcpl) != H5D_CHUNKED || H5Pget_chunk(dcpl, 1, &chunkValues) != 1
+      || chunkValues == 0 || numValues <= chunkValues)
+  {
+    return 0;
+  }
+  // Only the pipeline of VTK_H5_CODEC_DEFLATE is run by the threads
+  unsigned int flags = 0;
+  size_t numCdValues = 1;
+  unsigned int level = 0;
+  if (H5Pget_nfilters(dcpl) != 2
+      || H5Pget_filter2(dcpl, 0, &flags, NULL, NULL, 0, NULL, NULL) != H5Z_FILTER_SHUFFLE
+      || H5Pget_filter2(dcpl, 1, &flags, &numCdValues, &level, 0, NULL, NULL) != H5Z_FILTER_DEFLATE)
+  {
+    return 0;
+  }
+
+  hid_t sid = H5Screate_simple(1, &numValues, NULL);
+  if (sid < 0)
+  {
+    return -1;
+  }
+  hid_t did = H5Dcreate(fp, name.c_str(), memType, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+  H5Sclose(sid);
+  if (did < 0)
+  {
+    return -1;
+  }
+  H5Vtk::H5IOStatistics::objectOpened();
+
+  // Two sets of slots, compressed into and stored from in turns
+  hsize_t batch = static_cast<hsize_t>(numThreads) * H5VtkChunksPerThread;
+  std::vector<H5VtkChunkSlot> slots(static_cast<size_t>(2 * batch));
+  H5VtkChunkRound round;
+  round.datasetId = did;
+  round.data = static_cast<const unsigned char*>(data);
+  round.typeSize = H5Tget_size(memType);
+  round.numValues = numValues;
+  round.chunkValues = chunkValues;
+  round.level = static_cast<int>(level);
+  round.numWorkers = numThreads;
+  round.slots = &slots;
+  round.writeError = 0;
+
+  vtkSmartPointer<vtkMultiThreader> threader = vtkSmartPointer<vtkMultiThreader>::New();
+  threader->SetNumberOfThreads(numThreads + 1);
+  threader->SetSingleMethod(H5VtkChunkRoundExecute, &round);
+  hsize_t numChunks = (numValues + chunkValues - 1) / chunkValues;
+  int result = 1;
+  for (hsize_t first = 0, r = 0; first < numChunks + batch; first += batch, ++r)
+  {
+    round.compressFirst = first;
+    round.compressCount = (first < numChunks) ? std::min(batch, numChunks - first) : 0;
+    round.compressSlot = static_cast<size_t>((r % 2) * batch);
+    round.writeFirst = first - batch;
+    round.writeCount = (r > 0) ? std::min(batch, numChunks - round.writeFirst) : 0;
+    round.writeSlot = static_cast<size_t>(((r + 1) % 2) * batch);
+    threader->SingleMethodExecute();
+    if (round.writeError < 0)
+    {
+      std::cout << "Error writing a chunk of " << name << std::endl;
+      result = -1;
+      break;
+    }
+    for (hsize_t c = 0; c < round.compressCount && result > 0; ++c)
+    {
+      if (slots[round.compressSlot + c].size < 0)
+      {
+        std::cout << "Error compressing a chunk of " << name << std::endl;
+        result = -1;
+      }
+    }
+    if (result < 0)
+    {
+      break;
+    }
+  }
+  if (result > 0)
+  {
+    H5Vtk::H5IOStatistics::bytesWritten(numValues * round.typeSize);
+  }
+  if (H5Dclose(did) < 0)
+  {
+    std::cout << "Error Closing Dataset." << std::endl;
+    result = -1;
+  }
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5DataWriter::SetArrayLossyCompression(const char* name, int mode, double errorBound)
+{
+  if (NULL == name || mode < VTK_H5_LOSSY_NONE || mode > VTK_H5_LOSSY_ZFP || errorBound < 0.0)
+  {
+    vtkErrorMacro(<< "Invalid lossy compression " << mode << " with error bound " << errorBound);
+    return;
+  }
+  this->ArrayLossyCompression[name] = std::make_pair(mode, errorBound);
+  this->Modified();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5DataWriter::RemoveAllArrayLossyCompression()
+{
+  if (!this->ArrayLossyCompression.empty())
+  {
+    this->ArrayLossyCompression.clear();
+    this->Modified();
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -110,21 +495,39 @@ int vtkH5DataWriter::WriteDatasetArrays(hid_t parentId, vtkDataSet* ds,
   H5G_CREATE_GROUP(fp, parentId, groupName, 1, 0)
   if (fp < 0)
   {
-    return -1;
+    return 0;
   }
 
+  int codec = (strcmp(groupName, H5_CELL_DATA_GROUP_NAME) == 0) ? this->CellDataCompression
+                                                                : this->PointDataCompression;
   // Loop on all the arrays for the Point Data and write them to the HDF5 file
   vtkAbstractArray* array = NULL;
   int nArrays = pd->GetNumberOfArrays();
   for (int i = 0; i < nArrays; ++i)
   {
     array = pd->GetAbstractArray(i);
+    int encoded = this->WriteEncodedArray(fp, pd, array, numPts);
+    if (encoded == 0)
+    {
+      encoded = this->WriteLossyArray(fp, array, numPts, codec);
+    }
+    if (encoded < 0)
+    {
+      std::cout << "Error writing data set attribute " << array->GetName() << std::endl;
+      H5Gclose(fp);
+      return 0;
+    }
+    if (encoded > 0)
+    {
+      continue;
+    }
     err = this->WriteArray(fp, array->GetDataType(), array,
                      array->GetName(),
-                     numPts, array->GetNumberOfComponents() );
+                     numPts, array->GetNumberOfComponents(), codec );
     if (err == 0)
     {
       std::cout << "Error writing data set attribute " << array->GetName() << std::endl;
+      H5Gclose(fp);
       return err;
     }
   }
@@ -132,93 +535,432 @@ int vtkH5DataWriter::WriteDatasetArrays(hid_t parentId, vtkDataSet* ds,
 
   /* We are NOT going to iterate on the "Field Data" because the above loop
    * will capture ALL the Field Data Arrays that are assigned as attributes to
-   * the current data set. Then below we will interrogate each of the specific
-   * types of Data Set attributes (scalars, vectors, normals, etc... ) and set
-   * and HDF5 attribute onto the Group stating the name of the array for each
-   * valid Active* array.
+   * the current data set. WriteActiveAttributeNames() records which of them
+   * are the active scalars, vectors, normals, etc...
    */
+  if (this->WriteActiveAttributeNames(parentId, pd, groupName) == 0)
+  {
+    H5Gclose(fp);
+    return 0;
+  }
+
+  err = H5Gclose(fp); if (err < 0) { err = 0; } else { err = 1; } // Because HDF5 returns 0 to indicate NO_ERROR, but we need to return 0 ON error
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+  template<typename T>
+  herr_t H5VtkWriteEncodedArray(hid_t fp, const std::string &name, T* data, vtkIdType num,
+                                vtkTypeInt32 numComp, const char* encoding)
+  {
+    vtkTypeInt32 rank = 1;
+    vtkTypeUInt64 dims[1] = { static_cast<vtkTypeUInt64>(num) * numComp };
+    herr_t err = H5Vtk::H5Lite::writePointerDataset(fp, name, rank, dims, data);
+    if (err >= 0)
+    {
+      err = H5Vtk::H5Lite::writeScalarAttribute(fp, name, std::string(H5_NUMCOMPONENTS), numComp);
+    }
+    if (err >= 0)
+    {
+      err = H5Vtk::H5Lite::writeStringAttribute(fp, name, H5_ENCODING, encoding);
+    }
+    return err;
+  }
+
+  template<typename T>
+  herr_t H5VtkWriteSymmetricTensors(hid_t fp, const std::string &name, const T* tensors, vtkIdType num)
+  {
+    if (!H5Vtk::H5ArrayEncoding::isSymmetric(tensors, num))
+    {
+      return 0;
+    }
+    std::vector<T> packed(static_cast<size_t>(num) * 6);
+    H5Vtk::H5ArrayEncoding::packSymmetric(tensors, num, &packed[0]);
+    herr_t err = H5VtkWriteEncodedArray(fp, name, &packed[0], num, 6, H5_ENCODING_SYMMETRIC_TENSOR);
+    return (err < 0) ? -1 : 1;
+  }
+
+  template<typename T>
+  herr_t H5VtkWriteOctahedralNormals(hid_t fp, const std::string &name, const T* normals, vtkIdType num,
+                                     vtkTypeInt32 dataType)
+  {
+    std::vector<uint16_t> encoded(static_cast<size_t>(num) * 2);
+    H5Vtk::H5ArrayEncoding::encodeOctahedral(normals, num, &encoded[0]);
+    herr_t err = H5VtkWriteEncodedArray(fp, name, &encoded[0], num, 2, H5_ENCODING_OCTAHEDRAL);
+    if (err >= 0)
+    {
+      err = H5Vtk::H5Lite::writeScalarAttribute(fp, name, H5_ENCODED_DATA_TYPE, dataType);
+    }
+    return (err < 0) ? -1 : 1;
+  }
+
+  template<typename T>
+  herr_t H5VtkWriteLossyArray(hid_t fp, const std::string &name, T* values, size_t numValues,
+                              vtkTypeInt32 numComp, int mode, double bound, bool relative,
+                              int codec, int level)
+  {
+    double maxMagnitude = H5Vtk::H5Compression::getMaximumMagnitude(values, numValues);
+    if (!(maxMagnitude > 0.0))
+    {
+      return 0; // Only zeros or no finite values, nothing to gain
+    }
+    double absBound = relative ? bound * maxMagnitude : bound;
+    if (!(absBound > 0.0))
+    {
+      return 0;
+    }
+    hid_t dcpl = H5Vtk::H5Compression::createChunkedProperties(numValues, numComp);
+    if (dcpl < 0)
+    {
+      return -1;
+    }
+    std::vector<T> rounded;
+    T* out = values;
+    const char* modeName = H5_LOSSY_SCALE_OFFSET;
+    herr_t err = 0;
+    switch (mode)
+    {
+      case VTK_H5_LOSSY_BIT_ROUND:
+      {
+        int kept = H5Vtk::H5Compression::getKeptMantissaBits(absBound / maxMagnitude, sizeof(T) == sizeof(double));
+        rounded.assign(values, values + numValues);
+        H5Vtk::H5Compression::roundMantissa(&rounded[0], numValues, kept);
+        out = &rounded[0];
+        absBound = maxMagnitude * H5Vtk::H5Compression::getBitRoundError(kept);
+        modeName = H5_LOSSY_BIT_ROUND;
+        // The rounded values still need a lossless codec to take less space
+        err = (codec != VTK_H5_CODEC_NONE) ? H5Vtk::H5Compression::setCodec(dcpl, codec, level)
+                                           : H5Vtk::H5Compression::setShuffleDeflate(dcpl, level);
+        break;
+      }
+      case VTK_H5_LOSSY_ZFP:
+        modeName = H5_LOSSY_ZFP;
+        err = H5Vtk::H5Compression::setZfpAccuracy(dcpl, absBound);
+        break;
+      default:
+        err = H5Vtk::H5Compression::setScaleOffset(dcpl, absBound);
+        break;
+    }
+    hsize_t dims[1] = { static_cast<hsize_t>(numValues) };
+    if (err >= 0)
+    {
+      err = H5Vtk::H5Lite::writeFilteredPointerDataset(fp, name, 1, dims, dcpl, out);
+    }
+    H5Pclose(dcpl);
+    if (err >= 0)
+    {
+      err = H5Vtk::H5Lite::writeScalarAttribute(fp, name, std::string(H5_NUMCOMPONENTS), numComp);
+    }
+    if (err >= 0)
+    {
+      err = H5Vtk::H5Lite::writeStringAttribute(fp, name, H5_LOSSY_COMPRESSION, modeName);
+    }
+    if (err >= 0)
+    {
+      err = H5Vtk::H5Lite::writeScalarAttribute(fp, name, std::string(H5_ERROR_BOUND), absBound);
+    }
+    if (err >= 0 && relative)
+    {
+      err = H5Vtk::H5Lite::writeScalarAttribute(fp, name, std::string(H5_RELATIVE_ERROR_BOUND), bound);
+    }
+    return (err < 0) ? -1 : 1;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataWriter::WriteLossyArray(hid_t fp, vtkAbstractArray* array, int num, int codec)
+{
+  vtkDataArray* data = vtkDataArray::SafeDownCast(array);
+  vtkTypeInt32 dataType = array->GetDataType();
+  if (NULL == data || NULL == array->GetName() || num < 1
+      || (dataType != VTK_FLOAT && dataType != VTK_DOUBLE))
+  {
+    return 0;
+  }
+  int mode = this->LossyCompression;
+  double bound = this->ErrorBound;
+  std::map<std::string, std::pair<int, double> >::const_iterator iter = this->ArrayLossyCompression.find(array->GetName());
+  if (iter != this->ArrayLossyCompression.end())
+  {
+    mode = iter->second.first;
+    bound = iter->second.second;
+  }
+  if (mode == VTK_H5_LOSSY_NONE || !(bound > 0.0))
+  {
+    return 0;
+  }
+  if (codec == VTK_H5_CODEC_AUTO)
+  {
+    codec = VTK_H5_CODEC_NONE; // The lossy modes bring their own filters
+  }
+  if (mode == VTK_H5_LOSSY_ZFP && !H5Vtk::H5Compression::isFilterAvailable(H5Z_FILTER_ZFP))
+  {
+    vtkWarningMacro(<< "The ZFP filter is not available, writing " << array->GetName() << " with scale-offset");
+    mode = VTK_H5_LOSSY_SCALE_OFFSET;
+  }
+  if (mode == VTK_H5_LOSSY_BIT_ROUND && codec != VTK_H5_CODEC_NONE
+      && !H5Vtk::H5Compression::isFilterAvailable(H5Vtk::H5Compression::getCodecFilter(codec)))
+  {
+    vtkWarningMacro(<< "The " << H5Vtk::H5Compression::getCodecName(codec)
+                    << " filter is not available, deflating " << array->GetName());
+    codec = VTK_H5_CODEC_NONE;
+  }
+  H5Z_filter_t filter = H5Z_FILTER_NONE;
+  if (mode == VTK_H5_LOSSY_SCALE_OFFSET)
+  {
+    filter = H5Z_FILTER_SCALEOFFSET;
+  }
+  else if (mode == VTK_H5_LOSSY_BIT_ROUND && codec == VTK_H5_CODEC_NONE)
+  {
+    filter = H5Z_FILTER_DEFLATE;
+  }
+  if (filter != H5Z_FILTER_NONE && !H5Vtk::H5Compression::isFilterAvailable(filter))
+  {
+    vtkWarningMacro(<< "The HDF5 library lacks the filter " << filter << ", writing " << array->GetName() << " losslessly");
+    return 0;
+  }
+  std::string name(array->GetName());
+  size_t numValues = static_cast<size_t>(num) * data->GetNumberOfComponents();
+  vtkTypeInt32 numComp = data->GetNumberOfComponents();
+  bool relative = (this->RelativeErrorBound != 0);
+  if (dataType == VTK_FLOAT)
+  {
+    return H5VtkWriteLossyArray(fp, name, static_cast<float*>(data->GetVoidPointer(0)), numValues,
+                                numComp, mode, bound, relative, codec, this->CompressionLevel);
+  }
+  return H5VtkWriteLossyArray(fp, name, static_cast<double*>(data->GetVoidPointer(0)), numValues,
+                              numComp, mode, bound, relative, codec, this->CompressionLevel);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataWriter::WriteEncodedArray(hid_t fp, vtkDataSetAttributes* pd, vtkAbstractArray* array, int num)
+{
+  vtkDataArray* data = vtkDataArray::SafeDownCast(array);
+  vtkTypeInt32 dataType = array->GetDataType();
+  if (NULL == data || NULL == array->GetName() || num < 1
+      || (dataType != VTK_FLOAT && dataType != VTK_DOUBLE))
+  {
+    return 0;
+  }
+  std::string name(array->GetName());
+  bool isFloat = (dataType == VTK_FLOAT);
+  if (this->SymmetricTensors && data == pd->GetTensors() && data->GetNumberOfComponents() == 9)
+  {
+    return isFloat ? H5VtkWriteSymmetricTensors(fp, name, static_cast<float*>(data->GetVoidPointer(0)), num)
+                   : H5VtkWriteSymmetricTensors(fp, name, static_cast<double*>(data->GetVoidPointer(0)), num);
+  }
+  if (this->OctahedralNormals && data == pd->GetNormals() && data->GetNumberOfComponents() == 3)
+  {
+    return isFloat ? H5VtkWriteOctahedralNormals(fp, name, static_cast<float*>(data->GetVoidPointer(0)), num, dataType)
+                   : H5VtkWriteOctahedralNormals(fp, name, static_cast<double*>(data->GetVoidPointer(0)), num, dataType);
+  }
+  return 0;
+}
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataWriter::WriteActiveAttributeNames(hid_t parentId, vtkDataSetAttributes* pd, const char* groupName)
+{
+  herr_t err = 1;
   // Now Write the names of the "Active*" as HDF5 attributes to the group
   vtkDataArray* scalars = pd->GetScalars();
   if(scalars && scalars->GetNumberOfTuples() > 0)
   {
     err = H5Vtk::H5Lite::writeStringAttribute(parentId, groupName, H5_ACTIVE_SCALARS, scalars->GetName() );
-    if (err < 0) { err = 0; } else { err = 1;}
+    if (err < 0) { return 0; }
   }
 
   vtkDataArray* vectors = pd->GetVectors();
   if(vectors && vectors->GetNumberOfTuples() > 0)
   {
     err = H5Vtk::H5Lite::writeStringAttribute(parentId, groupName, H5_ACTIVE_VECTORS, vectors->GetName() );
-    if (err < 0) { err = 0; } else { err = 1;}
+    if (err < 0) { return 0; }
   }
 
   vtkDataArray* normals = pd->GetNormals();
   if(normals && normals->GetNumberOfTuples() > 0)
   {
     err = H5Vtk::H5Lite::writeStringAttribute(parentId, groupName, H5_ACTIVE_NORMALS, normals->GetName() );
-    if (err < 0) { err = 0; } else { err = 1;}
+    if (err < 0) { return 0; }
   }
 
   vtkDataArray* tcoords = pd->GetTCoords();
   if(tcoords && tcoords->GetNumberOfTuples() > 0)
   {
     err = H5Vtk::H5Lite::writeStringAttribute(parentId, groupName, H5_ACTIVE_TEXTURE_COORDINATES, tcoords->GetName() );
-    if (err < 0) { err = 0; } else { err = 1;}
+    if (err < 0) { return 0; }
   }
 
   vtkDataArray* tensors = pd->GetTensors();
   if(tensors && tensors->GetNumberOfTuples() > 0)
   {
     err = H5Vtk::H5Lite::writeStringAttribute(parentId, groupName, H5_ACTIVE_TENSORS, tensors->GetName() );
-    if (err < 0) { err = 0; } else { err = 1;}
+    if (err < 0) { return 0; }
   }
 
   vtkDataArray* globalIds = pd->GetGlobalIds();
   if(globalIds && globalIds->GetNumberOfTuples() > 0)
   {
     err = H5Vtk::H5Lite::writeStringAttribute(parentId, groupName, H5_ACTIVE_GLOBAL_IDS, globalIds->GetName() );
-    if (err < 0) { err = 0; } else { err = 1;}
+    if (err < 0) { return 0; }
   }
 
   vtkAbstractArray* pedigreeIds = pd->GetPedigreeIds();
   if(pedigreeIds && pedigreeIds->GetNumberOfTuples() > 0)
   {
     err = H5Vtk::H5Lite::writeStringAttribute(parentId, groupName, H5_ACTIVE_PEDIGREE_IDS, pedigreeIds->GetName() );
-    if (err < 0) { err = 0; } else { err = 1;}
+    if (err < 0) { return 0; }
   }
 
-  err = H5Gclose(fp); if (err < 0) { err = 0; } else { err = 1; } // Because HDF5 returns 0 to indicate NO_ERROR, but we need to return 0 ON error
-  return err;
+  return 1;
 }
 
-
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-
-int vtkH5DataWriter::WriteCells(hid_t fp, vtkCellArray *cells, const char *label)
+int vtkH5DataWriter::WriteStructuredArrays(hid_t parentId, vtkDataSetAttributes* pd,
+                                           const int dims[3], int chunkSize, const char* groupName)
 {
-  // std::cout << "   vtkH5DataWriter::WriteCells()" << std::endl;
-  if ( ! cells )
-    {
-    return 1;
-    }
+  vtkDebugMacro(<<"Writing " << groupName << " data...");
 
-  int ncells=cells->GetNumberOfCells();
-  int size=cells->GetNumberOfConnectivityEntries();
+  H5G_CREATE_GROUP(fp, parentId, groupName, 1, 0)
+
+  int nArrays = pd->GetNumberOfArrays();
+  for (int i = 0; i < nArrays; ++i)
+  {
+    vtkDataArray* array = pd->GetArray(i);
+    if (NULL == array)
+    {
+      // String and variant arrays have no meaningful chunked layout
+      vtkWarningMacro(<< "Skipping array " << pd->GetAbstractArray(i)->GetName() << " which is not a data array");
+      continue;
+    }
+    if (this->WriteChunkedArray(fp, array->GetName(), array, dims, chunkSize) < 0)
+    {
+      H5Gclose(fp);
+      return 0;
+    }
+  }
+  if (this->WriteActiveAttributeNames(parentId, pd, groupName) == 0)
+  {
+    H5Gclose(fp);
+    return 0;
+  }
+
+  herr_t err = H5Gclose(fp); if (err < 0) { err = 0; } else { err = 1; } // Because HDF5 returns 0 to indicate NO_ERROR, but we need to return 0 ON error
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataWriter::WriteChunkedArray(hid_t parentId, const char* dsetName, vtkDataArray* data,
+                                       const int dims[3], int chunkSize)
+{
+  int numComp = data->GetNumberOfComponents();
+  hsize_t shape[4] = { static_cast<hsize_t>(dims[2]), static_cast<hsize_t>(dims[1]),
+                       static_cast<hsize_t>(dims[0]), static_cast<hsize_t>(numComp) };
+  hsize_t chunk[4] = { static_cast<hsize_t>(chunkSize), static_cast<hsize_t>(chunkSize),
+                       static_cast<hsize_t>(chunkSize), static_cast<hsize_t>(numComp) };
+  int rank = (numComp > 1) ? 4 : 3;
+  if (static_cast<hsize_t>(data->GetNumberOfTuples()) != shape[0] * shape[1] * shape[2])
+  {
+    vtkErrorMacro(<< "Array " << dsetName << " has " << data->GetNumberOfTuples()
+                  << " tuples but the extent has " << shape[0] * shape[1] * shape[2]);
+    return -1;
+  }
+  void* ptr = data->GetNumberOfTuples() > 0 ? data->GetVoidPointer(0) : NULL;
+  switch (data->GetDataType())
+  {
+    case VTK_FLOAT:
+      return vtkWriteChunkedDataArray(parentId, static_cast<float*>(ptr), dsetName, rank, shape, chunk, numComp);
+    case VTK_DOUBLE:
+      return vtkWriteChunkedDataArray(parentId, static_cast<double*>(ptr), dsetName, rank, shape, chunk, numComp);
+    case VTK_CHAR:
+    case VTK_SIGNED_CHAR:
+      return vtkWriteChunkedDataArray(parentId, static_cast<int8_t*>(ptr), dsetName, rank, shape, chunk, numComp);
+    case VTK_UNSIGNED_CHAR:
+      return vtkWriteChunkedDataArray(parentId, static_cast<uint8_t*>(ptr), dsetName, rank, shape, chunk, numComp);
+    case VTK_SHORT:
+      return vtkWriteChunkedDataArray(parentId, static_cast<int16_t*>(ptr), dsetName, rank, shape, chunk, numComp);
+    case VTK_UNSIGNED_SHORT:
+      return vtkWriteChunkedDataArray(parentId, static_cast<uint16_t*>(ptr), dsetName, rank, shape, chunk, numComp);
+    case VTK_INT:
+      return vtkWriteChunkedDataArray(parentId, static_cast<int32_t*>(ptr), dsetName, rank, shape, chunk, numComp);
+    case VTK_UNSIGNED_INT:
+      return vtkWriteChunkedDataArray(parentId, static_cast<uint32_t*>(ptr), dsetName, rank, shape, chunk, numComp);
+    default:
+      break;
+  }
+  // The remaining integer types (long, long long, __int64, vtkIdType) only
+  // differ by their size on the platform
+  bool isUnsigned = (data->GetDataType() == VTK_UNSIGNED_LONG
+#if defined(VTK_TYPE_USE_LONG_LONG)
+                     || data->GetDataType() == VTK_UNSIGNED_LONG_LONG
+#endif
+#if defined(VTK_TYPE_USE___INT64)
+                     || data->GetDataType() == VTK_UNSIGNED___INT64
+#endif
+                    );
+  switch (data->GetDataTypeSize())
+  {
+    case 4:
+      if (isUnsigned) { return vtkWriteChunkedDataArray(parentId, static_cast<uint32_t*>(ptr), dsetName, rank, shape, chunk, numComp); }
+      return vtkWriteChunkedDataArray(parentId, static_cast<int32_t*>(ptr), dsetName, rank, shape, chunk, numComp);
+    case 8:
+      if (isUnsigned) { return vtkWriteChunkedDataArray(parentId, static_cast<uint64_t*>(ptr), dsetName, rank, shape, chunk, numComp); }
+      return vtkWriteChunkedDataArray(parentId, static_cast<int64_t*>(ptr), dsetName, rank, shape, chunk, numComp);
+    default:
+      break;
+  }
+  vtkErrorMacro(<< "Array " << dsetName << " has an unsupported data type " << data->GetDataTypeAsString());
+  return -1;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+
+int vtkH5DataWriter::WriteCells(hid_t fp, vtkCellArray *cells, const char *label, bool useCodec)
+{
+  // std::cout << "   vtkH5DataWriter::WriteCells()" << std::endl;
+  if ( ! cells )
+    {
+    return 1;
+    }
+
+  int ncells=cells->GetNumberOfCells();
+  int size=cells->GetNumberOfConnectivityEntries();
 
   if ( ncells < 1 )
     {
     return 1;
     }
   vtkIdType *tempArray = cells->GetPointer();
-  vtkTypeInt32 rank =1;
-  vtkTypeUInt64 dims[1] = {size};
-  herr_t err = H5Vtk::H5Lite::writePointerDataset(fp, label, rank, dims, tempArray);
+  herr_t err = 0;
+  if (this->ConnectivityCodec && useCodec)
+  {
+    err = H5Vtk::H5ConnectivityCodec::writeCells(fp, label, tempArray, ncells, size);
+  }
+  else
+  {
+    err = this->vtkWriteCompressedDataset(fp, label, static_cast<hsize_t>(size), tempArray,
+                                          this->ConnectivityCompression, 1);
+  }
   if (err < 0)
   {
-    // std::cout << "Error Writing Vertices." << std::endl;
+    std::cout << "Error writing cells with name: " << label << std::endl;
+    return err;
   }
   err = H5Vtk::H5Lite::writeScalarAttribute(fp, label, "Number Of Cells", ncells);
 
@@ -241,10 +983,12 @@ int vtkH5DataWriter::WritePoints(hid_t fp, vtkPoints *points)
 
   numPts=points->GetNumberOfPoints();
 
-  int err = this->WriteArray(fp, points->GetDataType(), points->GetData(), H5_POINTS, numPts, 3);
+  int err = this->WriteArray(fp, points->GetDataType(), points->GetData(), H5_POINTS, numPts, 3,
+                             this->PointsCompression);
   if (err != 1)
   {
-    // std::cout << "Error Writing Points Array" << std::endl;
+    std::cout << "Error writing the points" << std::endl;
+    return -1;
   }
   //Write the attributes to the dataset
   vtkTypeInt32 numComp = 3;
@@ -256,6 +1000,88 @@ int vtkH5DataWriter::WritePoints(hid_t fp, vtkPoints *points)
   return err;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataWriter::WriteStructuredPoints(hid_t fp, vtkPoints *points, const int dims[3], int chunkSize)
+{
+  if (points == NULL)
+    {
+    return 1;
+    }
+  return this->WriteChunkedArray(fp, H5_POINTS, points->GetData(), dims, chunkSize);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataWriter::WriteCoordinates(hid_t fp, vtkDataArray *coords, int axes)
+{
+  const char* names[3] = { H5_X_COORDINATES, H5_Y_COORDINATES, H5_Z_COORDINATES };
+  if (axes < 0 || axes > 2)
+  {
+    vtkErrorMacro(<< "Invalid coordinate axis " << axes);
+    return 0;
+  }
+  if (coords == NULL)
+  {
+    return 1;
+  }
+  int numTuples = coords->GetNumberOfTuples();
+  if (numTuples < 1)
+  {
+    return 1;
+  }
+  return this->WriteArray(fp, coords->GetDataType(), coords, names[axes], numTuples, 1);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataWriter::WriteWholeExtent(hid_t fileId, const char* hdfPath, const int extent[6])
+{
+  vtkTypeInt32 wholeExtent[6];
+  for (int i = 0; i < 6; ++i)
+  {
+    wholeExtent[i] = extent[i];
+  }
+  hsize_t attrDims[1] = { 6 };
+  return H5Vtk::H5Lite::writePointerAttribute(fileId, hdfPath, H5_WHOLE_EXTENT, 1, attrDims, wholeExtent);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataWriter::WriteStructuredData(hid_t fp, vtkDataSet* ds, const int dims[3], int chunkSize)
+{
+  vtkFieldData* field = ds->GetFieldData();
+  if (field && field->GetNumberOfTuples() > 0)
+  {
+    if (!this->WriteFieldData(fp, field))
+    {
+      return 0; // we tried to write field data, but we couldn't
+    }
+  }
+
+  int cellDims[3];
+  for (int i = 0; i < 3; ++i)
+  {
+    // Flat axes still hold one layer of cells
+    cellDims[i] = (dims[i] > 1) ? dims[i] - 1 : 1;
+  }
+  if (ds->GetNumberOfCells() > 0
+      && this->WriteStructuredArrays(fp, ds->GetCellData(), cellDims, chunkSize, H5_CELL_DATA_GROUP_NAME) == 0)
+  {
+    return 0;
+  }
+  if (ds->GetNumberOfPoints() > 0
+      && this->WriteStructuredArrays(fp, ds->GetPointData(), dims, chunkSize, H5_POINT_DATA_GROUP_NAME) == 0)
+  {
+    return 0;
+  }
+  return 1;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -294,6 +1120,11 @@ int vtkH5DataWriter::WriteFieldData(hid_t parentGroup, vtkFieldData *f)
  // hid_t fp = H5Gcreate(parentGroup, H5_FIELD_DATA_GROUP_NAME, numArrays);
   H5G_CREATE_GROUP(fp, parentGroup, H5_FIELD_DATA_GROUP_NAME, 1, 0)
   err = H5Vtk::H5Lite::writeStringAttribute(parentGroup, H5_FIELD_DATA_GROUP_NAME, H5_NAME, H5_FIELD_DATA_DEFAULT);
+  if (err < 0)
+  {
+    H5Gclose(fp);
+    return 0;
+  }
 
   for (i = 0; i < numArrays; i++)
   {
@@ -319,8 +1150,13 @@ int vtkH5DataWriter::WriteFieldData(hid_t parentGroup, vtkFieldData *f)
           this->EncodeString(buffer, array->GetName(), true);
         }
         // sprintf(format, "%s %d %d %s\n", buffer, numComp, numTuples, "%s");
-        this->WriteArray(fp, array->GetDataType(), array, buffer, numTuples, numComp);
+        int written = this->WriteArray(fp, array->GetDataType(), array, buffer, numTuples, numComp);
         delete[] buffer;
+        if (written == 0)
+        {
+          H5Gclose(fp);
+          return 0;
+        }
       }
 
     }
@@ -336,10 +1172,10 @@ int vtkH5DataWriter::WriteFieldData(hid_t parentGroup, vtkFieldData *f)
 // -----------------------------------------------------------------------------
 // Write out data to file specified.
 int vtkH5DataWriter::WriteArray(hid_t fp, int dataType, vtkAbstractArray *data,
-                                const char *dsetName, int num, int numComp)
+                                const char *dsetName, int num, int numComp, int codec)
 {
   // std::cout << "    vtkH5DataWriter::WriteArray()" << std::endl;
-  int i;
+  herr_t err = 0;
 
   //char* outputFormat = new char[10];
   switch (dataType)
@@ -348,7 +1184,7 @@ int vtkH5DataWriter::WriteArray(hid_t fp, int dataType, vtkAbstractArray *data,
       {
         {
         unsigned char *cptr= static_cast<vtkUnsignedCharArray*>(data)->GetPointer(0);
-        vtkWriteDataArray(fp, reinterpret_cast<char *>(cptr), dsetName, (sizeof(unsigned char))*((num-1)/8+1), 1);
+        err = vtkWriteDataArray(fp, reinterpret_cast<char *>(cptr), dsetName, (sizeof(unsigned char))*((num-1)/8+1), 1, codec);
         }
       }
     break;
@@ -356,7 +1192,7 @@ int vtkH5DataWriter::WriteArray(hid_t fp, int dataType, vtkAbstractArray *data,
     case VTK_CHAR:
       {
        char *s=static_cast<vtkCharArray *>(data)->GetPointer(0);
-      vtkWriteDataArray(fp, s, dsetName, num, numComp);
+      err = vtkWriteDataArray(fp, s, dsetName, num, numComp, codec);
       }
     break;
 
@@ -364,7 +1200,7 @@ int vtkH5DataWriter::WriteArray(hid_t fp, int dataType, vtkAbstractArray *data,
       {
 
       unsigned char *s= static_cast<vtkUnsignedCharArray *>(data)->GetPointer(0);
-      vtkWriteDataArray(fp, s , dsetName, num, numComp);
+      err = vtkWriteDataArray(fp, s , dsetName, num, numComp, codec);
       }
     break;
 
@@ -372,7 +1208,7 @@ int vtkH5DataWriter::WriteArray(hid_t fp, int dataType, vtkAbstractArray *data,
       {
 
       short *s=static_cast<vtkShortArray *>(data)->GetPointer(0);
-      vtkWriteDataArray(fp, s , dsetName, num, numComp);
+      err = vtkWriteDataArray(fp, s , dsetName, num, numComp, codec);
       }
     break;
 
@@ -380,35 +1216,35 @@ int vtkH5DataWriter::WriteArray(hid_t fp, int dataType, vtkAbstractArray *data,
       {
 
       unsigned short *s= static_cast<vtkUnsignedShortArray *>(data)->GetPointer(0);
-      vtkWriteDataArray(fp, s , dsetName, num, numComp);
+      err = vtkWriteDataArray(fp, s , dsetName, num, numComp, codec);
       }
     break;
 
     case VTK_INT:
       {
       int *s=static_cast<vtkIntArray *>(data)->GetPointer(0);
-      vtkWriteDataArray(fp, s , dsetName, num, numComp);
+      err = vtkWriteDataArray(fp, s , dsetName, num, numComp, codec);
       }
     break;
 
     case VTK_UNSIGNED_INT:
       {
       unsigned int *s=static_cast<vtkUnsignedIntArray *>(data)->GetPointer(0);
-      vtkWriteDataArray(fp, s , dsetName, num, numComp);
+      err = vtkWriteDataArray(fp, s , dsetName, num, numComp, codec);
       }
     break;
 
     case VTK_LONG:
       {
       long *s=static_cast<vtkLongArray *>(data)->GetPointer(0);
-      vtkWriteDataArray(fp, s , dsetName, num, numComp);
+      err = vtkWriteDataArray(fp, s , dsetName, num, numComp, codec);
       }
     break;
 
     case VTK_UNSIGNED_LONG:
       {
       unsigned long *s= static_cast<vtkUnsignedLongArray *>(data)->GetPointer(0);
-      vtkWriteDataArray(fp, s , dsetName, num, numComp);
+      err = vtkWriteDataArray(fp, s , dsetName, num, numComp, codec);
       }
     break;
 
@@ -417,7 +1253,7 @@ int vtkH5DataWriter::WriteArray(hid_t fp, int dataType, vtkAbstractArray *data,
       {
 
       __int64_t *s= static_cast<__int64_t*>(data->GetVoidPointer(0));
-      vtkWriteDataArray(fp, s , dsetName, num, numComp);
+      err = vtkWriteDataArray(fp, s , dsetName, num, numComp, codec);
       }
     break;
 
@@ -425,7 +1261,7 @@ int vtkH5DataWriter::WriteArray(hid_t fp, int dataType, vtkAbstractArray *data,
       {
 
       unsigned __int64_t *s=  static_cast<unsigned __int64_t*>(data->GetVoidPointer(0));
-      vtkWriteDataArray(fp, s , dsetName, num, numComp);
+      err = vtkWriteDataArray(fp, s , dsetName, num, numComp, codec);
       }
     break;
 #endif
@@ -435,7 +1271,7 @@ int vtkH5DataWriter::WriteArray(hid_t fp, int dataType, vtkAbstractArray *data,
       {
 
       long long *s= static_cast<long long*>(data->GetVoidPointer(0));
-      vtkWriteDataArray(fp, s , dsetName, num, numComp);
+      err = vtkWriteDataArray(fp, s , dsetName, num, numComp, codec);
       }
     break;
 
@@ -444,7 +1280,7 @@ int vtkH5DataWriter::WriteArray(hid_t fp, int dataType, vtkAbstractArray *data,
 
       unsigned long long *s=
         static_cast<unsigned long long*>(data->GetVoidPointer(0));
-      vtkWriteDataArray(fp, s , dsetName, num, numComp);
+      err = vtkWriteDataArray(fp, s , dsetName, num, numComp, codec);
       }
     break;
 #endif
@@ -453,7 +1289,7 @@ int vtkH5DataWriter::WriteArray(hid_t fp, int dataType, vtkAbstractArray *data,
       {
 
       float *s=static_cast<vtkFloatArray *>(data)->GetPointer(0);
-      vtkWriteDataArray(fp, s , dsetName, num, numComp);
+      err = vtkWriteDataArray(fp, s , dsetName, num, numComp, codec);
       }
     break;
 
@@ -461,69 +1297,26 @@ int vtkH5DataWriter::WriteArray(hid_t fp, int dataType, vtkAbstractArray *data,
       {
 
       double *s=static_cast<vtkDoubleArray *>(data)->GetPointer(0);
-      vtkWriteDataArray(fp, s , dsetName, num, numComp);
+      err = vtkWriteDataArray(fp, s , dsetName, num, numComp, codec);
       }
     break;
 
-    //TODO: Write the correct type in all conditions for vtkIdType
     case VTK_ID_TYPE:
       {
-      // currently writing vtkIdType as int.
-      int size = data->GetNumberOfTuples();
-      int *intArray = new int[size*numComp];
+      // Written at the full width of vtkIdType, ids of more than 2^31 points
+      // or cells do not fit into int
       vtkIdType *s=static_cast<vtkIdTypeArray *>(data)->GetPointer(0);
-      for (i = 0; i < size*numComp; i++)
-        {
-        intArray[i] = s[i];
-        }
-      vtkWriteDataArray(fp, intArray, dsetName, num, numComp);
-      delete [] intArray;
+      err = vtkWriteDataArray(fp, s, dsetName, num, numComp, codec);
       }
     break;
-    //TODO: Write a String data set
-#if 0
     case VTK_STRING:
       {
-
+      if (this->WriteStringArray(fp, static_cast<vtkStringArray *>(data), dsetName, num, numComp) == 0)
         {
-        vtkStdString s;
-        for (j=0; j<num; j++)
-          {
-          for (i=0; i<numComp; i++)
-            {
-            idx = i + j*numComp;
-            s = static_cast<vtkStringArray *>(data)->GetValue(idx);
-            vtkTypeUInt64 length = s.length();
-            if (length < (static_cast<vtkTypeUInt64>(1) << 6))
-              {
-              vtkTypeUInt8 len = (static_cast<vtkTypeUInt8>(3) << 6)
-                | static_cast<vtkTypeUInt8>(length);
-              fp->write(reinterpret_cast<char*>(&len), 1);
-              }
-            else if (length < (static_cast<vtkTypeUInt64>(1) << 14))
-              {
-              vtkTypeUInt16 len = (static_cast<vtkTypeUInt16>(2) << 14)
-                | static_cast<vtkTypeUInt16>(length);
-              vtkByteSwap::SwapWrite2BERange(&len, 1, fp);
-              }
-            else if (length < (static_cast<vtkTypeUInt64>(1) << 30))
-              {
-              vtkTypeUInt32 len = (static_cast<vtkTypeUInt32>(1) << 30)
-                | static_cast<vtkTypeUInt32>(length);
-              vtkByteSwap::SwapWrite4BERange(&len, 1, fp);
-              }
-            else
-              {
-              vtkByteSwap::SwapWrite8BERange(&length, 1, fp);
-              }
-            fp->write(s.c_str(), length);
-            }
-          }
+        return 0;
         }
-      *fp << "\n";
       }
     break;
-#endif
 
 #if 0
     case VTK_VARIANT:
@@ -545,10 +1338,63 @@ int vtkH5DataWriter::WriteArray(hid_t fp, int dataType, vtkAbstractArray *data,
     }
   //delete[] outputFormat;
 
-  return 1;
+  return (err < 0) ? 0 : 1; // HDF5 returns a negative value on error, but we need to return 0 ON error
 }
 
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataWriter::WriteStringArray(hid_t fp, vtkStringArray* data, const char* dsetName,
+                                      int num, int numComp)
+{
+  vtkIdType numValues = static_cast<vtkIdType>(num) * numComp;
+  if (numValues > data->GetNumberOfValues())
+  {
+    numValues = data->GetNumberOfValues();
+  }
+
+  // Pack the strings back to back and remember where each one starts. String
+  // i is characters[offsets[i], offsets[i+1])
+  std::vector<int64_t> offsets(numValues + 1);
+  offsets[0] = 0;
+  for (vtkIdType i = 0; i < numValues; ++i)
+  {
+    offsets[i + 1] = offsets[i] + static_cast<int64_t>(data->GetValue(i).size());
+  }
+  std::vector<char> characters(static_cast<size_t>(offsets[numValues]) + 1, 0);
+  for (vtkIdType i = 0; i < numValues; ++i)
+  {
+    const vtkStdString &value = data->GetValue(i);
+    if (!value.empty())
+    {
+      ::memcpy(&(characters[static_cast<size_t>(offsets[i])]), value.data(), value.size());
+    }
+  }
+
+  H5G_CREATE_GROUP(gid, fp, dsetName, 1, 0)
+  vtkTypeInt32 rank = 1;
+  vtkTypeUInt64 dims[1] = { static_cast<vtkTypeUInt64>(offsets[numValues]) };
+  herr_t err = H5Vtk::H5Lite::writePointerDataset(gid, H5_STRING_CHARACTERS, rank, dims, &(characters.front()));
+  if (err >= 0)
+  {
+    dims[0] = static_cast<vtkTypeUInt64>(offsets.size());
+    err = H5Vtk::H5Lite::writePointerDataset(gid, H5_STRING_OFFSETS, rank, dims, &(offsets.front()));
+  }
+  H5Gclose(gid);
+  if (err >= 0)
+  {
+    vtkTypeInt32 nComp = numComp;
+    err = H5Vtk::H5Lite::writeScalarAttribute(fp, dsetName, std::string(H5_NUMCOMPONENTS), nComp);
+  }
+  if (err < 0)
+  {
+    std::cout << "Error writing string array with name: " << dsetName << std::endl;
+    return 0;
+  }
+  return 1;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -615,11 +1461,12 @@ int vtkH5DataWriter::WriteScalarData(hid_t fp, vtkDataArray *scalars, int num)
 //              scalarsName, numComp, name);
 //      }
 
-    if (this->WriteArray(fp, scalars->GetDataType(), scalars, scalarsName, num, numComp) == 0)
+    int written = this->WriteArray(fp, scalars->GetDataType(), scalars, scalarsName, num, numComp);
+    delete[] scalarsName;
+    if (written == 0)
       {
       return 0;
       }
-    delete[] scalarsName;
     }
 
   else //color scalars
@@ -629,8 +1476,11 @@ int vtkH5DataWriter::WriteScalarData(hid_t fp, vtkDataArray *scalars, int num)
    // *fp << "COLOR_SCALARS " << scalarsName << " " << nvs << "\n";
 
    // fp->write(reinterpret_cast<char *>(data), (sizeof(unsigned char))*(nvs*num));
-    this->WriteArray(fp, scalars->GetDataType(), scalars, H5_COLOR_SCALARS, num, nvs);
     delete[] scalarsName;
+    if (this->WriteArray(fp, scalars->GetDataType(), scalars, H5_COLOR_SCALARS, num, nvs) == 0)
+      {
+      return 0;
+      }
 
     }
 
@@ -642,7 +1492,10 @@ int vtkH5DataWriter::WriteScalarData(hid_t fp, vtkDataArray *scalars, int num)
     //unsigned char *colors=lut->GetPointer(0);
     //fp->write(reinterpret_cast<char *>(colors), (sizeof(unsigned char)*4*size));
     int numComp = 4;
-    this->WriteArray(fp, lut->GetTable()->GetDataType(), lut->GetTable(), H5_LOOKUP_TABLE, size, numComp);
+    if (this->WriteArray(fp, lut->GetTable()->GetDataType(), lut->GetTable(), H5_LOOKUP_TABLE, size, numComp) == 0)
+      {
+      return 0;
+      }
 
     }
 
@@ -889,3 +1742,727 @@ int vtkH5DataWriter::writeObjectIndex(hid_t fileId, std::vector<std::string> &hd
 
   return err;
 }
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5DataWriter::WriteXdmfDescriptor()
+{
+  if (!this->XdmfDescriptor || NULL == this->FileName)
+  {
+    return;
+  }
+  std::string h5File(this->FileName);
+  std::string xmfFile = H5Vtk::H5Xdmf::descriptorFileName(h5File);
+  std::vector<std::string> hdfPaths; // Describe every object in the file
+  if (H5Vtk::H5Xdmf::writeDescriptor(h5File, xmfFile, hdfPaths) < 0)
+  {
+    vtkWarningMacro(<< "Could not write the XDMF descriptor " << xmfFile);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataWriter::WriteVTKHDF(hid_t fileId, vtkDataSet* input)
+{
+  vtkPolyData* poly = vtkPolyData::SafeDownCast(input);
+  vtkUnstructuredGrid* ugrid = vtkUnstructuredGrid::SafeDownCast(input);
+  if (NULL == poly && NULL == ugrid)
+  {
+    vtkErrorMacro(<< "The VTKHDF layout is only implemented for vtkPolyData and vtkUnstructuredGrid");
+    return -1;
+  }
+  std::string type = (NULL != poly) ? H5_VTKHDF_POLYDATA : H5_VTKHDF_UNSTRUCTURED_GRID;
+
+  herr_t err = 0;
+  bool firstPartition = false;
+  hid_t gid = -1;
+  if (H5Lexists(fileId, H5_VTKHDF_GROUP, H5P_DEFAULT) > 0)
+  {
+    std::string existing;
+    err = H5Vtk::H5Lite::readStringAttribute(fileId, H5_VTKHDF_GROUP, H5_VTKHDF_TYPE, existing);
+    if (err < 0 || existing.compare(type) != 0)
+    {
+      vtkErrorMacro(<< "Can not append a " << type << " partition to a VTKHDF group of type '" << existing << "'");
+      return -1;
+    }
+    gid = H5Gopen(fileId, H5_VTKHDF_GROUP, H5P_DEFAULT);
+  }
+  else
+  {
+    firstPartition = true;
+    gid = H5Gcreate(fileId, H5_VTKHDF_GROUP, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if (gid >= 0)
+    {
+      // PolyData was added in version 2.0 of the layout
+      vtkTypeInt32 version[2] = { (NULL != poly) ? 2 : 1, 0 };
+      hsize_t dims[1] = { 2 };
+      err = H5Vtk::H5Lite::writePointerAttribute(fileId, H5_VTKHDF_GROUP, H5_VTKHDF_VERSION, 1, dims, version);
+      if (err >= 0)
+      {
+        err = H5Vtk::H5Lite::writeStringAttribute(fileId, H5_VTKHDF_GROUP, H5_VTKHDF_TYPE, type);
+      }
+    }
+  }
+  if (gid < 0)
+  {
+    vtkErrorMacro(<< "Could not open or create the group " << H5_VTKHDF_GROUP);
+    return -1;
+  }
+
+  hsize_t one[1] = { 1 };
+  int64_t numPoints = input->GetNumberOfPoints();
+  if (err >= 0)
+  {
+    err = H5Vtk::H5Lite::appendPointerDataset(gid, H5_VTKHDF_NUMBER_OF_POINTS, 1, one, &numPoints, H5VtkCountChunkValues);
+  }
+  vtkPoints* points = vtkPointSet::SafeDownCast(input)->GetPoints();
+  if (err >= 0 && NULL != points)
+  {
+    err = this->AppendVTKHDFArray(gid, H5_VTKHDF_POINTS, points->GetData(), numPoints);
+  }
+  else if (err >= 0)
+  {
+    hsize_t dims[2] = { 0, 3 };
+    float* empty = NULL;
+    err = H5Vtk::H5Lite::appendPointerDataset(gid, H5_VTKHDF_POINTS, 2, dims, empty);
+  }
+
+  if (NULL != poly)
+  {
+    // Cell data of each partition is ordered vertices, lines, polygons, strips
+    // which is also the cell order of vtkPolyData.
+    const char* topologies[4] = { H5_VTKHDF_VERTICES, H5_VTKHDF_LINES, H5_VTKHDF_POLYGONS, H5_VTKHDF_STRIPS };
+    vtkCellArray* cells[4] = { poly->GetVerts(), poly->GetLines(), poly->GetPolys(), poly->GetStrips() };
+    for (int t = 0; t < 4 && err >= 0; ++t)
+    {
+      hid_t topoId = -1;
+      if (H5Lexists(gid, topologies[t], H5P_DEFAULT) > 0)
+      {
+        topoId = H5Gopen(gid, topologies[t], H5P_DEFAULT);
+      }
+      else
+      {
+        topoId = H5Gcreate(gid, topologies[t], H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      }
+      if (topoId < 0)
+      {
+        err = -1;
+        break;
+      }
+      err = this->AppendVTKHDFCells(topoId, cells[t]);
+      H5Gclose(topoId);
+    }
+  }
+  else if (err >= 0)
+  {
+    err = this->AppendVTKHDFCells(gid, ugrid->GetCells());
+    vtkUnsignedCharArray* types = ugrid->GetCellTypesArray();
+    hsize_t dims[1] = { static_cast<hsize_t>(ugrid->GetNumberOfCells()) };
+    if (err >= 0)
+    {
+      unsigned char* ptr = (NULL != types && dims[0] > 0) ? types->GetPointer(0) : NULL;
+      err = H5Vtk::H5Lite::appendPointerDataset(gid, H5_VTKHDF_TYPES, 1, dims, ptr);
+    }
+  }
+
+  if (err >= 0)
+  {
+    err = this->AppendVTKHDFArrays(gid, H5_VTKHDF_POINT_DATA, input->GetPointData());
+  }
+  if (err >= 0)
+  {
+    err = this->AppendVTKHDFArrays(gid, H5_VTKHDF_CELL_DATA, input->GetCellData());
+  }
+  // Field data is not partitioned so only the first partition stores it
+  vtkFieldData* field = input->GetFieldData();
+  if (err >= 0 && firstPartition && NULL != field && field->GetNumberOfArrays() > 0)
+  {
+    err = this->AppendVTKHDFArrays(gid, H5_VTKHDF_FIELD_DATA, field);
+  }
+
+  H5Gclose(gid);
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataWriter::AppendVTKHDFCells(hid_t parentId, vtkCellArray* cells)
+{
+  int64_t numCells = (NULL != cells) ? cells->GetNumberOfCells() : 0;
+  std::vector<int64_t> offsets(static_cast<size_t>(numCells + 1), 0);
+  std::vector<int64_t> connectivity;
+  if (numCells > 0)
+  {
+    connectivity.resize(static_cast<size_t>(cells->GetNumberOfConnectivityEntries() - numCells));
+    vtkIdType* ptr = cells->GetPointer();
+    int64_t pos = 0;
+    for (int64_t c = 0; c < numCells; ++c)
+    {
+      vtkIdType npts = *ptr++;
+      for (vtkIdType j = 0; j < npts; ++j)
+      {
+        connectivity[pos++] = *ptr++;
+      }
+      offsets[c + 1] = pos;
+    }
+  }
+  int64_t numConnectivity = static_cast<int64_t>(connectivity.size());
+
+  hsize_t one[1] = { 1 };
+  herr_t err = H5Vtk::H5Lite::appendPointerDataset(parentId, H5_VTKHDF_NUMBER_OF_CELLS, 1, one, &numCells,
+                                                   H5VtkCountChunkValues);
+  if (err >= 0)
+  {
+    err = H5Vtk::H5Lite::appendPointerDataset(parentId, H5_VTKHDF_NUMBER_OF_CONNECTIVITY_IDS, 1, one, &numConnectivity,
+                                              H5VtkCountChunkValues);
+  }
+  if (err >= 0)
+  {
+    hsize_t dims[1] = { offsets.size() };
+    err = H5Vtk::H5Lite::appendPointerDataset(parentId, H5_VTKHDF_OFFSETS, 1, dims, &(offsets.front()));
+  }
+  if (err >= 0)
+  {
+    hsize_t dims[1] = { connectivity.size() };
+    err = H5Vtk::H5Lite::appendPointerDataset(parentId, H5_VTKHDF_CONNECTIVITY, 1, dims,
+                                              connectivity.empty() ? static_cast<int64_t*>(NULL) : &(connectivity.front()));
+  }
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataWriter::AppendVTKHDFArrays(hid_t parentId, const char* groupName, vtkFieldData* attrs)
+{
+  if (NULL == attrs)
+  {
+    return 0;
+  }
+  hid_t gid = -1;
+  if (H5Lexists(parentId, groupName, H5P_DEFAULT) > 0)
+  {
+    gid = H5Gopen(parentId, groupName, H5P_DEFAULT);
+  }
+  else
+  {
+    gid = H5Gcreate(parentId, groupName, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  }
+  if (gid < 0)
+  {
+    vtkErrorMacro(<< "Error creating group with name " << groupName);
+    return -1;
+  }
+
+  herr_t err = 0;
+  for (int i = 0; i < attrs->GetNumberOfArrays() && err >= 0; ++i)
+  {
+    vtkDataArray* array = attrs->GetArray(i);
+    if (NULL == array || NULL == array->GetName() || array->GetDataType() == VTK_BIT)
+    {
+      vtkWarningMacro(<< "Array " << i << " of " << groupName << " can not be stored in the VTKHDF layout and is skipped");
+      continue;
+    }
+    err = this->AppendVTKHDFArray(gid, array->GetName(), array, array->GetNumberOfTuples());
+  }
+
+  // Active attributes use the names vtkHDFReader looks for
+  vtkDataSetAttributes* dsa = vtkDataSetAttributes::SafeDownCast(attrs);
+  if (NULL != dsa && err >= 0)
+  {
+    vtkDataArray* active[5] = { dsa->GetScalars(), dsa->GetVectors(), dsa->GetNormals(), dsa->GetTCoords(), dsa->GetTensors() };
+    for (int a = 0; a < 5; ++a)
+    {
+      if (NULL != active[a] && NULL != active[a]->GetName())
+      {
+        H5Vtk::H5Lite::writeStringAttribute(parentId, groupName,
+                                            vtkDataSetAttributes::GetAttributeTypeAsString(a), active[a]->GetName());
+      }
+    }
+  }
+
+  H5Gclose(gid);
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataWriter::AppendVTKHDFArray(hid_t parentId, const char* dsetName, vtkDataArray* data, vtkIdType numTuples)
+{
+  int numComp = data->GetNumberOfComponents();
+  void* ptr = numTuples > 0 ? data->GetVoidPointer(0) : NULL;
+  switch (data->GetDataType())
+  {
+    case VTK_FLOAT:
+      return vtkAppendDataArray(parentId, static_cast<float*>(ptr), dsetName, numTuples, numComp);
+    case VTK_DOUBLE:
+      return vtkAppendDataArray(parentId, static_cast<double*>(ptr), dsetName, numTuples, numComp);
+    case VTK_CHAR:
+    case VTK_SIGNED_CHAR:
+      return vtkAppendDataArray(parentId, static_cast<int8_t*>(ptr), dsetName, numTuples, numComp);
+    case VTK_UNSIGNED_CHAR:
+      return vtkAppendDataArray(parentId, static_cast<uint8_t*>(ptr), dsetName, numTuples, numComp);
+    case VTK_SHORT:
+      return vtkAppendDataArray(parentId, static_cast<int16_t*>(ptr), dsetName, numTuples, numComp);
+    case VTK_UNSIGNED_SHORT:
+      return vtkAppendDataArray(parentId, static_cast<uint16_t*>(ptr), dsetName, numTuples, numComp);
+    case VTK_INT:
+      return vtkAppendDataArray(parentId, static_cast<int32_t*>(ptr), dsetName, numTuples, numComp);
+    case VTK_UNSIGNED_INT:
+      return vtkAppendDataArray(parentId, static_cast<uint32_t*>(ptr), dsetName, numTuples, numComp);
+    default:
+      break;
+  }
+  // The remaining integer types (long, long long, __int64, vtkIdType) only
+  // differ by their size on the platform
+  bool isUnsigned = (data->GetDataType() == VTK_UNSIGNED_LONG
+#if defined(VTK_TYPE_USE_LONG_LONG)
+                     || data->GetDataType() == VTK_UNSIGNED_LONG_LONG
+#endif
+#if defined(VTK_TYPE_USE___INT64)
+                     || data->GetDataType() == VTK_UNSIGNED___INT64
+#endif
+                    );
+  switch (data->GetDataTypeSize())
+  {
+    case 4:
+      if (isUnsigned) { return vtkAppendDataArray(parentId, static_cast<uint32_t*>(ptr), dsetName, numTuples, numComp); }
+      return vtkAppendDataArray(parentId, static_cast<int32_t*>(ptr), dsetName, numTuples, numComp);
+    case 8:
+      if (isUnsigned) { return vtkAppendDataArray(parentId, static_cast<uint64_t*>(ptr), dsetName, numTuples, numComp); }
+      return vtkAppendDataArray(parentId, static_cast<int64_t*>(ptr), dsetName, numTuples, numComp);
+    default:
+      break;
+  }
+  vtkErrorMacro(<< "Array " << dsetName << " has an unsupported data type " << data->GetDataTypeAsString());
+  return -1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+  // Length of the first dimension of a dataset, 0 if it does not exist
+  int64_t H5VtkNumberOfRows(hid_t parentId, const char* dsetName)
+  {
+    if (parentId < 0 || H5Lexists(parentId, dsetName, H5P_DEFAULT) <= 0)
+    {
+      return 0;
+    }
+    std::vector<hsize_t> dims;
+    H5T_class_t classType;
+    size_t typeSize = 0;
+    if (H5Vtk::H5Lite::getDatasetInfo(parentId, dsetName, dims, classType, typeSize) < 0 || dims.empty())
+    {
+      return 0;
+    }
+    return static_cast<int64_t>(dims[0]);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5DataWriter::GetVTKHDFSizes(hid_t fileId, bool polyData, std::vector<int64_t> &sizes)
+{
+  sizes.assign(2, 0);
+  HDF_ERROR_HANDLER_OFF
+  hid_t gid = -1;
+  if (H5Lexists(fileId, H5_VTKHDF_GROUP, H5P_DEFAULT) > 0)
+  {
+    gid = H5Gopen(fileId, H5_VTKHDF_GROUP, H5P_DEFAULT);
+  }
+  sizes[0] = H5VtkNumberOfRows(gid, H5_VTKHDF_NUMBER_OF_POINTS);
+  sizes[1] = H5VtkNumberOfRows(gid, H5_VTKHDF_POINTS);
+  const char* topologies[4] = { H5_VTKHDF_VERTICES, H5_VTKHDF_LINES, H5_VTKHDF_POLYGONS, H5_VTKHDF_STRIPS };
+  int numTopologies = polyData ? 4 : 1;
+  for (int t = 0; t < numTopologies; ++t)
+  {
+    hid_t topoId = -1;
+    if (!polyData)
+    {
+      topoId = gid;
+    }
+    else if (gid >= 0 && H5Lexists(gid, topologies[t], H5P_DEFAULT) > 0)
+    {
+      topoId = H5Gopen(gid, topologies[t], H5P_DEFAULT);
+    }
+    // Every partition stores one offset more than it has cells
+    sizes.push_back(H5VtkNumberOfRows(topoId, H5_VTKHDF_OFFSETS) - H5VtkNumberOfRows(topoId, H5_VTKHDF_NUMBER_OF_CELLS));
+    sizes.push_back(H5VtkNumberOfRows(topoId, H5_VTKHDF_CONNECTIVITY));
+    if (polyData && topoId >= 0)
+    {
+      H5Gclose(topoId);
+    }
+  }
+  if (gid >= 0)
+  {
+    H5Gclose(gid);
+  }
+  HDF_ERROR_HANDLER_ON
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataWriter::AppendVTKHDFStep(hid_t fileId, double time, const std::vector<int64_t> &before)
+{
+  std::string stepsPath = std::string(H5_VTKHDF_GROUP) + "/" + H5_VTKHDF_STEPS;
+  hid_t gid = -1;
+  if (H5Lexists(fileId, stepsPath.c_str(), H5P_DEFAULT) > 0)
+  {
+    gid = H5Gopen(fileId, stepsPath.c_str(), H5P_DEFAULT);
+  }
+  else
+  {
+    gid = H5Gcreate(fileId, stepsPath.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  }
+  if (gid < 0)
+  {
+    vtkErrorMacro(<< "Could not open or create the group " << stepsPath);
+    return -1;
+  }
+
+  // Every step is the single partition written last
+  int64_t numParts = 1;
+  size_t numTopologies = (before.size() - 2) / 2;
+  std::vector<int64_t> cellOffsets(numTopologies, 0);
+  std::vector<int64_t> connOffsets(numTopologies, 0);
+  for (size_t t = 0; t < numTopologies; ++t)
+  {
+    cellOffsets[t] = before[2 + 2 * t];
+    connOffsets[t] = before[3 + 2 * t];
+  }
+  hsize_t one[1] = { 1 };
+  hsize_t row[2] = { 1, numTopologies };
+  int64_t partOffset = before[0];
+  int64_t pointOffset = before[1];
+  herr_t err = H5Vtk::H5Lite::appendPointerDataset(gid, H5_VTKHDF_VALUES, 1, one, &time, H5VtkCountChunkValues);
+  if (err >= 0)
+  {
+    err = H5Vtk::H5Lite::appendPointerDataset(gid, H5_VTKHDF_PART_OFFSETS, 1, one, &partOffset, H5VtkCountChunkValues);
+  }
+  if (err >= 0)
+  {
+    err = H5Vtk::H5Lite::appendPointerDataset(gid, H5_VTKHDF_NUMBER_OF_PARTS, 1, one, &numParts, H5VtkCountChunkValues);
+  }
+  if (err >= 0)
+  {
+    err = H5Vtk::H5Lite::appendPointerDataset(gid, H5_VTKHDF_POINT_OFFSETS, 1, one, &pointOffset, H5VtkCountChunkValues);
+  }
+  if (err >= 0)
+  {
+    err = H5Vtk::H5Lite::appendPointerDataset(gid, H5_VTKHDF_CELL_OFFSETS, 2, row, &(cellOffsets.front()),
+                                              H5VtkCountChunkValues);
+  }
+  if (err >= 0)
+  {
+    err = H5Vtk::H5Lite::appendPointerDataset(gid, H5_VTKHDF_CONNECTIVITY_ID_OFFSETS, 2, row, &(connOffsets.front()),
+                                              H5VtkCountChunkValues);
+  }
+  H5Gclose(gid);
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5DataWriter::WriteSWMRStep(vtkDataSet* input, bool append)
+{
+  if (NULL == this->FileName)
+  {
+    vtkErrorMacro(<< "No FileName was set");
+    return -1;
+  }
+  if (this->SWMRFileId >= 0 && this->SWMRFileName.compare(this->FileName) != 0)
+  {
+    this->CloseSWMRFile();
+  }
+  bool startWriting = false;
+  if (this->SWMRFileId < 0)
+  {
+    hid_t fileId = -1;
+    if (append)
+    {
+      fileId = H5Vtk::H5Utilities::openSWMRWriteFile(this->FileName, false);
+    }
+    if (fileId < 0)
+    {
+      fileId = H5Vtk::H5Utilities::openSWMRWriteFile(this->FileName, true);
+    }
+    if (fileId < 0)
+    {
+      vtkErrorMacro(<< "The hdf5 file could not be opened or created: " << this->FileName);
+      return -1;
+    }
+    this->SWMRFileId = fileId;
+    this->SWMRFileName = this->FileName;
+    startWriting = true;
+  }
+
+  std::vector<int64_t> before;
+  this->GetVTKHDFSizes(this->SWMRFileId, NULL != vtkPolyData::SafeDownCast(input), before);
+  std::string stepsPath = std::string(H5_VTKHDF_GROUP) + "/" + H5_VTKHDF_STEPS;
+  double time = 0.0;
+  if (input->GetInformation()->Has(vtkDataObject::DATA_TIME_STEPS()))
+  {
+    time = input->GetInformation()->Get(vtkDataObject::DATA_TIME_STEPS())[0];
+  }
+  else
+  {
+    HDF_ERROR_HANDLER_OFF
+    hid_t gid = H5Lexists(this->SWMRFileId, H5_VTKHDF_GROUP, H5P_DEFAULT) > 0
+              && H5Lexists(this->SWMRFileId, stepsPath.c_str(), H5P_DEFAULT) > 0
+              ? H5Gopen(this->SWMRFileId, stepsPath.c_str(), H5P_DEFAULT) : -1;
+    time = static_cast<double>(H5VtkNumberOfRows(gid, H5_VTKHDF_VALUES));
+    if (gid >= 0)
+    {
+      H5Gclose(gid);
+    }
+    HDF_ERROR_HANDLER_ON
+  }
+
+  herr_t err = this->WriteVTKHDF(this->SWMRFileId, input);
+  // The data of a step has to reach the file before readers see the step
+  if (err >= 0)
+  {
+    err = H5Fflush(this->SWMRFileId, H5F_SCOPE_GLOBAL);
+  }
+  if (err >= 0)
+  {
+    err = this->AppendVTKHDFStep(this->SWMRFileId, time, before);
+  }
+  if (err >= 0 && startWriting)
+  {
+    // Attributes can not change once SWMR writing started. Time steps need
+    // version 2.0 of the layout.
+    vtkTypeInt32 version[2] = { 2, 0 };
+    hsize_t dims[1] = { 2 };
+    err = H5Vtk::H5Lite::writePointerAttribute(this->SWMRFileId, H5_VTKHDF_GROUP, H5_VTKHDF_VERSION, 1, dims, version);
+    if (err >= 0)
+    {
+      hid_t gid = H5Gopen(this->SWMRFileId, stepsPath.c_str(), H5P_DEFAULT);
+      vtkTypeInt32 numSteps = static_cast<vtkTypeInt32>(H5VtkNumberOfRows(gid, H5_VTKHDF_VALUES));
+      H5Gclose(gid);
+      err = H5Vtk::H5Lite::writeScalarAttribute(this->SWMRFileId, stepsPath, H5_VTKHDF_NSTEPS, numSteps);
+    }
+    if (err >= 0)
+    {
+      err = H5Fstart_swmr_write(this->SWMRFileId);
+    }
+  }
+  else if (err >= 0)
+  {
+    err = H5Fflush(this->SWMRFileId, H5F_SCOPE_GLOBAL);
+  }
+  if (err < 0)
+  {
+    vtkErrorMacro(<< "Error writing a time step to " << this->SWMRFileName);
+    this->CloseSWMRFile();
+  }
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5DataWriter::CloseSWMRFile()
+{
+  if (this->SWMRFileId < 0)
+  {
+    return;
+  }
+  H5Vtk::H5Utilities::closeFile(this->SWMRFileId);
+  this->SWMRFileId = -1;
+
+  hid_t fileId = H5Vtk::H5Utilities::openFile(this->SWMRFileName, false);
+  if (fileId < 0)
+  {
+    return;
+  }
+  std::string stepsPath = std::string(H5_VTKHDF_GROUP) + "/" + H5_VTKHDF_STEPS;
+  HDF_ERROR_HANDLER_OFF
+  hid_t gid = H5Lexists(fileId, H5_VTKHDF_GROUP, H5P_DEFAULT) > 0
+            && H5Lexists(fileId, stepsPath.c_str(), H5P_DEFAULT) > 0
+            ? H5Gopen(fileId, stepsPath.c_str(), H5P_DEFAULT) : -1;
+  HDF_ERROR_HANDLER_ON
+  if (gid >= 0)
+  {
+    vtkTypeInt32 numSteps = static_cast<vtkTypeInt32>(H5VtkNumberOfRows(gid, H5_VTKHDF_VALUES));
+    H5Gclose(gid);
+    H5Vtk::H5Lite::writeScalarAttribute(fileId, stepsPath, H5_VTKHDF_NSTEPS, numSteps);
+  }
+  H5Vtk::H5Utilities::closeFile(fileId);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+  // Bits per axis of the curve keys, 3 * 21 bits fit in 64 bit keys
+  const int H5VtkCurveBits = 21;
+
+  // Interleaves the bits of x, y and z, the bit of x being the most
+  // significant at every level
+  vtkTypeUInt64 H5VtkInterleave(const vtkTypeUInt32 x[3])
+  {
+    vtkTypeUInt64 key = 0;
+    for (int bit = H5VtkCurveBits - 1; bit >= 0; --bit)
+    {
+      key = (key << 3)
+          | (static_cast<vtkTypeUInt64>((x[0] >> bit) & 1) << 2)
+          | (static_cast<vtkTypeUInt64>((x[1] >> bit) & 1) << 1)
+          | static_cast<vtkTypeUInt64>((x[2] >> bit) & 1);
+    }
+    return key;
+  }
+
+  // Position of x on the Hilbert curve, after J. Skilling, "Programming the
+  // Hilbert curve", AIP Conf. Proc. 707, 2004
+  vtkTypeUInt64 H5VtkHilbertKey(vtkTypeUInt32 x[3])
+  {
+    vtkTypeUInt32 m = 1u << (H5VtkCurveBits - 1);
+    for (vtkTypeUInt32 q = m; q > 1; q >>= 1)
+    {
+      vtkTypeUInt32 p = q - 1;
+      for (int i = 0; i < 3; ++i)
+      {
+        if (x[i] & q)
+        {
+          x[0] ^= p;
+        }
+        else
+        {
+          vtkTypeUInt32 t = (x[0] ^ x[i]) & p;
+          x[0] ^= t;
+          x[i] ^= t;
+        }
+      }
+    }
+    x[1] ^= x[0];
+    x[2] ^= x[1];
+    vtkTypeUInt32 t = 0;
+    for (vtkTypeUInt32 q = m; q > 1; q >>= 1)
+    {
+      if (x[2] & q)
+      {
+        t ^= q - 1;
+      }
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+      x[i] ^= t;
+    }
+    return H5VtkInterleave(x);
+  }
+
+  typedef std::pair<vtkTypeUInt64, vtkIdType> H5VtkCurveKey;
+
+  // Key of the position p inside bounds on the given curve
+  vtkTypeUInt64 H5VtkCurveKeyOf(const double p[3], const double bounds[6], int curve)
+  {
+    vtkTypeUInt32 x[3];
+    const double maxCoord = static_cast<double>((1u << H5VtkCurveBits) - 1);
+    for (int i = 0; i < 3; ++i)
+    {
+      double length = bounds[2 * i + 1] - bounds[2 * i];
+      double u = (length > 0.0) ? (p[i] - bounds[2 * i]) / length : 0.0;
+      u = std::min(1.0, std::max(0.0, u));
+      x[i] = static_cast<vtkTypeUInt32>(u * maxCoord);
+    }
+    return (curve == VTK_H5_CURVE_HILBERT) ? H5VtkHilbertKey(x) : H5VtkInterleave(x);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5DataWriter::SortPointsAlongCurve(vtkPoints* points, const double bounds[6],
+                                           std::vector<vtkIdType> &pointMap)
+{
+  vtkIdType numPoints = points->GetNumberOfPoints();
+  std::vector<H5VtkCurveKey> keys(numPoints);
+  double x[3];
+  for (vtkIdType p = 0; p < numPoints; ++p)
+  {
+    points->GetPoint(p, x);
+    keys[p] = H5VtkCurveKey(H5VtkCurveKeyOf(x, bounds, this->SpaceFillingCurve), p);
+  }
+  std::sort(keys.begin(), keys.end());
+  pointMap.resize(numPoints);
+  for (vtkIdType p = 0; p < numPoints; ++p)
+  {
+    pointMap[keys[p].second] = p;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5DataWriter::SortCellsAlongCurve(vtkCellArray* cells, vtkPoints* points, const double bounds[6],
+                                          vtkIdType firstCell, std::vector<vtkIdType> &cellOrder)
+{
+  vtkIdType numCells = cells->GetNumberOfCells();
+  vtkIdType* conn = cells->GetPointer();
+  std::vector<H5VtkCurveKey> keys(numCells);
+  double x[3];
+  vtkIdType loc = 0;
+  for (vtkIdType c = 0; c < numCells; ++c)
+  {
+    vtkIdType npts = conn[loc];
+    double center[3] = { 0.0, 0.0, 0.0 };
+    for (vtkIdType k = 1; k <= npts; ++k)
+    {
+      points->GetPoint(conn[loc + k], x);
+      center[0] += x[0];
+      center[1] += x[1];
+      center[2] += x[2];
+    }
+    for (int i = 0; i < 3 && npts > 0; ++i)
+    {
+      center[i] /= npts;
+    }
+    keys[c] = H5VtkCurveKey(H5VtkCurveKeyOf(center, bounds, this->SpaceFillingCurve), c);
+    loc += npts + 1;
+  }
+  std::sort(keys.begin(), keys.end());
+  for (vtkIdType c = 0; c < numCells; ++c)
+  {
+    cellOrder.push_back(firstCell + keys[c].second);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5DataWriter::AddOriginalIds(vtkDataSet* output, const std::vector<vtkIdType> &pointMap,
+                                     const std::vector<vtkIdType> &cellOrder)
+{
+  vtkIdType numPoints = static_cast<vtkIdType>(pointMap.size());
+  vtkIdType numCells = static_cast<vtkIdType>(cellOrder.size());
+  vtkIdTypeArray* originalIds = vtkIdTypeArray::New();
+  originalIds->SetName(H5_ORIGINAL_POINT_IDS);
+  originalIds->SetNumberOfTuples(numPoints);
+  for (vtkIdType p = 0; p < numPoints; ++p)
+  {
+    originalIds->SetValue(pointMap[p], p);
+  }
+  output->GetPointData()->AddArray(originalIds);
+  originalIds->Delete();
+  originalIds = vtkIdTypeArray::New();
+  originalIds->SetName(H5_ORIGINAL_CELL_IDS);
+  originalIds->SetNumberOfTuples(numCells);
+  for (vtkIdType c = 0; c < numCells; ++c)
+  {
+    originalIds->SetValue(c, cellOrder[c]);
+  }
+  output->GetCellData()->AddArray(originalIds);
+  originalIds->Delete();
+}
@@ -14,12 +14,17 @@
 
 #include <vtkWriter.h>
 
+#include <map>
+#include <string>
+#include <vector>
+
 //-- Hdf5 includes
 #include <hdf5.h>
 
 //-- Our Constants
 #include "VTKH5Constants.h"
 #include "HDF5/H5Lite.h"
+#include "HDF5/H5StorageTuner.h"
 
 
 #ifndef VTK_EXPORT
@@ -34,6 +39,24 @@ class vtkPoints;
 class vtkCellArray;
 class vtkDataArray;
 class vtkDataSetAttributes;
+class vtkStringArray;
+
+#define VTK_H5_LOSSY_NONE          0
+#define VTK_H5_LOSSY_SCALE_OFFSET  1
+#define VTK_H5_LOSSY_BIT_ROUND     2
+#define VTK_H5_LOSSY_ZFP           3
+
+// Lossless codecs, the values of H5Vtk::H5Compression::Codecs
+#define VTK_H5_CODEC_NONE          0
+#define VTK_H5_CODEC_DEFLATE       1
+#define VTK_H5_CODEC_LZ4           2
+#define VTK_H5_CODEC_ZSTD          3
+#define VTK_H5_CODEC_BLOSC         4
+#define VTK_H5_CODEC_AUTO          5
+
+#define VTK_H5_CURVE_NONE          0
+#define VTK_H5_CURVE_MORTON        1
+#define VTK_H5_CURVE_HILBERT       2
 
 /**
 * @class vtkH5DataWriter vtkH5DataWriter.h HDF5/vtkH5DataWriter.h
@@ -50,14 +73,54 @@ public:
   vtkTypeRevisionMacro( vtkH5DataWriter, vtkWriter );
   void PrintSelf( ostream&, vtkIndent );
 
+  // Description:
+  // Writes the arrays of pd into the group groupName of parentId. Returns 0
+  // on error.
   int WriteDatasetArrays(hid_t parentId, vtkDataSet* ds,
                                           vtkDataSetAttributes* pd,
                                           int numTuples, const char* groupName);
 
+  // Description:
+  // Writes every data array of pd into the group groupName as a chunked
+  // dataset shaped like the structured dimensions dims (x, y, z). The dataset
+  // dimensions are stored slowest first (z, y, x) with an extra trailing
+  // dimension for arrays with more than one component. Chunks are bricks of at
+  // most chunkSize samples along each axis so a sub extent is read by touching
+  // only the bricks that intersect it.
+  int WriteStructuredArrays(hid_t parentId, vtkDataSetAttributes* pd,
+                            const int dims[3], int chunkSize, const char* groupName);
+
+  // Description:
+  // Writes the points as the POINTS dataset. Returns a negative value on
+  // error.
   int WritePoints(hid_t fp, vtkPoints *points);
-  //TODO:: Implement WriteCoordinates
- // int WriteCoordinates(hid_t fp, vtkDataArray *coords, int axes);
-  int WriteCells(hid_t fp, vtkCellArray *cells, const char *label);
+
+  // Description:
+  // Writes the points of a structured data set as a chunked (z, y, x, 3)
+  // dataset so a sub extent of the points can be read back. Returns a
+  // negative value on error like WritePoints().
+  int WriteStructuredPoints(hid_t fp, vtkPoints *points, const int dims[3], int chunkSize);
+
+  // Description:
+  // Writes one axis (0, 1 or 2 for x, y or z) of a rectilinear grid as a one
+  // dimensional dataset. Returns 0 on error.
+  int WriteCoordinates(hid_t fp, vtkDataArray *coords, int axes);
+
+  // Description:
+  // Writes the extent of a structured data set as the WholeExtent attribute
+  // of the group hdfPath. Returns a negative value on error.
+  int WriteWholeExtent(hid_t fileId, const char* hdfPath, const int extent[6]);
+
+  // Description:
+  // Writes the field, cell and point data of a structured data set with the
+  // point dimensions dims using WriteStructuredArrays(). Returns 0 on error.
+  int WriteStructuredData(hid_t fp, vtkDataSet* ds, const int dims[3], int chunkSize);
+
+  // Description:
+  // Writes a cell array as the dataset label. With ConnectivityCodec on and
+  // useCodec true the cells are encoded with H5ConnectivityCodec. Returns a
+  // negative value on error.
+  int WriteCells(hid_t fp, vtkCellArray *cells, const char *label, bool useCodec = true);
 //  int WriteCellData1(hid_t fp, vtkDataSet *ds);
 //  int WritePointData1(hid_t fp, vtkDataSet *ds);
 
@@ -69,7 +132,165 @@ public:
 
   int WriteFieldData(hid_t parentGroup, vtkFieldData *f);
 
+  // Description:
+  // When on, the data set is written into the /VTKHDF group of the file using
+  // the VTKHDF layout (Offsets/Connectivity/Types) instead of under HDFPath so
+  // VTK's own vtkHDFReader can read it. With AppendData on, writing into a file
+  // that already has a /VTKHDF group adds the data set as a new partition.
+  vtkSetMacro(VTKHDFLayout, int);
+  vtkGetMacro(VTKHDFLayout, int);
+  vtkBooleanMacro(VTKHDFLayout, int);
+
+  // Description:
+  // When on, an XDMF descriptor (the file name with a .xmf extension) is
+  // written next to the file after every write. It references the datasets of
+  // the file in place so XDMF readers need no converted copy. Objects XDMF can
+  // not describe, such as grids with mixed cell types, are left out of it.
+  vtkSetMacro(XdmfDescriptor, int);
+  vtkGetMacro(XdmfDescriptor, int);
+  vtkBooleanMacro(XdmfDescriptor, int);
+
+  // Description:
+  // When on, cell connectivity is delta coded and bit packed with
+  // H5ConnectivityCodec instead of written as plain vtkIdType values. Files
+  // written this way can only be read by the H5Vtk readers.
+  vtkSetMacro(ConnectivityCodec, int);
+  vtkGetMacro(ConnectivityCodec, int);
+  vtkBooleanMacro(ConnectivityCodec, int);
+
+  // Description:
+  // When on, active tensors that are exactly symmetric are written with their
+  // 6 independent components instead of 9. Lossless.
+  vtkSetMacro(SymmetricTensors, int);
+  vtkGetMacro(SymmetricTensors, int);
+  vtkBooleanMacro(SymmetricTensors, int);
+
+  // Description:
+  // When on, active float or double normals are written octahedron encoded
+  // as two 16 bit values, with an angular error below 0.01 degree. Normals
+  // are read back with unit length.
+  vtkSetMacro(OctahedralNormals, int);
+  vtkGetMacro(OctahedralNormals, int);
+  vtkBooleanMacro(OctahedralNormals, int);
+
+  // Description:
+  // Lossless codec of each class of arrays: VTK_H5_CODEC_NONE (the default),
+  // VTK_H5_CODEC_DEFLATE, VTK_H5_CODEC_LZ4, VTK_H5_CODEC_ZSTD or
+  // VTK_H5_CODEC_BLOSC (Blosc with bitshuffle and LZ4). Points covers POINTS,
+  // connectivity the cells, cell types, cell locations and polyhedron faces.
+  // The datasets are chunked in about 64K values. LZ4, Zstd and Blosc are
+  // HDF5 filter plugins. When one can not be loaded the arrays are written
+  // uncompressed with a warning. Readers need the same plugins.
+  // VTK_H5_CODEC_AUTO chooses the codec and chunk size of every dataset by
+  // trial compressing a sample of it, see TargetWriteThroughput.
+  vtkSetClampMacro(PointsCompression, int, VTK_H5_CODEC_NONE, VTK_H5_CODEC_AUTO);
+  vtkGetMacro(PointsCompression, int);
+  vtkSetClampMacro(ConnectivityCompression, int, VTK_H5_CODEC_NONE, VTK_H5_CODEC_AUTO);
+  vtkGetMacro(ConnectivityCompression, int);
+  vtkSetClampMacro(PointDataCompression, int, VTK_H5_CODEC_NONE, VTK_H5_CODEC_AUTO);
+  vtkGetMacro(PointDataCompression, int);
+  vtkSetClampMacro(CellDataCompression, int, VTK_H5_CODEC_NONE, VTK_H5_CODEC_AUTO);
+  vtkGetMacro(CellDataCompression, int);
+
+  // Description:
+  // Level of the deflate, Zstd and Blosc codecs, 1 (fastest) to 9. LZ4 has
+  // no level. The default is 4.
+  vtkSetClampMacro(CompressionLevel, int, 1, 9);
+  vtkGetMacro(CompressionLevel, int);
+
+  // Description:
+  // Targets of VTK_H5_CODEC_AUTO. With a TargetWriteThroughput in MB/s (200
+  // by default) the codec with the best ratio that still writes that fast
+  // is taken. With only a TargetCompressionRatio the fastest codec that
+  // reaches the ratio is taken. 0 turns a target off. The choice and the
+  // measurements behind it are stored as attributes of each dataset.
+  vtkSetClampMacro(TargetWriteThroughput, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(TargetWriteThroughput, double);
+  vtkSetClampMacro(TargetCompressionRatio, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(TargetCompressionRatio, double);
+
+  // Description:
+  // Number of threads compressing the chunks of deflated datasets, 0 (the
+  // default) for one per core and 1 to leave the compression to H5Dwrite.
+  // The chunks are stored with H5Dwrite_chunk in order while the next ones
+  // are compressed, which needs HDF5 1.10.3 or later.
+  vtkSetClampMacro(CompressionThreads, int, 0, VTK_INT_MAX);
+  vtkGetMacro(CompressionThreads, int);
+
+  // Description:
+  // Space filling curve the points and cells are sorted along before they are
+  // written: VTK_H5_CURVE_NONE (the default), VTK_H5_CURVE_MORTON or
+  // VTK_H5_CURVE_HILBERT. Points are sorted by their position and cells by
+  // their center, which makes neighbours close in the file and compresses
+  // better. The ids the points and cells had in the input are written as the
+  // vtkOriginalPointIds and vtkOriginalCellIds arrays. Used by the poly data
+  // and unstructured grid writers.
+  vtkSetClampMacro(SpaceFillingCurve, int, VTK_H5_CURVE_NONE, VTK_H5_CURVE_HILBERT);
+  vtkGetMacro(SpaceFillingCurve, int);
+  void SetSpaceFillingCurveToNone() { this->SetSpaceFillingCurve(VTK_H5_CURVE_NONE); }
+  void SetSpaceFillingCurveToMorton() { this->SetSpaceFillingCurve(VTK_H5_CURVE_MORTON); }
+  void SetSpaceFillingCurveToHilbert() { this->SetSpaceFillingCurve(VTK_H5_CURVE_HILBERT); }
+
+  // Description:
+  // A directory HDF5 searches for filter plugins in addition to
+  // HDF5_PLUGIN_PATH. The path is added to the search path of the process
+  // when it is set.
+  virtual void SetFilterPluginPath(const char* path);
+  vtkGetStringMacro(FilterPluginPath);
+
+  // Description:
+  // Lossy compression of the float and double point and cell data arrays,
+  // which keeps every value within ErrorBound of the input:
+  // VTK_H5_LOSSY_NONE (the default) writes them as they are.
+  // VTK_H5_LOSSY_SCALE_OFFSET uses the scale-offset filter built into HDF5.
+  // VTK_H5_LOSSY_BIT_ROUND drops the mantissa bits below the bound and
+  // deflates the rest, so the file stays plain floats.
+  // VTK_H5_LOSSY_ZFP uses the H5Z-ZFP filter plugin in fixed accuracy mode
+  // and falls back to scale-offset when the plugin can not be loaded. Readers
+  // need the plugin on their HDF5_PLUGIN_PATH.
+  // Every array is written with the LossyCompression and ErrorBound
+  // attributes.
+  vtkSetClampMacro(LossyCompression, int, VTK_H5_LOSSY_NONE, VTK_H5_LOSSY_ZFP);
+  vtkGetMacro(LossyCompression, int);
+  void SetLossyCompressionToNone() { this->SetLossyCompression(VTK_H5_LOSSY_NONE); }
+  void SetLossyCompressionToScaleOffset() { this->SetLossyCompression(VTK_H5_LOSSY_SCALE_OFFSET); }
+  void SetLossyCompressionToBitRound() { this->SetLossyCompression(VTK_H5_LOSSY_BIT_ROUND); }
+  void SetLossyCompressionToZfp() { this->SetLossyCompression(VTK_H5_LOSSY_ZFP); }
+
+  // Description:
+  // The largest error of a value written with LossyCompression. 0 (the
+  // default) writes every array losslessly.
+  vtkSetClampMacro(ErrorBound, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(ErrorBound, double);
+
+  // Description:
+  // When on, ErrorBound and the bounds of SetArrayLossyCompression() are
+  // relative to the largest magnitude of each array instead of absolute.
+  vtkSetMacro(RelativeErrorBound, int);
+  vtkGetMacro(RelativeErrorBound, int);
+  vtkBooleanMacro(RelativeErrorBound, int);
+
+  // Description:
+  // Overrides LossyCompression and ErrorBound for the point and cell data
+  // arrays called name. VTK_H5_LOSSY_NONE keeps the array lossless.
+  void SetArrayLossyCompression(const char* name, int mode, double errorBound);
+  void RemoveAllArrayLossyCompression();
+
+  // Description:
+  // When on, every Write() appends the input as a new time step of the
+  // VTKHDF layout to a file that stays open for single writer/multiple reader
+  // (SWMR) access, so the readers can follow a running simulation. The time
+  // of a step is the DATA_TIME_STEPS of the input, or the step number. Every
+  // array has to be present in the first step. CloseSWMRFile() ends the
+  // session, which also happens when the writer is destroyed.
+  vtkSetMacro(SWMRMode, int);
+  vtkGetMacro(SWMRMode, int);
+  vtkBooleanMacro(SWMRMode, int);
 
+  // Description:
+  // Closes the file kept open by SWMRMode and stores the final number of
+  // steps as the NSteps attribute, which can not change during SWMR writing.
+  void CloseSWMRFile();
 
 protected:
   vtkH5DataWriter();
@@ -77,8 +298,56 @@ protected:
 
   virtual void WriteData();
 
+  // Description:
+  // Writes num tuples of data as the dataset dsetName. Returns 0 on error.
   int WriteArray(hid_t fp, int dataType, vtkAbstractArray *data,
-                 const char *dsetName, int num, int numComp);
+                 const char *dsetName, int num, int numComp, int codec = VTK_H5_CODEC_NONE);
+
+  // Description:
+  // Writes a string array as the group dsetName holding all characters in one
+  // CHARACTERS dataset and the start of every string in an OFFSETS dataset,
+  // so any number of strings takes two writes. Returns 0 on error.
+  int WriteStringArray(hid_t fp, vtkStringArray* data, const char* dsetName,
+                       int num, int numComp);
+  // Writes array compactly with H5ArrayEncoding if it is the active tensors
+  // or normals of pd and the matching option is on. Returns 1 if the array
+  // was written, 0 if it has to be written as is and -1 on error.
+  int WriteEncodedArray(hid_t fp, vtkDataSetAttributes* pd, vtkAbstractArray* array, int num);
+
+  // Writes a float or double array with its LossyCompression. Returns 1 if
+  // the array was written, 0 if it has to be written as is and -1 on error.
+  int WriteLossyArray(hid_t fp, vtkAbstractArray* array, int num, int codec);
+
+  // Description:
+  // Creates the properties of a dataset of numValues values compressed with
+  // codec. Returns a negative value if the dataset has to be written without
+  // compression, because codec is VTK_H5_CODEC_NONE, there are no values or
+  // the filter is not available.
+  hid_t CreateCompressedProperties(int codec, hsize_t numValues, int numComp);
+
+  //BTX
+  // Description:
+  // Creates the properties of a dataset of numValues values of memType as
+  // chosen by H5StorageTuner for the targets. Returns a negative value if the
+  // dataset is best written contiguous without compression.
+  hid_t CreateTunedProperties(const void* data, hid_t memType, hsize_t numValues, int numComp,
+                              H5Vtk::H5StorageTuner::Decision &decision);
+
+  // Description:
+  // Stores decision and the targets as attributes of the dataset name.
+  herr_t WriteStorageDecision(hid_t fp, const std::string &name,
+                              const H5Vtk::H5StorageTuner::Decision &decision);
+
+  // Description:
+  // Writes numValues values of memType as the new dataset name created with
+  // dcpl, compressing its chunks on CompressionThreads threads. Returns 1 if
+  // the dataset was written, 0 if it has to be written by H5Dwrite, because
+  // dcpl is not the shuffle and deflate pipeline, there is only one chunk or
+  // one thread, and -1 on error.
+  int WriteParallelDataset(hid_t fp, const std::string &name, hsize_t numValues, hid_t dcpl,
+                           hid_t memType, const void* data);
+  //ETX
+
   int WriteScalarData(hid_t fp, vtkDataArray *s, int num);
   int WriteVectorData(hid_t fp, vtkDataArray *v, int num);
   int WriteNormalData(hid_t fp, vtkDataArray *n, int num);
@@ -89,25 +358,207 @@ protected:
 
   int vtkIsInTheList(int index, int* list, int numElem);
 
+  // Description:
+  // Writes the names of the active attributes of pd (scalars, vectors, ...)
+  // as string attributes of the group groupName.
+  int WriteActiveAttributeNames(hid_t parentId, vtkDataSetAttributes* pd, const char* groupName);
+
+  // Description:
+  // Writes one array of WriteStructuredArrays.
+  int WriteChunkedArray(hid_t parentId, const char* dsetName, vtkDataArray* data,
+                        const int dims[3], int chunkSize);
+
+  int VTKHDFLayout;
+  int XdmfDescriptor;
+  int ConnectivityCodec;
+  int SymmetricTensors;
+  int OctahedralNormals;
+  int LossyCompression;
+  double ErrorBound;
+  int RelativeErrorBound;
+  int PointsCompression;
+  int ConnectivityCompression;
+  int PointDataCompression;
+  int CellDataCompression;
+  int CompressionLevel;
+  double TargetWriteThroughput;
+  double TargetCompressionRatio;
+  int CompressionThreads;
+  int SpaceFillingCurve;
+  char* FilterPluginPath;
+  //BTX
+  std::map<std::string, std::pair<int, double> > ArrayLossyCompression;
+  //ETX
+  int SWMRMode;
+  hid_t SWMRFileId;
+  std::string SWMRFileName;
+
+  /**
+   * @brief Writes the XDMF descriptor of FileName when XdmfDescriptor is on.
+   * Must be called after the HDF5 file has been closed.
+   */
+  void WriteXdmfDescriptor();
+
+  //BTX
+  /**
+   * @brief Writes a vtkPolyData or vtkUnstructuredGrid as a new partition of
+   * the /VTKHDF group, creating the group if needed.
+   * @return Standard HDF5 error condition
+   */
+  int WriteVTKHDF(hid_t fileId, vtkDataSet* input);
+
+  /**
+   * @brief Appends NumberOfCells, NumberOfConnectivityIds, Offsets and
+   * Connectivity for one partition to parentId.
+   */
+  int AppendVTKHDFCells(hid_t parentId, vtkCellArray* cells);
+
+  /**
+   * @brief Appends every data array of attrs to the group groupName, creating
+   * the group if needed. Arrays with more than one component are written as
+   * (numTuples, numComponents) datasets.
+   */
+  int AppendVTKHDFArrays(hid_t parentId, const char* groupName, vtkFieldData* attrs);
+
+  /**
+   * @brief Appends numTuples tuples of data to the dataset dsetName.
+   */
+  int AppendVTKHDFArray(hid_t parentId, const char* dsetName, vtkDataArray* data, vtkIdType numTuples);
+
+  /**
+   * @brief Writes input as the next time step of the file kept open by
+   * SWMRMode. The first step opens the file, or creates it when append is
+   * false or the file does not exist, and starts SWMR writing once all
+   * datasets exist.
+   * @return Standard HDF5 error condition
+   */
+  int WriteSWMRStep(vtkDataSet* input, bool append);
+
+  /**
+   * @brief Appends one row to the Steps datasets of the /VTKHDF group for
+   * the partition written last. before holds the number of partitions,
+   * points and per topology the cells and connectivity ids in the file
+   * before that partition was written, see GetVTKHDFSizes().
+   */
+  int AppendVTKHDFStep(hid_t fileId, double time, const std::vector<int64_t> &before);
+
+  /**
+   * @brief Reads the number of partitions, points and per topology the
+   * cells and connectivity ids stored in the /VTKHDF group of fileId.
+   */
+  void GetVTKHDFSizes(hid_t fileId, bool polyData, std::vector<int64_t> &sizes);
+  //ETX
+
   //BTX
   // Template to handle writing data in ascii or binary
   // We could change the format into C++ io standard ...
+  // Returns a negative value on error.
   template <class T>
-  void vtkWriteDataArray(hid_t fp, T *data, const char *dsetName,
-                         int num, int numComp)
+  herr_t vtkWriteDataArray(hid_t fp, T *data, const char *dsetName,
+                           int num, int numComp, int codec = VTK_H5_CODEC_NONE)
   {
     // std::cout << "      vtkH5DataWriter::vtkWriteDataArray<T>()" << std::endl;
-    vtkTypeInt32 rank = 1;
-    vtkTypeUInt64 dims[1] = { (vtkTypeUInt64)num * (vtkTypeUInt64)numComp};
     std::string name (dsetName);
-    herr_t err = H5Vtk::H5Lite::writePointerDataset(fp, name, rank, dims, data);
+    herr_t err = this->vtkWriteCompressedDataset(fp, name, (hsize_t)num * (hsize_t)numComp, data, codec, numComp);
     if (err < 0)
     {
       std::cout << "Error writing array with name: " << std::string (dsetName) << std::endl;
+      return err;
+    }
+    return H5Vtk::H5Lite::writeScalarAttribute(fp, name, std::string(H5_NUMCOMPONENTS), numComp);
+  }
+
+  // Writes a one dimensional dataset compressed with codec when it is
+  // available, uncompressed otherwise
+  template <class T>
+  herr_t vtkWriteCompressedDataset(hid_t fp, const std::string &name, hsize_t numValues,
+                                   T *data, int codec, int numComp)
+  {
+    hsize_t dims[1] = { numValues };
+    H5Vtk::H5StorageTuner::Decision decision;
+    hid_t dcpl = -1;
+    if (codec == VTK_H5_CODEC_AUTO)
+    {
+      dcpl = this->CreateTunedProperties(data, H5Vtk::H5Lite::HDFTypeForPrimitive(T()), numValues,
+                                         numComp, decision);
+    }
+    else
+    {
+      dcpl = this->CreateCompressedProperties(codec, numValues, numComp);
     }
-    err = H5Vtk::H5Lite::writeScalarAttribute(fp, name, std::string(H5_NUMCOMPONENTS), numComp);
+    herr_t err = 0;
+    if (dcpl < 0)
+    {
+      err = H5Vtk::H5Lite::writePointerDataset(fp, name, 1, dims, data);
+    }
+    else
+    {
+      int written = this->WriteParallelDataset(fp, name, numValues, dcpl,
+                                               H5Vtk::H5Lite::HDFTypeForPrimitive(T()), data);
+      if (written == 0)
+      {
+        err = H5Vtk::H5Lite::writeFilteredPointerDataset(fp, name, 1, dims, dcpl, data);
+      }
+      else if (written < 0)
+      {
+        err = -1;
+      }
+      H5Pclose(dcpl);
+    }
+    if (err >= 0 && codec == VTK_H5_CODEC_AUTO)
+    {
+      err = this->WriteStorageDecision(fp, name, decision);
+    }
+    return err;
+  }
+
+  // Writes an N dimensional dataset with chunked storage
+  template <class T>
+  int vtkWriteChunkedDataArray(hid_t fp, T *data, const char *dsetName,
+                               int rank, hsize_t* dims, hsize_t* chunkDims, int numComp)
+  {
+    std::string name (dsetName);
+    herr_t err = H5Vtk::H5Lite::writeChunkedPointerDataset(fp, name, rank, dims, chunkDims, data);
+    if (err < 0)
+    {
+      std::cout << "Error writing array with name: " << name << std::endl;
+      return err;
+    }
+    return H5Vtk::H5Lite::writeScalarAttribute(fp, name, std::string(H5_NUMCOMPONENTS), numComp);
+  }
+
+  // Appends rows to a dataset that can grow along its first dimension
+  template <class T>
+  int vtkAppendDataArray(hid_t fp, T *data, const char *dsetName,
+                         vtkIdType num, int numComp)
+  {
+    hsize_t dims[2] = { static_cast<hsize_t>(num), static_cast<hsize_t>(numComp) };
+    herr_t err = H5Vtk::H5Lite::appendPointerDataset(fp, std::string(dsetName), numComp > 1 ? 2 : 1, dims, data);
+    if (err < 0)
+    {
+      std::cout << "Error appending array with name: " << std::string (dsetName) << std::endl;
+    }
+    return err;
   }
 
+  // Description:
+  // Sorts points along the SpaceFillingCurve by their position inside bounds.
+  // pointMap receives the new id of every point.
+  void SortPointsAlongCurve(vtkPoints* points, const double bounds[6], std::vector<vtkIdType> &pointMap);
+
+  // Description:
+  // Sorts the cells of cells along the SpaceFillingCurve by the position of
+  // their center and appends the old id of every cell, plus firstCell, to
+  // cellOrder. Cell arrays sorted one after the other keep their cells apart.
+  void SortCellsAlongCurve(vtkCellArray* cells, vtkPoints* points, const double bounds[6],
+                           vtkIdType firstCell, std::vector<vtkIdType> &cellOrder);
+
+  // Description:
+  // Adds the vtkOriginalPointIds and vtkOriginalCellIds arrays of a
+  // permutation made by the two methods above to output.
+  void AddOriginalIds(vtkDataSet* output, const std::vector<vtkIdType> &pointMap,
+                      const std::vector<vtkIdType> &cellOrder);
+
   /**
    *
    */
@@ -0,0 +1,220 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "vtkH5ImageDataReader.h"
+
+#include "VTKH5Constants.h"
+#include "HDF5/H5Lite.h"
+#include "HDF5/H5Utilities.h"
+
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+vtkCxxRevisionMacro(vtkH5ImageDataReader, "$Revision: 1.1 $");
+vtkStandardNewMacro(vtkH5ImageDataReader);
+
+
+//----------------------------------------------------------------------------
+vtkH5ImageDataReader::vtkH5ImageDataReader()
+{
+  this->FileName = NULL;
+  this->HDFPath = NULL;
+  this->SetNumberOfInputPorts(0);
+  this->HDFError = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkH5ImageDataReader::~vtkH5ImageDataReader()
+{
+  this->SetFileName(NULL);
+  this->SetHDFPath(NULL);
+}
+
+//----------------------------------------------------------------------------
+void vtkH5ImageDataReader::PrintSelf(std::ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+  os << indent << "FileName: " << (this->FileName ? this->FileName : "(none)") << std::endl;
+  os << indent << "HDFPath: " << (this->HDFPath ? this->HDFPath : "(none)") << std::endl;
+}
+
+//----------------------------------------------------------------------------
+int vtkH5ImageDataReader::FillOutputPortInformation(int port, vtkInformation* info)
+{
+  info->Set(vtkDataObject::DATA_TYPE_NAME(), "vtkImageData");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+vtkImageData* vtkH5ImageDataReader::GetOutput()
+{
+  return this->GetOutput(0);
+}
+
+//----------------------------------------------------------------------------
+vtkImageData* vtkH5ImageDataReader::GetOutput(int idx)
+{
+  return vtkImageData::SafeDownCast(this->GetOutputDataObject(idx));
+}
+
+//----------------------------------------------------------------------------
+void vtkH5ImageDataReader::SetOutput(vtkImageData *output)
+{
+  this->GetExecutive()->SetOutputData(0, output);
+}
+
+//----------------------------------------------------------------------------
+int vtkH5ImageDataReader::RequestInformation( vtkInformation *vtkNotUsed(request),
+                                      vtkInformationVector **vtkNotUsed(inputVector),
+                                      vtkInformationVector *outputVector)
+{
+  if (NULL == this->FileName || NULL == this->HDFPath)
+  {
+    return 1;
+  }
+  HDF_ERROR_HANDLER_OFF;
+  hid_t fileId = H5Vtk::H5Utilities::openFile(this->FileName, true);
+  HDF_ERROR_HANDLER_ON;
+  if (fileId < 0)
+  {
+    // RequestData reports the error
+    return 1;
+  }
+  int wholeExtent[6];
+  double origin[3];
+  double spacing[3];
+  int ok = this->readImageGeometry(fileId, this->HDFPath, wholeExtent, origin, spacing);
+  H5Vtk::H5Utilities::closeFile(fileId);
+  if (!ok)
+  {
+    vtkErrorMacro(<< "Could not read the geometry of " << this->HDFPath << " from " << this->FileName);
+    return 0;
+  }
+
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent, 6);
+  outInfo->Set(vtkDataObject::ORIGIN(), origin, 3);
+  outInfo->Set(vtkDataObject::SPACING(), spacing, 3);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkH5ImageDataReader::RequestData( vtkInformation *vtkNotUsed(request),
+                                      vtkInformationVector **vtkNotUsed(inputVector),
+                                      vtkInformationVector *outputVector)
+{
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  vtkImageData *output = vtkImageData::SafeDownCast( outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  HDF_ERROR_HANDLER_OFF;
+  hid_t fileId = H5Vtk::H5Utilities::openFile(this->FileName, true);
+  if (fileId < 0)
+  {
+   this->HDFError= fileId;
+   HDF_ERROR_HANDLER_ON;
+   return 1;
+  }
+
+  int wholeExtent[6];
+  double origin[3];
+  double spacing[3];
+  if (!this->readImageGeometry(fileId, this->HDFPath, wholeExtent, origin, spacing))
+  {
+    H5Vtk::H5Utilities::closeFile(fileId);
+    this->HDFError = -1;
+    HDF_ERROR_HANDLER_ON;
+    return 1;
+  }
+
+  // Only read the part of the image the pipeline asked for
+  int extent[6];
+  if (!this->GetRequestedExtent(outInfo, wholeExtent, extent))
+  {
+    // Empty request
+    H5Vtk::H5Utilities::closeFile(fileId);
+    HDF_ERROR_HANDLER_ON;
+    return 1;
+  }
+
+  vtkImageData* image = this->loadImageData(fileId, this->HDFPath, extent);
+  if (NULL != image)
+  {
+    output->ShallowCopy(image);
+    image->Delete();
+  }
+
+  herr_t err = H5Vtk::H5Utilities::closeFile(fileId);
+  this->HDFError = err;
+  HDF_ERROR_HANDLER_ON;
+  return 1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5ImageDataReader::readImageGeometry(hid_t fileId, const std::string &hdfpath,
+                                            int wholeExtent[6], double origin[3], double spacing[3])
+{
+  std::string dataObjectType;
+  herr_t err = H5Vtk::H5Lite::readStringAttribute(fileId, hdfpath, H5_VTK_DATA_OBJECT, dataObjectType);
+  if (err < 0 || dataObjectType.compare(H5_VTK_IMAGE_DATA) != 0)
+  {
+    std::cout << "HDF Group " << hdfpath << " is NOT type vtkImageData. It is " << dataObjectType << std::endl;
+    return 0;
+  }
+  if (!this->ReadWholeExtent(fileId, hdfpath, wholeExtent))
+  {
+    return 0;
+  }
+  err = H5Vtk::H5Lite::readPointerAttribute(fileId, hdfpath, H5_ORIGIN, origin);
+  if (err >= 0)
+  {
+    err = H5Vtk::H5Lite::readPointerAttribute(fileId, hdfpath, H5_SPACING, spacing);
+  }
+  if (err < 0)
+  {
+    return 0;
+  }
+  return 1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkImageData* vtkH5ImageDataReader::loadImageData(hid_t fileId, const std::string &hdfpath, const int extent[6])
+{
+  int wholeExtent[6];
+  double origin[3];
+  double spacing[3];
+  if (!this->readImageGeometry(fileId, hdfpath, wholeExtent, origin, spacing))
+  {
+    return NULL;
+  }
+  hid_t rootId = H5Gopen(fileId, hdfpath.c_str(), H5P_DEFAULT);
+  if (rootId < 0)
+  {
+    this->HDFError = rootId;
+    return NULL;
+  }
+
+  vtkImageData* output = vtkImageData::New();
+  output->SetExtent(const_cast<int*>(extent));
+  output->SetOrigin(origin);
+  output->SetSpacing(spacing);
+
+  if (this->ReadStructuredData(rootId, output, wholeExtent, extent) == 0)
+  {
+    this->HDFError = -1;
+  }
+
+  H5Gclose(rootId);
+  return output;
+}
@@ -0,0 +1,133 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+#ifndef _VTKH5IMAGEDATAREADER_H_
+#define _VTKH5IMAGEDATAREADER_H_
+
+//-- HDF5 includes
+#include <hdf5.h>
+
+//-- Superclass
+#include "vtkH5DataReader.h"
+
+class vtkInformation;
+class vtkInformationVector;
+class vtkImageData;
+
+
+/**
+* @class vtkH5ImageDataReader vtkH5ImageDataReader.h vtkH5ImageDataReader.h
+* @brief The class reads vtkImageData Objects written by vtkH5ImageDataWriter.
+* The whole extent, origin and spacing are reported in RequestInformation and
+* RequestData only reads the requested UPDATE_EXTENT, so slicing or streaming
+* a large volume only touches the chunks that intersect the request.
+* @author Mike Jackson for BlueQuartz Software
+* @date Nov 2010
+* @version $Revision: 1.1 $
+*/
+class VTK_EXPORT vtkH5ImageDataReader : public vtkH5DataReader
+{
+public:
+  static vtkH5ImageDataReader *New();
+  vtkTypeRevisionMacro(vtkH5ImageDataReader,vtkH5DataReader);
+
+  //BTX
+  /**
+   * @brief Prints information about this class. Good for debugging
+   * @param os Output stream to write to
+   * @param indent The amount of indentation
+   */
+  void PrintSelf(std::ostream& os, vtkIndent indent);
+//ETX
+
+  // Description:
+  // Specify file name of the h5i file to read.
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+
+  vtkSetStringMacro(HDFPath);
+  vtkGetStringMacro(HDFPath);
+
+  // Description:
+  // Get the output of this reader.
+  vtkImageData *GetOutput();
+  vtkImageData *GetOutput(int idx);
+  void SetOutput(vtkImageData *output);
+
+  vtkSetMacro(HDFError, int);
+  vtkGetMacro(HDFError, int);
+
+  //BTX
+  /**
+   * @brief Reads the geometry attributes of the image at hdfpath
+   * @param fileId The HDF5 fileId
+   * @param hdfpath The internal hdf5 path to the data set
+   * @param wholeExtent Receives the extent stored in the file
+   * @param origin Receives the origin
+   * @param spacing Receives the spacing
+   * @return 1 on success, 0 on error
+   */
+  virtual int readImageGeometry(hid_t fileId, const std::string &hdfpath,
+                                int wholeExtent[6], double origin[3], double spacing[3]);
+
+  /**
+   * @brief Loads the part of the image at hdfpath covered by extent
+   * @param fileId The HDF5 fileId
+   * @param hdfpath The internal hdf5 path to the data set
+   * @param extent The extent to read. Must be inside the whole extent
+   * @return NULL pointer if error, otherwise valid vtkImageData object
+   */
+  virtual vtkImageData* loadImageData(hid_t fileId, const std::string &hdfpath, const int extent[6]);
+  //ETX
+
+protected:
+  vtkH5ImageDataReader();
+ ~vtkH5ImageDataReader();
+
+ /**
+ * @brief Standard vtk 5.x pipeline method. This method is used to set what type
+ * of outputs this filter produces.
+ * @param port The port to get output information for
+ * @param information The vtkInformation pointer
+ * @return 1 on success, 0 on error
+ */
+ virtual int FillOutputPortInformation(int port, vtkInformation* information);
+
+ /**
+  * @brief Reads the UPDATE_EXTENT of the image
+  * @param vtkNotUsed vtkInformation Object
+  * @param vtkNotUsed vtkInformationVector for the inputs
+  * @param outputVector vtkInformationVector for the outputs
+  * @return 1 on success, 0 on error
+  */
+ virtual int RequestData( vtkInformation *vtkNotUsed(request),
+                  vtkInformationVector **vtkNotUsed(inputVector),
+                  vtkInformationVector *outputVector);
+
+ /**
+  * @brief Reports WHOLE_EXTENT, ORIGIN and SPACING of the image
+  * @param request vtkInformation Object
+  * @param inputVector vtkInformationVector for the inputs
+  * @param outputVector vtkInformationVector for the outputs
+  * @return 1 on success, 0 on error
+  */
+ virtual int RequestInformation(vtkInformation *request,
+                                vtkInformationVector **inputVector,
+                                vtkInformationVector *outputVector);
+
+private:
+
+  char* FileName;
+  char* HDFPath;
+  int HDFError;
+
+
+  vtkH5ImageDataReader(const vtkH5ImageDataReader&);  // Not implemented.
+  void operator=(const vtkH5ImageDataReader&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,198 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "vtkH5ImageDataWriter.h"
+#include "VTKH5Constants.h"
+
+#include "HDF5/H5Utilities.h"
+
+#include "vtkObjectFactory.h"
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkImageData.h>
+
+#define APPEND_DATA_TRUE 1
+#define APPEND_DATA_FALSE 0
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkCxxRevisionMacro( vtkH5ImageDataWriter, "$Revision: 1.1 $" );
+vtkStandardNewMacro( vtkH5ImageDataWriter );
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkH5ImageDataWriter::vtkH5ImageDataWriter()
+{
+  this->FileName = NULL;
+  this->HDFPath = NULL;
+  this->SetNumberOfInputPorts(1);
+  this->AppendData = APPEND_DATA_TRUE;
+  this->ChunkSize = 32;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkH5ImageDataWriter::~vtkH5ImageDataWriter()
+{
+  this->SetFileName( NULL );
+  this->SetHDFPath(NULL);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5ImageDataWriter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+  os << indent << "ChunkSize: " << this->ChunkSize << std::endl;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5ImageDataWriter::FillInputPortInformation(int, vtkInformation *info)
+{
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkImageData");
+  return 1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkImageData* vtkH5ImageDataWriter::GetInput()
+{
+  return vtkImageData::SafeDownCast(this->Superclass::GetInput());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkImageData* vtkH5ImageDataWriter::GetInput(int port)
+{
+  return vtkImageData::SafeDownCast(this->Superclass::GetInput(port));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5ImageDataWriter::WriteData()
+{
+  hid_t fileId = -1;
+  // Try to open a file to append data into
+  if (APPEND_DATA_TRUE == this->AppendData)
+  {
+    fileId = H5Vtk::H5Utilities::openFile(this->FileName, false);
+  }
+  // No file was found or we are writing new data only to a clean file
+  if (APPEND_DATA_FALSE == this->AppendData || fileId < 0)
+  {
+    fileId = H5Vtk::H5Utilities::createFile (this->FileName);
+  }
+
+  //Something went wrong either opening or creating the file. Error messages have
+  // Alread been written at this point so just return.
+  if (fileId < 0)
+  {
+    vtkErrorMacro(<< "The hdf5 file could not be opened or created: " << this->FileName);
+    return;
+  }
+
+  if (this->VTKHDFLayout)
+  {
+    vtkWarningMacro(<< "The VTKHDF layout is only written for polydata and unstructured grids. "
+                    << "Writing " << this->HDFPath << " in the h5i layout.");
+  }
+
+  herr_t err = H5Vtk::H5Utilities::createGroupsFromPath(this->HDFPath, fileId);
+  if (err < 0)
+  {
+    H5Vtk::H5Utilities::closeFile(fileId);
+    return;
+  }
+  hid_t fp = H5Gopen(fileId, this->HDFPath, H5P_DEFAULT );
+  err = H5Vtk::H5Lite::writeStringAttribute(fileId, this->HDFPath, H5_VTK_DATA_OBJECT, H5_VTK_IMAGE_DATA );
+  if(err < 0)
+  {
+    H5Gclose(fp);
+    H5Vtk::H5Utilities::closeFile(fileId);
+    return;
+  }
+  vtkImageData *input = this->GetInput();
+  int errorOccured = 0;
+
+  // The geometry of the image lives in attributes of the group
+  int extent[6];
+  input->GetExtent(extent);
+  double origin[3];
+  double spacing[3];
+  input->GetOrigin(origin);
+  input->GetSpacing(spacing);
+  err = this->WriteWholeExtent(fileId, this->HDFPath, extent);
+  hsize_t attrDims[1] = { 3 };
+  if (err >= 0)
+  {
+    err = H5Vtk::H5Lite::writePointerAttribute(fileId, this->HDFPath, H5_ORIGIN, 1, attrDims, origin);
+  }
+  if (err >= 0)
+  {
+    err = H5Vtk::H5Lite::writePointerAttribute(fileId, this->HDFPath, H5_SPACING, 1, attrDims, spacing);
+  }
+  if (err < 0)
+  {
+    errorOccured = 1;
+  }
+
+  int dims[3];
+  input->GetDimensions(dims);
+  if (!errorOccured && this->WriteStructuredData(fp, input, dims, this->ChunkSize) == 0)
+  {
+    errorOccured = 1;
+  }
+
+  if(errorOccured)
+    {
+    vtkErrorMacro(<< "Error occured writing ImageData to HDF5 file.")
+    }
+
+  // Close the ImageData group when we are finished with it
+  err = H5Gclose(fp);
+
+  // Close the file when we are finished with it
+  H5Vtk::H5Utilities::closeFile(fileId);
+
+  this->WriteXdmfDescriptor();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5ImageDataWriter::writeVtkObjectIndex(std::vector<std::string> &paths)
+{
+  hid_t fileId = -1;
+  herr_t err = 0;
+  // Try to open a file
+  fileId = H5Vtk::H5Utilities::openFile(this->FileName, false);
+  if (fileId < 0)
+  {
+    return -1;
+  }
+  err = this->writeObjectIndex(fileId, paths);
+
+  // Close the file when we are finished with it
+  H5Vtk::H5Utilities::closeFile(fileId);
+
+  // The index sets the order of the grids in the descriptor
+  this->WriteXdmfDescriptor();
+
+  return err;
+}
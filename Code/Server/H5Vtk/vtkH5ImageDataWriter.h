@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+#ifndef VTKH5IMAGEDATAWRITER_H_
+#define VTKH5IMAGEDATAWRITER_H_
+
+
+#include "vtkH5DataWriter.h"
+
+//-- Hdf5 includes
+#include <hdf5.h>
+
+#include "HDF5/H5Lite.h"
+
+#ifndef VTK_EXPORT
+#define VTK_EXPORT
+#endif
+
+class vtkImageData;
+
+/**
+* @class vtkH5ImageDataWriter vtkH5ImageDataWriter.h vtkH5ImageDataWriter.h
+* @brief This class writes a vtkImageData object to an HDF5 based file
+* using the same layout that vtkH5ImageDataReader reads. Every point and cell
+* data array is stored as a chunked (z, y, x[, components]) dataset so that a
+* sub extent can be read without reading the whole volume.
+* @author Mike Jackson for BlueQuartz Software
+* @date Nov 2010
+* @version $Revision: 1.1 $
+*/
+class VTK_EXPORT vtkH5ImageDataWriter : public vtkH5DataWriter
+{
+public:
+  static vtkH5ImageDataWriter* New();
+  vtkTypeRevisionMacro( vtkH5ImageDataWriter, vtkH5DataWriter );
+  void PrintSelf( ostream&, vtkIndent );
+
+  // Description:
+  // Specify file name of the h5i file to write.
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+
+  vtkSetStringMacro(HDFPath);
+  vtkGetStringMacro(HDFPath);
+
+  vtkSetMacro(AppendData, vtkTypeInt32);
+  vtkGetMacro(AppendData, vtkTypeInt32);
+  vtkBooleanMacro(AppendData, vtkTypeInt32);
+
+  // Description:
+  // Edge length, in samples, of the bricks the arrays are chunked into.
+  // Smaller bricks make small sub extent reads cheaper, larger bricks make
+  // reading the whole volume cheaper. Default is 32.
+  vtkSetClampMacro(ChunkSize, int, 1, VTK_INT_MAX);
+  vtkGetMacro(ChunkSize, int);
+
+  // Description:
+  // Get the input to this writer.
+  vtkImageData* GetInput();
+  vtkImageData* GetInput(int port);
+
+  //BTX
+  int writeVtkObjectIndex(std::vector<std::string> &paths);
+  //ETX
+
+protected:
+  vtkH5ImageDataWriter();
+  ~vtkH5ImageDataWriter();
+
+  virtual void WriteData();
+
+  /**
+  * @brief Standard vtk 5.x pipeline method. This method is used to set what type
+  * of outputs this filter produces.
+  * @param port The port to get output information for
+  * @param information The vtkInformation pointer
+  * @return 1 on success, 0 on error
+  */
+  virtual int FillInputPortInformation(int port, vtkInformation* information);
+
+private:
+
+  char* FileName;
+
+  char* HDFPath;
+
+  vtkTypeInt32 AppendData;
+
+  int ChunkSize;
+
+
+  vtkH5ImageDataWriter(const vtkH5ImageDataWriter&);  // Not implemented.
+  void operator=(const vtkH5ImageDataWriter&);  // Not implemented.
+
+
+};
+
+#endif /*VTKH5IMAGEDATAWRITER_H_*/
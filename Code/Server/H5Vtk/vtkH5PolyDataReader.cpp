@@ -12,6 +12,8 @@
 #include "VTKH5Constants.h"
 #include "HDF5/H5Lite.h"
 #include "HDF5/H5Utilities.h"
+#include "HDF5/H5IOStatistics.h"
+#include "HDF5/H5ConnectivityCodec.h"
 
 #include <vtkPolyData.h>
 #include <vtkCellArray.h>
@@ -30,6 +32,7 @@
 #include <vtkErrorCode.h>
 #include <vtkFieldData.h>
 #include <vtkFloatArray.h>
+#include <vtkIdList.h>
 #include <vtkIdTypeArray.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
@@ -38,6 +41,7 @@
 #include <vtkLookupTable.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
+#include <vtkPoints.h>
 #include <vtkPointSet.h>
 #include <vtkRectilinearGrid.h>
 #include <vtkShortArray.h>
@@ -62,6 +66,8 @@ vtkStandardNewMacro(vtkH5PolyDataReader);
 
 #include <ctype.h>
 #include <sys/stat.h>
+#include <algorithm>
+#include <sstream>
 
 #define ALLOCATE_AND_READ_ARRAY(array, VTK_TYPE, numComp, numTuples, parentId, dsetName, dType ) \
 array = VTK_TYPE##Array::New();\
@@ -82,6 +88,9 @@ vtkH5PolyDataReader::vtkH5PolyDataReader()
   this->HDFPath = NULL;
   this->SetNumberOfInputPorts(0);
   this->HDFError = 0;
+  this->LevelOfDetail = 0;
+  this->TriangleBudget = 0;
+  this->GenerateImplicitVertices = 1;
 }
 
 //----------------------------------------------------------------------------
@@ -130,8 +139,14 @@ int vtkH5PolyDataReader::RequestData( vtkInformation *vtkNotUsed(request),
   vtkInformation *outInfo = outputVector->GetInformationObject(0);
   vtkPolyData *output = vtkPolyData::SafeDownCast( outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
+  // RequestInformation already warned that the object does not fit
+  if (this->OverMemoryBudget)
+  {
+    return 1;
+  }
+
   HDF_ERROR_HANDLER_OFF;
-  hid_t fileId = H5Vtk::H5Utilities::openFile(this->FileName, false);
+  hid_t fileId = this->OpenFile(false);
   // Something went wrong either opening or creating the file. Error messages have
   // Alread been written at this point so just return.
   if (fileId < 0)
@@ -141,7 +156,18 @@ int vtkH5PolyDataReader::RequestData( vtkInformation *vtkNotUsed(request),
    return 1;
   }
 
-  vtkPolyData* p = loadPolyData(fileId, this->HDFPath);
+  vtkPolyData* p = NULL;
+  if (this->IsVTKHDF(fileId, H5_VTKHDF_POLYDATA))
+  {
+    this->SelectVTKHDFTimeStep(outInfo, output);
+    int piece = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+    int numPieces = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
+    p = loadVTKHDFPolyData(fileId, piece, numPieces);
+  }
+  else
+  {
+    p = loadPolyData(fileId, this->selectLevelOfDetail(fileId, this->HDFPath));
+  }
   if (NULL != p)
   {
       output->ShallowCopy(p);
@@ -149,13 +175,46 @@ int vtkH5PolyDataReader::RequestData( vtkInformation *vtkNotUsed(request),
     }
 
   // Close the file
-  err = H5Vtk::H5Utilities::closeFile(fileId);
+  err = this->CloseFile(fileId);
   this->HDFError = err;
   HDF_ERROR_HANDLER_ON;
   return 1;
 }
 
 
+//----------------------------------------------------------------------------
+int vtkH5PolyDataReader::RequestInformation( vtkInformation *vtkNotUsed(request),
+                                      vtkInformationVector **vtkNotUsed(inputVector),
+                                      vtkInformationVector *outputVector)
+{
+  this->ResetMemoryBudget();
+  if (NULL == this->FileName)
+  {
+    return 1;
+  }
+  HDF_ERROR_HANDLER_OFF;
+  hid_t fileId = this->OpenFile(true);
+  HDF_ERROR_HANDLER_ON;
+  if (fileId < 0)
+  {
+    // RequestData reports the error
+    return 1;
+  }
+  if (this->IsVTKHDF(fileId, H5_VTKHDF_POLYDATA))
+  {
+    // The partitions of the file are distributed over any number of pieces
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::MAXIMUM_NUMBER_OF_PIECES(), -1);
+    this->ReadVTKHDFTimeSteps(fileId, outInfo);
+  }
+  else if (NULL != this->HDFPath)
+  {
+    this->ApplyMemoryBudget(fileId, this->HDFPath);
+  }
+  this->CloseFile(fileId);
+  return 1;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -213,12 +272,28 @@ vtkPolyData* vtkH5PolyDataReader::loadPolyData(hid_t fileId, const std::string &
     //          return 1;
     //        }
 
-    //Read the VERTICES from the file
+    //Read the VERTICES from the file, or make them for a point cloud
     vtkCellArray *verts = vtkCellArray::New();
-    err = readCells(output, rootId, verts, H5_VERTICES);
-    if (err == 1)
+    bool skippedVerts = false;
+    if (this->hasImplicitVertices(rootId))
+    {
+      if (this->GenerateImplicitVertices)
+      {
+        this->buildImplicitVertices(output->GetNumberOfPoints(), verts);
+        output->SetVerts(verts);
+      }
+      else
+      {
+        skippedVerts = true;
+      }
+    }
+    else
     {
-      output->SetVerts(verts);
+      err = readCells(output, rootId, verts, H5_VERTICES);
+      if (err == 1)
+      {
+        output->SetVerts(verts);
+      }
     }
     verts->Delete();
 
@@ -254,7 +329,10 @@ vtkPolyData* vtkH5PolyDataReader::loadPolyData(hid_t fileId, const std::string &
     }
     tris->Delete();
 
-    output->BuildLinks();
+    if (!this->SkipLinks)
+    {
+      output->BuildLinks();
+    }
     output->ComputeBounds();
 
     // Read any FIELD_DATA
@@ -267,8 +345,8 @@ vtkPolyData* vtkH5PolyDataReader::loadPolyData(hid_t fileId, const std::string &
       H5Gclose(gid);
     }
 
-    // Read CELL_DATA
-    gid = H5Gopen(rootId, H5_CELL_DATA_GROUP_NAME, H5P_DEFAULT);
+    // Read CELL_DATA, which belongs to the vertices first if there are any
+    gid = skippedVerts ? -1 : H5Gopen(rootId, H5_CELL_DATA_GROUP_NAME, H5P_DEFAULT);
     if (gid > 0)
     {
       int err = this->ReadCellData(output, rootId, gid);
@@ -297,7 +375,7 @@ vtkPolyData* vtkH5PolyDataReader::loadPolyData(hid_t fileId, const std::string &
 
     if (!output->GetPoints())
     vtkWarningMacro(<<"No points read!");
-    if (!(output->GetVerts() || output->GetLines() || output->GetPolys() || output->GetStrips()))
+    if (!skippedVerts && !(output->GetVerts() || output->GetLines() || output->GetPolys() || output->GetStrips()))
     vtkWarningMacro(<<"No topology read!");
 
     err = H5Gclose(rootId);
@@ -316,6 +394,131 @@ vtkPolyData* vtkH5PolyDataReader::loadPolyData(hid_t fileId, const std::string &
 }
 
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkPolyData* vtkH5PolyDataReader::loadVTKHDFPolyData(hid_t fileId, int piece, int numPieces)
+{
+  hid_t gid = H5Gopen(fileId, H5_VTKHDF_GROUP, H5P_DEFAULT);
+  if (gid < 0)
+  {
+    this->HDFError = gid;
+    return NULL;
+  }
+  VTKHDFSelection selection;
+  if (this->SelectVTKHDFPartitions(gid, piece, numPieces, selection) == 0)
+  {
+    H5Gclose(gid);
+    this->HDFError = -1;
+    return NULL;
+  }
+
+  vtkPolyData* output = vtkPolyData::New();
+  vtkDataArray* data = this->ReadArrayRows(gid, H5_VTKHDF_POINTS, selection.PointStart, selection.PointCount);
+  if (NULL != data)
+  {
+    vtkPoints* points = vtkPoints::New();
+    points->SetData(data);
+    data->Delete();
+    output->SetPoints(points);
+    points->Delete();
+  }
+
+  const char* topologies[4] = { H5_VTKHDF_VERTICES, H5_VTKHDF_LINES, H5_VTKHDF_POLYGONS, H5_VTKHDF_STRIPS };
+  std::vector<vtkIdType> partitionCells[4];
+  vtkTypeUInt64 cellStart = 0;
+  vtkTypeUInt64 cellCount = 0;
+  for (int t = 0; t < 4; ++t)
+  {
+    partitionCells[t].assign(selection.NumberOfPartitions, 0);
+    if (H5Lexists(gid, topologies[t], H5P_DEFAULT) <= 0)
+    {
+      continue;
+    }
+    hid_t topoId = H5Gopen(gid, topologies[t], H5P_DEFAULT);
+    vtkTypeUInt64 start = 0;
+    vtkTypeUInt64 count = 0;
+    vtkCellArray* cells = this->ReadVTKHDFCells(topoId, selection, start, count, partitionCells[t], NULL);
+    H5Gclose(topoId);
+    if (NULL == cells)
+    {
+      vtkErrorMacro(<< "Could not read the " << topologies[t] << " of the VTKHDF file");
+      this->HDFError = -1;
+      partitionCells[t].assign(selection.NumberOfPartitions, 0);
+      continue;
+    }
+    switch (t)
+    {
+      case 0: output->SetVerts(cells); break;
+      case 1: output->SetLines(cells); break;
+      case 2: output->SetPolys(cells); break;
+      default: output->SetStrips(cells); break;
+    }
+    cells->Delete();
+    cellStart += start;
+    cellCount += count;
+  }
+  if (!this->SkipLinks)
+  {
+    output->BuildLinks();
+  }
+  output->ComputeBounds();
+
+  // Within the file the cell data of every partition is ordered vertices,
+  // lines, polygons, strips. With more than one partition the rows have to be
+  // regrouped into the vtkPolyData order.
+  vtkIdList* order = NULL;
+  if (selection.NumberOfPartitions > 1)
+  {
+    order = vtkIdList::New();
+    order->SetNumberOfIds(static_cast<vtkIdType>(cellCount));
+    std::vector<vtkIdType> partitionRow(selection.NumberOfPartitions, 0);
+    vtkIdType row = 0;
+    for (vtkTypeUInt64 p = 0; p < selection.NumberOfPartitions; ++p)
+    {
+      partitionRow[p] = row;
+      for (int t = 0; t < 4; ++t)
+      {
+        row += partitionCells[t][p];
+      }
+    }
+    vtkIdType cellId = 0;
+    for (int t = 0; t < 4; ++t)
+    {
+      for (vtkTypeUInt64 p = 0; p < selection.NumberOfPartitions; ++p)
+      {
+        vtkIdType first = partitionRow[p];
+        for (int before = 0; before < t; ++before)
+        {
+          first += partitionCells[before][p];
+        }
+        for (vtkIdType c = 0; c < partitionCells[t][p]; ++c)
+        {
+          order->SetId(cellId++, first + c);
+        }
+      }
+    }
+  }
+
+  vtkFieldData* fd = this->ReadVTKHDFFieldData(gid);
+  if (NULL != fd)
+  {
+    output->SetFieldData(fd);
+    fd->Delete();
+  }
+  if (this->ReadVTKHDFArrays(gid, H5_VTKHDF_CELL_DATA, output->GetCellData(), cellStart, cellCount, order) == 0
+   || this->ReadVTKHDFArrays(gid, H5_VTKHDF_POINT_DATA, output->GetPointData(), selection.PointStart, selection.PointCount, NULL) == 0)
+  {
+    this->HDFError = -1;
+  }
+  if (order)
+  {
+    order->Delete();
+  }
+  H5Gclose(gid);
+  return output;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -323,6 +526,10 @@ int vtkH5PolyDataReader::readCells(vtkPolyData* output, hid_t rootId, vtkCellArr
 {
   int  ncells, i;
   herr_t err = -1;
+  if (H5Vtk::H5ConnectivityCodec::isEncoded(rootId, dsetname))
+  {
+    return this->ReadEncodedCells(rootId, dsetname, verts);
+  }
   vtkAbstractArray* array = this->ReadArray(rootId, dsetname);
   if (NULL != array)
   {
@@ -337,6 +544,7 @@ int vtkH5PolyDataReader::readCells(vtkPolyData* output, hid_t rootId, vtkCellArr
 
     vtkIdTypeArray* data = vtkIdTypeArray::New();
     vtkIdType* dataPtr = data->WritePointer(0, size);
+    H5Vtk::H5IOStatistics::allocated(static_cast<vtkTypeUInt64>(size) * sizeof(vtkIdType));
     if (H5Tequal(typeId, H5T_NATIVE_INT64))
     {
       vtkTypeInt64Array* arrayPtr = vtkTypeInt64Array::SafeDownCast(array);
@@ -371,12 +579,85 @@ int vtkH5PolyDataReader::readCells(vtkPolyData* output, hid_t rootId, vtkCellArr
   return 0;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool vtkH5PolyDataReader::hasImplicitVertices(hid_t rootId)
+{
+  return H5Lexists(rootId, H5_POINTS, H5P_DEFAULT) > 0
+      && H5Aexists_by_name(rootId, H5_POINTS, H5_IMPLICIT_VERTICES, H5P_DEFAULT) > 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5PolyDataReader::buildImplicitVertices(vtkIdType numPoints, vtkCellArray* verts)
+{
+  vtkIdTypeArray* data = vtkIdTypeArray::New();
+  vtkIdType* dataPtr = data->WritePointer(0, 2 * numPoints);
+  H5Vtk::H5IOStatistics::allocated(static_cast<vtkTypeUInt64>(numPoints) * 2 * sizeof(vtkIdType));
+  for (vtkIdType i = 0; i < numPoints; ++i)
+  {
+    dataPtr[2 * i] = 1;
+    dataPtr[2 * i + 1] = i;
+  }
+  verts->SetCells(numPoints, data);
+  data->Delete();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::string vtkH5PolyDataReader::selectLevelOfDetail(hid_t fileId, const std::string &hdfpath)
+{
+  int32_t numLevels = 0;
+  if (H5Aexists_by_name(fileId, hdfpath.c_str(), H5_LOD_NUMBER_OF_LEVELS, H5P_DEFAULT) <= 0
+      || H5Vtk::H5Lite::readScalarAttribute(fileId, hdfpath, H5_LOD_NUMBER_OF_LEVELS, numLevels) < 0
+      || numLevels < 1)
+  {
+    return hdfpath;
+  }
+  int level = std::min(this->LevelOfDetail, static_cast<int>(numLevels));
+  if (this->TriangleBudget > 0)
+  {
+    // Levels get coarser with every step so the first that fits is the finest
+    level = numLevels;
+    for (int l = 0; l <= numLevels; ++l)
+    {
+      std::stringstream path;
+      path << hdfpath;
+      if (l > 0)
+      {
+        path << "/" << H5_LOD_GROUP << "/" << l;
+      }
+      int64_t numCells = 0;
+      if (H5Vtk::H5Lite::readScalarAttribute(fileId, path.str(), H5_LOD_NUMBER_OF_CELLS, numCells) >= 0
+          && numCells <= this->TriangleBudget)
+      {
+        level = l;
+        break;
+      }
+    }
+  }
+  if (level == 0)
+  {
+    return hdfpath;
+  }
+  vtkDebugMacro(<< "Reading level of detail " << level << " of " << hdfpath);
+  std::stringstream path;
+  path << hdfpath << "/" << H5_LOD_GROUP << "/" << level;
+  return path.str();
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
 void vtkH5PolyDataReader::PrintSelf(std::ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "LevelOfDetail: " << this->LevelOfDetail << "\n";
+  os << indent << "TriangleBudget: " << this->TriangleBudget << "\n";
+  os << indent << "GenerateImplicitVertices: " << this->GenerateImplicitVertices << "\n";
 }
 
 #if 0
@@ -54,6 +54,28 @@ public:
   vtkSetStringMacro(HDFPath);
   vtkGetStringMacro(HDFPath);
 
+  // Description:
+  // Level of detail to read from a surface written with levels (see
+  // vtkH5PolyDataWriter::SetNumberOfLevels). 0 (the default) is the full
+  // resolution, higher levels are coarser and are clamped to the coarsest
+  // level in the file.
+  vtkSetClampMacro(LevelOfDetail, int, 0, VTK_INT_MAX);
+  vtkGetMacro(LevelOfDetail, int);
+
+  // Description:
+  // When larger than 0, overrides LevelOfDetail with the finest level that
+  // has at most TriangleBudget cells, or the coarsest level if none has.
+  vtkSetClampMacro(TriangleBudget, vtkIdType, 0, VTK_ID_MAX);
+  vtkGetMacro(TriangleBudget, vtkIdType);
+
+  // Description:
+  // Point clouds with one vertex per point are written without VERTICES
+  // (see vtkH5PolyDataWriter). When on (the default) the reader makes the
+  // vertex cells, when off the output has only points and no cell data.
+  vtkSetMacro(GenerateImplicitVertices, int);
+  vtkGetMacro(GenerateImplicitVertices, int);
+  vtkBooleanMacro(GenerateImplicitVertices, int);
+
 
   // Description:
   // Get the output of this reader.
@@ -74,6 +96,16 @@ public:
     * @return NULL pointer if error, otherwise valid vtkPolyData object
     */
    virtual vtkPolyData* loadPolyData(hid_t fileId, const std::string &hdfpath);
+
+   /**
+    * @brief Loads the partitions of the /VTKHDF group that belong to the given
+    * piece. Each dataset is read with a single hyperslab.
+    * @param fileId The HDF5 fileId
+    * @param piece The piece to read
+    * @param numPieces The number of pieces the partitions are distributed over
+    * @return NULL pointer if error, otherwise valid vtkPolyData object
+    */
+   virtual vtkPolyData* loadVTKHDFPolyData(hid_t fileId, int piece, int numPieces);
    //ETX
 
 protected:
@@ -101,6 +133,18 @@ protected:
                   vtkInformationVector **vtkNotUsed(inputVector),
                   vtkInformationVector *outputVector);
 
+ /**
+  * @brief Estimates the memory needed to read the object at HDFPath and decides
+  * how the read has to be degraded to fit the MemoryBudget.
+  * @param request vtkInformation Object
+  * @param inputVector vtkInformationVector for the inputs
+  * @param outputVector vtkInformationVector for the outputs
+  * @return 1 on success, 0 on error
+  */
+ virtual int RequestInformation(vtkInformation *request,
+                                vtkInformationVector **inputVector,
+                                vtkInformationVector *outputVector);
+
 
 //BTX
   /**
@@ -111,6 +155,24 @@ protected:
    * @param dsetname
    */
   virtual int readCells(vtkPolyData* output, hid_t rootId, vtkCellArray* verts, const std::string &dsetname);
+
+  /**
+   * @brief Returns the path of the level of detail of hdfpath selected by
+   * LevelOfDetail and TriangleBudget, or hdfpath itself if the object has no
+   * levels or the full resolution is selected.
+   */
+  std::string selectLevelOfDetail(hid_t fileId, const std::string &hdfpath);
+
+  /**
+   * @brief Returns true if the POINTS of the group rootId carry the
+   * ImplicitVertices attribute in place of a VERTICES dataset.
+   */
+  bool hasImplicitVertices(hid_t rootId);
+
+  /**
+   * @brief Fills verts with one vertex per point in point order.
+   */
+  void buildImplicitVertices(vtkIdType numPoints, vtkCellArray* verts);
   //ETX
 
 private:
@@ -118,6 +180,9 @@ private:
   char* FileName;
   char* HDFPath;
   int HDFError;
+  int LevelOfDetail;
+  vtkIdType TriangleBudget;
+  int GenerateImplicitVertices;
 
 
   vtkH5PolyDataReader(const vtkH5PolyDataReader&);  // Not implemented.
@@ -12,6 +12,7 @@
 #include "HDF5/H5Utilities.h"
 
 #include "vtkObjectFactory.h"
+#include <vtkErrorCode.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
 #include <vtkPolyData.h>
@@ -19,6 +20,14 @@
 #include <vtkDataSetAttributes.h>
 #include <vtkCellData.h>
 #include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkCellArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkQuadricClustering.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
 
 //-- Our includes
 
@@ -46,6 +55,7 @@ vtkH5PolyDataWriter::vtkH5PolyDataWriter()
   this->HDFPath = NULL;
   this->SetNumberOfInputPorts(1);
   this->AppendData = APPEND_DATA_TRUE;
+  this->NumberOfLevels = 0;
 }
 
 // -----------------------------------------------------------------------------
@@ -63,6 +73,7 @@ vtkH5PolyDataWriter::~vtkH5PolyDataWriter()
 void vtkH5PolyDataWriter::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "NumberOfLevels: " << this->NumberOfLevels << "\n";
 }
 
 // -----------------------------------------------------------------------------
@@ -97,6 +108,16 @@ void vtkH5PolyDataWriter::WriteData()
 {
   // std::cout << "  vtkH5PolyDataWriter::WriteData() Starting" << std::endl;
 
+  this->SetErrorCode(vtkErrorCode::NoError);
+  if (this->SWMRMode)
+  {
+    if (this->WriteSWMRStep(this->GetInput(), APPEND_DATA_TRUE == this->AppendData) < 0)
+    {
+      this->SetErrorCode(vtkErrorCode::UnknownError);
+    }
+    return;
+  }
+
   hid_t fileId = -1;
   // Try to open a file to append data into
   if (APPEND_DATA_TRUE == this->AppendData)
@@ -113,13 +134,28 @@ void vtkH5PolyDataWriter::WriteData()
   // Alread been written at this point so just return.
   if (fileId < 0)
   {
-    // std::cout << logTime() << "The hdf5 file could not be opened or created.\n The Given filename was:\n\t[" << this->FileName << "]" << std::endl;
+    vtkErrorMacro(<< "The hdf5 file could not be opened or created: " << this->FileName);
+    this->SetErrorCode(vtkErrorCode::CannotOpenFileError);
+    return;
+  }
+
+  if (this->VTKHDFLayout)
+  {
+    if (this->WriteVTKHDF(fileId, this->GetInput()) < 0)
+    {
+      vtkErrorMacro(<< "Error writing the VTKHDF layout to " << this->FileName);
+      this->SetErrorCode(vtkErrorCode::UnknownError);
+    }
+    H5Vtk::H5Utilities::closeFile(fileId);
+    return;
   }
 
 
   herr_t err = H5Vtk::H5Utilities::createGroupsFromPath(this->HDFPath, fileId);
   if (err < 0)
   {
+    vtkErrorMacro(<< "Error creating the group " << this->HDFPath << " in " << this->FileName);
+    this->SetErrorCode(vtkErrorCode::UnknownError);
     H5Vtk::H5Utilities::closeFile(fileId);
     return;
   }
@@ -127,10 +163,159 @@ void vtkH5PolyDataWriter::WriteData()
   err = H5Vtk::H5Lite::writeStringAttribute(fileId, this->HDFPath, H5_VTK_DATA_OBJECT, H5_VTK_POLYDATA );
   if(err < 0)
   {
+    vtkErrorMacro(<< "Error writing the data object type of " << this->HDFPath);
+    this->SetErrorCode(vtkErrorCode::UnknownError);
     H5Vtk::H5Utilities::closeFile(fileId);
     return;
   }
   vtkPolyData *input = this->GetInput();
+  vtkPolyData *reordered = NULL;
+  if (this->SpaceFillingCurve != VTK_H5_CURVE_NONE)
+  {
+    reordered = this->ReorderAlongCurve(input);
+  }
+  int errorOccured = (this->WritePolyDataGroup(fp, NULL != reordered ? reordered : input) == 0);
+  if (NULL != reordered)
+  {
+    reordered->Delete();
+  }
+
+  if (!errorOccured && this->NumberOfLevels > 0 && this->WriteLevelsOfDetail(fileId, input) < 0)
+    {
+    errorOccured = 1;
+    }
+
+  if(errorOccured)
+    {
+    vtkErrorMacro(<< "Error occured writing PolyData to HDF5 file.")
+    this->SetErrorCode(vtkErrorCode::UnknownError);
+    }
+
+
+  // Close the PolyData group when we are finished with it
+  err = H5Gclose(fp);
+  if (err < 0)
+  {
+    // std::cout << "Error closing group: " << this->HDFPath << std::endl;
+  }
+
+  // Close the file when we are finished with it. HDF5 flushes the cached
+  // chunks and metadata here, so a full disk may only show up now
+  if (H5Vtk::H5Utilities::closeFile(fileId) < 0)
+  {
+    vtkErrorMacro(<< "Error closing " << this->FileName);
+    this->SetErrorCode(vtkErrorCode::UnknownError);
+  }
+
+  this->WriteXdmfDescriptor();
+  // std::cout << "  vtkH5PolyDataWriter::WriteData() Ending" << std::endl;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkPolyData* vtkH5PolyDataWriter::ReorderAlongCurve(vtkPolyData* input)
+{
+  vtkPoints* points = input->GetPoints();
+  if (NULL == points)
+  {
+    return NULL;
+  }
+  vtkIdType numPoints = input->GetNumberOfPoints();
+  double bounds[6];
+  input->GetBounds(bounds);
+
+  // Points are sorted by their own key, cells by the key of their center
+  std::vector<vtkIdType> pointMap;
+  this->SortPointsAlongCurve(points, bounds, pointMap);
+
+  vtkPolyData* output = vtkPolyData::New();
+  vtkPoints* newPoints = vtkPoints::New(points->GetDataType());
+  newPoints->SetNumberOfPoints(numPoints);
+  vtkPointData* inPD = input->GetPointData();
+  vtkPointData* outPD = output->GetPointData();
+  outPD->CopyAllOn();
+  outPD->CopyAllocate(inPD, numPoints);
+  for (vtkIdType p = 0; p < numPoints; ++p)
+  {
+    newPoints->SetPoint(pointMap[p], points->GetPoint(p));
+    outPD->CopyData(inPD, p, pointMap[p]);
+  }
+  output->SetPoints(newPoints);
+  newPoints->Delete();
+
+  // The cell data runs over the vertices, lines, polygons and strips in that
+  // order, so every cell array is sorted within its own range of cell ids
+  vtkCellArray* inCells[4] = { input->GetVerts(), input->GetLines(), input->GetPolys(), input->GetStrips() };
+  vtkCellArray* outCells[4] = { NULL, NULL, NULL, NULL };
+  std::vector<vtkIdType> cellOrder;
+  for (int t = 0; t < 4; ++t)
+  {
+    if (NULL == inCells[t] || inCells[t]->GetNumberOfCells() == 0)
+    {
+      continue;
+    }
+    vtkIdType numCells = inCells[t]->GetNumberOfCells();
+    vtkIdType* conn = inCells[t]->GetPointer();
+    std::vector<vtkIdType> cellLocations(numCells);
+    vtkIdType loc = 0;
+    for (vtkIdType c = 0; c < numCells; ++c)
+    {
+      cellLocations[c] = loc;
+      loc += conn[loc] + 1;
+    }
+    size_t first = cellOrder.size();
+    this->SortCellsAlongCurve(inCells[t], points, bounds, static_cast<vtkIdType>(first), cellOrder);
+
+    vtkIdTypeArray* newConn = vtkIdTypeArray::New();
+    vtkIdType* dest = newConn->WritePointer(0, inCells[t]->GetNumberOfConnectivityEntries());
+    vtkIdType pos = 0;
+    for (vtkIdType n = 0; n < numCells; ++n)
+    {
+      vtkIdType* cell = conn + cellLocations[cellOrder[first + n] - first];
+      dest[pos++] = cell[0];
+      for (vtkIdType k = 1; k <= cell[0]; ++k)
+      {
+        dest[pos++] = pointMap[cell[k]];
+      }
+    }
+    outCells[t] = vtkCellArray::New();
+    outCells[t]->SetCells(numCells, newConn);
+    newConn->Delete();
+  }
+  output->SetVerts(outCells[0]);
+  output->SetLines(outCells[1]);
+  output->SetPolys(outCells[2]);
+  output->SetStrips(outCells[3]);
+  for (int t = 0; t < 4; ++t)
+  {
+    if (NULL != outCells[t])
+    {
+      outCells[t]->Delete();
+    }
+  }
+
+  vtkIdType numCells = static_cast<vtkIdType>(cellOrder.size());
+  vtkCellData* inCD = input->GetCellData();
+  vtkCellData* outCD = output->GetCellData();
+  outCD->CopyAllOn();
+  outCD->CopyAllocate(inCD, numCells);
+  for (vtkIdType n = 0; n < numCells; ++n)
+  {
+    outCD->CopyData(inCD, cellOrder[n], n);
+  }
+  output->SetFieldData(input->GetFieldData());
+
+  // Keep the permutation so the solver ids can be recovered from the file
+  this->AddOriginalIds(output, pointMap, cellOrder);
+  return output;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5PolyDataWriter::WritePolyDataGroup(hid_t fp, vtkPolyData* input)
+{
   // Write data owned by the dataset
   int errorOccured = 0;
   vtkFieldData* field = input->GetFieldData();
@@ -148,7 +333,17 @@ void vtkH5PolyDataWriter::WriteData()
     errorOccured = 1;
     }
 
-  if (!errorOccured && input->GetVerts())
+  // A point cloud keeps only a flag for its vertices. XDMF topologies need
+  // the connectivity, so the vertices are written out for the descriptor.
+  if (!errorOccured && !this->XdmfDescriptor && this->HasImplicitVertices(input))
+    {
+    vtkTypeInt32 implicitVertices = 1;
+    if (H5Vtk::H5Lite::writeScalarAttribute(fp, H5_POINTS, H5_IMPLICIT_VERTICES, implicitVertices) < 0)
+      {
+      errorOccured = 1;
+      }
+    }
+  else if (!errorOccured && input->GetVerts())
     {
     if (this->WriteCells(fp, input->GetVerts(),H5_VERTICES) < 0)
       {
@@ -182,33 +377,152 @@ void vtkH5PolyDataWriter::WriteData()
     }
 
   vtkCellData* cd = input->GetCellData();
-  if (!errorOccured && (this->WriteDatasetArrays(fp, input, cd, input->GetNumberOfCells(), H5_CELL_DATA_GROUP_NAME) < 0) )
+  if (!errorOccured && (this->WriteDatasetArrays(fp, input, cd, input->GetNumberOfCells(), H5_CELL_DATA_GROUP_NAME) == 0) )
     {
     errorOccured = 1;
     }
 
   vtkPointData* pd = input->GetPointData();
-  if (!errorOccured && (this->WriteDatasetArrays(fp, input, pd, input->GetNumberOfPoints(), H5_POINT_DATA_GROUP_NAME) < 0) )
+  if (!errorOccured && (this->WriteDatasetArrays(fp, input, pd, input->GetNumberOfPoints(), H5_POINT_DATA_GROUP_NAME) == 0) )
     {
     errorOccured = 1;
     }
 
-  if(errorOccured)
+  return (errorOccured == 0);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+  // Number of divisions of vtkQuadricClustering that leave about
+  // targetPoints points on a surface spanning bounds
+  void H5VtkClusteringDivisions(const double bounds[6], double targetPoints, int divisions[3])
+  {
+    double length[3];
+    for (int i = 0; i < 3; ++i)
     {
-    vtkErrorMacro(<< "Error occured writing PolyData to HDF5 file.")
+      length[i] = std::max(0.0, bounds[2 * i + 1] - bounds[2 * i]);
     }
+    double area = length[0] * length[1] + length[1] * length[2] + length[2] * length[0];
+    if (area <= 0.0)
+    {
+      // A line along one axis
+      area = std::max(length[0], std::max(length[1], length[2]));
+      area = area * area / std::max(1.0, targetPoints);
+    }
+    double binLength = std::sqrt(area / std::max(1.0, targetPoints));
+    for (int i = 0; i < 3; ++i)
+    {
+      divisions[i] = 1;
+      if (binLength > 0.0 && length[i] > 0.0)
+      {
+        divisions[i] = static_cast<int>(std::min(4096.0, std::max(2.0, std::ceil(length[i] / binLength))));
+      }
+    }
+  }
+}
 
-
-  // Close the PolyData group when we are finished with it
-  err = H5Gclose(fp);
-  if (err < 0)
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool vtkH5PolyDataWriter::HasImplicitVertices(vtkPolyData* input)
+{
+  // The reader builds the vertices from the points alone and skips CELL_DATA,
+  // so any other cell keeps the vertices explicit.
+  vtkCellArray* others[3] = { input->GetLines(), input->GetPolys(), input->GetStrips() };
+  for (int i = 0; i < 3; ++i)
   {
-    // std::cout << "Error closing group: " << this->HDFPath << std::endl;
+    if (NULL != others[i] && others[i]->GetNumberOfCells() > 0)
+    {
+      return false;
+    }
   }
+  vtkCellArray* verts = input->GetVerts();
+  vtkIdType numPoints = input->GetNumberOfPoints();
+  if (NULL == verts || numPoints == 0 || verts->GetNumberOfCells() != numPoints
+      || verts->GetNumberOfConnectivityEntries() != 2 * numPoints)
+  {
+    return false;
+  }
+  const vtkIdType* conn = verts->GetPointer();
+  for (vtkIdType i = 0; i < numPoints; ++i)
+  {
+    if (conn[2 * i] != 1 || conn[2 * i + 1] != i)
+    {
+      return false;
+    }
+  }
+  return true;
+}
 
-  // Close the file when we are finished with it
-  H5Vtk::H5Utilities::closeFile(fileId);
-  // std::cout << "  vtkH5PolyDataWriter::WriteData() Ending" << std::endl;
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5PolyDataWriter::WriteLevelsOfDetail(hid_t fileId, vtkPolyData* input)
+{
+  std::string lodPath = std::string(this->HDFPath) + "/" + H5_LOD_GROUP;
+  vtkIdType numCells = input->GetNumberOfCells();
+  herr_t err = H5Vtk::H5Lite::writeScalarAttribute(fileId, this->HDFPath, H5_LOD_NUMBER_OF_CELLS,
+                                                   static_cast<int64_t>(numCells));
+  int numLevels = 0;
+  vtkPolyData* previous = input;
+  previous->Register(this);
+  for (int level = 1; level <= this->NumberOfLevels && err >= 0; ++level)
+  {
+    // Every level keeps about a quarter of the cells of the one before it and
+    // is decimated from it, so each pass works on a smaller surface
+    double targetCells = static_cast<double>(numCells) / std::pow(4.0, level);
+    if (targetCells < 1.0)
+    {
+      break;
+    }
+    int divisions[3];
+    H5VtkClusteringDivisions(input->GetBounds(), targetCells / 2.0, divisions);
+    vtkQuadricClustering* decimate = vtkQuadricClustering::New();
+    decimate->SetInput(previous);
+    decimate->SetNumberOfDivisions(divisions);
+    decimate->CopyCellDataOn();
+    decimate->Update();
+    vtkPolyData* decimated = vtkPolyData::New();
+    decimated->ShallowCopy(decimate->GetOutput());
+    decimate->Delete();
+    previous->UnRegister(this);
+    previous = decimated;
+
+    std::stringstream path;
+    path << lodPath << "/" << level;
+    err = H5Vtk::H5Utilities::createGroupsFromPath(path.str(), fileId);
+    if (err < 0)
+    {
+      break;
+    }
+    err = H5Vtk::H5Lite::writeStringAttribute(fileId, path.str(), H5_VTK_DATA_OBJECT, H5_VTK_POLYDATA);
+    if (err >= 0)
+    {
+      err = H5Vtk::H5Lite::writeScalarAttribute(fileId, path.str(), H5_LOD_NUMBER_OF_CELLS,
+                                                static_cast<int64_t>(decimated->GetNumberOfCells()));
+    }
+    hid_t gid = H5Gopen(fileId, path.str().c_str(), H5P_DEFAULT);
+    if (err < 0 || gid < 0 || this->WritePolyDataGroup(gid, decimated) == 0)
+    {
+      vtkErrorMacro(<< "Error writing level of detail " << level << " of " << this->HDFPath);
+      err = -1;
+    }
+    if (gid >= 0)
+    {
+      H5Gclose(gid);
+    }
+    numLevels = level;
+  }
+  previous->UnRegister(this);
+  if (err >= 0)
+  {
+    err = H5Vtk::H5Lite::writeScalarAttribute(fileId, this->HDFPath, H5_LOD_NUMBER_OF_LEVELS,
+                                              static_cast<int32_t>(numLevels));
+  }
+  return err;
 }
 
 int vtkH5PolyDataWriter::writeVtkObjectIndex(std::vector<std::string> &paths)
@@ -226,5 +540,8 @@ int vtkH5PolyDataWriter::writeVtkObjectIndex(std::vector<std::string> &paths)
   // Close the file when we are finished with it
   H5Vtk::H5Utilities::closeFile(fileId);
 
+  // The index sets the order of the grids in the descriptor
+  this->WriteXdmfDescriptor();
+
   return err;
 }
@@ -57,6 +57,15 @@ public:
   vtkGetMacro(AppendData, vtkTypeInt32);
   vtkBooleanMacro(AppendData, vtkTypeInt32);
 
+  // Description:
+  // Number of decimated levels of detail written with the surface. Level k
+  // is made with vtkQuadricClustering from level k - 1 and keeps about 1/4^k
+  // of the cells. The levels are complete poly data objects in the group
+  // LOD/k of HDFPath and vtkH5PolyDataReader selects one with its
+  // LevelOfDetail or TriangleBudget. 0 (the default) writes no levels.
+  vtkSetClampMacro(NumberOfLevels, int, 0, 16);
+  vtkGetMacro(NumberOfLevels, int);
+
   // Description:
   // Get the input to this writer.
   vtkPolyData* GetInput();
@@ -81,6 +90,37 @@ protected:
   */
   virtual int FillInputPortInformation(int port, vtkInformation* information);
 
+  /**
+   * @brief Writes the points, cells, cell data and point data of a poly data
+   * into the open group fp.
+   * @return 1 on success, 0 on error
+   */
+  int WritePolyDataGroup(hid_t fp, vtkPolyData* input);
+
+  /**
+   * @brief Returns true if the vertices of input are exactly one vertex per
+   * point in point order and input has no other cells. Such a point cloud is
+   * written with the ImplicitVertices attribute of POINTS instead of a
+   * VERTICES dataset.
+   */
+  bool HasImplicitVertices(vtkPolyData* input);
+
+  /**
+   * @brief Writes NumberOfLevels decimated copies of input under the LOD
+   * group of HDFPath together with the attributes the reader selects them by.
+   * @return Negative value on error
+   */
+  int WriteLevelsOfDetail(hid_t fileId, vtkPolyData* input);
+
+  /**
+   * @brief Builds a copy of input with points sorted along the
+   * SpaceFillingCurve and the cells of the vertices, lines, polygons and
+   * strips each sorted on their own, so the cell data keeps that order of
+   * the four cell arrays. The original id arrays are added.
+   * @return The sorted poly data, or NULL if input can not be sorted
+   */
+  vtkPolyData* ReorderAlongCurve(vtkPolyData* input);
+
 private:
 
   char* FileName;
@@ -89,6 +129,8 @@ private:
 
   vtkTypeInt32 AppendData;
 
+  int NumberOfLevels;
+
 
   vtkH5PolyDataWriter(const vtkH5PolyDataWriter&);  // Not implemented.
   void operator=(const vtkH5PolyDataWriter&);  // Not implemented.
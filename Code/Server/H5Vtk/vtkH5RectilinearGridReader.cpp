@@ -0,0 +1,217 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "vtkH5RectilinearGridReader.h"
+
+#include "VTKH5Constants.h"
+#include "HDF5/H5Lite.h"
+#include "HDF5/H5Utilities.h"
+
+#include <vtkDataArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkRectilinearGrid.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+vtkCxxRevisionMacro(vtkH5RectilinearGridReader, "$Revision: 1.1 $");
+vtkStandardNewMacro(vtkH5RectilinearGridReader);
+
+
+//----------------------------------------------------------------------------
+vtkH5RectilinearGridReader::vtkH5RectilinearGridReader()
+{
+  this->FileName = NULL;
+  this->HDFPath = NULL;
+  this->SetNumberOfInputPorts(0);
+  this->HDFError = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkH5RectilinearGridReader::~vtkH5RectilinearGridReader()
+{
+  this->SetFileName(NULL);
+  this->SetHDFPath(NULL);
+}
+
+//----------------------------------------------------------------------------
+void vtkH5RectilinearGridReader::PrintSelf(std::ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+  os << indent << "FileName: " << (this->FileName ? this->FileName : "(none)") << std::endl;
+  os << indent << "HDFPath: " << (this->HDFPath ? this->HDFPath : "(none)") << std::endl;
+}
+
+//----------------------------------------------------------------------------
+int vtkH5RectilinearGridReader::FillOutputPortInformation(int port, vtkInformation* info)
+{
+  info->Set(vtkDataObject::DATA_TYPE_NAME(), "vtkRectilinearGrid");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+vtkRectilinearGrid* vtkH5RectilinearGridReader::GetOutput()
+{
+  return this->GetOutput(0);
+}
+
+//----------------------------------------------------------------------------
+vtkRectilinearGrid* vtkH5RectilinearGridReader::GetOutput(int idx)
+{
+  return vtkRectilinearGrid::SafeDownCast(this->GetOutputDataObject(idx));
+}
+
+//----------------------------------------------------------------------------
+void vtkH5RectilinearGridReader::SetOutput(vtkRectilinearGrid *output)
+{
+  this->GetExecutive()->SetOutputData(0, output);
+}
+
+//----------------------------------------------------------------------------
+int vtkH5RectilinearGridReader::RequestInformation( vtkInformation *vtkNotUsed(request),
+                                      vtkInformationVector **vtkNotUsed(inputVector),
+                                      vtkInformationVector *outputVector)
+{
+  if (NULL == this->FileName || NULL == this->HDFPath)
+  {
+    return 1;
+  }
+  HDF_ERROR_HANDLER_OFF;
+  hid_t fileId = H5Vtk::H5Utilities::openFile(this->FileName, true);
+  HDF_ERROR_HANDLER_ON;
+  if (fileId < 0)
+  {
+    // RequestData reports the error
+    return 1;
+  }
+  int wholeExtent[6];
+  int ok = this->readGridExtent(fileId, this->HDFPath, wholeExtent);
+  H5Vtk::H5Utilities::closeFile(fileId);
+  if (!ok)
+  {
+    vtkErrorMacro(<< "Could not read the extent of " << this->HDFPath << " from " << this->FileName);
+    return 0;
+  }
+
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent, 6);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkH5RectilinearGridReader::RequestData( vtkInformation *vtkNotUsed(request),
+                                      vtkInformationVector **vtkNotUsed(inputVector),
+                                      vtkInformationVector *outputVector)
+{
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  vtkRectilinearGrid *output = vtkRectilinearGrid::SafeDownCast( outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  HDF_ERROR_HANDLER_OFF;
+  hid_t fileId = H5Vtk::H5Utilities::openFile(this->FileName, true);
+  if (fileId < 0)
+  {
+   this->HDFError= fileId;
+   HDF_ERROR_HANDLER_ON;
+   return 1;
+  }
+
+  int wholeExtent[6];
+  if (!this->readGridExtent(fileId, this->HDFPath, wholeExtent))
+  {
+    H5Vtk::H5Utilities::closeFile(fileId);
+    this->HDFError = -1;
+    HDF_ERROR_HANDLER_ON;
+    return 1;
+  }
+
+  // Only read the part of the grid the pipeline asked for
+  int extent[6];
+  if (!this->GetRequestedExtent(outInfo, wholeExtent, extent))
+  {
+    // Empty request
+    H5Vtk::H5Utilities::closeFile(fileId);
+    HDF_ERROR_HANDLER_ON;
+    return 1;
+  }
+
+  vtkRectilinearGrid* grid = this->loadRectilinearGrid(fileId, this->HDFPath, extent);
+  if (NULL != grid)
+  {
+    output->ShallowCopy(grid);
+    grid->Delete();
+  }
+
+  herr_t err = H5Vtk::H5Utilities::closeFile(fileId);
+  this->HDFError = err;
+  HDF_ERROR_HANDLER_ON;
+  return 1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5RectilinearGridReader::readGridExtent(hid_t fileId, const std::string &hdfpath, int wholeExtent[6])
+{
+  std::string dataObjectType;
+  herr_t err = H5Vtk::H5Lite::readStringAttribute(fileId, hdfpath, H5_VTK_DATA_OBJECT, dataObjectType);
+  if (err < 0 || dataObjectType.compare(H5_VTK_RECTILINEAR_GRID) != 0)
+  {
+    std::cout << "HDF Group " << hdfpath << " is NOT type vtkRectilinearGrid. It is " << dataObjectType << std::endl;
+    return 0;
+  }
+  return this->ReadWholeExtent(fileId, hdfpath, wholeExtent);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkRectilinearGrid* vtkH5RectilinearGridReader::loadRectilinearGrid(hid_t fileId, const std::string &hdfpath, const int extent[6])
+{
+  int wholeExtent[6];
+  if (!this->readGridExtent(fileId, hdfpath, wholeExtent))
+  {
+    return NULL;
+  }
+  hid_t rootId = H5Gopen(fileId, hdfpath.c_str(), H5P_DEFAULT);
+  if (rootId < 0)
+  {
+    this->HDFError = rootId;
+    return NULL;
+  }
+
+  vtkRectilinearGrid* output = vtkRectilinearGrid::New();
+  output->SetExtent(const_cast<int*>(extent));
+
+  // Only the requested part of each axis is read
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    vtkDataArray* coords = this->ReadCoordinates(rootId, axis, wholeExtent, extent);
+    if (NULL == coords)
+    {
+      vtkErrorMacro(<< "Could not read the coordinates of axis " << axis << " of " << hdfpath);
+      output->Delete();
+      H5Gclose(rootId);
+      return NULL;
+    }
+    switch (axis)
+    {
+      case 0: output->SetXCoordinates(coords); break;
+      case 1: output->SetYCoordinates(coords); break;
+      default: output->SetZCoordinates(coords); break;
+    }
+    coords->Delete();
+  }
+
+  if (this->ReadStructuredData(rootId, output, wholeExtent, extent) == 0)
+  {
+    this->HDFError = -1;
+  }
+
+  H5Gclose(rootId);
+  return output;
+}
@@ -0,0 +1,130 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+#ifndef _VTKH5RECTILINEARGRIDREADER_H_
+#define _VTKH5RECTILINEARGRIDREADER_H_
+
+//-- HDF5 includes
+#include <hdf5.h>
+
+//-- Superclass
+#include "vtkH5DataReader.h"
+
+class vtkInformation;
+class vtkInformationVector;
+class vtkRectilinearGrid;
+
+
+/**
+* @class vtkH5RectilinearGridReader vtkH5RectilinearGridReader.h vtkH5RectilinearGridReader.h
+* @brief The class reads vtkRectilinearGrid Objects written by
+* vtkH5RectilinearGridWriter. The whole extent is reported in RequestInformation
+* and RequestData only reads the coordinates and arrays of the requested
+* UPDATE_EXTENT so each process of a parallel pipeline reads its own block.
+* @author Mike Jackson for BlueQuartz Software
+* @date Nov 2010
+* @version $Revision: 1.1 $
+*/
+class VTK_EXPORT vtkH5RectilinearGridReader : public vtkH5DataReader
+{
+public:
+  static vtkH5RectilinearGridReader *New();
+  vtkTypeRevisionMacro(vtkH5RectilinearGridReader,vtkH5DataReader);
+
+  //BTX
+  /**
+   * @brief Prints information about this class. Good for debugging
+   * @param os Output stream to write to
+   * @param indent The amount of indentation
+   */
+  void PrintSelf(std::ostream& os, vtkIndent indent);
+//ETX
+
+  // Description:
+  // Specify file name of the h5r file to read.
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+
+  vtkSetStringMacro(HDFPath);
+  vtkGetStringMacro(HDFPath);
+
+  // Description:
+  // Get the output of this reader.
+  vtkRectilinearGrid *GetOutput();
+  vtkRectilinearGrid *GetOutput(int idx);
+  void SetOutput(vtkRectilinearGrid *output);
+
+  vtkSetMacro(HDFError, int);
+  vtkGetMacro(HDFError, int);
+
+  //BTX
+  /**
+   * @brief Checks the type of the grid at hdfpath and reads its extent
+   * @param fileId The HDF5 fileId
+   * @param hdfpath The internal hdf5 path to the data set
+   * @param wholeExtent Receives the extent stored in the file
+   * @return 1 on success, 0 on error
+   */
+  virtual int readGridExtent(hid_t fileId, const std::string &hdfpath, int wholeExtent[6]);
+
+  /**
+   * @brief Loads the part of the grid at hdfpath covered by extent
+   * @param fileId The HDF5 fileId
+   * @param hdfpath The internal hdf5 path to the data set
+   * @param extent The extent to read. Must be inside the whole extent
+   * @return NULL pointer if error, otherwise valid vtkRectilinearGrid object
+   */
+  virtual vtkRectilinearGrid* loadRectilinearGrid(hid_t fileId, const std::string &hdfpath, const int extent[6]);
+  //ETX
+
+protected:
+  vtkH5RectilinearGridReader();
+ ~vtkH5RectilinearGridReader();
+
+ /**
+ * @brief Standard vtk 5.x pipeline method. This method is used to set what type
+ * of outputs this filter produces.
+ * @param port The port to get output information for
+ * @param information The vtkInformation pointer
+ * @return 1 on success, 0 on error
+ */
+ virtual int FillOutputPortInformation(int port, vtkInformation* information);
+
+ /**
+  * @brief Reads the UPDATE_EXTENT of the grid
+  * @param vtkNotUsed vtkInformation Object
+  * @param vtkNotUsed vtkInformationVector for the inputs
+  * @param outputVector vtkInformationVector for the outputs
+  * @return 1 on success, 0 on error
+  */
+ virtual int RequestData( vtkInformation *vtkNotUsed(request),
+                  vtkInformationVector **vtkNotUsed(inputVector),
+                  vtkInformationVector *outputVector);
+
+ /**
+  * @brief Reports the WHOLE_EXTENT of the grid
+  * @param request vtkInformation Object
+  * @param inputVector vtkInformationVector for the inputs
+  * @param outputVector vtkInformationVector for the outputs
+  * @return 1 on success, 0 on error
+  */
+ virtual int RequestInformation(vtkInformation *request,
+                                vtkInformationVector **inputVector,
+                                vtkInformationVector *outputVector);
+
+private:
+
+  char* FileName;
+  char* HDFPath;
+  int HDFError;
+
+
+  vtkH5RectilinearGridReader(const vtkH5RectilinearGridReader&);  // Not implemented.
+  void operator=(const vtkH5RectilinearGridReader&);  // Not implemented.
+};
+
+#endif
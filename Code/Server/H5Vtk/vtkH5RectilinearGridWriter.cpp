@@ -0,0 +1,192 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "vtkH5RectilinearGridWriter.h"
+#include "VTKH5Constants.h"
+
+#include "HDF5/H5Utilities.h"
+
+#include "vtkObjectFactory.h"
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkRectilinearGrid.h>
+
+#define APPEND_DATA_TRUE 1
+#define APPEND_DATA_FALSE 0
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkCxxRevisionMacro( vtkH5RectilinearGridWriter, "$Revision: 1.1 $" );
+vtkStandardNewMacro( vtkH5RectilinearGridWriter );
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkH5RectilinearGridWriter::vtkH5RectilinearGridWriter()
+{
+  this->FileName = NULL;
+  this->HDFPath = NULL;
+  this->SetNumberOfInputPorts(1);
+  this->AppendData = APPEND_DATA_TRUE;
+  this->ChunkSize = 32;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkH5RectilinearGridWriter::~vtkH5RectilinearGridWriter()
+{
+  this->SetFileName( NULL );
+  this->SetHDFPath(NULL);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5RectilinearGridWriter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+  os << indent << "ChunkSize: " << this->ChunkSize << std::endl;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5RectilinearGridWriter::FillInputPortInformation(int, vtkInformation *info)
+{
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkRectilinearGrid");
+  return 1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkRectilinearGrid* vtkH5RectilinearGridWriter::GetInput()
+{
+  return vtkRectilinearGrid::SafeDownCast(this->Superclass::GetInput());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkRectilinearGrid* vtkH5RectilinearGridWriter::GetInput(int port)
+{
+  return vtkRectilinearGrid::SafeDownCast(this->Superclass::GetInput(port));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5RectilinearGridWriter::WriteData()
+{
+  hid_t fileId = -1;
+  // Try to open a file to append data into
+  if (APPEND_DATA_TRUE == this->AppendData)
+  {
+    fileId = H5Vtk::H5Utilities::openFile(this->FileName, false);
+  }
+  // No file was found or we are writing new data only to a clean file
+  if (APPEND_DATA_FALSE == this->AppendData || fileId < 0)
+  {
+    fileId = H5Vtk::H5Utilities::createFile (this->FileName);
+  }
+
+  //Something went wrong either opening or creating the file. Error messages have
+  // Alread been written at this point so just return.
+  if (fileId < 0)
+  {
+    vtkErrorMacro(<< "The hdf5 file could not be opened or created: " << this->FileName);
+    return;
+  }
+
+  if (this->VTKHDFLayout)
+  {
+    vtkWarningMacro(<< "The VTKHDF layout is only written for polydata and unstructured grids. "
+                    << "Writing " << this->HDFPath << " in the h5r layout.");
+  }
+
+  herr_t err = H5Vtk::H5Utilities::createGroupsFromPath(this->HDFPath, fileId);
+  if (err < 0)
+  {
+    H5Vtk::H5Utilities::closeFile(fileId);
+    return;
+  }
+  hid_t fp = H5Gopen(fileId, this->HDFPath, H5P_DEFAULT );
+  err = H5Vtk::H5Lite::writeStringAttribute(fileId, this->HDFPath, H5_VTK_DATA_OBJECT, H5_VTK_RECTILINEAR_GRID );
+  if(err < 0)
+  {
+    H5Gclose(fp);
+    H5Vtk::H5Utilities::closeFile(fileId);
+    return;
+  }
+  vtkRectilinearGrid *input = this->GetInput();
+  int errorOccured = 0;
+
+  int extent[6];
+  input->GetExtent(extent);
+  if (this->WriteWholeExtent(fileId, this->HDFPath, extent) < 0)
+  {
+    errorOccured = 1;
+  }
+
+  // Only the axes are stored, the points are implied by them
+  if (!errorOccured
+      && (this->WriteCoordinates(fp, input->GetXCoordinates(), 0) == 0
+          || this->WriteCoordinates(fp, input->GetYCoordinates(), 1) == 0
+          || this->WriteCoordinates(fp, input->GetZCoordinates(), 2) == 0))
+  {
+    errorOccured = 1;
+  }
+
+  int dims[3];
+  input->GetDimensions(dims);
+  if (!errorOccured && this->WriteStructuredData(fp, input, dims, this->ChunkSize) == 0)
+  {
+    errorOccured = 1;
+  }
+
+  if(errorOccured)
+    {
+    vtkErrorMacro(<< "Error occured writing RectilinearGrid to HDF5 file.")
+    }
+
+  // Close the RectilinearGrid group when we are finished with it
+  err = H5Gclose(fp);
+
+  // Close the file when we are finished with it
+  H5Vtk::H5Utilities::closeFile(fileId);
+
+  this->WriteXdmfDescriptor();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5RectilinearGridWriter::writeVtkObjectIndex(std::vector<std::string> &paths)
+{
+  hid_t fileId = -1;
+  herr_t err = 0;
+  // Try to open a file
+  fileId = H5Vtk::H5Utilities::openFile(this->FileName, false);
+  if (fileId < 0)
+  {
+    return -1;
+  }
+  err = this->writeObjectIndex(fileId, paths);
+
+  // Close the file when we are finished with it
+  H5Vtk::H5Utilities::closeFile(fileId);
+
+  // The index sets the order of the grids in the descriptor
+  this->WriteXdmfDescriptor();
+
+  return err;
+}
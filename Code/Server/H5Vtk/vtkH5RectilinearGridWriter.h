@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+#ifndef VTKH5RECTILINEARGRIDWRITER_H_
+#define VTKH5RECTILINEARGRIDWRITER_H_
+
+
+#include "vtkH5DataWriter.h"
+
+//-- Hdf5 includes
+#include <hdf5.h>
+
+#include "HDF5/H5Lite.h"
+
+#ifndef VTK_EXPORT
+#define VTK_EXPORT
+#endif
+
+class vtkRectilinearGrid;
+
+/**
+* @class vtkH5RectilinearGridWriter vtkH5RectilinearGridWriter.h vtkH5RectilinearGridWriter.h
+* @brief This class writes a vtkRectilinearGrid object to an HDF5 based file
+* using the same layout that vtkH5RectilinearGridReader reads. Only the three
+* coordinate axes are stored, not the points of the grid. Point and cell data
+* arrays are stored as chunked (z, y, x[, components]) datasets so a sub
+* extent can be read on its own.
+* @author Mike Jackson for BlueQuartz Software
+* @date Nov 2010
+* @version $Revision: 1.1 $
+*/
+class VTK_EXPORT vtkH5RectilinearGridWriter : public vtkH5DataWriter
+{
+public:
+  static vtkH5RectilinearGridWriter* New();
+  vtkTypeRevisionMacro( vtkH5RectilinearGridWriter, vtkH5DataWriter );
+  void PrintSelf( ostream&, vtkIndent );
+
+  // Description:
+  // Specify file name of the h5r file to write.
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+
+  vtkSetStringMacro(HDFPath);
+  vtkGetStringMacro(HDFPath);
+
+  vtkSetMacro(AppendData, vtkTypeInt32);
+  vtkGetMacro(AppendData, vtkTypeInt32);
+  vtkBooleanMacro(AppendData, vtkTypeInt32);
+
+  // Description:
+  // Edge length, in samples, of the bricks the arrays are chunked into.
+  // Default is 32.
+  vtkSetClampMacro(ChunkSize, int, 1, VTK_INT_MAX);
+  vtkGetMacro(ChunkSize, int);
+
+  // Description:
+  // Get the input to this writer.
+  vtkRectilinearGrid* GetInput();
+  vtkRectilinearGrid* GetInput(int port);
+
+  //BTX
+  int writeVtkObjectIndex(std::vector<std::string> &paths);
+  //ETX
+
+protected:
+  vtkH5RectilinearGridWriter();
+  ~vtkH5RectilinearGridWriter();
+
+  virtual void WriteData();
+
+  /**
+  * @brief Standard vtk 5.x pipeline method. This method is used to set what type
+  * of outputs this filter produces.
+  * @param port The port to get output information for
+  * @param information The vtkInformation pointer
+  * @return 1 on success, 0 on error
+  */
+  virtual int FillInputPortInformation(int port, vtkInformation* information);
+
+private:
+
+  char* FileName;
+
+  char* HDFPath;
+
+  vtkTypeInt32 AppendData;
+
+  int ChunkSize;
+
+
+  vtkH5RectilinearGridWriter(const vtkH5RectilinearGridWriter&);  // Not implemented.
+  void operator=(const vtkH5RectilinearGridWriter&);  // Not implemented.
+
+
+};
+
+#endif /*VTKH5RECTILINEARGRIDWRITER_H_*/
@@ -0,0 +1,208 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "vtkH5StructuredGridReader.h"
+
+#include "VTKH5Constants.h"
+#include "HDF5/H5Lite.h"
+#include "HDF5/H5Utilities.h"
+
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPoints.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+#include <vtkStructuredGrid.h>
+
+vtkCxxRevisionMacro(vtkH5StructuredGridReader, "$Revision: 1.1 $");
+vtkStandardNewMacro(vtkH5StructuredGridReader);
+
+
+//----------------------------------------------------------------------------
+vtkH5StructuredGridReader::vtkH5StructuredGridReader()
+{
+  this->FileName = NULL;
+  this->HDFPath = NULL;
+  this->SetNumberOfInputPorts(0);
+  this->HDFError = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkH5StructuredGridReader::~vtkH5StructuredGridReader()
+{
+  this->SetFileName(NULL);
+  this->SetHDFPath(NULL);
+}
+
+//----------------------------------------------------------------------------
+void vtkH5StructuredGridReader::PrintSelf(std::ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+  os << indent << "FileName: " << (this->FileName ? this->FileName : "(none)") << std::endl;
+  os << indent << "HDFPath: " << (this->HDFPath ? this->HDFPath : "(none)") << std::endl;
+}
+
+//----------------------------------------------------------------------------
+int vtkH5StructuredGridReader::FillOutputPortInformation(int port, vtkInformation* info)
+{
+  info->Set(vtkDataObject::DATA_TYPE_NAME(), "vtkStructuredGrid");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+vtkStructuredGrid* vtkH5StructuredGridReader::GetOutput()
+{
+  return this->GetOutput(0);
+}
+
+//----------------------------------------------------------------------------
+vtkStructuredGrid* vtkH5StructuredGridReader::GetOutput(int idx)
+{
+  return vtkStructuredGrid::SafeDownCast(this->GetOutputDataObject(idx));
+}
+
+//----------------------------------------------------------------------------
+void vtkH5StructuredGridReader::SetOutput(vtkStructuredGrid *output)
+{
+  this->GetExecutive()->SetOutputData(0, output);
+}
+
+//----------------------------------------------------------------------------
+int vtkH5StructuredGridReader::RequestInformation( vtkInformation *vtkNotUsed(request),
+                                      vtkInformationVector **vtkNotUsed(inputVector),
+                                      vtkInformationVector *outputVector)
+{
+  if (NULL == this->FileName || NULL == this->HDFPath)
+  {
+    return 1;
+  }
+  HDF_ERROR_HANDLER_OFF;
+  hid_t fileId = H5Vtk::H5Utilities::openFile(this->FileName, true);
+  HDF_ERROR_HANDLER_ON;
+  if (fileId < 0)
+  {
+    // RequestData reports the error
+    return 1;
+  }
+  int wholeExtent[6];
+  int ok = this->readGridExtent(fileId, this->HDFPath, wholeExtent);
+  H5Vtk::H5Utilities::closeFile(fileId);
+  if (!ok)
+  {
+    vtkErrorMacro(<< "Could not read the extent of " << this->HDFPath << " from " << this->FileName);
+    return 0;
+  }
+
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent, 6);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkH5StructuredGridReader::RequestData( vtkInformation *vtkNotUsed(request),
+                                      vtkInformationVector **vtkNotUsed(inputVector),
+                                      vtkInformationVector *outputVector)
+{
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  vtkStructuredGrid *output = vtkStructuredGrid::SafeDownCast( outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  HDF_ERROR_HANDLER_OFF;
+  hid_t fileId = H5Vtk::H5Utilities::openFile(this->FileName, true);
+  if (fileId < 0)
+  {
+   this->HDFError= fileId;
+   HDF_ERROR_HANDLER_ON;
+   return 1;
+  }
+
+  int wholeExtent[6];
+  if (!this->readGridExtent(fileId, this->HDFPath, wholeExtent))
+  {
+    H5Vtk::H5Utilities::closeFile(fileId);
+    this->HDFError = -1;
+    HDF_ERROR_HANDLER_ON;
+    return 1;
+  }
+
+  // Only read the part of the grid the pipeline asked for
+  int extent[6];
+  if (!this->GetRequestedExtent(outInfo, wholeExtent, extent))
+  {
+    // Empty request
+    H5Vtk::H5Utilities::closeFile(fileId);
+    HDF_ERROR_HANDLER_ON;
+    return 1;
+  }
+
+  vtkStructuredGrid* grid = this->loadStructuredGrid(fileId, this->HDFPath, extent);
+  if (NULL != grid)
+  {
+    output->ShallowCopy(grid);
+    grid->Delete();
+  }
+
+  herr_t err = H5Vtk::H5Utilities::closeFile(fileId);
+  this->HDFError = err;
+  HDF_ERROR_HANDLER_ON;
+  return 1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5StructuredGridReader::readGridExtent(hid_t fileId, const std::string &hdfpath, int wholeExtent[6])
+{
+  std::string dataObjectType;
+  herr_t err = H5Vtk::H5Lite::readStringAttribute(fileId, hdfpath, H5_VTK_DATA_OBJECT, dataObjectType);
+  if (err < 0 || dataObjectType.compare(H5_VTK_STRUCTURED_GRID) != 0)
+  {
+    std::cout << "HDF Group " << hdfpath << " is NOT type vtkStructuredGrid. It is " << dataObjectType << std::endl;
+    return 0;
+  }
+  return this->ReadWholeExtent(fileId, hdfpath, wholeExtent);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkStructuredGrid* vtkH5StructuredGridReader::loadStructuredGrid(hid_t fileId, const std::string &hdfpath, const int extent[6])
+{
+  int wholeExtent[6];
+  if (!this->readGridExtent(fileId, hdfpath, wholeExtent))
+  {
+    return NULL;
+  }
+  hid_t rootId = H5Gopen(fileId, hdfpath.c_str(), H5P_DEFAULT);
+  if (rootId < 0)
+  {
+    this->HDFError = rootId;
+    return NULL;
+  }
+
+  vtkStructuredGrid* output = vtkStructuredGrid::New();
+  output->SetExtent(const_cast<int*>(extent));
+
+  vtkPoints* points = this->ReadStructuredPoints(rootId, wholeExtent, extent);
+  if (NULL == points)
+  {
+    vtkErrorMacro(<< "Could not read the points of " << hdfpath);
+    output->Delete();
+    H5Gclose(rootId);
+    return NULL;
+  }
+  output->SetPoints(points);
+  points->Delete();
+
+  if (this->ReadStructuredData(rootId, output, wholeExtent, extent) == 0)
+  {
+    this->HDFError = -1;
+  }
+
+  H5Gclose(rootId);
+  return output;
+}
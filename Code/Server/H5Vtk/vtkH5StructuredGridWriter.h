@@ -0,0 +1,101 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+#ifndef VTKH5STRUCTUREDGRIDWRITER_H_
+#define VTKH5STRUCTUREDGRIDWRITER_H_
+
+
+#include "vtkH5DataWriter.h"
+
+//-- Hdf5 includes
+#include <hdf5.h>
+
+#include "HDF5/H5Lite.h"
+
+#ifndef VTK_EXPORT
+#define VTK_EXPORT
+#endif
+
+class vtkStructuredGrid;
+
+/**
+* @class vtkH5StructuredGridWriter vtkH5StructuredGridWriter.h vtkH5StructuredGridWriter.h
+* @brief This class writes a vtkStructuredGrid object to an HDF5 based file
+* using the same layout that vtkH5StructuredGridReader reads. The points and
+* every point and cell data array are stored as chunked (z, y, x[, components])
+* datasets so a sub extent of a curvilinear grid can be read on its own.
+* @author Mike Jackson for BlueQuartz Software
+* @date Nov 2010
+* @version $Revision: 1.1 $
+*/
+class VTK_EXPORT vtkH5StructuredGridWriter : public vtkH5DataWriter
+{
+public:
+  static vtkH5StructuredGridWriter* New();
+  vtkTypeRevisionMacro( vtkH5StructuredGridWriter, vtkH5DataWriter );
+  void PrintSelf( ostream&, vtkIndent );
+
+  // Description:
+  // Specify file name of the h5s file to write.
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+
+  vtkSetStringMacro(HDFPath);
+  vtkGetStringMacro(HDFPath);
+
+  vtkSetMacro(AppendData, vtkTypeInt32);
+  vtkGetMacro(AppendData, vtkTypeInt32);
+  vtkBooleanMacro(AppendData, vtkTypeInt32);
+
+  // Description:
+  // Edge length, in samples, of the bricks the points and arrays are chunked
+  // into. Default is 32.
+  vtkSetClampMacro(ChunkSize, int, 1, VTK_INT_MAX);
+  vtkGetMacro(ChunkSize, int);
+
+  // Description:
+  // Get the input to this writer.
+  vtkStructuredGrid* GetInput();
+  vtkStructuredGrid* GetInput(int port);
+
+  //BTX
+  int writeVtkObjectIndex(std::vector<std::string> &paths);
+  //ETX
+
+protected:
+  vtkH5StructuredGridWriter();
+  ~vtkH5StructuredGridWriter();
+
+  virtual void WriteData();
+
+  /**
+  * @brief Standard vtk 5.x pipeline method. This method is used to set what type
+  * of outputs this filter produces.
+  * @param port The port to get output information for
+  * @param information The vtkInformation pointer
+  * @return 1 on success, 0 on error
+  */
+  virtual int FillInputPortInformation(int port, vtkInformation* information);
+
+private:
+
+  char* FileName;
+
+  char* HDFPath;
+
+  vtkTypeInt32 AppendData;
+
+  int ChunkSize;
+
+
+  vtkH5StructuredGridWriter(const vtkH5StructuredGridWriter&);  // Not implemented.
+  void operator=(const vtkH5StructuredGridWriter&);  // Not implemented.
+
+
+};
+
+#endif /*VTKH5STRUCTUREDGRIDWRITER_H_*/
@@ -11,6 +11,8 @@
 #include "VTKH5Constants.h"
 #include "HDF5/H5Lite.h"
 #include "HDF5/H5Utilities.h"
+#include "HDF5/H5IOStatistics.h"
+#include "HDF5/H5ConnectivityCodec.h"
 
 #include <vtkUnstructuredGrid.h>
 #include <vtkCellArray.h>
@@ -29,6 +31,7 @@
 #include <vtkErrorCode.h>
 #include <vtkFieldData.h>
 #include <vtkFloatArray.h>
+#include <vtkIdList.h>
 #include <vtkIdTypeArray.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
@@ -37,6 +40,7 @@
 #include <vtkLookupTable.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
+#include <vtkPoints.h>
 #include <vtkPointSet.h>
 #include <vtkRectilinearGrid.h>
 #include <vtkShortArray.h>
@@ -49,6 +53,8 @@
 #include <vtkUnsignedShortArray.h>
 #include <vtkAppendPolyData.h>
 
+#include <algorithm>
+
 vtkCxxRevisionMacro(vtkH5UnstructuredGridReader, "$Revision: 1.5 $");
 vtkStandardNewMacro(vtkH5UnstructuredGridReader);
 
@@ -81,6 +87,21 @@ vtkH5UnstructuredGridReader::vtkH5UnstructuredGridReader()
   this->HDFPath = NULL;
   this->SetNumberOfInputPorts(0);
   this->HDFError = 0;
+  this->UseReadBounds = 0;
+  this->Piece = 0;
+  this->NumberOfPieces = 1;
+  this->GhostLevels = 0;
+  for (int i = 0; i < 3; ++i)
+  {
+    this->ReadBounds[2 * i] = -VTK_DOUBLE_MAX;
+    this->ReadBounds[2 * i + 1] = VTK_DOUBLE_MAX;
+  }
+  this->ValueRangeArrayName = NULL;
+  this->UseValueRangeFilter = 0;
+  this->ValueRangeFilter[0] = -VTK_DOUBLE_MAX;
+  this->ValueRangeFilter[1] = VTK_DOUBLE_MAX;
+  this->UseIsovalue = 0;
+  this->Isovalue = 0.0;
 }
 
 //----------------------------------------------------------------------------
@@ -88,6 +109,7 @@ vtkH5UnstructuredGridReader::~vtkH5UnstructuredGridReader()
 {
   this->SetFileName(NULL);
   this->SetHDFPath(NULL);
+  this->SetValueRangeArrayName(NULL);
  // std::cout << "========> vtkH5UnstructuredGridReader Destructor" << std::endl;
 }
 
@@ -129,8 +151,14 @@ int vtkH5UnstructuredGridReader::RequestData( vtkInformation *vtkNotUsed(request
   vtkInformation *outInfo = outputVector->GetInformationObject(0);
   vtkUnstructuredGrid *output = vtkUnstructuredGrid::SafeDownCast( outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
+  // RequestInformation already warned that the object does not fit
+  if (this->OverMemoryBudget)
+  {
+    return 1;
+  }
+
   HDF_ERROR_HANDLER_OFF;
-  hid_t fileId = H5Vtk::H5Utilities::openFile(this->FileName, false);
+  hid_t fileId = this->OpenFile(false);
   // Something went wrong either opening or creating the file. Error messages have
   // Alread been written at this point so just return.
   if (fileId < 0)
@@ -140,21 +168,81 @@ int vtkH5UnstructuredGridReader::RequestData( vtkInformation *vtkNotUsed(request
    return 1;
   }
 
-  vtkUnstructuredGrid* p = loadUnstructuredGridData(fileId, this->HDFPath);
+  this->Piece = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+  this->NumberOfPieces = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
+  this->GhostLevels = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS());
+  vtkUnstructuredGrid* p = NULL;
+  if (this->IsVTKHDF(fileId, H5_VTKHDF_UNSTRUCTURED_GRID))
+  {
+    this->SelectVTKHDFTimeStep(outInfo, output);
+    int piece = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+    int numPieces = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
+    p = loadVTKHDFUnstructuredGrid(fileId, piece, numPieces);
+  }
+  else
+  {
+    p = loadUnstructuredGridData(fileId, this->HDFPath);
+  }
   if (NULL != p)
   {
       output->ShallowCopy(p);
+      if (NULL != p->GetCellData()->GetArray(H5_GHOST_LEVELS))
+      {
+        output->GetInformation()->Set(vtkDataObject::DATA_NUMBER_OF_GHOST_LEVELS(), this->GhostLevels);
+      }
       p->Delete();
     }
 
   // Close the file
-  err = H5Vtk::H5Utilities::closeFile(fileId);
+  err = this->CloseFile(fileId);
   this->HDFError = err;
   HDF_ERROR_HANDLER_ON;
   return 1;
 }
 
 
+//----------------------------------------------------------------------------
+int vtkH5UnstructuredGridReader::RequestInformation( vtkInformation *vtkNotUsed(request),
+                                      vtkInformationVector **vtkNotUsed(inputVector),
+                                      vtkInformationVector *outputVector)
+{
+  this->ResetMemoryBudget();
+  if (NULL == this->FileName)
+  {
+    return 1;
+  }
+  HDF_ERROR_HANDLER_OFF;
+  hid_t fileId = this->OpenFile(true);
+  HDF_ERROR_HANDLER_ON;
+  if (fileId < 0)
+  {
+    // RequestData reports the error
+    return 1;
+  }
+  if (this->IsVTKHDF(fileId, H5_VTKHDF_UNSTRUCTURED_GRID))
+  {
+    // The partitions of the file are distributed over any number of pieces
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::MAXIMUM_NUMBER_OF_PIECES(), -1);
+    this->ReadVTKHDFTimeSteps(fileId, outInfo);
+  }
+  else if (NULL != this->HDFPath)
+  {
+    // The chunks of a spatial index are distributed over any number of pieces
+    std::string indexPath = std::string(this->HDFPath) + "/" + H5_SPATIAL_INDEX;
+    HDF_ERROR_HANDLER_OFF;
+    if (H5Lexists(fileId, this->HDFPath, H5P_DEFAULT) > 0 && H5Lexists(fileId, indexPath.c_str(), H5P_DEFAULT) > 0)
+    {
+      vtkInformation *outInfo = outputVector->GetInformationObject(0);
+      outInfo->Set(vtkStreamingDemandDrivenPipeline::MAXIMUM_NUMBER_OF_PIECES(), -1);
+    }
+    HDF_ERROR_HANDLER_ON;
+    this->ApplyMemoryBudget(fileId, this->HDFPath);
+  }
+  this->CloseFile(fileId);
+  return 1;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -202,6 +290,20 @@ vtkUnstructuredGrid* vtkH5UnstructuredGridReader::loadUnstructuredGridData(hid_t
       }
     }
 
+    if ((this->UseReadBounds || this->UseValueRangeFilter || this->UseIsovalue
+         || this->NumberOfPieces > 1 || this->GhostLevels > 0)
+        && H5Lexists(rootId, H5_SPATIAL_INDEX, H5P_DEFAULT) > 0
+        && !H5Vtk::H5ConnectivityCodec::isEncoded(rootId, H5_CELLS))
+    {
+      output = this->loadUnstructuredGridRegion(rootId);
+      if (NULL == output)
+      {
+        this->HDFError = -1;
+      }
+      H5Gclose(rootId);
+      return output;
+    }
+
     // Now read the points, vertices, lines, polygons and triangle strips
     output = vtkUnstructuredGrid::New();
 
@@ -217,13 +319,41 @@ vtkUnstructuredGrid* vtkH5UnstructuredGridReader::loadUnstructuredGridData(hid_t
     //Read the VERTICES from the file
     vtkCellArray* cells = vtkCellArray::New();
     vtkIntArray*  cell_types = vtkIntArray::New();
-    err = readCells(output, rootId, cells, H5_CELLS);
-    if (err == 1)
+    if (H5Aexists_by_name(rootId, H5_CELLS, H5_CELL_TYPE, H5P_DEFAULT) > 0)
+    {
+      if (this->readHomogeneousCells(output, rootId, H5_CELLS) == 0)
+      {
+        this->HDFError = -1;
+        cells->Delete();
+        cell_types->Delete();
+        return output;
+      }
+    }
+    else if ((err = readCells(output, rootId, cells, H5_CELLS)) == 1)
     {
       err = readCellTypes(output, rootId, cell_types, H5_CELL_TYPES);
       if (err >= 0)
       {
-        output->SetCells(cell_types->GetPointer(0), cells);
+        err = this->readPolyhedronCells(output, rootId, cell_types, cells);
+        if (err == 0)
+        {
+          vtkUnsignedCharArray* types = vtkUnsignedCharArray::New();
+          vtkIdTypeArray* locations = vtkIdTypeArray::New();
+          if (this->readCellLocations(rootId, cell_types, cells, types, locations) == 1)
+          {
+            output->SetCells(types, locations, cells);
+          }
+          else
+          {
+            this->HDFError = -1;
+          }
+          types->Delete();
+          locations->Delete();
+        }
+        else if (err < 0)
+        {
+          this->HDFError = -1;
+        }
       }
       else
       {
@@ -239,7 +369,10 @@ vtkUnstructuredGrid* vtkH5UnstructuredGridReader::loadUnstructuredGridData(hid_t
     cells->Delete();
     cell_types->Delete();
 
-    output->BuildLinks();
+    if (!this->SkipLinks)
+    {
+      output->BuildLinks();
+    }
     output->ComputeBounds();
 
     // Read any FIELD_DATA
@@ -299,6 +432,76 @@ vtkUnstructuredGrid* vtkH5UnstructuredGridReader::loadUnstructuredGridData(hid_t
 }
 
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkUnstructuredGrid* vtkH5UnstructuredGridReader::loadVTKHDFUnstructuredGrid(hid_t fileId, int piece, int numPieces)
+{
+  hid_t gid = H5Gopen(fileId, H5_VTKHDF_GROUP, H5P_DEFAULT);
+  if (gid < 0)
+  {
+    this->HDFError = gid;
+    return NULL;
+  }
+  VTKHDFSelection selection;
+  if (this->SelectVTKHDFPartitions(gid, piece, numPieces, selection) == 0)
+  {
+    H5Gclose(gid);
+    this->HDFError = -1;
+    return NULL;
+  }
+
+  vtkUnstructuredGrid* output = vtkUnstructuredGrid::New();
+  vtkDataArray* data = this->ReadArrayRows(gid, H5_VTKHDF_POINTS, selection.PointStart, selection.PointCount);
+  if (NULL != data)
+  {
+    vtkPoints* points = vtkPoints::New();
+    points->SetData(data);
+    data->Delete();
+    output->SetPoints(points);
+    points->Delete();
+  }
+
+  vtkTypeUInt64 cellStart = 0;
+  vtkTypeUInt64 cellCount = 0;
+  std::vector<vtkIdType> partitionCells;
+  vtkIdTypeArray* locations = vtkIdTypeArray::New();
+  vtkCellArray* cells = this->ReadVTKHDFCells(gid, selection, cellStart, cellCount, partitionCells, locations);
+  vtkUnsignedCharArray* types = vtkUnsignedCharArray::SafeDownCast(
+        this->ReadArrayRows(gid, H5_VTKHDF_TYPES, cellStart, cellCount));
+  if (NULL == cells || NULL == types)
+  {
+    vtkErrorMacro(<< "Could not read the cells of the VTKHDF file");
+    this->HDFError = -1;
+  }
+  else
+  {
+    output->SetCells(types, locations, cells);
+    if (!this->SkipLinks)
+    {
+      output->BuildLinks();
+    }
+    output->ComputeBounds();
+  }
+  if (cells) { cells->Delete(); }
+  if (types) { types->Delete(); }
+  locations->Delete();
+
+  vtkFieldData* fd = this->ReadVTKHDFFieldData(gid);
+  if (NULL != fd)
+  {
+    output->SetFieldData(fd);
+    fd->Delete();
+  }
+  if (this->ReadVTKHDFArrays(gid, H5_VTKHDF_CELL_DATA, output->GetCellData(), cellStart, cellCount, NULL) == 0
+   || this->ReadVTKHDFArrays(gid, H5_VTKHDF_POINT_DATA, output->GetPointData(), selection.PointStart, selection.PointCount, NULL) == 0)
+  {
+    this->HDFError = -1;
+  }
+  H5Gclose(gid);
+  return output;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -309,6 +512,10 @@ int vtkH5UnstructuredGridReader::readCells(vtkUnstructuredGrid* output,
 {
   int  ncells, i;
   herr_t err = -1;
+  if (H5Vtk::H5ConnectivityCodec::isEncoded(rootId, dsetname))
+  {
+    return this->ReadEncodedCells(rootId, dsetname, cells);
+  }
   vtkAbstractArray* array = this->ReadArray(rootId, dsetname);
   if (NULL != array)
   {
@@ -323,6 +530,7 @@ int vtkH5UnstructuredGridReader::readCells(vtkUnstructuredGrid* output,
 
     vtkIdTypeArray* data = vtkIdTypeArray::New();
     vtkIdType* dataPtr = data->WritePointer(0, size);
+    H5Vtk::H5IOStatistics::allocated(static_cast<vtkTypeUInt64>(size) * sizeof(vtkIdType));
     if (H5Tequal(typeId, H5T_NATIVE_INT64))
     {
       vtkTypeInt64Array* arrayPtr = vtkTypeInt64Array::SafeDownCast(array);
@@ -407,18 +615,768 @@ int vtkH5UnstructuredGridReader::readCellTypes(vtkUnstructuredGrid* output,
   vtkTypeInt32* dest = static_cast<vtkTypeInt32* > (((vtkIntArray*)cell_types)->WritePointer(0, numElements));
   if (0 != dest)
   {
+    H5Vtk::H5IOStatistics::allocated(static_cast<vtkTypeUInt64>(numElements) * sizeof(vtkTypeInt32));
     err = H5Vtk::H5Lite::readPointerDataset(parentId, dsetName, dest);
   }
 
   return err;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5UnstructuredGridReader::readCellLocations(hid_t rootId,
+                                                   vtkIntArray* cell_types,
+                                                   vtkCellArray* cells,
+                                                   vtkUnsignedCharArray* types,
+                                                   vtkIdTypeArray* locations)
+{
+  vtkIdType ncells = cells->GetNumberOfCells();
+  if (cell_types->GetNumberOfTuples() != ncells)
+  {
+    vtkErrorMacro(<< "The " << cell_types->GetNumberOfTuples() << " cell types of " << this->HDFPath
+                  << " do not match its " << ncells << " cells");
+    return 0;
+  }
+  unsigned char* typePtr = types->WritePointer(0, ncells);
+  const int* cellTypes = cell_types->GetPointer(0);
+  for (vtkIdType i = 0; i < ncells; ++i)
+  {
+    typePtr[i] = static_cast<unsigned char>(cellTypes[i]);
+  }
+  vtkIdType* locationPtr = locations->WritePointer(0, ncells);
+  H5Vtk::H5IOStatistics::allocated(static_cast<vtkTypeUInt64>(ncells) * (sizeof(unsigned char) + sizeof(vtkIdType)));
+
+  // HDF5 converts the stored offsets straight into the vtkIdType buffer
+  std::vector<hsize_t> dims;
+  H5T_class_t classType;
+  size_t typeSize;
+  if (H5Lexists(rootId, H5_CELL_LOCATIONS, H5P_DEFAULT) > 0
+      && H5Vtk::H5Lite::getDatasetInfo(rootId, H5_CELL_LOCATIONS, dims, classType, typeSize) >= 0
+      && dims.size() == 1 && dims[0] == static_cast<hsize_t>(ncells)
+      && H5Vtk::H5Lite::readPointerDataset(rootId, H5_CELL_LOCATIONS, locationPtr) >= 0)
+  {
+    return 1;
+  }
+
+  // Files without CELL_LOCATIONS need a walk over the cells
+  const vtkIdType* connectivity = cells->GetPointer();
+  vtkIdType location = 0;
+  for (vtkIdType i = 0; i < ncells; ++i)
+  {
+    locationPtr[i] = location;
+    location += connectivity[location] + 1;
+  }
+  return 1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5UnstructuredGridReader::readHomogeneousCells(vtkUnstructuredGrid* output,
+                                                      hid_t rootId,
+                                                      const std::string &dsetname)
+{
+  vtkTypeInt32 ncells = 0;
+  vtkTypeInt32 cellType = 0;
+  if (H5Vtk::H5Lite::readScalarAttribute(rootId, dsetname, "Number Of Cells", ncells) < 0
+      || H5Vtk::H5Lite::readScalarAttribute(rootId, dsetname, H5_CELL_TYPE, cellType) < 0
+      || ncells < 1)
+  {
+    vtkErrorMacro(<< "Could not read the number and type of the cells " << dsetname);
+    return 0;
+  }
+
+  vtkCellArray* cells = vtkCellArray::New();
+  vtkIdType cellSize = 0;
+  if (H5Vtk::H5ConnectivityCodec::isEncoded(rootId, dsetname))
+  {
+    if (this->ReadEncodedCells(rootId, dsetname, cells) == 0)
+    {
+      cells->Delete();
+      return 0;
+    }
+    cellSize = cells->GetPointer()[0];
+  }
+  else
+  {
+    std::vector<hsize_t> dims;
+    H5T_class_t classType;
+    size_t typeSize;
+    if (H5Vtk::H5Lite::getDatasetInfo(rootId, dsetname, dims, classType, typeSize) < 0
+        || dims.size() != 1 || dims[0] % ncells != 0)
+    {
+      vtkErrorMacro(<< "The size of " << dsetname << " does not match its " << ncells << " cells");
+      cells->Delete();
+      return 0;
+    }
+    cellSize = static_cast<vtkIdType>(dims[0] / ncells);
+    vtkIdTypeArray* data = vtkIdTypeArray::New();
+    vtkIdType* dataPtr = data->WritePointer(0, ncells * (cellSize + 1));
+    H5Vtk::H5IOStatistics::allocated(static_cast<vtkTypeUInt64>(ncells) * (cellSize + 1) * sizeof(vtkIdType));
+    // The ids are read behind room for the cell sizes and then moved forward
+    // into place, every cell landing before the ids still to be moved
+    vtkIdType* ids = dataPtr + ncells;
+    if (dims[0] > 0 && H5Vtk::H5Lite::readPointerDataset(rootId, dsetname, ids) < 0)
+    {
+      this->CheckFilters(rootId, dsetname);
+      vtkErrorMacro(<< "Error reading the cells " << dsetname);
+      data->Delete();
+      cells->Delete();
+      return 0;
+    }
+    for (vtkIdType c = 0; c < ncells; ++c)
+    {
+      vtkIdType* dest = dataPtr + c * (cellSize + 1);
+      if (dest + 1 != ids + c * cellSize)
+      {
+        std::copy(ids + c * cellSize, ids + (c + 1) * cellSize, dest + 1);
+      }
+      dest[0] = cellSize;
+    }
+    cells->SetCells(ncells, data);
+    data->Delete();
+  }
+  if (cells->GetNumberOfConnectivityEntries() != ncells * (cellSize + 1))
+  {
+    vtkErrorMacro(<< "The cells of " << dsetname << " do not all have " << cellSize << " points");
+    cells->Delete();
+    return 0;
+  }
+
+  // Every cell has the same type and its location follows from its index
+  vtkUnsignedCharArray* types = vtkUnsignedCharArray::New();
+  unsigned char* typePtr = types->WritePointer(0, ncells);
+  std::fill(typePtr, typePtr + ncells, static_cast<unsigned char>(cellType));
+  vtkIdTypeArray* locations = vtkIdTypeArray::New();
+  vtkIdType* locationPtr = locations->WritePointer(0, ncells);
+  for (vtkIdType c = 0; c < ncells; ++c)
+  {
+    locationPtr[c] = c * (cellSize + 1);
+  }
+  H5Vtk::H5IOStatistics::allocated(static_cast<vtkTypeUInt64>(ncells) * (sizeof(unsigned char) + sizeof(vtkIdType)));
+  output->SetCells(types, locations, cells);
+  types->Delete();
+  locations->Delete();
+  cells->Delete();
+  return 1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5UnstructuredGridReader::readPolyhedronCells(vtkUnstructuredGrid* output,
+                                                     hid_t rootId,
+                                                     vtkIntArray* cell_types,
+                                                     vtkCellArray* cells)
+{
+  if (H5Lexists(rootId, H5_FACES, H5P_DEFAULT) <= 0)
+  {
+    return 0;
+  }
+#ifdef H5VTK_HAVE_POLYHEDRON_FACES
+  vtkIdType ncells = cells->GetNumberOfCells();
+  const char* names[2] = { H5_FACES, H5_FACE_LOCATIONS };
+  vtkIdTypeArray* arrays[2] = { NULL, NULL };
+  for (int i = 0; i < 2; ++i)
+  {
+    std::vector<hsize_t> dims;
+    H5T_class_t classType;
+    size_t typeSize;
+    if (H5Vtk::H5Lite::getDatasetInfo(rootId, names[i], dims, classType, typeSize) < 0 || dims.size() != 1)
+    {
+      break;
+    }
+    arrays[i] = vtkIdTypeArray::New();
+    vtkIdType* ptr = arrays[i]->WritePointer(0, static_cast<vtkIdType>(dims[0]));
+    H5Vtk::H5IOStatistics::allocated(static_cast<vtkTypeUInt64>(dims[0]) * sizeof(vtkIdType));
+    // HDF5 converts the stored integers straight into the vtkIdType buffer
+    if (dims[0] > 0 && H5Vtk::H5Lite::readPointerDataset(rootId, names[i], ptr) < 0)
+    {
+      this->CheckFilters(rootId, names[i]);
+      arrays[i]->Delete();
+      arrays[i] = NULL;
+      break;
+    }
+  }
+  if (NULL == arrays[0] || NULL == arrays[1] || arrays[1]->GetNumberOfTuples() != ncells
+      || cell_types->GetNumberOfTuples() != ncells)
+  {
+    vtkErrorMacro(<< "The polyhedron faces of " << this->HDFPath << " do not match its cells");
+    if (arrays[0]) { arrays[0]->Delete(); }
+    if (arrays[1]) { arrays[1]->Delete(); }
+    return -1;
+  }
+
+  // SetCells(int*, vtkCellArray*) would take the connectivity of polyhedra
+  // for a face stream, so the types and locations are built here and the
+  // grid gets all arrays at once.
+  vtkUnsignedCharArray* types = vtkUnsignedCharArray::New();
+  vtkIdTypeArray* locations = vtkIdTypeArray::New();
+  if (this->readCellLocations(rootId, cell_types, cells, types, locations) == 0)
+  {
+    types->Delete();
+    locations->Delete();
+    arrays[0]->Delete();
+    arrays[1]->Delete();
+    return -1;
+  }
+  output->SetCells(types, locations, cells, arrays[1], arrays[0]);
+  types->Delete();
+  locations->Delete();
+  arrays[0]->Delete();
+  arrays[1]->Delete();
+  return 1;
+#else
+  vtkWarningMacro(<< "This version of VTK can not store polyhedron faces. "
+                  << "The polyhedra of " << this->HDFPath << " have no faces.");
+  return 0;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+  typedef std::pair<vtkTypeUInt64, vtkTypeUInt64> H5VtkRun;
+
+  // Appends a run, extending the last one when they touch
+  void H5VtkAppendRun(std::vector<H5VtkRun> &runs, vtkTypeUInt64 start, vtkTypeUInt64 count)
+  {
+    if (count == 0)
+    {
+      return;
+    }
+    if (!runs.empty() && runs.back().first + runs.back().second == start)
+    {
+      runs.back().second += count;
+    }
+    else
+    {
+      runs.push_back(H5VtkRun(start, count));
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkUnstructuredGrid* vtkH5UnstructuredGridReader::loadUnstructuredGridRegion(hid_t rootId)
+{
+  hid_t gid = H5Gopen(rootId, H5_SPATIAL_INDEX, H5P_DEFAULT);
+  if (gid < 0)
+  {
+    return NULL;
+  }
+  std::vector<hsize_t> dims;
+  H5T_class_t classType;
+  size_t typeSize = 0;
+  herr_t err = H5Vtk::H5Lite::getDatasetInfo(gid, H5_SPATIAL_INDEX_RANGES, dims, classType, typeSize);
+  if (err < 0 || dims.size() != 2 || dims[0] == 0 || dims[1] != H5_SPATIAL_INDEX_COLUMNS)
+  {
+    vtkErrorMacro(<< "The " << H5_SPATIAL_INDEX << " of " << this->HDFPath << " is not valid");
+    H5Gclose(gid);
+    return NULL;
+  }
+  size_t numChunks = static_cast<size_t>(dims[0]);
+  std::vector<double> bounds(numChunks * H5_SPATIAL_INDEX_COLUMNS);
+  std::vector<int64_t> ranges(numChunks * H5_SPATIAL_INDEX_COLUMNS);
+  err = H5Vtk::H5Lite::readPointerDataset(gid, H5_SPATIAL_INDEX_BOUNDS, &bounds[0]);
+  if (err >= 0)
+  {
+    err = H5Vtk::H5Lite::readPointerDataset(gid, H5_SPATIAL_INDEX_RANGES, &ranges[0]);
+  }
+  std::vector<double> valueRanges;
+  bool filterValues = false;
+  if (err >= 0 && (this->UseValueRangeFilter || this->UseIsovalue))
+  {
+    filterValues = (this->readChunkValueRanges(gid, valueRanges) == 1 && valueRanges.size() == 2 * numChunks);
+    if (!filterValues)
+    {
+      vtkWarningMacro(<< "The spatial index of " << this->HDFPath << " has no value ranges for the array '"
+                      << (this->ValueRangeArrayName ? this->ValueRangeArrayName : "") << "'. Chunks are not filtered by value.");
+    }
+  }
+  std::vector<int64_t> neighborOffsets;
+  std::vector<int64_t> neighbors;
+  int ghostLevels = (this->GhostLevels > 0) ? this->GhostLevels : 0;
+  if (err >= 0 && ghostLevels > 0)
+  {
+    if (H5Lexists(gid, H5_SPATIAL_INDEX_NEIGHBOR_OFFSETS, H5P_DEFAULT) > 0)
+    {
+      err = H5Vtk::H5Lite::readVectorDataset(gid, H5_SPATIAL_INDEX_NEIGHBOR_OFFSETS, neighborOffsets);
+      if (err >= 0 && H5Lexists(gid, H5_SPATIAL_INDEX_NEIGHBORS, H5P_DEFAULT) > 0)
+      {
+        err = H5Vtk::H5Lite::readVectorDataset(gid, H5_SPATIAL_INDEX_NEIGHBORS, neighbors);
+      }
+    }
+    if (err >= 0 && neighborOffsets.size() != numChunks + 1)
+    {
+      vtkWarningMacro(<< "The spatial index of " << this->HDFPath << " has no chunk neighbors. No ghost cells are read.");
+      ghostLevels = 0;
+    }
+  }
+  // The point range of a chunk only holds the points it owns when the index
+  // lists the points it shares with other chunks
+  std::vector<int64_t> sharedOffsets;
+  if (err >= 0 && H5Lexists(gid, H5_SPATIAL_INDEX_SHARED_POINT_OFFSETS, H5P_DEFAULT) > 0)
+  {
+    err = H5Vtk::H5Lite::readVectorDataset(gid, H5_SPATIAL_INDEX_SHARED_POINT_OFFSETS, sharedOffsets);
+    if (err >= 0 && sharedOffsets.size() != numChunks + 1)
+    {
+      err = -1;
+    }
+  }
+  H5Gclose(gid);
+  if (err < 0)
+  {
+    vtkErrorMacro(<< "Could not read the " << H5_SPATIAL_INDEX << " of " << this->HDFPath);
+    return NULL;
+  }
+
+  // Every piece owns a contiguous range of chunks
+  int numPieces = (this->NumberOfPieces > 0) ? this->NumberOfPieces : 1;
+  int piece = (this->Piece >= 0 && this->Piece < numPieces) ? this->Piece : 0;
+  size_t firstChunk = (numChunks * piece) / numPieces;
+  size_t lastChunk = (numChunks * (piece + 1)) / numPieces;
+
+  // Level of every chunk: 0 for the chunks of the piece that intersect
+  // ReadBounds and may hold values the predicates accept, k for the chunks
+  // k neighbors away from those and -1 for chunks that are not read
+  std::vector<int> chunkLevels(numChunks, -1);
+  for (size_t c = firstChunk; c < lastChunk; ++c)
+  {
+    const double* b = &bounds[c * H5_SPATIAL_INDEX_COLUMNS];
+    bool intersects = true;
+    for (int i = 0; i < 3 && this->UseReadBounds; ++i)
+    {
+      if (b[2 * i] > this->ReadBounds[2 * i + 1] || b[2 * i + 1] < this->ReadBounds[2 * i])
+      {
+        intersects = false;
+      }
+    }
+    if (filterValues)
+    {
+      double minValue = valueRanges[2 * c];
+      double maxValue = valueRanges[2 * c + 1];
+      if (this->UseValueRangeFilter && (minValue > this->ValueRangeFilter[1] || maxValue < this->ValueRangeFilter[0]))
+      {
+        intersects = false;
+      }
+      if (this->UseIsovalue && (minValue > this->Isovalue || maxValue < this->Isovalue))
+      {
+        intersects = false;
+      }
+    }
+    if (intersects)
+    {
+      chunkLevels[c] = 0;
+    }
+  }
+  // A cell k ghost levels away from the piece lies in a chunk at most k
+  // neighbors away, so the cells of these chunks are all that is needed
+  for (int level = 1; level <= ghostLevels; ++level)
+  {
+    for (size_t c = 0; c < numChunks; ++c)
+    {
+      if (chunkLevels[c] != level - 1)
+      {
+        continue;
+      }
+      for (int64_t n = neighborOffsets[c]; n < neighborOffsets[c + 1]; ++n)
+      {
+        size_t neighbor = static_cast<size_t>(neighbors[n]);
+        if (neighbor < numChunks && chunkLevels[neighbor] < 0)
+        {
+          chunkLevels[neighbor] = level;
+        }
+      }
+    }
+  }
+
+  // Chunks are stored in order so the cell and connectivity rows of
+  // neighbouring chunks merge into a single run.
+  std::vector<H5VtkRun> cellRuns;
+  std::vector<H5VtkRun> connRuns;
+  std::vector<H5VtkRun> pointRanges;
+  std::vector<H5VtkRun> sharedRuns;
+  std::vector<unsigned char> owned;
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    if (chunkLevels[c] < 0)
+    {
+      continue;
+    }
+    const int64_t* r = &ranges[c * H5_SPATIAL_INDEX_COLUMNS];
+    H5VtkAppendRun(cellRuns, r[0], r[1]);
+    H5VtkAppendRun(connRuns, r[2], r[3]);
+    if (r[5] > 0)
+    {
+      pointRanges.push_back(H5VtkRun(r[4], r[5]));
+    }
+    if (!sharedOffsets.empty() && sharedOffsets[c + 1] > sharedOffsets[c])
+    {
+      H5VtkAppendRun(sharedRuns, sharedOffsets[c], sharedOffsets[c + 1] - sharedOffsets[c]);
+    }
+    owned.insert(owned.end(), static_cast<size_t>(r[1]), (chunkLevels[c] == 0) ? 1 : 0);
+  }
+
+  // Every shared point is a run of its own, most of them fall into the
+  // point range of another chunk that is read anyway
+  if (!sharedRuns.empty())
+  {
+    gid = H5Gopen(rootId, H5_SPATIAL_INDEX, H5P_DEFAULT);
+    vtkDataArray* sharedData = (gid < 0) ? NULL : this->ReadArrayRuns(gid, H5_SPATIAL_INDEX_SHARED_POINTS, sharedRuns);
+    if (gid >= 0)
+    {
+      H5Gclose(gid);
+    }
+    if (NULL == sharedData)
+    {
+      vtkErrorMacro(<< "Could not read the " << H5_SPATIAL_INDEX_SHARED_POINTS << " of " << this->HDFPath);
+      return NULL;
+    }
+    vtkIdTypeArray* shared = vtkIdTypeArray::New();
+    shared->DeepCopy(sharedData);
+    sharedData->Delete();
+    for (vtkIdType i = 0; i < shared->GetNumberOfTuples(); ++i)
+    {
+      pointRanges.push_back(H5VtkRun(static_cast<vtkTypeUInt64>(shared->GetValue(i)), 1));
+    }
+    shared->Delete();
+  }
+
+  // The point ranges of the chunks overlap where chunks share points
+  std::sort(pointRanges.begin(), pointRanges.end());
+  std::vector<H5VtkRun> pointRuns;
+  for (size_t i = 0; i < pointRanges.size(); ++i)
+  {
+    vtkTypeUInt64 end = pointRanges[i].first + pointRanges[i].second;
+    if (!pointRuns.empty() && pointRanges[i].first <= pointRuns.back().first + pointRuns.back().second)
+    {
+      pointRuns.back().second = std::max(pointRuns.back().first + pointRuns.back().second, end) - pointRuns.back().first;
+    }
+    else
+    {
+      pointRuns.push_back(pointRanges[i]);
+    }
+  }
+
+  vtkUnstructuredGrid* output = vtkUnstructuredGrid::New();
+  if (cellRuns.empty())
+  {
+    vtkDebugMacro(<< "No chunk of " << this->HDFPath << " passes the ReadBounds and value predicates");
+    return output;
+  }
+
+  // POINTS and the first output id of every point run
+  std::vector<vtkTypeUInt64> runStarts(pointRuns.size());
+  std::vector<vtkIdType> runOffsets(pointRuns.size());
+  vtkIdType numPoints = 0;
+  for (size_t i = 0; i < pointRuns.size(); ++i)
+  {
+    runStarts[i] = pointRuns[i].first;
+    runOffsets[i] = numPoints;
+    numPoints += static_cast<vtkIdType>(pointRuns[i].second);
+  }
+  if (numPoints > 0)
+  {
+    vtkDataArray* pointData = this->ReadArrayRuns(rootId, H5_POINTS, pointRuns);
+    if (NULL == pointData)
+    {
+      output->Delete();
+      return NULL;
+    }
+    vtkPoints* points = vtkPoints::New();
+    points->SetData(pointData);
+    pointData->Delete();
+    output->SetPoints(points);
+    points->Delete();
+  }
+
+  // CELLS with the point ids moved into the points that were read
+  // A grid with a single cell type has neither cell sizes nor CELL_TYPES
+  vtkTypeInt32 cellType = -1;
+  if (H5Aexists_by_name(rootId, H5_CELLS, H5_CELL_TYPE, H5P_DEFAULT) > 0)
+  {
+    H5Vtk::H5Lite::readScalarAttribute(rootId, H5_CELLS, H5_CELL_TYPE, cellType);
+  }
+  vtkDataArray* connData = this->ReadArrayRuns(rootId, H5_CELLS, connRuns);
+  vtkDataArray* typeData = (cellType >= 0) ? NULL : this->ReadArrayRuns(rootId, H5_CELL_TYPES, cellRuns);
+  if (NULL == connData || (NULL == typeData && cellType < 0))
+  {
+    if (NULL != connData)
+    {
+      connData->Delete();
+    }
+    if (NULL != typeData)
+    {
+      typeData->Delete();
+    }
+    output->Delete();
+    return NULL;
+  }
+  vtkIdType numCells = 0;
+  for (size_t i = 0; i < cellRuns.size(); ++i)
+  {
+    numCells += static_cast<vtkIdType>(cellRuns[i].second);
+  }
+  vtkIdTypeArray* legacy = vtkIdTypeArray::New();
+  legacy->DeepCopy(connData);
+  connData->Delete();
+  if (cellType >= 0)
+  {
+    vtkIdTypeArray* ids = legacy;
+    vtkIdType cellSize = ids->GetNumberOfTuples() / numCells;
+    legacy = vtkIdTypeArray::New();
+    vtkIdType* dest = legacy->WritePointer(0, numCells * (cellSize + 1));
+    const vtkIdType* src = ids->GetPointer(0);
+    for (vtkIdType c = 0; c < numCells; ++c)
+    {
+      *dest++ = cellSize;
+      dest = std::copy(src, src + cellSize, dest);
+      src += cellSize;
+    }
+    ids->Delete();
+  }
+  vtkIdType size = legacy->GetNumberOfTuples();
+  vtkIdType* conn = legacy->GetPointer(0);
+  // The cell locations fall out of the walk that moves the ids anyway
+  vtkIdTypeArray* locations = vtkIdTypeArray::New();
+  vtkIdType* locationPtr = locations->WritePointer(0, numCells);
+  vtkIdType c = 0;
+  for (vtkIdType pos = 0; pos < size && c < numCells; pos += conn[pos] + 1, ++c)
+  {
+    locationPtr[c] = pos;
+    for (vtkIdType k = pos + 1; k <= pos + conn[pos]; ++k)
+    {
+      size_t run = std::upper_bound(runStarts.begin(), runStarts.end(), static_cast<vtkTypeUInt64>(conn[k])) - runStarts.begin() - 1;
+      conn[k] = runOffsets[run] + (conn[k] - static_cast<vtkIdType>(runStarts[run]));
+    }
+  }
+  vtkCellArray* cells = vtkCellArray::New();
+  cells->SetCells(numCells, legacy);
+  legacy->Delete();
+  vtkUnsignedCharArray* types = vtkUnsignedCharArray::New();
+  unsigned char* typePtr = types->WritePointer(0, numCells);
+  std::fill(typePtr, typePtr + numCells, static_cast<unsigned char>(cellType));
+  if (NULL != typeData)
+  {
+    for (c = 0; c < numCells; ++c)
+    {
+      typePtr[c] = static_cast<unsigned char>(typeData->GetTuple1(c));
+    }
+    typeData->Delete();
+  }
+  output->SetCells(types, locations, cells);
+  types->Delete();
+  locations->Delete();
+  cells->Delete();
+
+  if (!this->SkipLinks)
+  {
+    output->BuildLinks();
+  }
+
+  // Read any FIELD_DATA
+  gid = H5Gopen(rootId, H5_FIELD_DATA_GROUP_NAME, H5P_DEFAULT);
+  if (gid > 0)
+  {
+    vtkFieldData* fd = this->ReadFieldData(rootId, gid);
+    output->SetFieldData(fd);
+    fd->Delete();
+    H5Gclose(gid);
+  }
+
+  if (this->ReadArraysRuns(rootId, H5_CELL_DATA_GROUP_NAME, output->GetCellData(), cellRuns) == 0
+      || (numPoints > 0
+          && this->ReadArraysRuns(rootId, H5_POINT_DATA_GROUP_NAME, output->GetPointData(), pointRuns) == 0))
+  {
+    this->HDFError = -1;
+  }
+  if (ghostLevels > 0)
+  {
+    this->markGhostCells(output, owned);
+  }
+  return output;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5UnstructuredGridReader::markGhostCells(vtkUnstructuredGrid* output, const std::vector<unsigned char> &owned)
+{
+  vtkIdType numCells = output->GetNumberOfCells();
+  vtkIdType numPoints = output->GetNumberOfPoints();
+  vtkCellArray* cells = output->GetCells();
+  if (NULL == cells || static_cast<size_t>(numCells) != owned.size())
+  {
+    return;
+  }
+  const vtkIdType* conn = cells->GetPointer();
+  vtkIdType size = cells->GetNumberOfConnectivityEntries();
+
+  // Grow the levels one layer of cells at a time through the shared points
+  const int unset = VTK_INT_MAX;
+  std::vector<int> cellLevels(static_cast<size_t>(numCells), unset);
+  std::vector<int> pointLevels(static_cast<size_t>(numPoints), unset);
+  for (vtkIdType c = 0; c < numCells; ++c)
+  {
+    cellLevels[c] = owned[c] ? 0 : unset;
+  }
+  for (int level = 0; level <= this->GhostLevels; ++level)
+  {
+    vtkIdType c = 0;
+    for (vtkIdType pos = 0; pos < size; pos += conn[pos] + 1, ++c)
+    {
+      if (cellLevels[c] != level)
+      {
+        continue;
+      }
+      for (vtkIdType k = pos + 1; k <= pos + conn[pos]; ++k)
+      {
+        pointLevels[conn[k]] = std::min(pointLevels[conn[k]], level);
+      }
+    }
+    if (level == this->GhostLevels)
+    {
+      break;
+    }
+    c = 0;
+    for (vtkIdType pos = 0; pos < size; pos += conn[pos] + 1, ++c)
+    {
+      if (cellLevels[c] != unset)
+      {
+        continue;
+      }
+      for (vtkIdType k = pos + 1; k <= pos + conn[pos]; ++k)
+      {
+        if (pointLevels[conn[k]] == level)
+        {
+          cellLevels[c] = level + 1;
+          break;
+        }
+      }
+    }
+  }
+
+  // Drop the cells of the ghost chunks that are further away
+  vtkIdList* keep = vtkIdList::New();
+  for (vtkIdType c = 0; c < numCells; ++c)
+  {
+    if (cellLevels[c] != unset)
+    {
+      keep->InsertNextId(c);
+    }
+  }
+  if (keep->GetNumberOfIds() < numCells)
+  {
+    vtkUnstructuredGrid* kept = vtkUnstructuredGrid::New();
+    kept->SetPoints(output->GetPoints());
+    kept->GetPointData()->ShallowCopy(output->GetPointData());
+    kept->SetFieldData(output->GetFieldData());
+    kept->Allocate(keep->GetNumberOfIds());
+    kept->GetCellData()->CopyAllocate(output->GetCellData(), keep->GetNumberOfIds());
+    vtkIdList* pts = vtkIdList::New();
+    for (vtkIdType i = 0; i < keep->GetNumberOfIds(); ++i)
+    {
+      vtkIdType c = keep->GetId(i);
+      output->GetCellPoints(c, pts);
+      vtkIdType newId = kept->InsertNextCell(output->GetCellType(c), pts);
+      kept->GetCellData()->CopyData(output->GetCellData(), c, newId);
+      cellLevels[i] = cellLevels[c];
+    }
+    pts->Delete();
+    output->ShallowCopy(kept);
+    kept->Delete();
+    if (!this->SkipLinks)
+    {
+      output->BuildLinks();
+    }
+  }
+
+  vtkUnsignedCharArray* cellGhosts = vtkUnsignedCharArray::New();
+  cellGhosts->SetName(H5_GHOST_LEVELS);
+  cellGhosts->SetNumberOfTuples(keep->GetNumberOfIds());
+  for (vtkIdType i = 0; i < keep->GetNumberOfIds(); ++i)
+  {
+    cellGhosts->SetValue(i, static_cast<unsigned char>(cellLevels[i]));
+  }
+  output->GetCellData()->AddArray(cellGhosts);
+  cellGhosts->Delete();
+  keep->Delete();
+
+  // Points not used by a kept cell lie in the range of a chunk but belong to
+  // other chunks, they are marked as the outermost level
+  vtkUnsignedCharArray* pointGhosts = vtkUnsignedCharArray::New();
+  pointGhosts->SetName(H5_GHOST_LEVELS);
+  pointGhosts->SetNumberOfTuples(numPoints);
+  for (vtkIdType p = 0; p < numPoints; ++p)
+  {
+    int level = (pointLevels[p] == unset) ? this->GhostLevels : pointLevels[p];
+    pointGhosts->SetValue(p, static_cast<unsigned char>(level));
+  }
+  output->GetPointData()->AddArray(pointGhosts);
+  pointGhosts->Delete();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5UnstructuredGridReader::readChunkValueRanges(hid_t indexId, std::vector<double> &valueRanges)
+{
+  if (NULL == this->ValueRangeArrayName)
+  {
+    return 0;
+  }
+  const char* groups[2] = { H5_POINT_DATA_GROUP_NAME, H5_CELL_DATA_GROUP_NAME };
+  for (int g = 0; g < 2; ++g)
+  {
+    if (H5Lexists(indexId, groups[g], H5P_DEFAULT) <= 0)
+    {
+      continue;
+    }
+    hid_t gid = H5Gopen(indexId, groups[g], H5P_DEFAULT);
+    if (gid < 0)
+    {
+      continue;
+    }
+    std::vector<hsize_t> dims;
+    H5T_class_t classType;
+    size_t typeSize = 0;
+    herr_t err = -1;
+    if (H5Lexists(gid, this->ValueRangeArrayName, H5P_DEFAULT) > 0)
+    {
+      err = H5Vtk::H5Lite::getDatasetInfo(gid, this->ValueRangeArrayName, dims, classType, typeSize);
+    }
+    if (err >= 0 && dims.size() == 2 && dims[0] > 0 && dims[1] == 2)
+    {
+      valueRanges.resize(2 * dims[0]);
+      err = H5Vtk::H5Lite::readPointerDataset(gid, this->ValueRangeArrayName, &valueRanges[0]);
+      H5Gclose(gid);
+      return (err < 0) ? 0 : 1;
+    }
+    H5Gclose(gid);
+  }
+  return 0;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
 void vtkH5UnstructuredGridReader::PrintSelf(std::ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "UseReadBounds: " << this->UseReadBounds << "\n";
+  os << indent << "ReadBounds: (" << this->ReadBounds[0] << ", " << this->ReadBounds[1] << ", "
+     << this->ReadBounds[2] << ", " << this->ReadBounds[3] << ", "
+     << this->ReadBounds[4] << ", " << this->ReadBounds[5] << ")\n";
+  os << indent << "ValueRangeArrayName: " << (this->ValueRangeArrayName ? this->ValueRangeArrayName : "(none)") << "\n";
+  os << indent << "UseValueRangeFilter: " << this->UseValueRangeFilter << "\n";
+  os << indent << "ValueRangeFilter: (" << this->ValueRangeFilter[0] << ", " << this->ValueRangeFilter[1] << ")\n";
+  os << indent << "UseIsovalue: " << this->UseIsovalue << "\n";
+  os << indent << "Isovalue: " << this->Isovalue << "\n";
 }
 
 #if 0
@@ -22,6 +22,8 @@ class vtkInformationVector;
 class vtkUnstructuredGrid;
 class vtkCellArray;
 class vtkIntArray;
+class vtkIdTypeArray;
+class vtkUnsignedCharArray;
 
 
 /**
@@ -55,6 +57,49 @@ public:
   vtkSetStringMacro(HDFPath);
   vtkGetStringMacro(HDFPath);
 
+  // Description:
+  // When on and the grid was written with a spatial index (see
+  // vtkH5UnstructuredGridWriter::SetSpatialChunkSize), only the chunks whose
+  // bounding box intersects ReadBounds are read. The output then holds the
+  // cells of those chunks with the points they use. Grids without an index
+  // are read completely.
+  vtkSetMacro(UseReadBounds, int);
+  vtkGetMacro(UseReadBounds, int);
+  vtkBooleanMacro(UseReadBounds, int);
+
+  // Description:
+  // The region of interest (xmin, xmax, ymin, ymax, zmin, zmax) used when
+  // UseReadBounds is on.
+  vtkSetVector6Macro(ReadBounds, double);
+  vtkGetVector6Macro(ReadBounds, double);
+
+  // Description:
+  // Name of the point or cell data array the value predicates below are
+  // tested against. Like ReadBounds they need a grid written with a spatial
+  // index, which stores the value range of every chunk.
+  vtkSetStringMacro(ValueRangeArrayName);
+  vtkGetStringMacro(ValueRangeArrayName);
+
+  // Description:
+  // When UseValueRangeFilter is on, chunks whose values of
+  // ValueRangeArrayName are all outside ValueRangeFilter (min, max) are not
+  // read, so a threshold downstream only gets the candidate cells.
+  vtkSetMacro(UseValueRangeFilter, int);
+  vtkGetMacro(UseValueRangeFilter, int);
+  vtkBooleanMacro(UseValueRangeFilter, int);
+  vtkSetVector2Macro(ValueRangeFilter, double);
+  vtkGetVector2Macro(ValueRangeFilter, double);
+
+  // Description:
+  // When UseIsovalue is on, chunks whose value range of ValueRangeArrayName
+  // does not contain Isovalue are not read, so a contour downstream only gets
+  // the cells it can cut.
+  vtkSetMacro(UseIsovalue, int);
+  vtkGetMacro(UseIsovalue, int);
+  vtkBooleanMacro(UseIsovalue, int);
+  vtkSetMacro(Isovalue, double);
+  vtkGetMacro(Isovalue, double);
+
 
   // Description:
   // Get the output of this reader.
@@ -75,6 +120,16 @@ public:
     * @return NULL pointer if error, otherwise valid vtkUnstructuredGrid object
     */
    virtual vtkUnstructuredGrid* loadUnstructuredGridData(hid_t fileId, const std::string &hdfpath);
+
+   /**
+    * @brief Loads the partitions of the /VTKHDF group that belong to the given
+    * piece. Each dataset is read with a single hyperslab.
+    * @param fileId The HDF5 fileId
+    * @param piece The piece to read
+    * @param numPieces The number of pieces the partitions are distributed over
+    * @return NULL pointer if error, otherwise valid vtkUnstructuredGrid object
+    */
+   virtual vtkUnstructuredGrid* loadVTKHDFUnstructuredGrid(hid_t fileId, int piece, int numPieces);
    //ETX
 
 protected:
@@ -102,6 +157,18 @@ protected:
                   vtkInformationVector **vtkNotUsed(inputVector),
                   vtkInformationVector *outputVector);
 
+ /**
+  * @brief Estimates the memory needed to read the object at HDFPath and decides
+  * how the read has to be degraded to fit the MemoryBudget.
+  * @param request vtkInformation Object
+  * @param inputVector vtkInformationVector for the inputs
+  * @param outputVector vtkInformationVector for the outputs
+  * @return 1 on success, 0 on error
+  */
+ virtual int RequestInformation(vtkInformation *request,
+                                vtkInformationVector **inputVector,
+                                vtkInformationVector *outputVector);
+
 
 //BTX
   /**
@@ -120,6 +187,84 @@ protected:
                             hid_t rootId,
                             vtkIntArray* cell_types,
                             const std::string &dsetname);
+
+  /**
+   * @brief Converts the cell types read by readCellTypes into types and
+   * reads the offset of every cell from CELL_LOCATIONS into locations. The
+   * offsets are only computed from the cells when the file has none.
+   * @param rootId The HDF5 group of the grid
+   * @param cell_types The cell types read by readCellTypes
+   * @param cells The cells read by readCells
+   * @param types Receives the cell types
+   * @param locations Receives the cell locations
+   * @return 1 on success, 0 on error
+   */
+  virtual int readCellLocations(hid_t rootId,
+                                vtkIntArray* cell_types,
+                                vtkCellArray* cells,
+                                vtkUnsignedCharArray* types,
+                                vtkIdTypeArray* locations);
+
+  /**
+   * @brief Sets the cells of a grid whose CELLS carry the CellType attribute.
+   * The cell stream, types and locations are filled in place from the
+   * connectivity without reading any per cell type or size.
+   * @param output The grid
+   * @param rootId The HDF5 group of the grid
+   * @param dsetname The name of the cells dataset
+   * @return 1 on success, 0 on error
+   */
+  virtual int readHomogeneousCells(vtkUnstructuredGrid* output,
+                                   hid_t rootId,
+                                   const std::string &dsetname);
+
+  /**
+   * @brief Sets the cells of a grid with polyhedra. The FACES and
+   * FACE_LOCATIONS datasets are read with one bulk read each and handed to
+   * the grid as they are.
+   * @param output The grid
+   * @param rootId The HDF5 group of the grid
+   * @param cell_types The cell types read by readCellTypes
+   * @param cells The cells read by readCells
+   * @return 1 if the cells were set, 0 if the grid has no polyhedron faces
+   * and -1 on error
+   */
+  virtual int readPolyhedronCells(vtkUnstructuredGrid* output,
+                                  hid_t rootId,
+                                  vtkIntArray* cell_types,
+                                  vtkCellArray* cells);
+
+  /**
+   * @brief Reads the chunks of the SPATIAL_INDEX of a grid that intersect
+   * ReadBounds and pass the value predicates. Every dataset is read with one hyperslab per run of selected
+   * chunks and the point ids of the cells are remapped to the points read.
+   * When the grid is read in pieces every piece owns a contiguous range of
+   * chunks. With ghost levels requested the neighbouring chunks are read in
+   * the same runs and their cells within the ghost levels are kept and
+   * marked in a vtkGhostLevels array.
+   * @param rootId The HDF5 group of the grid
+   * @return NULL pointer if error, otherwise valid vtkUnstructuredGrid object
+   */
+  virtual vtkUnstructuredGrid* loadUnstructuredGridRegion(hid_t rootId);
+
+  /**
+   * @brief Reads the (min, max) of every chunk of ValueRangeArrayName from the
+   * index, looking at the point data first.
+   * @param indexId The SPATIAL_INDEX group
+   * @param valueRanges Receives 2 values per chunk
+   * @return 1 if the ranges were read, 0 otherwise
+   */
+  int readChunkValueRanges(hid_t indexId, std::vector<double> &valueRanges);
+
+  /**
+   * @brief Works out the ghost level of every cell of a region read with
+   * ghost chunks. Cells of owned chunks are level 0, a cell sharing a point
+   * with a level k cell is level k + 1. Cells above GhostLevels are removed
+   * with their cell data and the vtkGhostLevels arrays are added.
+   * @param output The region
+   * @param owned 1 for every cell of output read from an owned chunk
+   */
+  void markGhostCells(vtkUnstructuredGrid* output, const std::vector<unsigned char> &owned);
   //ETX
 
 private:
@@ -127,6 +272,17 @@ private:
   char* FileName;
   char* HDFPath;
   int HDFError;
+  int UseReadBounds;
+  double ReadBounds[6];
+  char* ValueRangeArrayName;
+  int UseValueRangeFilter;
+  double ValueRangeFilter[2];
+  int UseIsovalue;
+  double Isovalue;
+  // Update request of the current RequestData
+  int Piece;
+  int NumberOfPieces;
+  int GhostLevels;
 
 
   vtkH5UnstructuredGridReader(const vtkH5UnstructuredGridReader&);  // Not implemented.
@@ -0,0 +1,997 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "vtkH5UnstructuredGridWriter.h"
+#include "VTKH5Constants.h"
+
+#include "HDF5/H5Utilities.h"
+
+#include "vtkObjectFactory.h"
+#include <vtkErrorCode.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkUnstructuredGrid.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkFieldData.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkCellArray.h>
+
+#include <cmath>
+#include <algorithm>
+
+#define APPEND_DATA_TRUE 1
+#define APPEND_DATA_FALSE 0
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkCxxRevisionMacro( vtkH5UnstructuredGridWriter, "$Revision: 1.1 $" );
+vtkStandardNewMacro( vtkH5UnstructuredGridWriter );
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkH5UnstructuredGridWriter::vtkH5UnstructuredGridWriter()
+{
+  this->FileName = NULL;
+  this->HDFPath = NULL;
+  this->SetNumberOfInputPorts(1);
+  this->AppendData = APPEND_DATA_TRUE;
+  this->SpatialChunkSize = 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkH5UnstructuredGridWriter::~vtkH5UnstructuredGridWriter()
+{
+  this->SetFileName( NULL );
+  this->SetHDFPath(NULL);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5UnstructuredGridWriter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+  os << indent << "SpatialChunkSize: " << this->SpatialChunkSize << "\n";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5UnstructuredGridWriter::FillInputPortInformation(int, vtkInformation *info)
+{
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkUnstructuredGrid");
+  return 1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkUnstructuredGrid* vtkH5UnstructuredGridWriter::GetInput()
+{
+  return vtkUnstructuredGrid::SafeDownCast(this->Superclass::GetInput());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkUnstructuredGrid* vtkH5UnstructuredGridWriter::GetInput(int port)
+{
+  return vtkUnstructuredGrid::SafeDownCast(this->Superclass::GetInput(port));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void vtkH5UnstructuredGridWriter::WriteData()
+{
+  this->SetErrorCode(vtkErrorCode::NoError);
+  if (this->SWMRMode)
+  {
+    if (this->WriteSWMRStep(this->GetInput(), APPEND_DATA_TRUE == this->AppendData) < 0)
+    {
+      this->SetErrorCode(vtkErrorCode::UnknownError);
+    }
+    return;
+  }
+
+  hid_t fileId = -1;
+  // Try to open a file to append data into
+  if (APPEND_DATA_TRUE == this->AppendData)
+  {
+    fileId = H5Vtk::H5Utilities::openFile(this->FileName, false);
+  }
+  // No file was found or we are writing new data only to a clean file
+  if (APPEND_DATA_FALSE == this->AppendData || fileId < 0)
+  {
+    fileId = H5Vtk::H5Utilities::createFile (this->FileName);
+  }
+
+  //Something went wrong either opening or creating the file. Error messages have
+  // Alread been written at this point so just return.
+  if (fileId < 0)
+  {
+    vtkErrorMacro(<< "The hdf5 file could not be opened or created: " << this->FileName);
+    this->SetErrorCode(vtkErrorCode::CannotOpenFileError);
+    return;
+  }
+
+  if (this->VTKHDFLayout)
+  {
+#ifdef H5VTK_HAVE_POLYHEDRON_FACES
+    if (NULL != this->GetInput()->GetFaces())
+    {
+      vtkWarningMacro(<< "The VTKHDF layout does not store polyhedron faces. "
+                      << "Polyhedra written to " << this->FileName << " can not be read back.");
+    }
+#endif
+    if (this->WriteVTKHDF(fileId, this->GetInput()) < 0)
+    {
+      vtkErrorMacro(<< "Error writing the VTKHDF layout to " << this->FileName);
+      this->SetErrorCode(vtkErrorCode::UnknownError);
+    }
+    H5Vtk::H5Utilities::closeFile(fileId);
+    return;
+  }
+
+
+  herr_t err = H5Vtk::H5Utilities::createGroupsFromPath(this->HDFPath, fileId);
+  if (err < 0)
+  {
+    vtkErrorMacro(<< "Error creating the group " << this->HDFPath << " in " << this->FileName);
+    this->SetErrorCode(vtkErrorCode::UnknownError);
+    H5Vtk::H5Utilities::closeFile(fileId);
+    return;
+  }
+  hid_t fp = H5Gopen(fileId, this->HDFPath, H5P_DEFAULT );
+  err = H5Vtk::H5Lite::writeStringAttribute(fileId, this->HDFPath, H5_VTK_DATA_OBJECT, H5_VTK_UNSTRUCTURED_GRID );
+  if(err < 0)
+  {
+    vtkErrorMacro(<< "Error writing the data object type of " << this->HDFPath);
+    this->SetErrorCode(vtkErrorCode::UnknownError);
+    H5Gclose(fp);
+    H5Vtk::H5Utilities::closeFile(fileId);
+    return;
+  }
+  vtkUnstructuredGrid *input = this->GetInput();
+  vtkUnstructuredGrid *reordered = NULL;
+  if (this->SpaceFillingCurve != VTK_H5_CURVE_NONE)
+  {
+    reordered = this->ReorderAlongCurve(input);
+    if (NULL != reordered)
+    {
+      input = reordered;
+    }
+  }
+  // Binning keeps the curve order of the cells inside every chunk
+  vtkUnstructuredGrid *sorted = NULL;
+  std::vector<double> chunkBounds;
+  std::vector<int64_t> chunkRanges;
+  if (this->SpatialChunkSize > 0 && input->GetNumberOfCells() > this->SpatialChunkSize)
+  {
+    sorted = this->SortCellsSpatially(input, chunkBounds, chunkRanges);
+    if (NULL != sorted)
+    {
+      input = sorted;
+    }
+  }
+  // Write data owned by the dataset
+  int errorOccured = 0;
+  vtkFieldData* field = input->GetFieldData();
+  if (field && field->GetNumberOfTuples() > 0)
+  {
+    if (!this->WriteFieldData(fp, field))
+    {
+      errorOccured = 1; // we tried to write field data, but we couldn't
+    }
+  }
+
+  if (!errorOccured && this->WritePoints(fp, input->GetPoints()) < 0 )
+    {
+    errorOccured = 1;
+    }
+
+  // A grid with a single cell type needs neither cell sizes nor CELL_TYPES
+  int cellSize = 0;
+  int cellType = 0;
+  if (!errorOccured && input->GetCells())
+    {
+    // Chunks of the spatial index are read by ranges of CELLS, which needs
+    // the plain layout
+    if (NULL != sorted && this->ConnectivityCodec)
+    {
+      vtkWarningMacro(<< "ConnectivityCodec is not used for grids written with a spatial index");
+    }
+    cellSize = this->GetHomogeneousCellSize(input, cellType);
+    if (cellSize > 0)
+      {
+      if (this->WriteHomogeneousCells(fp, input, cellType, cellSize, NULL == sorted) < 0)
+        {
+        errorOccured = 1;
+        }
+      }
+    else if (this->WriteCells(fp, input->GetCells(), H5_CELLS, NULL == sorted) < 0)
+      {
+      errorOccured = 1;
+      }
+    }
+
+  vtkUnsignedCharArray* types = input->GetCellTypesArray();
+  if (!errorOccured && types && input->GetNumberOfCells() > 0 && cellSize == 0)
+    {
+    if (this->WriteArray(fp, VTK_UNSIGNED_CHAR, types, H5_CELL_TYPES, input->GetNumberOfCells(), 1,
+                         this->ConnectivityCompression) == 0)
+      {
+      errorOccured = 1;
+      }
+    }
+
+  vtkIdTypeArray* locations = input->GetCellLocationsArray();
+  if (!errorOccured && locations && input->GetNumberOfCells() > 0 && cellSize == 0
+      && this->WriteCellLocations(fp, locations) < 0)
+    {
+    errorOccured = 1;
+    }
+
+  if (!errorOccured && this->WritePolyhedronFaces(fp, input) < 0)
+    {
+    errorOccured = 1;
+    }
+
+  if (!errorOccured && NULL != sorted && this->WriteSpatialIndex(fp, sorted, chunkBounds, chunkRanges, cellSize) < 0)
+    {
+    errorOccured = 1;
+    }
+
+  vtkCellData* cd = input->GetCellData();
+  if (!errorOccured && (this->WriteDatasetArrays(fp, input, cd, input->GetNumberOfCells(), H5_CELL_DATA_GROUP_NAME) == 0) )
+    {
+    errorOccured = 1;
+    }
+
+  vtkPointData* pd = input->GetPointData();
+  if (!errorOccured && (this->WriteDatasetArrays(fp, input, pd, input->GetNumberOfPoints(), H5_POINT_DATA_GROUP_NAME) == 0) )
+    {
+    errorOccured = 1;
+    }
+
+  if(errorOccured)
+    {
+    vtkErrorMacro(<< "Error occured writing UnstructuredGrid to HDF5 file.")
+    this->SetErrorCode(vtkErrorCode::UnknownError);
+    }
+  if (NULL != sorted)
+    {
+    sorted->Delete();
+    }
+  if (NULL != reordered)
+    {
+    reordered->Delete();
+    }
+
+  // Close the UnstructuredGrid group when we are finished with it
+  err = H5Gclose(fp);
+
+  // Close the file when we are finished with it. HDF5 flushes the cached
+  // chunks and metadata here, so a full disk may only show up now
+  if (H5Vtk::H5Utilities::closeFile(fileId) < 0)
+  {
+    vtkErrorMacro(<< "Error closing " << this->FileName);
+    this->SetErrorCode(vtkErrorCode::UnknownError);
+  }
+
+  this->WriteXdmfDescriptor();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5UnstructuredGridWriter::WriteCellLocations(hid_t fp, vtkIdTypeArray* locations)
+{
+  // Written at full width straight from the memory of the grid, without the
+  // NumComponents attribute of WriteArray()
+  herr_t err = this->vtkWriteCompressedDataset(fp, H5_CELL_LOCATIONS, static_cast<hsize_t>(locations->GetNumberOfTuples()),
+                                               locations->GetPointer(0), this->ConnectivityCompression, 1);
+  if (err < 0)
+  {
+    vtkErrorMacro(<< "Error writing the cell locations");
+  }
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5UnstructuredGridWriter::WritePolyhedronFaces(hid_t fp, vtkUnstructuredGrid* input)
+{
+#ifdef H5VTK_HAVE_POLYHEDRON_FACES
+  vtkIdTypeArray* faces = input->GetFaces();
+  vtkIdTypeArray* faceLocations = input->GetFaceLocations();
+  if (NULL == faces || NULL == faceLocations || faces->GetNumberOfTuples() == 0)
+  {
+    return 1; // No polyhedra in this grid
+  }
+  // Both arrays are written straight from the memory of the grid
+  herr_t err = this->vtkWriteCompressedDataset(fp, H5_FACES, static_cast<hsize_t>(faces->GetNumberOfTuples()),
+                                               faces->GetPointer(0), this->ConnectivityCompression, 1);
+  if (err < 0)
+  {
+    vtkErrorMacro(<< "Error writing the polyhedron faces");
+    return err;
+  }
+  err = this->vtkWriteCompressedDataset(fp, H5_FACE_LOCATIONS, static_cast<hsize_t>(faceLocations->GetNumberOfTuples()),
+                                        faceLocations->GetPointer(0), this->ConnectivityCompression, 1);
+  if (err < 0)
+  {
+    vtkErrorMacro(<< "Error writing the polyhedron face locations");
+  }
+  return err;
+#else
+  return 1;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5UnstructuredGridWriter::GetHomogeneousCellSize(vtkUnstructuredGrid* input, int &cellType)
+{
+  vtkIdType ncells = input->GetNumberOfCells();
+  vtkUnsignedCharArray* types = input->GetCellTypesArray();
+  vtkCellArray* cells = input->GetCells();
+  if (ncells < 1 || NULL == types || NULL == cells)
+  {
+    return 0;
+  }
+  const unsigned char* typePtr = types->GetPointer(0);
+  cellType = typePtr[0];
+#ifdef H5VTK_HAVE_POLYHEDRON_FACES
+  if (cellType == VTK_POLYHEDRON)
+  {
+    return 0;
+  }
+#endif
+  for (vtkIdType c = 1; c < ncells; ++c)
+  {
+    if (typePtr[c] != cellType)
+    {
+      return 0;
+    }
+  }
+  // Polygons, poly lines and the like may still differ in size
+  const vtkIdType* conn = cells->GetPointer();
+  vtkIdType cellSize = conn[0];
+  if (cellSize < 1 || cells->GetNumberOfConnectivityEntries() != ncells * (cellSize + 1))
+  {
+    return 0;
+  }
+  for (vtkIdType c = 1; c < ncells; ++c)
+  {
+    if (conn[c * (cellSize + 1)] != cellSize)
+    {
+      return 0;
+    }
+  }
+  return static_cast<int>(cellSize);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5UnstructuredGridWriter::WriteHomogeneousCells(hid_t fp, vtkUnstructuredGrid* input, int cellType,
+                                                       int cellSize, bool useCodec)
+{
+  vtkCellArray* cells = input->GetCells();
+  herr_t err = 0;
+  if (this->ConnectivityCodec && useCodec)
+  {
+    // The codec already stores a constant cell size only once
+    err = this->WriteCells(fp, cells, H5_CELLS, true);
+  }
+  else
+  {
+    vtkIdType ncells = cells->GetNumberOfCells();
+    const vtkIdType* conn = cells->GetPointer();
+    std::vector<vtkIdType> ids(static_cast<size_t>(ncells) * cellSize);
+    vtkIdType* dest = &ids[0];
+    for (vtkIdType c = 0; c < ncells; ++c)
+    {
+      std::copy(conn + 1, conn + 1 + cellSize, dest);
+      conn += cellSize + 1;
+      dest += cellSize;
+    }
+    // Chunks hold whole cells
+    err = this->vtkWriteCompressedDataset(fp, H5_CELLS, static_cast<hsize_t>(ids.size()), &ids[0],
+                                          this->ConnectivityCompression, cellSize);
+    if (err >= 0)
+    {
+      vtkTypeInt32 numCells = static_cast<vtkTypeInt32>(ncells);
+      err = H5Vtk::H5Lite::writeScalarAttribute(fp, H5_CELLS, "Number Of Cells", numCells);
+    }
+  }
+  if (err >= 0)
+  {
+    vtkTypeInt32 type = cellType;
+    err = H5Vtk::H5Lite::writeScalarAttribute(fp, H5_CELLS, H5_CELL_TYPE, type);
+  }
+  if (err < 0)
+  {
+    vtkErrorMacro(<< "Error writing the cells of type " << cellType << " to " << this->FileName);
+  }
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkUnstructuredGrid* vtkH5UnstructuredGridWriter::PermuteGrid(vtkUnstructuredGrid* input,
+                                                              const std::vector<vtkIdType> &cellOrder,
+                                                              const std::vector<vtkIdType> &pointMap)
+{
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkIdType numPoints = input->GetNumberOfPoints();
+  vtkCellArray* cells = input->GetCells();
+  vtkPoints* points = input->GetPoints();
+  vtkIdType* conn = cells->GetPointer();
+
+  std::vector<vtkIdType> cellLocations(numCells);
+  vtkIdType loc = 0;
+  for (vtkIdType c = 0; c < numCells; ++c)
+  {
+    cellLocations[c] = loc;
+    loc += conn[loc] + 1;
+  }
+
+  vtkIdTypeArray* newConn = vtkIdTypeArray::New();
+  vtkIdType* dest = newConn->WritePointer(0, cells->GetNumberOfConnectivityEntries());
+  std::vector<int> types(numCells);
+  vtkIdType pos = 0;
+  for (vtkIdType n = 0; n < numCells; ++n)
+  {
+    vtkIdType c = cellOrder[n];
+    types[n] = input->GetCellType(c);
+    vtkIdType* cell = conn + cellLocations[c];
+    dest[pos++] = cell[0];
+    for (vtkIdType k = 1; k <= cell[0]; ++k)
+    {
+      dest[pos++] = pointMap[cell[k]];
+    }
+  }
+
+  vtkUnstructuredGrid* output = vtkUnstructuredGrid::New();
+  vtkPoints* newPoints = vtkPoints::New(points->GetDataType());
+  newPoints->SetNumberOfPoints(numPoints);
+  vtkPointData* inPD = input->GetPointData();
+  vtkPointData* outPD = output->GetPointData();
+  outPD->CopyAllOn();
+  outPD->CopyAllocate(inPD, numPoints);
+  for (vtkIdType p = 0; p < numPoints; ++p)
+  {
+    newPoints->SetPoint(pointMap[p], points->GetPoint(p));
+    outPD->CopyData(inPD, p, pointMap[p]);
+  }
+  output->SetPoints(newPoints);
+  newPoints->Delete();
+
+  vtkCellArray* newCells = vtkCellArray::New();
+  newCells->SetCells(numCells, newConn);
+  newConn->Delete();
+  output->SetCells(numCells > 0 ? &types[0] : NULL, newCells);
+  newCells->Delete();
+
+  vtkCellData* inCD = input->GetCellData();
+  vtkCellData* outCD = output->GetCellData();
+  outCD->CopyAllOn();
+  outCD->CopyAllocate(inCD, numCells);
+  for (vtkIdType n = 0; n < numCells; ++n)
+  {
+    outCD->CopyData(inCD, cellOrder[n], n);
+  }
+  output->SetFieldData(input->GetFieldData());
+  return output;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkUnstructuredGrid* vtkH5UnstructuredGridWriter::ReorderAlongCurve(vtkUnstructuredGrid* input)
+{
+#ifdef H5VTK_HAVE_POLYHEDRON_FACES
+  if (NULL != input->GetFaces())
+  {
+    vtkWarningMacro(<< "Grids with polyhedra are written in their own order");
+    return NULL;
+  }
+#endif
+  vtkCellArray* cells = input->GetCells();
+  vtkPoints* points = input->GetPoints();
+  if (NULL == cells || NULL == points)
+  {
+    return NULL;
+  }
+  double bounds[6];
+  input->GetBounds(bounds);
+
+  // Points are sorted by their own key, cells by the key of their center
+  std::vector<vtkIdType> pointMap;
+  this->SortPointsAlongCurve(points, bounds, pointMap);
+  std::vector<vtkIdType> cellOrder;
+  this->SortCellsAlongCurve(cells, points, bounds, 0, cellOrder);
+
+  // Keep the permutation so the solver ids can be recovered from the file
+  vtkUnstructuredGrid* output = this->PermuteGrid(input, cellOrder, pointMap);
+  this->AddOriginalIds(output, pointMap, cellOrder);
+  return output;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkUnstructuredGrid* vtkH5UnstructuredGridWriter::SortCellsSpatially(vtkUnstructuredGrid* input,
+                                                                     std::vector<double> &bounds,
+                                                                     std::vector<int64_t> &ranges)
+{
+#ifdef H5VTK_HAVE_POLYHEDRON_FACES
+  if (NULL != input->GetFaces())
+  {
+    vtkWarningMacro(<< "Grids with polyhedra are written without a spatial index");
+    return NULL;
+  }
+#endif
+  vtkCellArray* cells = input->GetCells();
+  vtkPoints* points = input->GetPoints();
+  if (NULL == cells || NULL == points)
+  {
+    return NULL;
+  }
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkIdType numPoints = input->GetNumberOfPoints();
+  vtkIdType* conn = cells->GetPointer();
+
+  // Lay a regular grid of bins over the bounds of the data set with about
+  // SpatialChunkSize cells per bin, ignoring the flat axes
+  double gb[6];
+  input->GetBounds(gb);
+  double length[3];
+  double volume = 1.0;
+  int numAxes = 0;
+  for (int i = 0; i < 3; ++i)
+  {
+    length[i] = gb[2 * i + 1] - gb[2 * i];
+    if (length[i] > 0.0)
+    {
+      volume *= length[i];
+      ++numAxes;
+    }
+  }
+  double numBinsWanted = std::max(1.0, static_cast<double>(numCells) / this->SpatialChunkSize);
+  double binLength = (numAxes > 0) ? std::pow(volume / numBinsWanted, 1.0 / numAxes) : 1.0;
+  vtkIdType binDims[3];
+  for (int i = 0; i < 3; ++i)
+  {
+    binDims[i] = 1;
+    if (length[i] > 0.0 && binLength > 0.0)
+    {
+      binDims[i] = std::max(static_cast<vtkIdType>(1), static_cast<vtkIdType>(std::ceil(length[i] / binLength)));
+    }
+  }
+  vtkIdType numBins = binDims[0] * binDims[1] * binDims[2];
+
+  // Bin every cell by the average of its points and counting sort the cells.
+  // The sort is stable so cells keep their order inside a bin.
+  std::vector<vtkIdType> cellLocations(numCells);
+  std::vector<vtkIdType> cellBins(numCells);
+  std::vector<vtkIdType> binStarts(numBins + 1, 0);
+  vtkIdType loc = 0;
+  double x[3];
+  for (vtkIdType c = 0; c < numCells; ++c)
+  {
+    cellLocations[c] = loc;
+    vtkIdType npts = conn[loc];
+    double center[3] = { 0.0, 0.0, 0.0 };
+    for (vtkIdType k = 1; k <= npts; ++k)
+    {
+      points->GetPoint(conn[loc + k], x);
+      center[0] += x[0];
+      center[1] += x[1];
+      center[2] += x[2];
+    }
+    vtkIdType bin = 0;
+    for (int i = 2; i >= 0; --i)
+    {
+      vtkIdType b = 0;
+      if (npts > 0 && length[i] > 0.0)
+      {
+        b = static_cast<vtkIdType>((center[i] / npts - gb[2 * i]) / length[i] * binDims[i]);
+        b = std::min(std::max(b, static_cast<vtkIdType>(0)), binDims[i] - 1);
+      }
+      bin = bin * binDims[i] + b;
+    }
+    cellBins[c] = bin;
+    ++binStarts[bin + 1];
+    loc += npts + 1;
+  }
+  for (vtkIdType b = 0; b < numBins; ++b)
+  {
+    binStarts[b + 1] += binStarts[b];
+  }
+  std::vector<vtkIdType> order(numCells);
+  std::vector<vtkIdType> fill(binStarts.begin(), binStarts.end() - 1);
+  for (vtkIdType c = 0; c < numCells; ++c)
+  {
+    order[fill[cellBins[c]]++] = c;
+  }
+
+  // Renumber the points in the order the sorted cells first use them, points
+  // no cell uses go to the end. The points a bin uses first are owned by it
+  // and form the run [pointStarts[b], pointStarts[b + 1]) of POINTS.
+  std::vector<vtkIdType> pointMap(numPoints, -1);
+  std::vector<vtkIdType> pointStarts(numBins + 1, 0);
+  vtkIdType nextPoint = 0;
+  for (vtkIdType b = 0; b < numBins; ++b)
+  {
+    pointStarts[b] = nextPoint;
+    for (vtkIdType n = binStarts[b]; n < binStarts[b + 1]; ++n)
+    {
+      vtkIdType* cell = conn + cellLocations[order[n]];
+      for (vtkIdType k = 1; k <= cell[0]; ++k)
+      {
+        if (pointMap[cell[k]] < 0)
+        {
+          pointMap[cell[k]] = nextPoint++;
+        }
+      }
+    }
+  }
+  pointStarts[numBins] = nextPoint;
+  for (vtkIdType p = 0; p < numPoints; ++p)
+  {
+    if (pointMap[p] < 0)
+    {
+      pointMap[p] = nextPoint++;
+    }
+  }
+  vtkUnstructuredGrid* output = this->PermuteGrid(input, order, pointMap);
+
+  // Describe every non empty bin of the sorted grid as one chunk
+  conn = output->GetCells()->GetPointer();
+  points = output->GetPoints();
+  vtkIdType pos = 0;
+  for (vtkIdType b = 0; b < numBins; ++b)
+  {
+    if (binStarts[b] == binStarts[b + 1])
+    {
+      continue;
+    }
+    double cb[6] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+    vtkIdType connStart = pos;
+    bool hasPoints = false;
+    for (vtkIdType n = binStarts[b]; n < binStarts[b + 1]; ++n)
+    {
+      vtkIdType npts = conn[pos++];
+      for (vtkIdType k = 0; k < npts; ++k)
+      {
+        vtkIdType id = conn[pos++];
+        hasPoints = true;
+        points->GetPoint(id, x);
+        for (int i = 0; i < 3; ++i)
+        {
+          cb[2 * i] = std::min(cb[2 * i], x[i]);
+          cb[2 * i + 1] = std::max(cb[2 * i + 1], x[i]);
+        }
+      }
+    }
+    if (!hasPoints)
+    {
+      for (int i = 0; i < 6; ++i)
+      {
+        cb[i] = gb[i]; // Only empty cells in this chunk
+      }
+    }
+    bounds.insert(bounds.end(), cb, cb + 6);
+    ranges.push_back(binStarts[b]);
+    ranges.push_back(binStarts[b + 1] - binStarts[b]);
+    ranges.push_back(connStart);
+    ranges.push_back(pos - connStart);
+    ranges.push_back(pointStarts[b]);
+    ranges.push_back(pointStarts[b + 1] - pointStarts[b]);
+  }
+  return output;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5UnstructuredGridWriter::WriteSpatialIndex(hid_t fp, vtkUnstructuredGrid* sorted,
+                                                   std::vector<double> &bounds, std::vector<int64_t> &ranges,
+                                                   int cellSize)
+{
+  hid_t gid = H5Gcreate(fp, H5_SPATIAL_INDEX, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  if (gid < 0)
+  {
+    vtkErrorMacro(<< "Error creating the " << H5_SPATIAL_INDEX << " group");
+    return gid;
+  }
+  vtkTypeInt32 rank = 2;
+  vtkTypeUInt64 dims[2] = { static_cast<vtkTypeUInt64>(ranges.size() / H5_SPATIAL_INDEX_COLUMNS), H5_SPATIAL_INDEX_COLUMNS };
+  herr_t err = H5Vtk::H5Lite::writePointerDataset(gid, H5_SPATIAL_INDEX_BOUNDS, rank, dims, &bounds[0]);
+  if (err >= 0)
+  {
+    // The connectivity ranges of the file skip the cell sizes that were not
+    // written, the ones of the sorted grid are still needed for the neighbors
+    std::vector<int64_t> fileRanges(ranges);
+    for (size_t r = 0; cellSize > 0 && r < fileRanges.size(); r += H5_SPATIAL_INDEX_COLUMNS)
+    {
+      fileRanges[r + 2] = fileRanges[r] * cellSize;
+      fileRanges[r + 3] = fileRanges[r + 1] * cellSize;
+    }
+    err = H5Vtk::H5Lite::writePointerDataset(gid, H5_SPATIAL_INDEX_RANGES, rank, dims, &fileRanges[0]);
+  }
+  std::vector<int64_t> sharedOffsets;
+  std::vector<int64_t> sharedPoints;
+  if (err >= 0)
+  {
+    err = this->WriteSharedPoints(gid, sorted, ranges, sharedOffsets, sharedPoints);
+  }
+  if (err >= 0)
+  {
+    std::vector<int64_t> noShared;
+    err = this->WriteChunkValueRanges(gid, H5_CELL_DATA_GROUP_NAME, sorted->GetCellData(), ranges, 0,
+                                      noShared, noShared);
+  }
+  if (err >= 0)
+  {
+    err = this->WriteChunkValueRanges(gid, H5_POINT_DATA_GROUP_NAME, sorted->GetPointData(), ranges, 4,
+                                      sharedOffsets, sharedPoints);
+  }
+  if (err >= 0)
+  {
+    err = this->WriteChunkNeighbors(gid, sorted, ranges);
+  }
+  if (err < 0)
+  {
+    vtkErrorMacro(<< "Error writing the " << H5_SPATIAL_INDEX << " of " << this->FileName);
+  }
+  H5Gclose(gid);
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5UnstructuredGridWriter::WriteSharedPoints(hid_t indexId, vtkUnstructuredGrid* sorted,
+                                                   std::vector<int64_t> &ranges,
+                                                   std::vector<int64_t> &offsets,
+                                                   std::vector<int64_t> &shared)
+{
+  // The points a chunk uses outside of the run of points it owns, which an
+  // earlier chunk used first
+  size_t numChunks = ranges.size() / H5_SPATIAL_INDEX_COLUMNS;
+  const vtkIdType* conn = sorted->GetCells()->GetPointer();
+  offsets.assign(numChunks + 1, 0);
+  shared.clear();
+  std::vector<int64_t> chunkShared;
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    const int64_t* r = &ranges[c * H5_SPATIAL_INDEX_COLUMNS];
+    chunkShared.clear();
+    for (int64_t pos = r[2]; pos < r[2] + r[3]; pos += conn[pos] + 1)
+    {
+      for (vtkIdType k = 1; k <= conn[pos]; ++k)
+      {
+        if (conn[pos + k] < r[4] || conn[pos + k] >= r[4] + r[5])
+        {
+          chunkShared.push_back(conn[pos + k]);
+        }
+      }
+    }
+    std::sort(chunkShared.begin(), chunkShared.end());
+    chunkShared.erase(std::unique(chunkShared.begin(), chunkShared.end()), chunkShared.end());
+    shared.insert(shared.end(), chunkShared.begin(), chunkShared.end());
+    offsets[c + 1] = static_cast<int64_t>(shared.size());
+  }
+
+  vtkTypeInt32 rank = 1;
+  vtkTypeUInt64 dims[1] = { static_cast<vtkTypeUInt64>(offsets.size()) };
+  herr_t err = H5Vtk::H5Lite::writePointerDataset(indexId, H5_SPATIAL_INDEX_SHARED_POINT_OFFSETS, rank, dims, &offsets[0]);
+  if (err >= 0 && !shared.empty())
+  {
+    dims[0] = shared.size();
+    err = H5Vtk::H5Lite::writePointerDataset(indexId, H5_SPATIAL_INDEX_SHARED_POINTS, rank, dims, &shared[0]);
+  }
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5UnstructuredGridWriter::WriteChunkNeighbors(hid_t indexId, vtkUnstructuredGrid* sorted,
+                                                     std::vector<int64_t> &ranges)
+{
+  // Every (point, chunk) use, so the chunks sharing a point end up next to
+  // each other once sorted
+  size_t numChunks = ranges.size() / H5_SPATIAL_INDEX_COLUMNS;
+  const vtkIdType* conn = sorted->GetCells()->GetPointer();
+  std::vector<std::pair<vtkIdType, int64_t> > uses;
+  uses.reserve(static_cast<size_t>(sorted->GetNumberOfPoints()));
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    const int64_t* r = &ranges[c * H5_SPATIAL_INDEX_COLUMNS];
+    for (int64_t pos = r[2]; pos < r[2] + r[3]; pos += conn[pos] + 1)
+    {
+      for (vtkIdType k = 1; k <= conn[pos]; ++k)
+      {
+        uses.push_back(std::make_pair(conn[pos + k], static_cast<int64_t>(c)));
+      }
+    }
+  }
+  std::sort(uses.begin(), uses.end());
+  uses.erase(std::unique(uses.begin(), uses.end()), uses.end());
+
+  std::vector<std::pair<int64_t, int64_t> > pairs;
+  for (size_t i = 0; i < uses.size(); )
+  {
+    size_t j = i + 1;
+    while (j < uses.size() && uses[j].first == uses[i].first)
+    {
+      ++j;
+    }
+    for (size_t a = i; a < j; ++a)
+    {
+      for (size_t b = i; b < j; ++b)
+      {
+        if (a != b)
+        {
+          pairs.push_back(std::make_pair(uses[a].second, uses[b].second));
+        }
+      }
+    }
+    i = j;
+  }
+  std::sort(pairs.begin(), pairs.end());
+  pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+  std::vector<int64_t> offsets(numChunks + 1, 0);
+  std::vector<int64_t> neighbors(pairs.size());
+  for (size_t i = 0; i < pairs.size(); ++i)
+  {
+    ++offsets[pairs[i].first + 1];
+    neighbors[i] = pairs[i].second;
+  }
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    offsets[c + 1] += offsets[c];
+  }
+
+  vtkTypeInt32 rank = 1;
+  vtkTypeUInt64 dims[1] = { static_cast<vtkTypeUInt64>(offsets.size()) };
+  herr_t err = H5Vtk::H5Lite::writePointerDataset(indexId, H5_SPATIAL_INDEX_NEIGHBOR_OFFSETS, rank, dims, &offsets[0]);
+  if (err >= 0 && !neighbors.empty())
+  {
+    dims[0] = neighbors.size();
+    err = H5Vtk::H5Lite::writePointerDataset(indexId, H5_SPATIAL_INDEX_NEIGHBORS, rank, dims, &neighbors[0]);
+  }
+  return err;
+}
+
+namespace
+{
+  // Min and max of the tuples of every chunk, including the shared tuples
+  // shared[offsets[c]] up to shared[offsets[c + 1]] when offsets is not
+  // empty. The loop over the run of a chunk has no branches so the compiler
+  // can vectorize it.
+  template <class T>
+  void H5VtkChunkValueRanges(const T* data, const std::vector<int64_t> &ranges, int column,
+                             const std::vector<int64_t> &offsets, const std::vector<int64_t> &shared,
+                             std::vector<double> &valueRanges)
+  {
+    size_t numChunks = ranges.size() / H5_SPATIAL_INDEX_COLUMNS;
+    valueRanges.resize(2 * numChunks);
+    for (size_t c = 0; c < numChunks; ++c)
+    {
+      const T* begin = data + ranges[c * H5_SPATIAL_INDEX_COLUMNS + column];
+      const T* end = begin + ranges[c * H5_SPATIAL_INDEX_COLUMNS + column + 1];
+      int64_t s = offsets.empty() ? 0 : offsets[c];
+      int64_t sharedEnd = offsets.empty() ? 0 : offsets[c + 1];
+      T minValue = (begin < end) ? *begin : ((s < sharedEnd) ? data[shared[s]] : T(0));
+      T maxValue = minValue;
+      for (const T* v = begin; v < end; ++v)
+      {
+        minValue = (*v < minValue) ? *v : minValue;
+        maxValue = (*v > maxValue) ? *v : maxValue;
+      }
+      for (; s < sharedEnd; ++s)
+      {
+        T v = data[shared[s]];
+        minValue = (v < minValue) ? v : minValue;
+        maxValue = (v > maxValue) ? v : maxValue;
+      }
+      valueRanges[2 * c] = static_cast<double>(minValue);
+      valueRanges[2 * c + 1] = static_cast<double>(maxValue);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5UnstructuredGridWriter::WriteChunkValueRanges(hid_t indexId, const char* groupName, vtkDataSetAttributes* a,
+                                                       std::vector<int64_t> &ranges, int column,
+                                                       std::vector<int64_t> &sharedOffsets,
+                                                       std::vector<int64_t> &sharedTuples)
+{
+  hid_t gid = -1;
+  herr_t err = 0;
+  for (int i = 0; i < a->GetNumberOfArrays() && err >= 0; ++i)
+  {
+    vtkDataArray* array = a->GetArray(i);
+    if (NULL == array || NULL == array->GetName() || array->GetNumberOfComponents() != 1)
+    {
+      continue;
+    }
+    std::vector<double> valueRanges;
+    switch (array->GetDataType())
+    {
+      vtkTemplateMacro(H5VtkChunkValueRanges(static_cast<VTK_TT*>(array->GetVoidPointer(0)), ranges, column,
+                                             sharedOffsets, sharedTuples, valueRanges));
+      default:
+        continue;
+    }
+    if (gid < 0)
+    {
+      gid = H5Gcreate(indexId, groupName, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      if (gid < 0)
+      {
+        return gid;
+      }
+    }
+    vtkTypeInt32 rank = 2;
+    vtkTypeUInt64 dims[2] = { static_cast<vtkTypeUInt64>(valueRanges.size() / 2), 2 };
+    err = H5Vtk::H5Lite::writePointerDataset(gid, array->GetName(), rank, dims, &valueRanges[0]);
+  }
+  if (gid >= 0)
+  {
+    H5Gclose(gid);
+  }
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkH5UnstructuredGridWriter::writeVtkObjectIndex(std::vector<std::string> &paths)
+{
+  hid_t fileId = -1;
+  herr_t err = 0;
+  // Try to open a file
+  fileId = H5Vtk::H5Utilities::openFile(this->FileName, false);
+  if (fileId < 0)
+  {
+    return -1;
+  }
+  err = this->writeObjectIndex(fileId, paths);
+
+  // Close the file when we are finished with it
+  H5Vtk::H5Utilities::closeFile(fileId);
+
+  // The index sets the order of the grids in the descriptor
+  this->WriteXdmfDescriptor();
+
+  return err;
+}
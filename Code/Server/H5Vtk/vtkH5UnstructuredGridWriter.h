@@ -0,0 +1,216 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+#ifndef VTKH5UNSTRUCTUREDGRIDWRITER_H_
+#define VTKH5UNSTRUCTUREDGRIDWRITER_H_
+
+
+#include "vtkH5DataWriter.h"
+
+//-- Hdf5 includes
+#include <hdf5.h>
+
+#include "HDF5/H5Lite.h"
+
+#ifndef VTK_EXPORT
+#define VTK_EXPORT
+#endif
+
+class vtkUnstructuredGrid;
+class vtkIdTypeArray;
+
+/**
+* @class vtkH5UnstructuredGridWriter vtkH5UnstructuredGridWriter.h vtkH5UnstructuredGridWriter.h
+* @brief This class writes a vtkUnstructuredGrid object to an HDF5 based file
+* using the same layout that vtkH5UnstructuredGridReader reads.
+* @author Mike Jackson for BlueQuartz Software
+* @date Nov 2010
+* @version $Revision: 1.1 $
+*/
+class VTK_EXPORT vtkH5UnstructuredGridWriter : public vtkH5DataWriter
+{
+public:
+  static vtkH5UnstructuredGridWriter* New();
+  vtkTypeRevisionMacro( vtkH5UnstructuredGridWriter, vtkH5DataWriter );
+  void PrintSelf( ostream&, vtkIndent );
+
+  // Description:
+  // Specify file name of the h5u file to write.
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+
+  vtkSetStringMacro(HDFPath);
+  vtkGetStringMacro(HDFPath);
+
+  vtkSetMacro(AppendData, vtkTypeInt32);
+  vtkGetMacro(AppendData, vtkTypeInt32);
+  vtkBooleanMacro(AppendData, vtkTypeInt32);
+
+  // Description:
+  // When larger than 0, the cells are binned spatially into chunks of about
+  // SpatialChunkSize cells before they are written and the bounding box of
+  // every chunk is stored in a SPATIAL_INDEX group next to CELLS. Cells, cell
+  // data, points and point data are reordered so each chunk is a contiguous
+  // run of every dataset, which lets vtkH5UnstructuredGridReader read only the
+  // chunks that intersect its ReadBounds. 0 (the default) writes the grid in
+  // its own order without an index. The index also holds the value range of
+  // every single component cell and point data array in each chunk so the
+  // reader can skip chunks with its ValueRangeFilter and Isovalue.
+  vtkSetClampMacro(SpatialChunkSize, int, 0, VTK_INT_MAX);
+  vtkGetMacro(SpatialChunkSize, int);
+
+  // Description:
+  // Get the input to this writer.
+  vtkUnstructuredGrid* GetInput();
+  vtkUnstructuredGrid* GetInput(int port);
+
+  //BTX
+  int writeVtkObjectIndex(std::vector<std::string> &paths);
+  //ETX
+
+protected:
+  vtkH5UnstructuredGridWriter();
+  ~vtkH5UnstructuredGridWriter();
+
+  virtual void WriteData();
+
+  /**
+  * @brief Standard vtk 5.x pipeline method. This method is used to set what type
+  * of outputs this filter produces.
+  * @param port The port to get output information for
+  * @param information The vtkInformation pointer
+  * @return 1 on success, 0 on error
+  */
+  virtual int FillInputPortInformation(int port, vtkInformation* information);
+
+  /**
+   * @brief Writes the offset of every cell into CELLS as CELL_LOCATIONS so
+   * the reader does not have to walk the cells to find them.
+   * @param fp The HDF5 group of the grid
+   * @param locations The cell locations of the grid
+   * @return Negative value on error
+   */
+  int WriteCellLocations(hid_t fp, vtkIdTypeArray* locations);
+
+  /**
+   * @brief Writes the face stream and face locations of the polyhedra of a
+   * grid as they are kept by vtkUnstructuredGrid, without any per cell work.
+   * @param fp The HDF5 group of the grid
+   * @param input The grid to write
+   * @return Negative value on error
+   */
+  int WritePolyhedronFaces(hid_t fp, vtkUnstructuredGrid* input);
+
+  /**
+   * @brief Returns the number of points of every cell of input if all cells
+   * have the same type and size, 0 otherwise. Polyhedra are never homogeneous.
+   * @param input The grid to check
+   * @param cellType Receives the type of the cells
+   */
+  int GetHomogeneousCellSize(vtkUnstructuredGrid* input, int &cellType);
+
+  /**
+   * @brief Writes the cells of a grid with a single cell type as CELLS with
+   * the CellType attribute and no CELL_TYPES. Without the codec only the
+   * point ids are written, the size of every cell being implied.
+   * @return Negative value on error
+   */
+  int WriteHomogeneousCells(hid_t fp, vtkUnstructuredGrid* input, int cellType,
+                            int cellSize, bool useCodec);
+
+  //BTX
+  /**
+   * @brief Builds a copy of input with the cells in the order cellOrder (new
+   * to old cell id) and the points renumbered by pointMap (old to new point
+   * id), carrying the point, cell and field data along.
+   */
+  vtkUnstructuredGrid* PermuteGrid(vtkUnstructuredGrid* input,
+                                   const std::vector<vtkIdType> &cellOrder,
+                                   const std::vector<vtkIdType> &pointMap);
+
+  /**
+   * @brief Builds a copy of input with points and cells sorted along the
+   * SpaceFillingCurve and the original id arrays added.
+   * @return The sorted grid, or NULL if input can not be sorted
+   */
+  vtkUnstructuredGrid* ReorderAlongCurve(vtkUnstructuredGrid* input);
+
+  /**
+   * @brief Builds a copy of input whose cells are sorted into spatial bins of
+   * about SpatialChunkSize cells. Points are renumbered in the order the
+   * sorted cells first use them, so each chunk owns the contiguous run of
+   * the points it uses first. The points it shares with earlier chunks are
+   * listed by WriteSharedPoints().
+   * @param input The grid to sort
+   * @param bounds Receives 6 bounds per chunk
+   * @param ranges Receives H5_SPATIAL_INDEX_COLUMNS ranges per chunk
+   * @return The sorted grid, or NULL if input can not be sorted
+   */
+  vtkUnstructuredGrid* SortCellsSpatially(vtkUnstructuredGrid* input,
+                                          std::vector<double> &bounds,
+                                          std::vector<int64_t> &ranges);
+
+  /**
+   * @brief Writes the SPATIAL_INDEX group built by SortCellsSpatially along
+   * with the value ranges of the arrays of the sorted grid.
+   * @param cellSize The number of points of every cell if CELLS was written
+   * without cell sizes, 0 otherwise
+   * @return Negative value on error
+   */
+  int WriteSpatialIndex(hid_t fp, vtkUnstructuredGrid* sorted,
+                        std::vector<double> &bounds, std::vector<int64_t> &ranges,
+                        int cellSize);
+
+  /**
+   * @brief Writes the points every chunk of sorted uses outside of the run
+   * of points it owns as SHARED_POINTS and SHARED_POINT_OFFSETS of the index.
+   * @param offsets Receives the first shared point of every chunk
+   * @param shared Receives the shared points of all chunks
+   * @return Negative value on error
+   */
+  int WriteSharedPoints(hid_t indexId, vtkUnstructuredGrid* sorted, std::vector<int64_t> &ranges,
+                        std::vector<int64_t> &offsets, std::vector<int64_t> &shared);
+
+  /**
+   * @brief Writes the (min, max) of every chunk of each single component
+   * array of a into the group groupName of the index.
+   * @param column The column of ranges holding the first tuple of a chunk,
+   * the next column holds the number of tuples
+   * @param sharedOffsets, sharedTuples The tuples of other chunks a chunk
+   * also uses, see WriteSharedPoints(). Empty when there are none.
+   * @return Negative value on error
+   */
+  int WriteChunkValueRanges(hid_t indexId, const char* groupName, vtkDataSetAttributes* a,
+                            std::vector<int64_t> &ranges, int column,
+                            std::vector<int64_t> &sharedOffsets, std::vector<int64_t> &sharedTuples);
+
+  /**
+   * @brief Writes for every chunk of the index the chunks it shares a point
+   * with, which a reader uses to add ghost cells around its piece.
+   * @return Negative value on error
+   */
+  int WriteChunkNeighbors(hid_t indexId, vtkUnstructuredGrid* sorted, std::vector<int64_t> &ranges);
+  //ETX
+
+private:
+
+  char* FileName;
+
+  char* HDFPath;
+
+  vtkTypeInt32 AppendData;
+
+  int SpatialChunkSize;
+
+
+  vtkH5UnstructuredGridWriter(const vtkH5UnstructuredGridWriter&);  // Not implemented.
+  void operator=(const vtkH5UnstructuredGridWriter&);  // Not implemented.
+
+
+};
+
+#endif /*VTKH5UNSTRUCTUREDGRIDWRITER_H_*/
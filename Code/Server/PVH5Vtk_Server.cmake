@@ -13,6 +13,13 @@ set (H5Vtk_Server_Wrapped_Sources
     ${H5Vtk_SOURCE_DIR}/vtkH5PolyDataReader.cpp
     ${H5Vtk_SOURCE_DIR}/vtkH5UnstructuredGridReader.cpp
     ${H5Vtk_SOURCE_DIR}/vtkH5PolyDataWriter.cpp
+    ${H5Vtk_SOURCE_DIR}/vtkH5UnstructuredGridWriter.cpp
+    ${H5Vtk_SOURCE_DIR}/vtkH5ImageDataReader.cpp
+    ${H5Vtk_SOURCE_DIR}/vtkH5ImageDataWriter.cpp
+    ${H5Vtk_SOURCE_DIR}/vtkH5StructuredGridReader.cpp
+    ${H5Vtk_SOURCE_DIR}/vtkH5StructuredGridWriter.cpp
+    ${H5Vtk_SOURCE_DIR}/vtkH5RectilinearGridReader.cpp
+    ${H5Vtk_SOURCE_DIR}/vtkH5RectilinearGridWriter.cpp
     ${H5Vtk_SOURCE_DIR}/vtkH5DataReader.cpp
     ${H5Vtk_SOURCE_DIR}/vtkH5DataWriter.cpp
 )
@@ -22,6 +29,13 @@ set (H5Vtk_SM_HDRS
     ${H5Vtk_SOURCE_DIR}/vtkH5PolyDataReader.h
     ${H5Vtk_SOURCE_DIR}/vtkH5UnstructuredGridReader.h
     ${H5Vtk_SOURCE_DIR}/vtkH5PolyDataWriter.h
+    ${H5Vtk_SOURCE_DIR}/vtkH5UnstructuredGridWriter.h
+    ${H5Vtk_SOURCE_DIR}/vtkH5ImageDataReader.h
+    ${H5Vtk_SOURCE_DIR}/vtkH5ImageDataWriter.h
+    ${H5Vtk_SOURCE_DIR}/vtkH5StructuredGridReader.h
+    ${H5Vtk_SOURCE_DIR}/vtkH5StructuredGridWriter.h
+    ${H5Vtk_SOURCE_DIR}/vtkH5RectilinearGridReader.h
+    ${H5Vtk_SOURCE_DIR}/vtkH5RectilinearGridWriter.h
     ${H5Vtk_SOURCE_DIR}/vtkH5DataReader.h
     ${H5Vtk_SOURCE_DIR}/vtkH5DataWriter.h
 )
@@ -30,10 +44,22 @@ SOURCE_GROUP("H5Vtk\\\\Headers" FILES ${H5Vtk_SM_HDRS} )
 set (H5Vtk_Server_Sources 
     ${H5Vtk_SOURCE_DIR}/HDF5/H5Lite.cpp
     ${H5Vtk_SOURCE_DIR}/HDF5/H5Utilities.cpp
+    ${H5Vtk_SOURCE_DIR}/HDF5/H5IOStatistics.cpp
+    ${H5Vtk_SOURCE_DIR}/HDF5/H5Xdmf.cpp
+    ${H5Vtk_SOURCE_DIR}/HDF5/H5ConnectivityCodec.cpp
+    ${H5Vtk_SOURCE_DIR}/HDF5/H5ArrayEncoding.cpp
+    ${H5Vtk_SOURCE_DIR}/HDF5/H5Compression.cpp
+    ${H5Vtk_SOURCE_DIR}/HDF5/H5StorageTuner.cpp
 )
 set (H5Vtk_HDRS 
     ${H5Vtk_SOURCE_DIR}/HDF5/H5Lite.h 
     ${H5Vtk_SOURCE_DIR}/HDF5/H5Utilities.h 
+    ${H5Vtk_SOURCE_DIR}/HDF5/H5IOStatistics.h
+    ${H5Vtk_SOURCE_DIR}/HDF5/H5Xdmf.h
+    ${H5Vtk_SOURCE_DIR}/HDF5/H5ConnectivityCodec.h
+    ${H5Vtk_SOURCE_DIR}/HDF5/H5ArrayEncoding.h
+    ${H5Vtk_SOURCE_DIR}/HDF5/H5Compression.h
+    ${H5Vtk_SOURCE_DIR}/HDF5/H5StorageTuner.h
 )
             
 SOURCE_GROUP("H5Vtk\\\\Sources" FILES "${H5Vtk_Server_Sources}" )
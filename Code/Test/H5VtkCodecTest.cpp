@@ -0,0 +1,391 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/* H5VtkCodecTest round trips the encodings H5Vtk writes to disk through their
+ * encoders and decoders: the connectivity codec, the symmetric tensor and
+ * octahedral normal encodings and the bit rounding of lossy compression. The
+ * test to run is given as the only argument, ctest runs each one on its own.
+ * Returns 0 if the test passed.
+ */
+
+//-- C++ includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+//-- H5Vtk includes
+#include "HDF5/H5ArrayEncoding.h"
+#include "HDF5/H5Compression.h"
+#include "HDF5/H5ConnectivityCodec.h"
+
+#define H5VTK_TEST(condition, message) \
+  if (!(condition)) \
+  { \
+    std::cout << __FILE__ << "(" << __LINE__ << "): " << message << std::endl; \
+    return 1; \
+  }
+
+namespace
+{
+
+// -----------------------------------------------------------------------------
+//  Deterministic values so a failure can be reproduced
+// -----------------------------------------------------------------------------
+class TestRandom
+{
+  public:
+    TestRandom() : m_State(12345) {}
+    double next()
+    {
+      m_State = m_State * 6364136223846793005ull + 1442695040888963407ull;
+      return static_cast<double>(m_State >> 11) / 9007199254740992.0;
+    }
+  private:
+    vtkTypeUInt64 m_State;
+};
+
+// -----------------------------------------------------------------------------
+//  Encodes and decodes a cell stream and compares it with the original
+// -----------------------------------------------------------------------------
+int roundTripCells(const std::vector<vtkIdType> &cells, vtkIdType numCells, vtkTypeInt32 expectedCellSize)
+{
+  vtkIdType numIds = static_cast<vtkIdType>(cells.size());
+  std::vector<unsigned char> encoded;
+  vtkTypeInt32 cellSize = -1;
+  herr_t err = H5Vtk::H5ConnectivityCodec::encode(numIds > 0 ? &(cells.front()) : NULL, numCells, numIds,
+                                                  encoded, cellSize);
+  H5VTK_TEST(err >= 0, "encode failed");
+  H5VTK_TEST(cellSize == expectedCellSize, "cell size " << cellSize << " instead of " << expectedCellSize);
+  std::vector<vtkIdType> decoded(numIds + 1, -7);
+  err = H5Vtk::H5ConnectivityCodec::decode(encoded.empty() ? NULL : &(encoded.front()), encoded.size(),
+                                           numCells, numIds, cellSize, &(decoded.front()));
+  H5VTK_TEST(err >= 0, "decode failed");
+  for (vtkIdType i = 0; i < numIds; ++i)
+  {
+    H5VTK_TEST(decoded[i] == cells[i], "id " << i << " decoded as " << decoded[i] << " instead of " << cells[i]);
+  }
+  H5VTK_TEST(decoded[numIds] == -7, "decode wrote past the cell stream");
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int testVariableSizeCells()
+{
+  // More cells than one block of 128 values, with growing and falling ids
+  std::vector<vtkIdType> cells;
+  vtkIdType numCells = 0;
+  for (vtkIdType c = 0; c < 300; ++c)
+  {
+    vtkIdType npts = 1 + c % 8;
+    cells.push_back(npts);
+    for (vtkIdType k = 0; k < npts; ++k)
+    {
+      cells.push_back((c * 37 + k * 1001) % 5000);
+    }
+    ++numCells;
+  }
+  return roundTripCells(cells, numCells, 0);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int testConstantSizeCells()
+{
+  // Hexahedra of a structured block, every corner one row apart
+  std::vector<vtkIdType> cells;
+  vtkIdType n = 12;
+  vtkIdType numCells = 0;
+  for (vtkIdType k = 0; k < n - 1; ++k)
+  {
+    for (vtkIdType j = 0; j < n - 1; ++j)
+    {
+      for (vtkIdType i = 0; i < n - 1; ++i)
+      {
+        vtkIdType p = i + n * (j + n * k);
+        vtkIdType hex[9] = { 8, p, p + 1, p + 1 + n, p + n,
+                             p + n * n, p + 1 + n * n, p + 1 + n + n * n, p + n + n * n };
+        cells.insert(cells.end(), hex, hex + 9);
+        ++numCells;
+      }
+    }
+  }
+  if (roundTripCells(cells, numCells, 8) != 0)
+  {
+    return 1;
+  }
+  // A single cell is constant size as well
+  std::vector<vtkIdType> triangle;
+  triangle.push_back(3);
+  triangle.push_back(4);
+  triangle.push_back(0);
+  triangle.push_back(9);
+  return roundTripCells(triangle, 1, 3);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int testEmptyCells()
+{
+  std::vector<vtkIdType> cells;
+  if (roundTripCells(cells, 0, 0) != 0)
+  {
+    return 1;
+  }
+  // Cells without points, e.g. empty polygons
+  cells.assign(4, 0);
+  if (roundTripCells(cells, 4, 0) != 0)
+  {
+    return 1;
+  }
+  // A stream that does not match its cell count is refused
+  std::vector<unsigned char> encoded;
+  vtkTypeInt32 cellSize = 0;
+  cells.clear();
+  cells.push_back(3);
+  cells.push_back(0);
+  H5VTK_TEST(H5Vtk::H5ConnectivityCodec::encode(&(cells.front()), 1, 2, encoded, cellSize) < 0,
+             "a truncated cell was encoded");
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int testLargeIdDeltas()
+{
+#if VTK_SIZEOF_ID_TYPE == 8
+  // Differences that need all 64 bits once zigzag mapped
+  const vtkIdType large = std::numeric_limits<vtkIdType>::max();
+  std::vector<vtkIdType> cells;
+  vtkIdType ids[6] = { 0, large, 1, large - 1, static_cast<vtkIdType>(1) << 40, 5 };
+  for (int c = 0; c < 3; ++c)
+  {
+    cells.push_back(2);
+    cells.push_back(ids[2 * c]);
+    cells.push_back(ids[2 * c + 1]);
+  }
+  if (roundTripCells(cells, 3, 2) != 0)
+  {
+    return 1;
+  }
+  cells.push_back(1);
+  cells.push_back(large);
+  return roundTripCells(cells, 4, 0);
+#else
+  std::cout << "vtkIdType has 32 bits, 64 bit ids can not occur" << std::endl;
+  return 0;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int testSymmetricTensors()
+{
+  TestRandom random;
+  const vtkIdType numTuples = 50;
+  std::vector<double> tensors(9 * numTuples);
+  for (vtkIdType t = 0; t < numTuples; ++t)
+  {
+    double* m = &tensors[9 * t];
+    for (int r = 0; r < 3; ++r)
+    {
+      for (int c = r; c < 3; ++c)
+      {
+        m[3 * r + c] = m[3 * c + r] = random.next() * 200.0 - 100.0;
+      }
+    }
+  }
+  H5VTK_TEST(H5Vtk::H5ArrayEncoding::isSymmetric(&tensors[0], numTuples), "symmetric tensors were refused");
+  std::vector<double> packed(6 * numTuples);
+  std::vector<double> unpacked(9 * numTuples);
+  H5Vtk::H5ArrayEncoding::packSymmetric(&tensors[0], numTuples, &packed[0]);
+  H5Vtk::H5ArrayEncoding::unpackSymmetric(&packed[0], numTuples, &unpacked[0]);
+  for (size_t i = 0; i < tensors.size(); ++i)
+  {
+    H5VTK_TEST(unpacked[i] == tensors[i], "component " << i << " changed");
+  }
+  std::vector<float> single(tensors.begin(), tensors.end());
+  single[9 * 7 + 1] += 1.0f;
+  H5VTK_TEST(!H5Vtk::H5ArrayEncoding::isSymmetric(&single[0], numTuples), "an asymmetric tensor was accepted");
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int testOctahedralNormals()
+{
+  TestRandom random;
+  const vtkIdType numTuples = 1000;
+  std::vector<float> normals(3 * numTuples);
+  for (vtkIdType t = 0; t < numTuples; ++t)
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      normals[3 * t + i] = static_cast<float>(random.next() * 2.0 - 1.0);
+    }
+  }
+  // The poles and the folded edges of the octahedron
+  float special[12] = { 0, 0, 1, 0, 0, -1, 1, 0, 0, 0, -1, 0 };
+  std::copy(special, special + 12, normals.begin());
+  std::vector<uint16_t> encoded(2 * numTuples);
+  std::vector<float> decoded(3 * numTuples);
+  H5Vtk::H5ArrayEncoding::encodeOctahedral(&normals[0], numTuples, &encoded[0]);
+  H5Vtk::H5ArrayEncoding::decodeOctahedral(&encoded[0], numTuples, &decoded[0]);
+  for (vtkIdType t = 0; t < numTuples; ++t)
+  {
+    const float* n = &normals[3 * t];
+    const float* d = &decoded[3 * t];
+    double length = std::sqrt(static_cast<double>(n[0]) * n[0] + n[1] * n[1] + n[2] * n[2]);
+    double dot = (n[0] * d[0] + n[1] * d[1] + n[2] * d[2]) / length;
+    // 16 bits per coordinate keep the direction to well under 0.01 degree
+    H5VTK_TEST(dot > 0.99999, "normal " << t << " is off by " << std::acos(std::min(dot, 1.0)) << " rad");
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//  Rounds values to the bits kept for relativeBound and checks the error
+// -----------------------------------------------------------------------------
+template<typename T>
+int roundTripMantissa(double relativeBound)
+{
+  TestRandom random;
+  const size_t numValues = 10000;
+  std::vector<T> values(numValues);
+  for (size_t i = 0; i < numValues; ++i)
+  {
+    // Magnitudes over many binades and both signs
+    values[i] = static_cast<T>((random.next() - 0.5) * std::pow(10.0, random.next() * 20.0 - 10.0));
+  }
+  values[0] = std::numeric_limits<T>::infinity();
+  values[1] = -std::numeric_limits<T>::infinity();
+  values[2] = std::numeric_limits<T>::quiet_NaN();
+  values[3] = 0;
+  values[4] = std::numeric_limits<T>::max();
+  std::vector<T> rounded(values);
+  bool isDouble = (sizeof(T) == 8);
+  int kept = H5Vtk::H5Compression::getKeptMantissaBits(relativeBound, isDouble);
+  double error = H5Vtk::H5Compression::getBitRoundError(kept);
+  H5VTK_TEST(error <= relativeBound, "kept " << kept << " bits allow an error of " << error);
+  H5Vtk::H5Compression::roundMantissa(&rounded[0], numValues, kept);
+  H5VTK_TEST(rounded[0] == values[0] && rounded[1] == values[1], "an infinity changed");
+  H5VTK_TEST(rounded[2] != rounded[2], "NaN changed");
+  H5VTK_TEST(rounded[3] == 0, "zero changed");
+  for (size_t i = 4; i < numValues; ++i)
+  {
+    double v = static_cast<double>(values[i]);
+    double r = static_cast<double>(rounded[i]);
+    // The largest value may round up to infinity, which breaks no bound of
+    // finite data but is not expected here
+    H5VTK_TEST(std::fabs(r) <= std::numeric_limits<T>::max(), "value " << i << " overflowed");
+    H5VTK_TEST(std::fabs(r - v) <= error * std::fabs(v), "value " << i << " " << v << " rounded to " << r);
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int testMantissaErrorBound()
+{
+  double bounds[4] = { 1.0e-2, 1.0e-3, 1.0e-5, 1.0e-7 };
+  for (int b = 0; b < 4; ++b)
+  {
+    if (roundTripMantissa<float>(bounds[b]) != 0 || roundTripMantissa<double>(bounds[b]) != 0)
+    {
+      std::cout << "Relative error bound " << bounds[b] << " was not kept" << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//  Arrays without a finite non zero value have no relative error to keep
+// -----------------------------------------------------------------------------
+int testZeroMagnitude()
+{
+  std::vector<float> zeros(100, 0.0f);
+  H5VTK_TEST(H5Vtk::H5Compression::getMaximumMagnitude(&zeros[0], zeros.size()) == 0.0,
+             "an array of zeros has a magnitude");
+  std::vector<double> nonFinite(3);
+  nonFinite[0] = std::numeric_limits<double>::infinity();
+  nonFinite[1] = -std::numeric_limits<double>::infinity();
+  nonFinite[2] = std::numeric_limits<double>::quiet_NaN();
+  H5VTK_TEST(H5Vtk::H5Compression::getMaximumMagnitude(&nonFinite[0], nonFinite.size()) == 0.0,
+             "an array without finite values has a magnitude");
+  // An absolute bound over a zero magnitude is an infinite relative bound
+  double bounds[3] = { 1.0, 1.0e300, std::numeric_limits<double>::infinity() };
+  for (int b = 0; b < 3; ++b)
+  {
+    H5VTK_TEST(H5Vtk::H5Compression::getKeptMantissaBits(bounds[b], false) == 0, "float keeps bits for " << bounds[b]);
+    H5VTK_TEST(H5Vtk::H5Compression::getKeptMantissaBits(bounds[b], true) == 0, "double keeps bits for " << bounds[b]);
+  }
+  H5Vtk::H5Compression::roundMantissa(&zeros[0], zeros.size(), 0);
+  for (size_t i = 0; i < zeros.size(); ++i)
+  {
+    H5VTK_TEST(zeros[i] == 0.0f, "zero " << i << " rounded to " << zeros[i]);
+  }
+  return 0;
+}
+
+struct CodecTest
+{
+  const char* name;
+  int (*run)();
+};
+
+const CodecTest Tests[] = {
+  { "VariableSizeCells", testVariableSizeCells },
+  { "ConstantSizeCells", testConstantSizeCells },
+  { "EmptyCells", testEmptyCells },
+  { "LargeIdDeltas", testLargeIdDeltas },
+  { "SymmetricTensors", testSymmetricTensors },
+  { "OctahedralNormals", testOctahedralNormals },
+  { "MantissaErrorBound", testMantissaErrorBound },
+  { "ZeroMagnitude", testZeroMagnitude }
+};
+const int NumberOfTests = sizeof(Tests) / sizeof(Tests[0]);
+
+} // End anonymous namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  int ran = 0;
+  int failed = 0;
+  for (int t = 0; t < NumberOfTests; ++t)
+  {
+    if (argc > 1 && std::string(argv[1]) != Tests[t].name)
+    {
+      continue;
+    }
+    int result = Tests[t].run();
+    std::cout << Tests[t].name << (result == 0 ? " passed" : " FAILED") << std::endl;
+    ++ran;
+    failed += (result == 0) ? 0 : 1;
+  }
+  if (ran == 0)
+  {
+    std::cout << "Unknown test " << argv[1] << std::endl;
+    return EXIT_FAILURE;
+  }
+  return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,29 @@
+#-------------------------------------------------------------------------------
+#
+#  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+#  All rights reserved.
+#  BSD License: http://www.opensource.org/licenses/bsd-license.html
+#
+#-------------------------------------------------------------------------------
+# --------------------------------------------------------------------
+# Round trip tests of the encodings written to disk. They only need the HDF5
+# helpers, not VTK.
+# --------------------------------------------------------------------
+OPTION(PVH5Vtk_BUILD_TESTING "Build the H5Vtk tests" ON)
+
+set (H5Vtk_TEST_SOURCE_DIR "${PVH5Vtk_SOURCE_DIR}/Code/Test")
+
+IF (PVH5Vtk_BUILD_TESTING)
+
+  ADD_EXECUTABLE(H5VtkCodecTest
+      ${H5Vtk_TEST_SOURCE_DIR}/H5VtkCodecTest.cpp
+      ${H5Vtk_Server_Sources}
+  )
+  TARGET_LINK_LIBRARIES(H5VtkCodecTest ${HDF5_LIBRARIES} vtkzlib)
+
+  foreach (test VariableSizeCells ConstantSizeCells EmptyCells LargeIdDeltas
+                SymmetricTensors OctahedralNormals MantissaErrorBound ZeroMagnitude)
+    ADD_TEST(NAME H5VtkCodec_${test} COMMAND H5VtkCodecTest ${test})
+  endforeach (test)
+
+ENDIF (PVH5Vtk_BUILD_TESTING)
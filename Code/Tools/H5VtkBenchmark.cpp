@@ -0,0 +1,665 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/* H5VtkBenchmark writes and reads fixed synthetic meshes through the H5Vtk
+ * writers and readers and compares the results against a baseline stored per
+ * machine (H5VtkBenchmark_<hostname>.baseline).
+ *
+ * Every case runs in its own process so that the peak memory of one case does
+ * not leak into the next. Deterministic counters from H5IOStatistics (object
+ * opens, read/write operations, bytes moved, allocations) must match the
+ * baseline exactly. Timings are the median of several repetitions and only
+ * count as a regression when the median is slower than the baseline by more
+ * than the relative tolerance plus three median absolute deviations, the
+ * write and read throughput may drop by as much. The program exits with a non
+ * zero value when anything regressed, and with 77 without running any case
+ * when there is no baseline for this machine. The H5VtkBenchmark ctest runs
+ * it against PVH5Vtk_BENCHMARK_BASELINE_DIR and reports the latter as
+ * skipped. Baselines are only written with --record.
+ *
+ * With --codec-sweep the cases are instead written once per lossless codec
+ * applied to the points, connectivity and data arrays, and the compression
+ * ratio and the write and read throughput of the uncompressed bytes are
+ * printed. Codecs whose filter plugin can not be loaded are skipped.
+ */
+
+//-- C++ includes
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+//-- VTK includes
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+#include <vtkPoints.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkUnstructuredGrid.h>
+#include <vtkFloatArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkIntArray.h>
+#include <vtkIdList.h>
+
+#include <vtksys/Process.h>
+#include <vtksys/SystemInformation.hxx>
+#include <vtksys/SystemTools.hxx>
+
+//-- H5Vtk includes
+#include "HDF5/H5Compression.h"
+#include "HDF5/H5IOStatistics.h"
+#include "vtkH5PolyDataReader.h"
+#include "vtkH5PolyDataWriter.h"
+#include "vtkH5UnstructuredGridReader.h"
+#include "vtkH5UnstructuredGridWriter.h"
+
+namespace
+{
+
+typedef std::map<std::string, double> ResultMap;
+
+// Cases and their mesh resolution. The meshes are fully deterministic so the
+// counters depend only on the code being benchmarked.
+struct BenchmarkCase
+{
+  const char* name;
+  bool unstructured;
+  int resolution;
+};
+
+const BenchmarkCase Cases[] = {
+  { "PolyDataSmall", false, 64 },
+  { "PolyDataLarge", false, 1024 },
+  { "UnstructuredGridSmall", true, 16 },
+  { "UnstructuredGridLarge", true, 96 }
+};
+const int NumberOfCases = sizeof(Cases) / sizeof(Cases[0]);
+
+// Codecs of the --codec-sweep, the first one is the uncompressed reference
+const int Codecs[] = {
+  VTK_H5_CODEC_NONE, VTK_H5_CODEC_DEFLATE, VTK_H5_CODEC_LZ4, VTK_H5_CODEC_ZSTD, VTK_H5_CODEC_BLOSC,
+  VTK_H5_CODEC_AUTO
+};
+const int NumberOfCodecs = sizeof(Codecs) / sizeof(Codecs[0]);
+
+// Exit code without a baseline for this machine, the ctest counts it as
+// skipped instead of passed or failed
+const int NoBaselineExitCode = 77;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool isExactKey(const std::string &key)
+{
+  return (key.find(".seconds") == std::string::npos
+       && key.find(".mbps") == std::string::npos
+       && key.find("peakMemoryKB") == std::string::npos);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+double peakMemoryKB()
+{
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS pmc;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+  {
+    return static_cast<double>(pmc.PeakWorkingSetSize) / 1024.0;
+  }
+  return 0.0;
+#else
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+  return static_cast<double>(usage.ru_maxrss) / 1024.0;
+#else
+  return static_cast<double>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+double median(std::vector<double> values)
+{
+  if (values.empty()) { return 0.0; }
+  std::sort(values.begin(), values.end());
+  size_t mid = values.size() / 2;
+  if (values.size() % 2 == 0)
+  {
+    return 0.5 * (values[mid - 1] + values[mid]);
+  }
+  return values[mid];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+double medianAbsoluteDeviation(const std::vector<double> &values)
+{
+  double m = median(values);
+  std::vector<double> deviations(values.size(), 0.0);
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    deviations[i] = std::fabs(values[i] - m);
+  }
+  return median(deviations);
+}
+
+// -----------------------------------------------------------------------------
+//  A gently curved triangulated sheet with point and cell attributes
+// -----------------------------------------------------------------------------
+vtkPolyData* createPolyData(int n)
+{
+  vtkPolyData* pd = vtkPolyData::New();
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataTypeToFloat();
+  points->SetNumberOfPoints(static_cast<vtkIdType>(n) * n);
+  vtkSmartPointer<vtkFloatArray> elevation = vtkSmartPointer<vtkFloatArray>::New();
+  elevation->SetName("Elevation");
+  elevation->SetNumberOfTuples(static_cast<vtkIdType>(n) * n);
+  vtkSmartPointer<vtkFloatArray> normals = vtkSmartPointer<vtkFloatArray>::New();
+  normals->SetName("Normals");
+  normals->SetNumberOfComponents(3);
+  normals->SetNumberOfTuples(static_cast<vtkIdType>(n) * n);
+  for (int j = 0; j < n; ++j)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      vtkIdType id = static_cast<vtkIdType>(j) * n + i;
+      double x = static_cast<double>(i) / n;
+      double y = static_cast<double>(j) / n;
+      double z = 0.1 * sin(6.0 * x) * cos(6.0 * y);
+      points->SetPoint(id, x, y, z);
+      elevation->SetValue(id, static_cast<float>(z));
+      normals->SetTuple3(id, 0.0, 0.0, 1.0);
+    }
+  }
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  vtkSmartPointer<vtkIntArray> cellIds = vtkSmartPointer<vtkIntArray>::New();
+  cellIds->SetName("CellIndex");
+  vtkIdType tri[3];
+  for (int j = 0; j < n - 1; ++j)
+  {
+    for (int i = 0; i < n - 1; ++i)
+    {
+      vtkIdType p0 = static_cast<vtkIdType>(j) * n + i;
+      tri[0] = p0; tri[1] = p0 + 1; tri[2] = p0 + n;
+      polys->InsertNextCell(3, tri);
+      cellIds->InsertNextValue(static_cast<int>(cellIds->GetNumberOfTuples()));
+      tri[0] = p0 + 1; tri[1] = p0 + n + 1; tri[2] = p0 + n;
+      polys->InsertNextCell(3, tri);
+      cellIds->InsertNextValue(static_cast<int>(cellIds->GetNumberOfTuples()));
+    }
+  }
+  pd->SetPoints(points);
+  pd->SetPolys(polys);
+  pd->GetPointData()->SetScalars(elevation);
+  pd->GetPointData()->SetNormals(normals);
+  pd->GetCellData()->AddArray(cellIds);
+  return pd;
+}
+
+// -----------------------------------------------------------------------------
+//  A block of hexahedra with scalar, vector and material attributes
+// -----------------------------------------------------------------------------
+vtkUnstructuredGrid* createUnstructuredGrid(int n)
+{
+  vtkUnstructuredGrid* ug = vtkUnstructuredGrid::New();
+  vtkIdType numPts = static_cast<vtkIdType>(n) * n * n;
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(numPts);
+  vtkSmartPointer<vtkDoubleArray> temperature = vtkSmartPointer<vtkDoubleArray>::New();
+  temperature->SetName("Temperature");
+  temperature->SetNumberOfTuples(numPts);
+  vtkSmartPointer<vtkFloatArray> velocity = vtkSmartPointer<vtkFloatArray>::New();
+  velocity->SetName("Velocity");
+  velocity->SetNumberOfComponents(3);
+  velocity->SetNumberOfTuples(numPts);
+  for (int k = 0; k < n; ++k)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      for (int i = 0; i < n; ++i)
+      {
+        vtkIdType id = (static_cast<vtkIdType>(k) * n + j) * n + i;
+        points->SetPoint(id, i, j, k);
+        temperature->SetValue(id, 300.0 + i + 0.5 * j + 0.25 * k);
+        velocity->SetTuple3(id, j, -i, 0.1 * k);
+      }
+    }
+  }
+  vtkIdType numCells = static_cast<vtkIdType>(n - 1) * (n - 1) * (n - 1);
+  ug->Allocate(numCells);
+  vtkSmartPointer<vtkIntArray> material = vtkSmartPointer<vtkIntArray>::New();
+  material->SetName("Material");
+  material->SetNumberOfTuples(numCells);
+  vtkIdType hex[8];
+  vtkIdType c = 0;
+  for (int k = 0; k < n - 1; ++k)
+  {
+    for (int j = 0; j < n - 1; ++j)
+    {
+      for (int i = 0; i < n - 1; ++i)
+      {
+        vtkIdType p0 = (static_cast<vtkIdType>(k) * n + j) * n + i;
+        hex[0] = p0;         hex[1] = p0 + 1;
+        hex[2] = p0 + n + 1; hex[3] = p0 + n;
+        hex[4] = hex[0] + n * n; hex[5] = hex[1] + n * n;
+        hex[6] = hex[2] + n * n; hex[7] = hex[3] + n * n;
+        ug->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+        material->SetValue(c++, (i * 4) / n + 1);
+      }
+    }
+  }
+  ug->SetPoints(points);
+  ug->GetPointData()->SetScalars(temperature);
+  ug->GetPointData()->SetVectors(velocity);
+  ug->GetCellData()->AddArray(material);
+  return ug;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void recordCounters(ResultMap &results, const std::string &prefix)
+{
+  results[prefix + ".objectOpens"] = static_cast<double>(H5Vtk::H5IOStatistics::getObjectOpens());
+  results[prefix + ".readOperations"] = static_cast<double>(H5Vtk::H5IOStatistics::getReadOperations());
+  results[prefix + ".bytesRead"] = static_cast<double>(H5Vtk::H5IOStatistics::getBytesRead());
+  results[prefix + ".writeOperations"] = static_cast<double>(H5Vtk::H5IOStatistics::getWriteOperations());
+  results[prefix + ".bytesWritten"] = static_cast<double>(H5Vtk::H5IOStatistics::getBytesWritten());
+  results[prefix + ".allocations"] = static_cast<double>(H5Vtk::H5IOStatistics::getAllocations());
+  results[prefix + ".bytesAllocated"] = static_cast<double>(H5Vtk::H5IOStatistics::getBytesAllocated());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool writeResults(const std::string &path, const ResultMap &results)
+{
+  std::ofstream out(path.c_str(), std::ios::out | std::ios::trunc);
+  if (!out.is_open())
+  {
+    std::cout << "Could not write " << path << std::endl;
+    return false;
+  }
+  out << std::setprecision(17);
+  for (ResultMap::const_iterator iter = results.begin(); iter != results.end(); ++iter)
+  {
+    out << iter->first << " " << iter->second << "\n";
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool readResults(const std::string &path, ResultMap &results)
+{
+  std::ifstream in(path.c_str());
+  if (!in.is_open())
+  {
+    return false;
+  }
+  std::string key;
+  double value;
+  while (in >> key >> value)
+  {
+    results[key] = value;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void setCompression(vtkH5DataWriter* writer, int codec)
+{
+  writer->SetPointsCompression(codec);
+  writer->SetConnectivityCompression(codec);
+  writer->SetPointDataCompression(codec);
+  writer->SetCellDataCompression(codec);
+}
+
+// -----------------------------------------------------------------------------
+//  Runs one case in this process and stores the results in resultFile
+// -----------------------------------------------------------------------------
+int runCase(const BenchmarkCase &bc, const std::string &resultFile, int repeats, const std::string &workDir,
+            int codec)
+{
+  std::string h5File = workDir + "/" + bc.name + (bc.unstructured ? ".h5u" : ".h5p");
+  vtkDataObject* mesh = NULL;
+  if (bc.unstructured) { mesh = createUnstructuredGrid(bc.resolution); }
+  else { mesh = createPolyData(bc.resolution); }
+
+  ResultMap results;
+  std::vector<double> writeTimes;
+  std::vector<double> readTimes;
+  for (int r = 0; r < repeats; ++r)
+  {
+    vtksys::SystemTools::RemoveFile(h5File.c_str());
+
+    H5Vtk::H5IOStatistics::reset();
+    double start = vtkTimerLog::GetUniversalTime();
+    if (bc.unstructured)
+    {
+      vtkSmartPointer<vtkH5UnstructuredGridWriter> writer = vtkSmartPointer<vtkH5UnstructuredGridWriter>::New();
+      writer->SetInput(mesh);
+      writer->SetFileName(h5File.c_str());
+      writer->SetHDFPath("/1");
+      writer->AppendDataOff();
+      setCompression(writer, codec);
+      writer->Write();
+    }
+    else
+    {
+      vtkSmartPointer<vtkH5PolyDataWriter> writer = vtkSmartPointer<vtkH5PolyDataWriter>::New();
+      writer->SetInput(mesh);
+      writer->SetFileName(h5File.c_str());
+      writer->SetHDFPath("/1");
+      writer->AppendDataOff();
+      setCompression(writer, codec);
+      writer->Write();
+    }
+    writeTimes.push_back(vtkTimerLog::GetUniversalTime() - start);
+    if (r == 0) { recordCounters(results, "write"); }
+
+    H5Vtk::H5IOStatistics::reset();
+    start = vtkTimerLog::GetUniversalTime();
+    if (bc.unstructured)
+    {
+      vtkSmartPointer<vtkH5UnstructuredGridReader> reader = vtkSmartPointer<vtkH5UnstructuredGridReader>::New();
+      reader->SetFileName(h5File.c_str());
+      reader->SetHDFPath("/1");
+      reader->Update();
+    }
+    else
+    {
+      vtkSmartPointer<vtkH5PolyDataReader> reader = vtkSmartPointer<vtkH5PolyDataReader>::New();
+      reader->SetFileName(h5File.c_str());
+      reader->SetHDFPath("/1");
+      reader->Update();
+    }
+    readTimes.push_back(vtkTimerLog::GetUniversalTime() - start);
+    if (r == 0) { recordCounters(results, "read"); }
+  }
+  mesh->Delete();
+
+  double fileMB = static_cast<double>(vtksys::SystemTools::FileLength(h5File.c_str())) / (1024.0 * 1024.0);
+  results["write.seconds.median"] = median(writeTimes);
+  results["write.seconds.mad"] = medianAbsoluteDeviation(writeTimes);
+  results["read.seconds.median"] = median(readTimes);
+  results["read.seconds.mad"] = medianAbsoluteDeviation(readTimes);
+  results["write.mbps"] = results["write.seconds.median"] > 0.0 ? fileMB / results["write.seconds.median"] : 0.0;
+  results["read.mbps"] = results["read.seconds.median"] > 0.0 ? fileMB / results["read.seconds.median"] : 0.0;
+  results["fileBytes"] = static_cast<double>(vtksys::SystemTools::FileLength(h5File.c_str()));
+  results["peakMemoryKB"] = peakMemoryKB();
+  vtksys::SystemTools::RemoveFile(h5File.c_str());
+
+  return writeResults(resultFile, results) ? 0 : 1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool spawnCase(const std::string &exe, const BenchmarkCase &bc, const std::string &resultFile,
+               int repeats, const std::string &workDir, int codec)
+{
+  std::stringstream ss;
+  ss << repeats;
+  std::string repeatStr = ss.str();
+  ss.str("");
+  ss << codec;
+  std::string codecStr = ss.str();
+  const char* cmd[] = { exe.c_str(), "--run-case", bc.name, resultFile.c_str(),
+                        repeatStr.c_str(), workDir.c_str(), codecStr.c_str(), NULL };
+  vtksysProcess* cp = vtksysProcess_New();
+  vtksysProcess_SetCommand(cp, cmd);
+  vtksysProcess_SetPipeShared(cp, vtksysProcess_Pipe_STDOUT, 1);
+  vtksysProcess_SetPipeShared(cp, vtksysProcess_Pipe_STDERR, 1);
+  vtksysProcess_Execute(cp);
+  vtksysProcess_WaitForExit(cp, NULL);
+  bool ok = (vtksysProcess_GetState(cp) == vtksysProcess_State_Exited && vtksysProcess_GetExitValue(cp) == 0);
+  vtksysProcess_Delete(cp);
+  return ok;
+}
+
+// -----------------------------------------------------------------------------
+//  Returns the number of regressions found for one value
+// -----------------------------------------------------------------------------
+int compareValue(const std::string &key, const ResultMap &current, const ResultMap &baseline,
+                 double timeTolerance, double memoryTolerance)
+{
+  ResultMap::const_iterator cur = current.find(key);
+  ResultMap::const_iterator base = baseline.find(key);
+  if (base == baseline.end())
+  {
+    std::cout << "  " << std::left << std::setw(48) << key << " new value " << cur->second << std::endl;
+    return 0;
+  }
+  bool regressed = false;
+  if (isExactKey(key))
+  {
+    regressed = (cur->second != base->second);
+  }
+  else if (key.find(".seconds.median") != std::string::npos)
+  {
+    std::string madKey = key.substr(0, key.size() - std::string("median").size()) + "mad";
+    double mad = std::max(current.find(madKey)->second,
+                          baseline.count(madKey) ? baseline.find(madKey)->second : 0.0);
+    regressed = cur->second > base->second * (1.0 + timeTolerance) + 3.0 * mad;
+  }
+  else if (key.find(".mbps") != std::string::npos)
+  {
+    // The throughput is the file size over the median time, so it is allowed
+    // the drop that the time limit above allows
+    std::string prefix = key.substr(0, key.size() - std::string("mbps").size());
+    ResultMap::const_iterator seconds = baseline.find(prefix + "seconds.median");
+    double mad = std::max(current.count(prefix + "seconds.mad") ? current.find(prefix + "seconds.mad")->second : 0.0,
+                          baseline.count(prefix + "seconds.mad") ? baseline.find(prefix + "seconds.mad")->second : 0.0);
+    double slowdown = 1.0 + timeTolerance;
+    if (seconds != baseline.end() && seconds->second > 0.0)
+    {
+      slowdown += 3.0 * mad / seconds->second;
+    }
+    regressed = cur->second < base->second / slowdown;
+  }
+  else if (key.find("peakMemoryKB") != std::string::npos)
+  {
+    regressed = cur->second > base->second * (1.0 + memoryTolerance);
+  }
+  std::cout << "  " << std::left << std::setw(48) << key << std::right << std::setw(16) << std::setprecision(6)
+            << base->second << " -> " << std::setw(16) << cur->second << (regressed ? "   REGRESSION" : "") << std::endl;
+  return regressed ? 1 : 0;
+}
+
+// -----------------------------------------------------------------------------
+//  Prints the compression ratio and throughput of every available codec
+// -----------------------------------------------------------------------------
+int runCodecSweep(const std::string &exe, int repeats, const std::string &workDir)
+{
+  std::cout << std::left << std::setw(24) << "Case" << std::setw(10) << "Codec" << std::right
+            << std::setw(10) << "Ratio" << std::setw(14) << "Write MB/s" << std::setw(14) << "Read MB/s" << std::endl;
+  for (int c = 0; c < NumberOfCases; ++c)
+  {
+    double uncompressedMB = 0.0;
+    for (int k = 0; k < NumberOfCodecs; ++k)
+    {
+      H5Z_filter_t filter = H5Vtk::H5Compression::getCodecFilter(Codecs[k]);
+      const char* codecName = H5Vtk::H5Compression::getCodecName(Codecs[k]);
+      if (filter != H5Z_FILTER_NONE && !H5Vtk::H5Compression::isFilterAvailable(filter))
+      {
+        std::cout << std::left << std::setw(24) << Cases[c].name << std::setw(10) << codecName
+                  << "  filter not available, skipped" << std::endl;
+        continue;
+      }
+      std::string resultFile = workDir + "/" + Cases[c].name + ".results";
+      ResultMap results;
+      if (!spawnCase(exe, Cases[c], resultFile, repeats, workDir, Codecs[k]) || !readResults(resultFile, results))
+      {
+        std::cout << "Benchmark case " << Cases[c].name << " failed to run with " << codecName << std::endl;
+        return 1;
+      }
+      vtksys::SystemTools::RemoveFile(resultFile.c_str());
+      double fileMB = results["fileBytes"] / (1024.0 * 1024.0);
+      if (k == 0) { uncompressedMB = fileMB; }
+      double writeSeconds = results["write.seconds.median"];
+      double readSeconds = results["read.seconds.median"];
+      std::cout << std::left << std::setw(24) << Cases[c].name << std::setw(10) << codecName << std::right
+                << std::fixed << std::setprecision(3)
+                << std::setw(10) << (fileMB > 0.0 ? uncompressedMB / fileMB : 0.0)
+                << std::setw(14) << (writeSeconds > 0.0 ? uncompressedMB / writeSeconds : 0.0)
+                << std::setw(14) << (readSeconds > 0.0 ? uncompressedMB / readSeconds : 0.0)
+                << std::endl;
+      std::cout.unsetf(std::ios::floatfield);
+    }
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void printUsage(const char* exe)
+{
+  std::cout << "Usage: " << exe << " [options]" << std::endl;
+  std::cout << "  --record                Store the results as the new baseline for this machine" << std::endl;
+  std::cout << "  --baseline-dir <dir>    Directory holding the per machine baselines (default: .)" << std::endl;
+  std::cout << "  --work-dir <dir>        Directory for the temporary h5p/h5u files (default: .)" << std::endl;
+  std::cout << "  --repeats <n>           Timed repetitions per case (default: 7)" << std::endl;
+  std::cout << "  --time-tolerance <f>    Allowed relative slow down of the median time (default: 0.10)" << std::endl;
+  std::cout << "  --memory-tolerance <f>  Allowed relative growth of the peak memory (default: 0.05)" << std::endl;
+  std::cout << "  --codec-sweep           Print the compression ratio and throughput of each codec" << std::endl;
+}
+
+} // End anonymous namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  if (argc > 1 && std::string(argv[1]) == "--run-case")
+  {
+    if (argc != 6 && argc != 7)
+    {
+      return 1;
+    }
+    for (int c = 0; c < NumberOfCases; ++c)
+    {
+      if (std::string(Cases[c].name) == argv[2])
+      {
+        return runCase(Cases[c], argv[3], atoi(argv[4]), argv[5], (argc == 7) ? atoi(argv[6]) : VTK_H5_CODEC_NONE);
+      }
+    }
+    std::cout << "Unknown benchmark case " << argv[2] << std::endl;
+    return 1;
+  }
+
+  bool record = false;
+  bool codecSweep = false;
+  std::string baselineDir = ".";
+  std::string workDir = ".";
+  int repeats = 7;
+  double timeTolerance = 0.10;
+  double memoryTolerance = 0.05;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg(argv[i]);
+    if (arg == "--record") { record = true; }
+    else if (arg == "--codec-sweep") { codecSweep = true; }
+    else if (arg == "--baseline-dir" && i + 1 < argc) { baselineDir = argv[++i]; }
+    else if (arg == "--work-dir" && i + 1 < argc) { workDir = argv[++i]; }
+    else if (arg == "--repeats" && i + 1 < argc) { repeats = atoi(argv[++i]); }
+    else if (arg == "--time-tolerance" && i + 1 < argc) { timeTolerance = atof(argv[++i]); }
+    else if (arg == "--memory-tolerance" && i + 1 < argc) { memoryTolerance = atof(argv[++i]); }
+    else { printUsage(argv[0]); return (arg == "-h" || arg == "--help") ? 0 : 1; }
+  }
+  if (repeats < 1) { repeats = 1; }
+
+  vtksys::SystemInformation sysInfo;
+  std::string host = sysInfo.GetHostname();
+  std::string baselineFile = baselineDir + "/H5VtkBenchmark_" + host + ".baseline";
+
+  std::string exe = vtksys::SystemTools::CollapseFullPath(argv[0]);
+  if (!vtksys::SystemTools::FileExists(exe.c_str()))
+  {
+    exe = vtksys::SystemTools::FindProgram(argv[0]);
+  }
+  if (codecSweep)
+  {
+    return runCodecSweep(exe, repeats, workDir);
+  }
+
+  // A run that compares nothing must not pass as one without regressions.
+  // Timings only compare on the machine that recorded them, so a new build
+  // tree or machine has to record its own baseline first.
+  ResultMap baseline;
+  if (!record && !readResults(baselineFile, baseline))
+  {
+    std::cout << "No baseline " << baselineFile << " for this machine. Run with --record to store one." << std::endl;
+    return NoBaselineExitCode;
+  }
+
+  ResultMap current;
+  for (int c = 0; c < NumberOfCases; ++c)
+  {
+    std::string resultFile = workDir + "/" + Cases[c].name + ".results";
+    ResultMap caseResults;
+    if (!spawnCase(exe, Cases[c], resultFile, repeats, workDir, VTK_H5_CODEC_NONE) || !readResults(resultFile, caseResults))
+    {
+      std::cout << "Benchmark case " << Cases[c].name << " failed to run." << std::endl;
+      return 1;
+    }
+    vtksys::SystemTools::RemoveFile(resultFile.c_str());
+    for (ResultMap::iterator iter = caseResults.begin(); iter != caseResults.end(); ++iter)
+    {
+      current[std::string(Cases[c].name) + "." + iter->first] = iter->second;
+    }
+  }
+
+  if (record)
+  {
+    std::cout << "Recording baseline " << baselineFile << std::endl;
+    vtksys::SystemTools::MakeDirectory(baselineDir.c_str());
+    return writeResults(baselineFile, current) ? 0 : 1;
+  }
+  std::cout << "Comparing against baseline " << baselineFile << std::endl;
+  int regressions = 0;
+  for (ResultMap::iterator iter = current.begin(); iter != current.end(); ++iter)
+  {
+    if (iter->first.find(".mad") != std::string::npos) { continue; }
+    regressions += compareValue(iter->first, current, baseline, timeTolerance, memoryTolerance);
+  }
+  if (regressions > 0)
+  {
+    std::cout << regressions << " values regressed. If the change is intended rerun with --record." << std::endl;
+    return 1;
+  }
+  std::cout << "No regressions." << std::endl;
+  return 0;
+}
@@ -0,0 +1,595 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/* H5VtkConvert converts legacy (.vtk) and XML (.vtp/.vtu) VTK files into
+ * h5p/h5u files. Inputs may be files, directories or glob patterns. The
+ * sorted input list is written to a manifest in the output directory and cut
+ * into fixed size batches; every batch becomes one multi-object file with a
+ * VTK_OBJECT_INDEX. Batches are handed to a pool of worker processes (this
+ * executable started with --worker) because HDF5 is not thread safe. Each
+ * worker takes the next unclaimed batch from the queue as soon as it finishes
+ * its current one, so slow inputs never hold up idle workers.
+ *
+ * A batch is first written to "<output>.part" and renamed when complete, or
+ * removed if any input could not be read or any write failed, so an interrupted or failed run can be
+ * restarted with --resume: the existing manifest is reused and every batch
+ * whose output file already exists is skipped.
+ */
+
+//-- C++ includes
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <set>
+#include <algorithm>
+
+//-- VTK includes
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+#include <vtkDataReader.h>
+#include <vtkErrorCode.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataReader.h>
+#include <vtkUnstructuredGrid.h>
+#include <vtkUnstructuredGridReader.h>
+#include <vtkXMLPolyDataReader.h>
+#include <vtkXMLUnstructuredGridReader.h>
+
+#include <vtksys/Directory.hxx>
+#include <vtksys/Glob.hxx>
+#include <vtksys/Process.h>
+#include <vtksys/SystemTools.hxx>
+
+//-- H5Vtk includes
+#include "VTKH5Constants.h"
+#include "HDF5/H5Lite.h"
+#include "HDF5/H5Utilities.h"
+#include "vtkH5PolyDataWriter.h"
+#include "vtkH5UnstructuredGridWriter.h"
+
+#define H5VTKCONVERT_POLYDATA_MANIFEST      "H5VtkConvert_PolyData.manifest"
+#define H5VTKCONVERT_UNSTRUCTURED_MANIFEST  "H5VtkConvert_UnstructuredGrid.manifest"
+
+namespace
+{
+
+enum InputKind
+{
+  UnknownKind = 0,
+  PolyDataKind,
+  UnstructuredGridKind
+};
+
+/**
+ * @brief One batch of consecutive manifest entries that ends up in one output file
+ */
+struct ConvertJob
+{
+  std::string manifest;
+  size_t first;
+  size_t count;
+  std::string output;
+  double inputBytes;
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void printUsage(const char* exe)
+{
+  std::cout << "Usage: " << exe << " [options] <file|directory|glob> ..." << std::endl;
+  std::cout << "  -o <dir>   Output directory (default: current directory)" << std::endl;
+  std::cout << "  -j <n>     Number of worker processes (default: 4)" << std::endl;
+  std::cout << "  -n <n>     Number of objects packed into each output file (default: 64)" << std::endl;
+  std::cout << "  -r         Recurse into sub directories" << std::endl;
+  std::cout << "  --resume   Reuse the manifests in the output directory and skip finished batches" << std::endl;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool isConvertibleExtension(const std::string &path)
+{
+  std::string ext = vtksys::SystemTools::LowerCase(vtksys::SystemTools::GetFilenameLastExtension(path));
+  return (ext == ".vtk" || ext == ".vtp" || ext == ".vtu");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+InputKind classifyInput(const std::string &path)
+{
+  std::string ext = vtksys::SystemTools::LowerCase(vtksys::SystemTools::GetFilenameLastExtension(path));
+  if (ext == ".vtp") { return PolyDataKind; }
+  if (ext == ".vtu") { return UnstructuredGridKind; }
+  if (ext == ".vtk")
+  {
+    // Legacy files carry the dataset type in their header
+    vtkSmartPointer<vtkDataReader> reader = vtkSmartPointer<vtkDataReader>::New();
+    reader->SetFileName(path.c_str());
+    if (reader->IsFilePolyData()) { return PolyDataKind; }
+    if (reader->IsFileUnstructuredGrid()) { return UnstructuredGridKind; }
+  }
+  return UnknownKind;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void expandInput(const std::string &arg, bool recurse, std::vector<std::string> &files)
+{
+  if (vtksys::SystemTools::FileIsDirectory(arg.c_str()))
+  {
+    if (recurse)
+    {
+      vtksys::Glob glob;
+      glob.RecurseOn();
+      glob.FindFiles(arg + "/*");
+      const std::vector<std::string> &found = glob.GetFiles();
+      for (std::vector<std::string>::const_iterator iter = found.begin(); iter != found.end(); ++iter)
+      {
+        if (isConvertibleExtension(*iter)) { files.push_back(*iter); }
+      }
+      return;
+    }
+    vtksys::Directory dir;
+    if (!dir.Load(arg.c_str()))
+    {
+      std::cout << "Could not read directory " << arg << std::endl;
+      return;
+    }
+    for (unsigned long i = 0; i < dir.GetNumberOfFiles(); ++i)
+    {
+      std::string path = arg + "/" + dir.GetFile(i);
+      if (!vtksys::SystemTools::FileIsDirectory(path.c_str()) && isConvertibleExtension(path))
+      {
+        files.push_back(path);
+      }
+    }
+  }
+  else if (arg.find_first_of("*?[") != std::string::npos)
+  {
+    vtksys::Glob glob;
+    if (recurse) { glob.RecurseOn(); }
+    glob.FindFiles(arg);
+    const std::vector<std::string> &found = glob.GetFiles();
+    for (std::vector<std::string>::const_iterator iter = found.begin(); iter != found.end(); ++iter)
+    {
+      if (isConvertibleExtension(*iter)) { files.push_back(*iter); }
+    }
+  }
+  else if (vtksys::SystemTools::FileExists(arg.c_str()))
+  {
+    files.push_back(arg);
+  }
+  else
+  {
+    std::cout << "Input does not exist: " << arg << std::endl;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool writeManifest(const std::string &path, const std::vector<std::string> &files)
+{
+  std::ofstream out(path.c_str(), std::ios::out | std::ios::trunc);
+  if (!out.is_open())
+  {
+    std::cout << "Could not write manifest " << path << std::endl;
+    return false;
+  }
+  for (std::vector<std::string>::const_iterator iter = files.begin(); iter != files.end(); ++iter)
+  {
+    out << *iter << "\n";
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool readManifest(const std::string &path, std::vector<std::string> &files)
+{
+  std::ifstream in(path.c_str());
+  if (!in.is_open())
+  {
+    return false;
+  }
+  std::string line;
+  while (std::getline(in, line))
+  {
+    if (!line.empty()) { files.push_back(line); }
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::string jobOutputName(const std::string &outDir, const char* prefix, size_t batch, const char* ext)
+{
+  std::stringstream ss;
+  ss << outDir << "/" << prefix << "_" << std::setw(6) << std::setfill('0') << batch << ext;
+  return ss.str();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void addJobs(std::deque<ConvertJob> &jobs, const std::string &manifest,
+             const std::vector<std::string> &files, size_t perFile,
+             const std::string &outDir, const char* prefix, const char* ext,
+             bool resume, size_t &skipped)
+{
+  size_t batch = 0;
+  for (size_t first = 0; first < files.size(); first += perFile, ++batch)
+  {
+    ConvertJob job;
+    job.manifest = manifest;
+    job.first = first;
+    job.count = std::min(perFile, files.size() - first);
+    job.output = jobOutputName(outDir, prefix, batch, ext);
+    job.inputBytes = 0.0;
+    if (resume && vtksys::SystemTools::FileExists(job.output.c_str()))
+    {
+      ++skipped;
+      continue;
+    }
+    for (size_t i = first; i < first + job.count; ++i)
+    {
+      job.inputBytes += static_cast<double>(vtksys::SystemTools::FileLength(files[i].c_str()));
+    }
+    jobs.push_back(job);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//  Returns a copy of the output of a Reader for path, or NULL if the file
+//  could not be read. A corrupt file leaves an empty output behind, which
+//  must not be converted into an empty object.
+// -----------------------------------------------------------------------------
+template<typename Reader, typename Data>
+vtkDataObject* readWith(const std::string &path)
+{
+  vtkSmartPointer<Reader> reader = vtkSmartPointer<Reader>::New();
+  reader->SetFileName(path.c_str());
+  reader->Update();
+  Data* output = reader->GetOutput();
+  if (reader->GetErrorCode() != vtkErrorCode::NoError || NULL == output || output->GetNumberOfPoints() == 0)
+  {
+    std::cout << "Error reading " << path << std::endl;
+    return NULL;
+  }
+  Data* data = Data::New();
+  data->ShallowCopy(output);
+  return data;
+}
+
+// -----------------------------------------------------------------------------
+//  Returns NULL for an input of UnknownKind or one that could not be read
+// -----------------------------------------------------------------------------
+vtkDataObject* readInput(const std::string &path, InputKind kind)
+{
+  std::string ext = vtksys::SystemTools::LowerCase(vtksys::SystemTools::GetFilenameLastExtension(path));
+  if (ext == ".vtp")
+  {
+    return readWith<vtkXMLPolyDataReader, vtkPolyData>(path);
+  }
+  if (ext == ".vtu")
+  {
+    return readWith<vtkXMLUnstructuredGridReader, vtkUnstructuredGrid>(path);
+  }
+  if (kind == PolyDataKind)
+  {
+    return readWith<vtkPolyDataReader, vtkPolyData>(path);
+  }
+  if (kind == UnstructuredGridKind)
+  {
+    return readWith<vtkUnstructuredGridReader, vtkUnstructuredGrid>(path);
+  }
+  return NULL;
+}
+
+// -----------------------------------------------------------------------------
+//  Converts one batch of the manifest into a single multi-object file.
+// -----------------------------------------------------------------------------
+int runWorker(const std::string &manifest, size_t first, size_t count, const std::string &output)
+{
+  std::vector<std::string> files;
+  if (!readManifest(manifest, files) || first + count > files.size())
+  {
+    std::cout << "Worker could not read entries " << first << "-" << first + count << " from " << manifest << std::endl;
+    return 1;
+  }
+
+  std::string partial = output + ".part";
+  vtksys::SystemTools::RemoveFile(partial.c_str());
+
+  std::vector<std::string> paths;
+  std::vector<std::string> sources;
+  for (size_t i = first; i < first + count; ++i)
+  {
+    InputKind kind = classifyInput(files[i]);
+    if (kind == UnknownKind)
+    {
+      std::cout << "Skipping unsupported input " << files[i] << std::endl;
+      continue;
+    }
+    vtkDataObject* data = readInput(files[i], kind);
+    if (NULL == data)
+    {
+      // Like a failed write, an unreadable input fails the whole batch
+      vtksys::SystemTools::RemoveFile(partial.c_str());
+      return 1;
+    }
+
+    std::stringstream ss;
+    ss << "/" << (paths.size() + 1);
+    int written = 0;
+    unsigned long errorCode = vtkErrorCode::NoError;
+    if (kind == PolyDataKind)
+    {
+      vtkSmartPointer<vtkH5PolyDataWriter> writer = vtkSmartPointer<vtkH5PolyDataWriter>::New();
+      writer->SetInput(data);
+      writer->SetFileName(partial.c_str());
+      writer->SetHDFPath(ss.str().c_str());
+      writer->AppendDataOn();
+      written = writer->Write();
+      errorCode = writer->GetErrorCode();
+    }
+    else
+    {
+      vtkSmartPointer<vtkH5UnstructuredGridWriter> writer = vtkSmartPointer<vtkH5UnstructuredGridWriter>::New();
+      writer->SetInput(data);
+      writer->SetFileName(partial.c_str());
+      writer->SetHDFPath(ss.str().c_str());
+      writer->AppendDataOn();
+      written = writer->Write();
+      errorCode = writer->GetErrorCode();
+    }
+    data->Delete();
+    if (written == 0 || errorCode != vtkErrorCode::NoError)
+    {
+      // The batch stays without a final name so that --resume retries it
+      std::cout << "Error writing " << files[i] << " to " << partial << std::endl;
+      vtksys::SystemTools::RemoveFile(partial.c_str());
+      return 1;
+    }
+    paths.push_back(ss.str());
+    sources.push_back(files[i]);
+  }
+
+  if (paths.empty())
+  {
+    std::cout << "No objects were converted for " << output << std::endl;
+    return 1;
+  }
+
+  // Record the object index and where every object came from
+  vtkSmartPointer<vtkH5PolyDataWriter> indexWriter = vtkSmartPointer<vtkH5PolyDataWriter>::New();
+  indexWriter->SetFileName(partial.c_str());
+  if (indexWriter->writeVtkObjectIndex(paths) < 0)
+  {
+    std::cout << "Error writing the object index to " << partial << std::endl;
+    vtksys::SystemTools::RemoveFile(partial.c_str());
+    return 1;
+  }
+  hid_t fileId = H5Vtk::H5Utilities::openFile(partial, false);
+  if (fileId < 0)
+  {
+    vtksys::SystemTools::RemoveFile(partial.c_str());
+    return 1;
+  }
+  herr_t err = 0;
+  for (size_t i = 0; i < paths.size() && err >= 0; ++i)
+  {
+    err = H5Vtk::H5Lite::writeStringAttribute(fileId, paths[i], H5_SOURCE_FILE, sources[i]);
+  }
+  if (H5Vtk::H5Utilities::closeFile(fileId) < 0 || err < 0)
+  {
+    std::cout << "Error writing the source files to " << partial << std::endl;
+    vtksys::SystemTools::RemoveFile(partial.c_str());
+    return 1;
+  }
+
+  // Only a complete file ever carries the final name
+  vtksys::SystemTools::RemoveFile(output.c_str());
+  if (::rename(partial.c_str(), output.c_str()) != 0)
+  {
+    std::cout << "Could not rename " << partial << " to " << output << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtksysProcess* startWorker(const std::string &exe, const ConvertJob &job)
+{
+  std::stringstream first;
+  first << job.first;
+  std::stringstream count;
+  count << job.count;
+  std::string firstStr = first.str();
+  std::string countStr = count.str();
+
+  const char* cmd[] = { exe.c_str(), "--worker", job.manifest.c_str(), firstStr.c_str(),
+                        countStr.c_str(), job.output.c_str(), NULL };
+  vtksysProcess* cp = vtksysProcess_New();
+  vtksysProcess_SetCommand(cp, cmd);
+  vtksysProcess_SetPipeShared(cp, vtksysProcess_Pipe_STDOUT, 1);
+  vtksysProcess_SetPipeShared(cp, vtksysProcess_Pipe_STDERR, 1);
+  vtksysProcess_Execute(cp);
+  return cp;
+}
+
+} // End anonymous namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  if (argc > 1 && std::string(argv[1]) == "--worker")
+  {
+    if (argc != 6)
+    {
+      std::cout << "Usage: " << argv[0] << " --worker <manifest> <first> <count> <output>" << std::endl;
+      return 1;
+    }
+    return runWorker(argv[2], static_cast<size_t>(atol(argv[3])), static_cast<size_t>(atol(argv[4])), argv[5]);
+  }
+
+  std::string outDir = ".";
+  int numWorkers = 4;
+  size_t perFile = 64;
+  bool recurse = false;
+  bool resume = false;
+  std::vector<std::string> inputs;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg(argv[i]);
+    if (arg == "-o" && i + 1 < argc) { outDir = argv[++i]; }
+    else if (arg == "-j" && i + 1 < argc) { numWorkers = atoi(argv[++i]); }
+    else if (arg == "-n" && i + 1 < argc) { perFile = static_cast<size_t>(atol(argv[++i])); }
+    else if (arg == "-r") { recurse = true; }
+    else if (arg == "--resume") { resume = true; }
+    else if (arg == "-h" || arg == "--help") { printUsage(argv[0]); return 0; }
+    else { inputs.push_back(arg); }
+  }
+  if (numWorkers < 1) { numWorkers = 1; }
+  if (perFile < 1) { perFile = 1; }
+  vtksys::SystemTools::MakeDirectory(outDir.c_str());
+
+  std::string polyManifest = outDir + "/" + H5VTKCONVERT_POLYDATA_MANIFEST;
+  std::string ugridManifest = outDir + "/" + H5VTKCONVERT_UNSTRUCTURED_MANIFEST;
+  std::vector<std::string> polyFiles;
+  std::vector<std::string> ugridFiles;
+
+  bool haveManifests = resume && (readManifest(polyManifest, polyFiles) | readManifest(ugridManifest, ugridFiles));
+  if (haveManifests)
+  {
+    std::cout << "Resuming from existing manifests in " << outDir << std::endl;
+  }
+  else
+  {
+    if (inputs.empty())
+    {
+      printUsage(argv[0]);
+      return 1;
+    }
+    std::vector<std::string> files;
+    for (std::vector<std::string>::iterator iter = inputs.begin(); iter != inputs.end(); ++iter)
+    {
+      expandInput(*iter, recurse, files);
+    }
+    // Sorted and unique so that the batches are reproducible between runs
+    std::sort(files.begin(), files.end());
+    files.erase(std::unique(files.begin(), files.end()), files.end());
+    for (std::vector<std::string>::iterator iter = files.begin(); iter != files.end(); ++iter)
+    {
+      std::string fullPath = vtksys::SystemTools::CollapseFullPath(iter->c_str());
+      switch(classifyInput(fullPath))
+      {
+        case PolyDataKind: polyFiles.push_back(fullPath); break;
+        case UnstructuredGridKind: ugridFiles.push_back(fullPath); break;
+        default: std::cout << "Skipping unsupported input " << fullPath << std::endl;
+      }
+    }
+    if (!writeManifest(polyManifest, polyFiles) || !writeManifest(ugridManifest, ugridFiles))
+    {
+      return 1;
+    }
+  }
+
+  std::deque<ConvertJob> jobs;
+  size_t skipped = 0;
+  addJobs(jobs, polyManifest, polyFiles, perFile, outDir, "PolyData", ".h5p", resume, skipped);
+  addJobs(jobs, ugridManifest, ugridFiles, perFile, outDir, "UnstructuredGrid", ".h5u", resume, skipped);
+  size_t totalJobs = jobs.size();
+  std::cout << (polyFiles.size() + ugridFiles.size()) << " inputs in " << (totalJobs + skipped) << " batches, "
+            << skipped << " already converted, using " << numWorkers << " worker processes." << std::endl;
+
+  std::string exe = vtksys::SystemTools::CollapseFullPath(argv[0]);
+  if (!vtksys::SystemTools::FileExists(exe.c_str()))
+  {
+    exe = vtksys::SystemTools::FindProgram(argv[0]);
+  }
+
+  std::vector<vtksysProcess*> running(numWorkers, static_cast<vtksysProcess*>(NULL));
+  std::vector<ConvertJob> runningJobs(numWorkers);
+  size_t finished = 0;
+  size_t failed = 0;
+  size_t objectsDone = 0;
+  double bytesDone = 0.0;
+  double startTime = vtkTimerLog::GetUniversalTime();
+
+  while (!jobs.empty() || finished + failed < totalJobs)
+  {
+    for (int w = 0; w < numWorkers; ++w)
+    {
+      // An idle worker immediately takes the next batch off the queue
+      if (NULL == running[w])
+      {
+        if (jobs.empty()) { continue; }
+        runningJobs[w] = jobs.front();
+        jobs.pop_front();
+        running[w] = startWorker(exe, runningJobs[w]);
+        continue;
+      }
+      double timeout = 0.05;
+      if (vtksysProcess_WaitForExit(running[w], &timeout) == 0)
+      {
+        continue;
+      }
+      const ConvertJob &job = runningJobs[w];
+      if (vtksysProcess_GetState(running[w]) == vtksysProcess_State_Exited
+          && vtksysProcess_GetExitValue(running[w]) == 0)
+      {
+        ++finished;
+        objectsDone += job.count;
+        bytesDone += job.inputBytes;
+      }
+      else
+      {
+        ++failed;
+        std::cout << "Batch " << job.output << " failed. Rerun with --resume to retry it." << std::endl;
+      }
+      vtksysProcess_Delete(running[w]);
+      running[w] = NULL;
+
+      double elapsed = vtkTimerLog::GetUniversalTime() - startTime;
+      if (elapsed <= 0.0) { elapsed = 1.0e-6; }
+      std::cout << "[" << (finished + failed) << "/" << totalJobs << "] " << job.output
+                << "  " << std::fixed << std::setprecision(1)
+                << (objectsDone / elapsed) << " objects/s, "
+                << (bytesDone / (1024.0 * 1024.0) / elapsed) << " MB/s" << std::endl;
+    }
+  }
+
+  double elapsed = vtkTimerLog::GetUniversalTime() - startTime;
+  if (elapsed <= 0.0) { elapsed = 1.0e-6; }
+  std::cout << "Converted " << objectsDone << " objects (" << std::fixed << std::setprecision(1)
+            << (bytesDone / (1024.0 * 1024.0)) << " MB) into " << finished << " files in "
+            << elapsed << " s: " << (objectsDone / elapsed) << " objects/s, "
+            << (bytesDone / (1024.0 * 1024.0) / elapsed) << " MB/s" << std::endl;
+  if (failed > 0)
+  {
+    std::cout << failed << " batches failed." << std::endl;
+    return 1;
+  }
+  return 0;
+}
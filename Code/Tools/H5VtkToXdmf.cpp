@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/* H5VtkToXdmf writes an XDMF descriptor for an existing h5p/h5u file so that
+ * XDMF aware applications can read the POINTS, CELLS and attribute datasets
+ * in place. Nothing in the HDF5 file is modified. Objects that XDMF can not
+ * express (mixed cell types, cells of different sizes, triangle strips) are
+ * reported and left out of the descriptor.
+ */
+
+//-- C++ includes
+#include <iostream>
+#include <string>
+#include <vector>
+
+//-- H5Vtk includes
+#include "HDF5/H5Xdmf.h"
+
+namespace
+{
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void printUsage(const char* exe)
+{
+  std::cout << "Usage: " << exe << " [options] <file.h5p|file.h5u> [hdfpath ...]" << std::endl;
+  std::cout << "  -o <file>  Descriptor to write (default: the input with a .xmf extension)" << std::endl;
+  std::cout << "  hdfpath    Objects to describe (default: every object in the file)" << std::endl;
+}
+
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  std::string xmfFile;
+  std::string h5File;
+  std::vector<std::string> hdfPaths;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg(argv[i]);
+    if (arg == "-o" && i + 1 < argc) { xmfFile = argv[++i]; }
+    else if (arg == "-h" || arg == "--help") { printUsage(argv[0]); return 0; }
+    else if (h5File.empty()) { h5File = arg; }
+    else { hdfPaths.push_back(arg); }
+  }
+  if (h5File.empty())
+  {
+    printUsage(argv[0]);
+    return 1;
+  }
+  if (xmfFile.empty())
+  {
+    xmfFile = H5Vtk::H5Xdmf::descriptorFileName(h5File);
+  }
+
+  if (H5Vtk::H5Xdmf::writeDescriptor(h5File, xmfFile, hdfPaths) < 0)
+  {
+    std::cout << "Error writing XDMF descriptor " << xmfFile << std::endl;
+    return 1;
+  }
+  std::cout << "Wrote " << xmfFile << std::endl;
+  return 0;
+}
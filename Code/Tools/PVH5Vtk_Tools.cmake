@@ -0,0 +1,65 @@
+#-------------------------------------------------------------------------------
+#
+#  Copyright (c) 2010, Michael A. Jackson. BlueQuartz Software
+#  All rights reserved.
+#  BSD License: http://www.opensource.org/licenses/bsd-license.html
+#
+#-------------------------------------------------------------------------------
+# --------------------------------------------------------------------
+# Command line tools. They compile the server sources directly so they do not
+# depend on the plugin library being loadable outside of ParaView.
+# --------------------------------------------------------------------
+OPTION(PVH5Vtk_BUILD_TOOLS "Build the H5Vtk command line tools" ON)
+
+set (H5Vtk_TOOLS_SOURCE_DIR "${PVH5Vtk_SOURCE_DIR}/Code/Tools")
+
+set (H5Vtk_Tool_LIBRARIES
+    vtkIO
+    vtkGraphics
+    vtkFiltering
+    vtkCommon
+    vtksys
+    vtkzlib
+    ${HDF5_LIBRARIES}
+)
+
+IF (PVH5Vtk_BUILD_TOOLS)
+
+  ADD_EXECUTABLE(H5VtkConvert
+      ${H5Vtk_TOOLS_SOURCE_DIR}/H5VtkConvert.cpp
+      ${H5Vtk_Server_Wrapped_Sources}
+      ${H5Vtk_Server_Sources}
+  )
+  TARGET_LINK_LIBRARIES(H5VtkConvert ${H5Vtk_Tool_LIBRARIES})
+
+  # Runs fixed read/write cases and compares them against a per machine
+  # baseline. Exits non zero on a regression.
+  ADD_EXECUTABLE(H5VtkBenchmark
+      ${H5Vtk_TOOLS_SOURCE_DIR}/H5VtkBenchmark.cpp
+      ${H5Vtk_Server_Wrapped_Sources}
+      ${H5Vtk_Server_Sources}
+  )
+  TARGET_LINK_LIBRARIES(H5VtkBenchmark ${H5Vtk_Tool_LIBRARIES})
+  IF (WIN32)
+    TARGET_LINK_LIBRARIES(H5VtkBenchmark psapi)
+  ENDIF (WIN32)
+
+  # The benchmark fails the test on a regression. Without a baseline for the
+  # machine in the directory the test is skipped, timings of another machine
+  # would not compare. Record one with H5VtkBenchmark --record
+  # --baseline-dir <dir> to enable it.
+  set (PVH5Vtk_BENCHMARK_BASELINE_DIR "${PVH5Vtk_BINARY_DIR}/Baselines" CACHE PATH
+       "Directory holding the per machine baselines of H5VtkBenchmark")
+  ADD_TEST(NAME H5VtkBenchmark
+           COMMAND H5VtkBenchmark --baseline-dir ${PVH5Vtk_BENCHMARK_BASELINE_DIR}
+                                  --work-dir ${PVH5Vtk_BINARY_DIR})
+  SET_TESTS_PROPERTIES(H5VtkBenchmark PROPERTIES SKIP_RETURN_CODE 77)
+
+  # Only needs the HDF5 helpers and the zlib the compression code calls, not VTK
+  ADD_EXECUTABLE(H5VtkToXdmf
+      ${H5Vtk_TOOLS_SOURCE_DIR}/H5VtkToXdmf.cpp
+      ${H5Vtk_Server_Sources}
+  )
+  TARGET_LINK_LIBRARIES(H5VtkToXdmf ${HDF5_LIBRARIES} vtkzlib)
+
+ENDIF (PVH5Vtk_BUILD_TOOLS)